@@ -0,0 +1,61 @@
+#pragma once
+
+#include <rhi/rhi_cpp.h>
+
+#include <chrono>
+#include <cstdio>
+
+namespace rhi::bench
+{
+    struct BenchContext
+    {
+        Instance instance;
+        Adapter adapter;
+        Device device;
+    };
+
+    // Creates a device on the first adapter, returns false if there is none.
+    inline bool CreateBenchContext(const DeviceDesc& deviceDesc, BenchContext* context)
+    {
+        InstanceDesc instanceDesc{};
+        instanceDesc.backend = BackendType::Vulkan;
+        instanceDesc.loggingCallback = nullptr;
+        instanceDesc.loggingCallbackUserData = nullptr;
+        instanceDesc.enableDebugLayer = false;
+        context->instance = CreateInstance(instanceDesc);
+        if (!context->instance)
+        {
+            std::fprintf(stderr, "Failed to create the instance.\n");
+            return false;
+        }
+
+        std::vector<Adapter> adapters = context->instance.EnumerateAdapters();
+        if (adapters.empty())
+        {
+            std::fprintf(stderr, "No adapter found.\n");
+            return false;
+        }
+        context->adapter = adapters[0];
+        context->device = context->adapter.CreateDevice(deviceDesc);
+        if (!context->device)
+        {
+            std::fprintf(stderr, "Failed to create the device.\n");
+            return false;
+        }
+        return true;
+    }
+
+    class Timer
+    {
+    public:
+        Timer() : mStart(std::chrono::steady_clock::now()) {}
+
+        double GetElapsedSeconds() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point mStart;
+    };
+} // namespace rhi::bench
@@ -0,0 +1,101 @@
+#include "BenchCommon.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Measures Queue::WriteBuffer throughput with several threads writing to their own buffers concurrently, for both the
+// synchronous and the asynchronous submission mode.
+
+namespace
+{
+    using namespace rhi;
+
+    constexpr uint64_t cBufferSize = 4 * 1024 * 1024;
+    constexpr uint64_t cBytesPerThread = 64 * 1024 * 1024;
+    constexpr uint64_t cChunkSizes[] = {4 * 1024, 64 * 1024, 1024 * 1024};
+    constexpr uint32_t cThreadCounts[] = {1, 2, 4, 8};
+
+    double RunUploads(Device& device, uint32_t threadCount, uint64_t chunkSize)
+    {
+        Queue queue = device.GetQueue(QueueType::Graphics);
+
+        std::vector<Buffer> buffers(threadCount);
+        for (Buffer& buffer : buffers)
+        {
+            BufferDesc bufferDesc{};
+            bufferDesc.size = cBufferSize;
+            bufferDesc.usage = BufferUsage::Storage | BufferUsage::CopyDst;
+            buffer = device.CreateBuffer(bufferDesc);
+        }
+        std::vector<uint8_t> data(chunkSize, 0xAB);
+        std::atomic<uint64_t> lastSerial = 0;
+
+        bench::Timer timer;
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back(
+                    [&, i]()
+                    {
+                        uint64_t offset = 0;
+                        for (uint64_t written = 0; written < cBytesPerThread; written += chunkSize)
+                        {
+                            queue.WriteBuffer(buffers[i], data.data(), chunkSize, offset);
+                            offset = (offset + chunkSize) % cBufferSize;
+                            // Submit once per buffer length so the staging memory can be reused.
+                            if (offset == 0)
+                            {
+                                uint64_t serial = queue.Submit(nullptr, 0);
+                                uint64_t previous = lastSerial.load();
+                                while (previous < serial && !lastSerial.compare_exchange_weak(previous, serial))
+                                {
+                                }
+                            }
+                        }
+                    });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        queue.WaitForSerial(std::max(lastSerial.load(), queue.Submit(nullptr, 0)));
+        const double seconds = timer.GetElapsedSeconds();
+        device.Tick();
+
+        return static_cast<double>(cBytesPerThread * threadCount) / (1024.0 * 1024.0) / seconds;
+    }
+} // namespace
+
+int main()
+{
+    for (bool asyncSubmission : {false, true})
+    {
+        DeviceDesc deviceDesc{};
+        deviceDesc.name = "UploadBenchmark";
+        deviceDesc.requiredFeatures = nullptr;
+        deviceDesc.asyncSubmission = asyncSubmission;
+        bench::BenchContext context;
+        if (!bench::CreateBenchContext(deviceDesc, &context))
+        {
+            return 1;
+        }
+
+        std::printf("%s submission\n", asyncSubmission ? "Asynchronous" : "Synchronous");
+        std::printf("%10s %10s %12s\n", "threads", "chunk KiB", "MiB/s");
+        for (uint64_t chunkSize : cChunkSizes)
+        {
+            for (uint32_t threadCount : cThreadCounts)
+            {
+                const double throughput = RunUploads(context.device, threadCount, chunkSize);
+                std::printf("%10u %10llu %12.1f\n",
+                            threadCount,
+                            static_cast<unsigned long long>(chunkSize / 1024),
+                            throughput);
+            }
+        }
+    }
+    return 0;
+}
@@ -15,9 +15,12 @@ DEFINE_RHI_OBJECT(ComputePipeline);
 DEFINE_RHI_OBJECT(CommandEncoder);
 DEFINE_RHI_OBJECT(RenderPassEncoder);
 DEFINE_RHI_OBJECT(ComputePassEncoder);
+DEFINE_RHI_OBJECT(RenderBundleEncoder);
+DEFINE_RHI_OBJECT(RenderBundle);
 DEFINE_RHI_OBJECT(CommandList);
 DEFINE_RHI_OBJECT(PipelineLayout);
 DEFINE_RHI_OBJECT(PipelineCache);
+DEFINE_RHI_OBJECT(ResourceHeap);
 DEFINE_RHI_OBJECT(Sampler);
 DEFINE_RHI_OBJECT(ShaderModule);
 DEFINE_RHI_OBJECT(Buffer);
@@ -29,9 +32,15 @@ DEFINE_RHI_OBJECT(TextureView);
 #define AUTO_COMPUTE uint32_t(-1)
 #define ARRAY_SIZE_UNDEFINE uint32_t(-1)
 #define MIPLEVEL_COUNT_UNDEFINE uint32_t(-1)
+#define RESOURCE_HEAP_SLOT_INVALID uint32_t(-1)
 
 struct RHIAdapterInfo;
 struct RHILimits;
+struct RHIDescriptorStats;
+struct RHIBindSetCacheStats;
+struct RHIUniformAllocatorStats;
+struct RHIPipelineObjectCacheStats;
+struct RHIShaderModuleCacheStats;
 
 struct RHIRect;
 struct RHIViewport;
@@ -40,6 +49,8 @@ struct RHIExtent3D;
 struct RHIOrigin3D;
 struct RHITextureDataLayout;
 struct RHITextureSlice;
+struct RHIUploadReservation;
+struct RHIUniformAllocation;
 struct RHIBindSetLayoutEntry;
 struct RHIBindSetEntry;
 struct RHIPushConstantRange;
@@ -72,6 +83,7 @@ struct RHIShaderModuleDesc;
 struct RHIBindSetDesc;
 struct RHIBindSetLayoutDesc;
 struct RHIPipelineLayoutDesc;
+struct RHIResourceHeapDesc;
 struct RHIRenderPipelineDesc;
 struct RHIComputePipelineDesc;
 struct RHIRenderPassDesc;
@@ -90,6 +102,28 @@ typedef enum RHIBufferMapAsyncStatus
     RHIBufferMapAsyncStatus_DestroyedBeforeCallback
 }RHIBufferMapAsyncStatus;
 
+typedef enum RHISerialCompletedStatus
+{
+    RHISerialCompletedStatus_Success,
+    RHISerialCompletedStatus_DeviceLost,
+    RHISerialCompletedStatus_DestroyedBeforeCallback
+}RHISerialCompletedStatus;
+
+typedef enum RHIReadbackStatus
+{
+    RHIReadbackStatus_Success,
+    RHIReadbackStatus_DeviceLost,
+    RHIReadbackStatus_DestroyedBeforeCallback
+}RHIReadbackStatus;
+
+typedef enum RHICreatePipelineAsyncStatus
+{
+    RHICreatePipelineAsyncStatus_Success,
+    RHICreatePipelineAsyncStatus_Error,
+    RHICreatePipelineAsyncStatus_DeviceLost,
+    RHICreatePipelineAsyncStatus_DestroyedBeforeCallback
+}RHICreatePipelineAsyncStatus;
+
 typedef enum RHIBufferUsage
 {
     RHIBufferUsage_None = 0 << 0,
@@ -340,6 +374,14 @@ typedef enum RHIBindingType
     RHIBindingType_CombinedTextureSampler
 }RHIBindingType;
 
+// Each slot type is a descriptor array of its own binding in the bind set of a resource heap.
+typedef enum RHIResourceHeapSlotType
+{
+    RHIResourceHeapSlotType_SampledTexture, // binding 0
+    RHIResourceHeapSlotType_StorageBuffer, // binding 1
+    RHIResourceHeapSlotType_Sampler // binding 2
+}RHIResourceHeapSlotType;
+
 typedef enum RHIShaderStage
 {
     RHIShaderStage_None = (0 << 0),
@@ -462,7 +504,10 @@ typedef enum RHIFeatureName
     RHIFeatureName_MultiDrawIndirect,
     RHIFeatureName_DepthBiasClamp,
     RHIFeatureName_DepthClamp,
-    RHIFeatureName_R8UnormStorage
+    RHIFeatureName_R8UnormStorage,
+    RHIFeatureName_DescriptorIndexing,
+    // Bind set layouts with dynamic offsets can't be created while it is enabled.
+    RHIFeatureName_DescriptorBuffer
 }RHIFeatureName;
 
 typedef enum RHIBackendType
@@ -503,6 +548,12 @@ typedef enum RHISurfaceAcquireNextTextureStatus
 }RHISurfaceAcquireNextTextureStatus;
 
 typedef void (*RHIBufferMapCallback)(RHIBufferMapAsyncStatus status, void* mappedAdress, void* userdata);
+typedef void (*RHISerialCompletedCallback)(RHISerialCompletedStatus status, void* userdata);
+// data is only valid during the callback, and null unless the status is success.
+typedef void (*RHIReadbackCallback)(RHIReadbackStatus status, const void* data, uint64_t size, void* userdata);
+// pipeline is null unless the status is success, the callback takes over its reference.
+typedef void (*RHICreateRenderPipelineAsyncCallback)(RHICreatePipelineAsyncStatus status, RHIRenderPipeline pipeline, void* userdata);
+typedef void (*RHICreateComputePipelineAsyncCallback)(RHICreatePipelineAsyncStatus status, RHIComputePipeline pipeline, void* userdata);
 typedef void(_stdcall* RHILoggingCallback) (RHILoggingSeverity severity, const char* msg, void* userData);
 
 typedef struct RHIStringView
@@ -567,6 +618,28 @@ typedef struct RHITextureSlice
     RHITextureAspect aspect;
 }RHITextureSlice;
 
+typedef struct RHIUploadReservation
+{
+    // Mapped staging memory the caller writes the upload to.
+    void* data;
+    uint64_t size;
+    // Identify the staging memory for the commit, not to be modified.
+    void* stagingBuffer;
+    uint64_t stagingOffset;
+    uint64_t serial;
+}RHIUploadReservation;
+
+typedef struct RHIUniformAllocation
+{
+    // Mapped memory the caller writes the uniforms to.
+    void* data;
+    // Bound once through a dynamic uniform buffer binding with a range of at most 64KiB, the allocation is then
+    // selected with its dynamic offset. Devices with the DescriptorBuffer feature enabled have no dynamic
+    // bindings, the buffer can then only be bound at dynamicOffset through a bind set of its own.
+    RHIBuffer buffer;
+    uint32_t dynamicOffset;
+}RHIUniformAllocation;
+
 typedef struct RHISpecializationConstant
 {
     uint32_t constantID;
@@ -758,6 +831,59 @@ typedef struct RHILimits
     float maxSamplerAnisotropy;
 }RHILimits;
 
+// Descriptor sets allocated for the bind sets of one layout.
+typedef struct RHIDescriptorStats
+{
+    uint64_t poolCount;
+    // Sum of maxSets over the live pools.
+    uint64_t setCapacity;
+    uint64_t liveSets;
+    // Sets that can be handed out without creating a pool, allocated from their pool or not.
+    uint64_t freeSets;
+    uint64_t poolCreations;
+    // Pools destroyed after staying fully free for a while.
+    uint64_t poolReclaims;
+}RHIDescriptorStats;
+
+// Bind sets shared through the device cache, see rhiDeviceCreateBindSet.
+typedef struct RHIBindSetCacheStats
+{
+    // Bind set creations that returned an identical live bind set.
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t cachedBindSets;
+}RHIBindSetCacheStats;
+
+// Ring buffers behind rhiQueueAllocateUniforms.
+typedef struct RHIUniformAllocatorStats
+{
+    uint64_t allocationCount;
+    uint64_t allocatedBytes;
+    uint64_t ringBufferCreations;
+    uint64_t ringBufferReleases;
+    // Ring buffers currently alive.
+    uint64_t ringBufferCount;
+}RHIUniformAllocatorStats;
+
+// Pipelines shared through the device cache, see rhiDeviceCreateRenderPipeline.
+typedef struct RHIPipelineObjectCacheStats
+{
+    // Pipeline creations that returned an identical live pipeline instead of compiling a new one.
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t cachedRenderPipelines;
+    uint64_t cachedComputePipelines;
+}RHIPipelineObjectCacheStats;
+
+// Shader modules shared through the device cache, see rhiDeviceCreateShader.
+typedef struct RHIShaderModuleCacheStats
+{
+    // Shader creations that returned a live module with the same code and entry point.
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t cachedShaderModules;
+}RHIShaderModuleCacheStats;
+
 typedef struct RHISurfaceConfiguration
 {
     RHIDevice device;
@@ -821,6 +947,8 @@ typedef struct RHIBindSetLayoutDesc
     RHIStringView name;
     uint32_t entryCount;
     RHIBindSetLayoutEntry const* entries;
+    // The bindings are pushed with PushBindings instead of being allocated as bind sets.
+    bool pushDescriptor;
 }RHIBindSetLayoutDesc;
 
 typedef struct RHIBindSetDesc
@@ -927,6 +1055,15 @@ typedef struct RHIPipelineCacheDesc
     size_t dataSize;
 }RHIPipelineCacheDesc;
 
+typedef struct RHIResourceHeapDesc
+{
+    RHIStringView name;
+    uint32_t sampledTextureCount;
+    uint32_t storageBufferCount;
+    uint32_t samplerCount;
+    RHIShaderStage visibility;
+}RHIResourceHeapDesc;
+
 typedef struct RHIRenderPipelineDesc
 {
     RHIStringView name;
@@ -953,6 +1090,9 @@ typedef struct RHIRenderPipelineDesc
     RHITextureFormat depthStencilFormat;
 
     uint32_t patchControlPoints;
+    // Cull mode, front face, primitive type within its topology class, depth test and stencil ops are taken from the
+    // render pass encoder instead of the states above.
+    bool extendedDynamicState;
 }RHIRenderPipelineDesc;
 
 typedef struct RHIComputePipelineDesc
@@ -984,6 +1124,19 @@ typedef struct RHIDeviceDesc
     RHIStringView name;
     uint32_t requiredFeatureCount = 0;
     RHIFeatureName const* requiredFeatures;
+    // Threads used to translate command lists at submit time. 0 or 1 translates on the submitting thread.
+    uint32_t commandRecordingThreadCount = 0;
+    // Hands submissions to a per-queue thread so that Submit returns without waiting for the driver.
+    bool asyncSubmission = false;
+    // Initial size of the staging ring buffers behind Queue WriteBuffer and WriteTexture, 0 selects 4 MiB. They grow and
+    // shrink from there with the upload volume.
+    uint64_t uploadRingBufferSize = 0;
+    // Threads compiling the pipelines of rhiDeviceCreate*PipelineAsync, which bounds how many compile at once. 0 selects
+    // half of the hardware threads, at most 4.
+    uint32_t pipelineCompilationThreadCount = 0;
+    // Directory the device loads its pipeline cache from and saves it to, pipelines created without a cache then use it
+    // implicitly. Empty disables the persistent cache.
+    RHIStringView pipelineCacheDirectory;
 }RHIDeviceDesc;
 
 RHIInstance rhiCreateInstance(const RHIInstanceDesc* desc);
@@ -1004,16 +1157,27 @@ RHIQueue rhiDeviceGetQueue(RHIDevice device, RHIQueueType queueType);
 RHIPipelineLayout rhiDeviceCreatePipelineLayout(RHIDevice device, const RHIPipelineLayoutDesc* desc);
 RHIPipelineLayout rhiDeviceCreatePipelineLayout2(RHIDevice device, const RHIPipelineLayoutDesc2* desc);
 RHIPipelineCache rhiDeviceCreatePipelineCache(RHIDevice device, const RHIPipelineCacheDesc* desc);
+RHIResourceHeap rhiDeviceCreateResourceHeap(RHIDevice device, const RHIResourceHeapDesc* desc);
 RHIRenderPipeline rhiDeviceCreateRenderPipeline(RHIDevice device, const RHIRenderPipelineDesc* desc);
 RHIComputePipeline rhiDeviceCreateComputePipeline(RHIDevice device, const RHIComputePipelineDesc* desc);
+// The pipeline is compiled on a worker thread and the callback runs from rhiDeviceTick once it is done. Compilations
+// still pending when the device is destroyed are cancelled.
+void rhiDeviceCreateRenderPipelineAsync(RHIDevice device, const RHIRenderPipelineDesc* desc, RHICreateRenderPipelineAsyncCallback callback, void* userData);
+void rhiDeviceCreateComputePipelineAsync(RHIDevice device, const RHIComputePipelineDesc* desc, RHICreateComputePipelineAsyncCallback callback, void* userData);
 RHIBindSetLayout rhiDeviceCreateBindSetLayout(RHIDevice device, const RHIBindSetLayoutDesc* desc);
 RHIBindSet rhiDeviceCreateBindSet(RHIDevice device, const RHIBindSetDesc* desc);
+// The bind set is only valid for commands submitted before the next rhiDeviceTick.
+RHIBindSet rhiDeviceCreateTransientBindSet(RHIDevice device, const RHIBindSetDesc* desc);
 RHITexture rhiDeviceCreateTexture(RHIDevice device, const RHITextureDesc* desc);
 RHIBuffer rhiDeviceCreateBuffer(RHIDevice device, const RHIBufferDesc* desc);
 RHIShaderModule rhiDeviceCreateShader(RHIDevice device, const RHIShaderModuleDesc* desc);
 RHISampler rhiDeviceCreateSampler(RHIDevice device, const RHISamplerDesc* desc);
 RHICommandEncoder rhiDeviceCreateCommandEncoder(RHIDevice device);
+RHIRenderBundleEncoder rhiDeviceCreateRenderBundleEncoder(RHIDevice device);
 void rhiDeviceTick(RHIDevice device);
+void rhiDeviceGetBindSetCacheStats(RHIDevice device, RHIBindSetCacheStats* stats);
+void rhiDeviceGetPipelineObjectCacheStats(RHIDevice device, RHIPipelineObjectCacheStats* stats);
+void rhiDeviceGetShaderModuleCacheStats(RHIDevice device, RHIShaderModuleCacheStats* stats);
 void rhiDeviceAddRef(RHIDevice device);
 void rhiDeviceRelease(RHIDevice device);
 // methods of Queue
@@ -1021,6 +1185,15 @@ void rhiQueueWriteBuffer(RHIQueue queue, RHIBuffer buffer, const void* data, uin
 void rhiQueueWriteTexture(RHIQueue queue, const RHITextureSlice* dstTexture, const void* data, size_t dataSize, const RHITextureDataLayout* dataLayout);
 void rhiQueueWaitFor(RHIQueue queue, RHIQueue waitQueue, uint64_t submitSerial);
 uint64_t rhiQueueSubmit(RHIQueue queue, RHICommandList const* commands, uint32_t commandListCount, RHIResourceTransfer const* transfers, uint32_t transferCount);
+bool rhiQueueWaitForSerial(RHIQueue queue, uint64_t serial, uint64_t timeoutNs);
+void rhiQueueOnSerialCompleted(RHIQueue queue, uint64_t serial, RHISerialCompletedCallback callback, void* userData);
+void rhiQueueReserveUpload(RHIQueue queue, uint64_t size, uint64_t alignment, RHIUploadReservation* reservation);
+void rhiQueueCommitUploadToBuffer(RHIQueue queue, const RHIUploadReservation* reservation, RHIBuffer buffer, uint64_t offset);
+void rhiQueueCommitUploadToTexture(RHIQueue queue, const RHIUploadReservation* reservation, const RHITextureSlice* dstTexture, const RHITextureDataLayout* dataLayout);
+void rhiQueueAllocateUniforms(RHIQueue queue, uint64_t size, RHIUniformAllocation* allocation);
+void rhiQueueGetUniformAllocatorStats(RHIQueue queue, RHIUniformAllocatorStats* stats);
+void rhiQueueReadBuffer(RHIQueue queue, RHIBuffer buffer, uint64_t offset, uint64_t size, RHIReadbackCallback callback, void* userData);
+void rhiQueueReadTexture(RHIQueue queue, const RHITextureSlice* srcTexture, RHIReadbackCallback callback, void* userData);
 void rhiQueueAddRef(RHIQueue queue);
 void rhiQueueRelease(RHIQueue queue);
 // methods of Surface
@@ -1055,8 +1228,19 @@ void rhiRenderPassEncoderSetIndexBuffer(RHIRenderPassEncoder encoder, RHIBuffer
 void rhiRenderPassEncoderSetScissorRect(RHIRenderPassEncoder encoder, uint32_t firstScissor, const RHIRect* scissors, uint32_t scissorCount);
 void rhiRenderPassEncoderSetStencilReference(RHIRenderPassEncoder encoder, uint32_t reference);
 void rhiRenderPassEncoderSetBlendConstant(RHIRenderPassEncoder encoder, const RHIColor* blendConstants);
+// Only used by pipelines created with extendedDynamicState.
+void rhiRenderPassEncoderSetCullMode(RHIRenderPassEncoder encoder, RHICullMode cullMode);
+void rhiRenderPassEncoderSetFrontFace(RHIRenderPassEncoder encoder, RHIFrontFace frontFace);
+void rhiRenderPassEncoderSetPrimitiveType(RHIRenderPassEncoder encoder, RHIPrimitiveType primitiveType);
+void rhiRenderPassEncoderSetDepthState(RHIRenderPassEncoder encoder, bool depthTestEnable, bool depthWriteEnable, RHICompareOp depthCompareOp);
+// The masks and the reference of the stencil op states are ignored.
+void rhiRenderPassEncoderSetStencilState(RHIRenderPassEncoder encoder, bool stencilTestEnable, const RHIStencilOpState* front, const RHIStencilOpState* back);
 void rhiRenderPassEncoderSetViewport(RHIRenderPassEncoder encoder, uint32_t firstViewport, RHIViewport const* viewports, uint32_t viewportCount);
 void rhiRenderPassEncoderSetBindSet(RHIRenderPassEncoder encoder, RHIBindSet set, uint32_t setIndex, uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets);
+void rhiRenderPassEncoderPushBindings(RHIRenderPassEncoder encoder, uint32_t setIndex, uint32_t entryCount, const RHIBindSetEntry* entries);
+// Declares the resources of heap slots read by the pass so that they are transitioned for it, binding the heap
+// doesn't. A null slots array declares every written slot of the type. Sampler slots are ignored.
+void rhiRenderPassEncoderUseResidentResources(RHIRenderPassEncoder encoder, RHIResourceHeap heap, RHIResourceHeapSlotType type, uint32_t slotCount, const uint32_t* slots);
 void rhiRenderPassEncoderDraw(RHIRenderPassEncoder encoder, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
 void rhiRenderPassEncoderDrawIndexed(RHIRenderPassEncoder encoder, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance);
 void rhiRenderPassEncoderDrawIndirect(RHIRenderPassEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset);
@@ -1066,14 +1250,39 @@ void rhiRenderPassEncoderMultiDrawIndexedIndirect(RHIRenderPassEncoder encoder,
 void rhiRenderPassEncoderSetPushConstant(RHIRenderPassEncoder encoder, RHIShaderStage stage, const void* data, uint32_t size, uint32_t offset);
 void rhiRenderPassEncoderBeginDebugLabel(RHIRenderPassEncoder encoder, RHIStringView label, const RHIColor* color);
 void rhiRenderPassEncoderEndDebugLabel(RHIRenderPassEncoder encoder);
+void rhiRenderPassEncoderExecuteBundles(RHIRenderPassEncoder encoder, RHIRenderBundle const* bundles, uint32_t bundleCount);
 void rhiRenderPassEncoderEnd(RHIRenderPassEncoder encoder);
 void rhiRenderPassEncoderAddRef(RHIRenderPassEncoder encoder);
 void rhiRenderPassEncoderRelease(RHIRenderPassEncoder encoder);
+// methods of RenderBundleEncoder
+void rhiRenderBundleEncoderSetPipeline(RHIRenderBundleEncoder encoder, RHIRenderPipeline pipeline);
+void rhiRenderBundleEncoderSetVertexBuffers(RHIRenderBundleEncoder encoder, uint32_t firstSlot, uint32_t bufferCount, RHIBuffer const* buffers, uint64_t* offsets);
+void rhiRenderBundleEncoderSetIndexBuffer(RHIRenderBundleEncoder encoder, RHIBuffer buffer, uint64_t offset, uint64_t size, RHIIndexFormat indexFormat);
+void rhiRenderBundleEncoderSetBindSet(RHIRenderBundleEncoder encoder, RHIBindSet set, uint32_t setIndex, uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets);
+void rhiRenderBundleEncoderPushBindings(RHIRenderBundleEncoder encoder, uint32_t setIndex, uint32_t entryCount, const RHIBindSetEntry* entries);
+void rhiRenderBundleEncoderUseResidentResources(RHIRenderBundleEncoder encoder, RHIResourceHeap heap, RHIResourceHeapSlotType type, uint32_t slotCount, const uint32_t* slots);
+void rhiRenderBundleEncoderDraw(RHIRenderBundleEncoder encoder, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+void rhiRenderBundleEncoderDrawIndexed(RHIRenderBundleEncoder encoder, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance);
+void rhiRenderBundleEncoderDrawIndirect(RHIRenderBundleEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset);
+void rhiRenderBundleEncoderDrawIndexedIndirect(RHIRenderBundleEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset);
+void rhiRenderBundleEncoderMultiDrawIndirect(RHIRenderBundleEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, RHIBuffer drawCountBuffer, uint64_t drawCountBufferOffset);
+void rhiRenderBundleEncoderMultiDrawIndexedIndirect(RHIRenderBundleEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, RHIBuffer drawCountBuffer, uint64_t drawCountBufferOffset);
+void rhiRenderBundleEncoderSetPushConstant(RHIRenderBundleEncoder encoder, RHIShaderStage stage, const void* data, uint32_t size, uint32_t offset);
+void rhiRenderBundleEncoderBeginDebugLabel(RHIRenderBundleEncoder encoder, RHIStringView label, const RHIColor* color);
+void rhiRenderBundleEncoderEndDebugLabel(RHIRenderBundleEncoder encoder);
+RHIRenderBundle rhiRenderBundleEncoderFinish(RHIRenderBundleEncoder encoder);
+void rhiRenderBundleEncoderAddRef(RHIRenderBundleEncoder encoder);
+void rhiRenderBundleEncoderRelease(RHIRenderBundleEncoder encoder);
+// methods of RenderBundle
+void rhiRenderBundleAddRef(RHIRenderBundle bundle);
+void rhiRenderBundleRelease(RHIRenderBundle bundle);
 // methods of ComputePassEncoder
 void rhiComputePassEncoderSetPipeline(RHIComputePassEncoder encoder, RHIComputePipeline pipeline);
 void rhiComputePassEncoderDispatch(RHIComputePassEncoder encoder, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
 void rhiComputePassEncoderDispatchIndirect(RHIComputePassEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset);
 void rhiComputePassEncoderSetBindSet(RHIComputePassEncoder encoder, RHIBindSet set, uint32_t setIndex, uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets);
+void rhiComputePassEncoderPushBindings(RHIComputePassEncoder encoder, uint32_t setIndex, uint32_t entryCount, const RHIBindSetEntry* entries);
+void rhiComputePassEncoderUseResidentResources(RHIComputePassEncoder encoder, RHIResourceHeap heap, RHIResourceHeapSlotType type, uint32_t slotCount, const uint32_t* slots);
 void rhiComputePassEncoderSetPushConstant(RHIComputePassEncoder encoder, RHIShaderStage stage, const void* data, uint32_t size, uint32_t offset);
 void rhiComputePassEncoderBeginDebugLabel(RHIComputePassEncoder encoder, RHIStringView label, const RHIColor* color);
 void rhiComputePassEncoderEndDebugLabel(RHIComputePassEncoder encoder);
@@ -1098,12 +1307,23 @@ void rhiPipelineCacheGetData(RHIPipelineCache pipelineCache, void* data, size_t*
 void rhiPipelineCacheAddRef(RHIPipelineCache pipelineLayout);
 void rhiPipelineCacheRelease(RHIPipelineCache pipelineLayout);
 // methods of BindSetLayout
+void rhiBindSetLayoutGetDescriptorStats(RHIBindSetLayout bindSetLayout, RHIDescriptorStats* stats);
 void rhiBindSetLayoutAddRef(RHIBindSetLayout bindSetLayout);
 void rhiBindSetLayoutRelease(RHIBindSetLayout bindSetLayout);
 // methods of BindSet
 void rhiBindSetDestroy(RHIBindSet bindSet);
 void rhiBindSetAddRef(RHIBindSet bindSet);
 void rhiBindSetRelease(RHIBindSet bindSet);
+// methods of ResourceHeap
+RHIBindSetLayout rhiResourceHeapGetBindSetLayout(RHIResourceHeap heap);
+RHIBindSet rhiResourceHeapGetBindSet(RHIResourceHeap heap);
+uint32_t rhiResourceHeapAllocateSlot(RHIResourceHeap heap, RHIResourceHeapSlotType type);
+void rhiResourceHeapFreeSlot(RHIResourceHeap heap, RHIResourceHeapSlotType type, uint32_t slot);
+void rhiResourceHeapWriteSampledTexture(RHIResourceHeap heap, uint32_t slot, RHITextureView textureView);
+void rhiResourceHeapWriteStorageBuffer(RHIResourceHeap heap, uint32_t slot, RHIBuffer buffer, uint64_t offset, uint64_t size);
+void rhiResourceHeapWriteSampler(RHIResourceHeap heap, uint32_t slot, RHISampler sampler);
+void rhiResourceHeapAddRef(RHIResourceHeap heap);
+void rhiResourceHeapRelease(RHIResourceHeap heap);
 // methods of Buffer
 RHIBufferUsage rhiBufferGetUsage(RHIBuffer buffer);
 uint64_t rhiBufferGetSize(RHIBuffer buffer);
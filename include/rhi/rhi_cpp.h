@@ -59,6 +59,34 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     static_assert(sizeof(RHIBufferMapAsyncStatus) == sizeof(BufferMapAsyncStatus), "sizeof mismatch for BufferMapAsyncStatus");
     static_assert(alignof(RHIBufferMapAsyncStatus) == alignof(BufferMapAsyncStatus), "alignof mismatch for BufferMapAsyncStatus");
 
+    enum class SerialCompletedStatus : uint32_t
+    {
+        Success = RHISerialCompletedStatus_Success,
+        DeviceLost = RHISerialCompletedStatus_DeviceLost,
+        DestroyedBeforeCallback = RHISerialCompletedStatus_DestroyedBeforeCallback,
+    };
+    static_assert(sizeof(RHISerialCompletedStatus) == sizeof(SerialCompletedStatus), "sizeof mismatch for SerialCompletedStatus");
+    static_assert(alignof(RHISerialCompletedStatus) == alignof(SerialCompletedStatus), "alignof mismatch for SerialCompletedStatus");
+
+    enum class ReadbackStatus : uint32_t
+    {
+        Success = RHIReadbackStatus_Success,
+        DeviceLost = RHIReadbackStatus_DeviceLost,
+        DestroyedBeforeCallback = RHIReadbackStatus_DestroyedBeforeCallback,
+    };
+    static_assert(sizeof(RHIReadbackStatus) == sizeof(ReadbackStatus), "sizeof mismatch for ReadbackStatus");
+    static_assert(alignof(RHIReadbackStatus) == alignof(ReadbackStatus), "alignof mismatch for ReadbackStatus");
+
+    enum class CreatePipelineAsyncStatus : uint32_t
+    {
+        Success = RHICreatePipelineAsyncStatus_Success,
+        Error = RHICreatePipelineAsyncStatus_Error,
+        DeviceLost = RHICreatePipelineAsyncStatus_DeviceLost,
+        DestroyedBeforeCallback = RHICreatePipelineAsyncStatus_DestroyedBeforeCallback,
+    };
+    static_assert(sizeof(RHICreatePipelineAsyncStatus) == sizeof(CreatePipelineAsyncStatus), "sizeof mismatch for CreatePipelineAsyncStatus");
+    static_assert(alignof(RHICreatePipelineAsyncStatus) == alignof(CreatePipelineAsyncStatus), "alignof mismatch for CreatePipelineAsyncStatus");
+
     enum class BufferUsage : uint32_t
     {
         None = RHIBufferUsage_None,
@@ -342,6 +370,15 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     static_assert(sizeof(RHIBindingType) == sizeof(BindingType), "sizeof mismatch for BindingType");
     static_assert(alignof(RHIBindingType) == alignof(BindingType), "alignof mismatch for BindingType");
 
+    enum class ResourceHeapSlotType : uint32_t
+    {
+        SampledTexture = RHIResourceHeapSlotType_SampledTexture,
+        StorageBuffer = RHIResourceHeapSlotType_StorageBuffer,
+        Sampler = RHIResourceHeapSlotType_Sampler
+    };
+    static_assert(sizeof(RHIResourceHeapSlotType) == sizeof(ResourceHeapSlotType), "sizeof mismatch for ResourceHeapSlotType");
+    static_assert(alignof(RHIResourceHeapSlotType) == alignof(ResourceHeapSlotType), "alignof mismatch for ResourceHeapSlotType");
+
     enum class ShaderStage : uint32_t
     {
         None = RHIShaderStage_None,
@@ -489,7 +526,9 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         MultiDrawIndirect = RHIFeatureName_MultiDrawIndirect,
         DepthBiasClamp = RHIFeatureName_DepthBiasClamp,
         DepthClamp = RHIFeatureName_DepthClamp,
-        R8UnormStorage = RHIFeatureName_R8UnormStorage
+        R8UnormStorage = RHIFeatureName_R8UnormStorage,
+        DescriptorIndexing = RHIFeatureName_DescriptorIndexing,
+        DescriptorBuffer = RHIFeatureName_DescriptorBuffer
     };
     static_assert(sizeof(RHIFeatureName) == sizeof(FeatureName), "sizeof mismatch for FeatureName");
     static_assert(alignof(RHIFeatureName) == alignof(FeatureName), "alignof mismatch for FeatureName");
@@ -543,6 +582,10 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
 #undef ENUM_CLASS_FLAG_OPERATORS
 
     using BufferMapCallback = RHIBufferMapCallback;
+    using SerialCompletedCallback = RHISerialCompletedCallback;
+    using ReadbackCallback = RHIReadbackCallback;
+    using CreateRenderPipelineAsyncCallback = RHICreateRenderPipelineAsyncCallback;
+    using CreateComputePipelineAsyncCallback = RHICreateComputePipelineAsyncCallback;
     using LoggingCallback = RHILoggingCallback;
 
     class Adapter;
@@ -559,8 +602,11 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     class PipelineCache;
     //class QuerySet;
     class Queue;
+    class RenderBundle;
+    class RenderBundleEncoder;
     class RenderPassEncoder;
     class RenderPipeline;
+    class ResourceHeap;
     class Sampler;
     class ShaderModule;
     class Surface;
@@ -579,6 +625,7 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     struct PipelineCacheDesc;
     struct RenderPassDesc;
     struct RenderPipelineDesc;
+    struct ResourceHeapDesc;
     struct SamplerDesc;
     struct ShaderModuleDesc;
     struct SurfaceConfiguration;
@@ -591,6 +638,8 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     struct Rect;
     struct TextureDataLayout;
     struct TextureSlice;
+    struct UploadReservation;
+    struct UniformAllocation;
     struct SpecializationConstant;
     struct BindSetLayoutEntry;
     struct BindSetEntry;
@@ -607,6 +656,11 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     struct DepthStencilAattachment;
     struct AdapterInfo;
     struct Limits;
+    struct DescriptorStats;
+    struct BindSetCacheStats;
+    struct UniformAllocatorStats;
+    struct PipelineObjectCacheStats;
+    struct ShaderModuleCacheStats;
     struct TextureSubresourceRange;
     struct TextureSubresources;
     struct ResourceTransfer;
@@ -737,6 +791,7 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     public:
         using ObjectBase::ObjectBase;
         using ObjectBase::operator=;
+        inline void GetDescriptorStats(DescriptorStats* stats) const;
     private:
         friend ObjectBase<BindSetLayout, RHIBindSetLayout>;
         static inline void AddRef(RHIBindSetLayout handle);
@@ -800,6 +855,8 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         inline void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
         inline void DispatchIndirect(Buffer& indirectBuffer, uint64_t indirectOffset);
         inline void SetBindSet(BindSet& set, uint32_t setIndex, uint32_t dynamicOffsetCount = 0, const uint32_t* dynamicOffsets = nullptr);
+        inline void PushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries);
+        inline void UseResidentResources(ResourceHeap& heap, ResourceHeapSlotType type, uint32_t slotCount = 0, const uint32_t* slots = nullptr);
         inline void End();
         inline void SetPushConstant(ShaderStage stage, const void* data, uint32_t size, uint32_t offset);
         inline void BeginDebugLabel(std::string_view label, const Color* color = nullptr);
@@ -832,16 +889,24 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         inline PipelineLayout CreatePipelineLayout(const PipelineLayoutDesc& desc);
         inline PipelineLayout CreatePipelineLayout2(const PipelineLayoutDesc2& desc);
         inline PipelineCache CreatePipelineCache(const PipelineCacheDesc& desc);
+        inline ResourceHeap CreateResourceHeap(const ResourceHeapDesc& desc);
         inline RenderPipeline CreateRenderPipeline(const RenderPipelineDesc& desc);
         inline ComputePipeline CreateComputePipeline(const ComputePipelineDesc& desc);
+        inline void CreateRenderPipelineAsync(const RenderPipelineDesc& desc, CreateRenderPipelineAsyncCallback callback, void* userData);
+        inline void CreateComputePipelineAsync(const ComputePipelineDesc& desc, CreateComputePipelineAsyncCallback callback, void* userData);
         inline BindSetLayout CreateBindSetLayout(const BindSetLayoutDesc& desc);
         inline BindSet CreateBindSet(const BindSetDesc& desc);
+        inline BindSet CreateTransientBindSet(const BindSetDesc& desc);
         inline Texture CreateTexture(const TextureDesc& desc);
         inline Buffer CreateBuffer(const BufferDesc& desc);
         inline ShaderModule CreateShader(const ShaderModuleDesc& desc);
         inline Sampler CreateSampler(const SamplerDesc& desc);
         inline CommandEncoder CreateCommandEncoder();
+        inline RenderBundleEncoder CreateRenderBundleEncoder();
         inline void Tick();
+        inline void GetBindSetCacheStats(BindSetCacheStats* stats) const;
+        inline void GetPipelineObjectCacheStats(PipelineObjectCacheStats* stats) const;
+        inline void GetShaderModuleCacheStats(ShaderModuleCacheStats* stats) const;
     private:
         friend ObjectBase<Device, RHIDevice>;
         static inline void AddRef(RHIDevice handle);
@@ -887,6 +952,24 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         static inline void Release(RHIPipelineCache handle);
     };
 
+    class ResourceHeap : public ObjectBase<ResourceHeap, RHIResourceHeap>
+    {
+    public:
+        using ObjectBase::ObjectBase;
+        using ObjectBase::operator=;
+        inline BindSetLayout GetBindSetLayout() const;
+        inline BindSet GetBindSet() const;
+        inline uint32_t AllocateSlot(ResourceHeapSlotType type);
+        inline void FreeSlot(ResourceHeapSlotType type, uint32_t slot);
+        inline void WriteSampledTexture(uint32_t slot, TextureView& textureView);
+        inline void WriteStorageBuffer(uint32_t slot, Buffer& buffer, uint64_t offset = 0, uint64_t size = WHOLE_SIZE);
+        inline void WriteSampler(uint32_t slot, Sampler& sampler);
+    private:
+        friend ObjectBase<ResourceHeap, RHIResourceHeap>;
+        static inline void AddRef(RHIResourceHeap handle);
+        static inline void Release(RHIResourceHeap handle);
+    };
+
     class Queue : public ObjectBase<Queue, RHIQueue>
     {
     public:
@@ -896,6 +979,18 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         inline void WriteTexture(const TextureSlice& dstTexture, const void* data, size_t dataSize, const TextureDataLayout& dataLayout);
         inline void WaitFor(Queue queue, uint64_t submitSerial);
         inline uint64_t Submit(CommandList const* commands, uint32_t commandListCount, ResourceTransfer const* transfers = nullptr, uint32_t transferCount = 0);
+        inline bool WaitForSerial(uint64_t serial, uint64_t timeoutNs = UINT64_MAX);
+        inline void OnSerialCompleted(uint64_t serial, SerialCompletedCallback callback, void* userData);
+        // Staging memory the caller fills directly, handed to one of the commit calls once written.
+        inline void ReserveUpload(uint64_t size, uint64_t alignment, UploadReservation* reservation);
+        inline void CommitUploadToBuffer(const UploadReservation& reservation, Buffer& buffer, uint64_t offset);
+        inline void CommitUploadToTexture(const UploadReservation& reservation, const TextureSlice& dstTexture, const TextureDataLayout& dataLayout);
+        inline void AllocateUniforms(uint64_t size, UniformAllocation* allocation);
+        inline void GetUniformAllocatorStats(UniformAllocatorStats* stats) const;
+        // The copy executes with the next submit. Readbacks of the same submit complete together, rows of a texture
+        // are tightly packed.
+        inline void ReadBuffer(Buffer& buffer, uint64_t offset, uint64_t size, ReadbackCallback callback, void* userData);
+        inline void ReadTexture(const TextureSlice& srcTexture, ReadbackCallback callback, void* userData);
     private:
         friend ObjectBase<Queue, RHIQueue>;
         static inline void AddRef(RHIQueue handle);
@@ -913,6 +1008,11 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         inline void SetScissorRect(uint32_t firstScissor, const Rect* scissors, uint32_t scissorCount);
         inline void SetStencilReference(uint32_t reference);
         inline void SetBlendConstant(const Color& blendConstants);
+        inline void SetCullMode(CullMode cullMode);
+        inline void SetFrontFace(FrontFace frontFace);
+        inline void SetPrimitiveType(PrimitiveType primitiveType);
+        inline void SetDepthState(bool depthTestEnable, bool depthWriteEnable, CompareOp depthCompareOp);
+        inline void SetStencilState(bool stencilTestEnable, const StencilOpState& front, const StencilOpState& back);
         inline void SetViewport(uint32_t firstViewport, Viewport const* viewports, uint32_t viewportCount);
         inline void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
         inline void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t baseVertex = 0, uint32_t firstInstance = 0);
@@ -921,6 +1021,9 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         inline void MultiDrawIndirect(Buffer& indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, Buffer drawCountBuffer = nullptr, uint64_t drawCountBufferOffset = 0);
         inline void MultiDrawIndexedIndirect(Buffer& indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, Buffer drawCountBuffer = nullptr, uint64_t drawCountBufferOffset = 0);
         inline void SetBindSet(BindSet& set, uint32_t setIndex, uint32_t dynamicOffsetCount = 0, const uint32_t* dynamicOffsets = nullptr);
+        inline void PushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries);
+        inline void UseResidentResources(ResourceHeap& heap, ResourceHeapSlotType type, uint32_t slotCount = 0, const uint32_t* slots = nullptr);
+        inline void ExecuteBundles(RenderBundle const* bundles, uint32_t bundleCount);
         inline void End();
         inline void SetPushConstant(ShaderStage stage, const void* data, uint32_t size, uint32_t offset);
         inline void BeginDebugLabel(std::string_view label, const Color* color = nullptr);
@@ -931,6 +1034,44 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         static inline void Release(RHIRenderPassEncoder handle);
     };
 
+    class RenderBundleEncoder : public ObjectBase<RenderBundleEncoder, RHIRenderBundleEncoder>
+    {
+    public:
+        using ObjectBase::ObjectBase;
+        using ObjectBase::operator=;
+        inline void SetPipeline(RenderPipeline& pipeline);
+        inline void SetVertexBuffers(uint32_t firstSlot, uint32_t bufferCount, Buffer const* buffers, uint64_t* offsets = nullptr);
+        inline void SetIndexBuffer(Buffer& buffer, IndexFormat indexFormat, uint64_t offset = 0, uint64_t size = WHOLE_SIZE);
+        inline void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+        inline void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t baseVertex = 0, uint32_t firstInstance = 0);
+        inline void DrawIndirect(Buffer& indirectBuffer, uint64_t indirectOffset);
+        inline void DrawIndexedIndirect(Buffer& indirectBuffer, uint64_t indirectOffset);
+        inline void MultiDrawIndirect(Buffer& indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, Buffer drawCountBuffer = nullptr, uint64_t drawCountBufferOffset = 0);
+        inline void MultiDrawIndexedIndirect(Buffer& indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, Buffer drawCountBuffer = nullptr, uint64_t drawCountBufferOffset = 0);
+        inline void SetBindSet(BindSet& set, uint32_t setIndex, uint32_t dynamicOffsetCount = 0, const uint32_t* dynamicOffsets = nullptr);
+        inline void PushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries);
+        inline void UseResidentResources(ResourceHeap& heap, ResourceHeapSlotType type, uint32_t slotCount = 0, const uint32_t* slots = nullptr);
+        inline void SetPushConstant(ShaderStage stage, const void* data, uint32_t size, uint32_t offset);
+        inline void BeginDebugLabel(std::string_view label, const Color* color = nullptr);
+        inline void EndDebugLabel();
+        inline RenderBundle Finish();
+    private:
+        friend ObjectBase<RenderBundleEncoder, RHIRenderBundleEncoder>;
+        static inline void AddRef(RHIRenderBundleEncoder handle);
+        static inline void Release(RHIRenderBundleEncoder handle);
+    };
+
+    class RenderBundle : public ObjectBase<RenderBundle, RHIRenderBundle>
+    {
+    public:
+        using ObjectBase::ObjectBase;
+        using ObjectBase::operator=;
+    private:
+        friend ObjectBase<RenderBundle, RHIRenderBundle>;
+        static inline void AddRef(RHIRenderBundle handle);
+        static inline void Release(RHIRenderBundle handle);
+    };
+
     class RenderPipeline : public ObjectBase<RenderPipeline, RHIRenderPipeline>
     {
     public:
@@ -1062,6 +1203,10 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         }
     }
     // BindSetLayout implementations
+    void BindSetLayout::GetDescriptorStats(DescriptorStats* stats) const
+    {
+        rhiBindSetLayoutGetDescriptorStats(Get(), reinterpret_cast<RHIDescriptorStats*>(stats));
+    }
     void BindSetLayout::AddRef(RHIBindSetLayout handle)
     {
         if (handle != nullptr)
@@ -1202,6 +1347,14 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     {
         rhiComputePassEncoderSetBindSet(Get(), set.Get(), setIndex, dynamicOffsetCount, dynamicOffsets);
     }
+    void ComputePassEncoder::PushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries)
+    {
+        rhiComputePassEncoderPushBindings(Get(), setIndex, entryCount, reinterpret_cast<const RHIBindSetEntry*>(entries));
+    }
+    void ComputePassEncoder::UseResidentResources(ResourceHeap& heap, ResourceHeapSlotType type, uint32_t slotCount, const uint32_t* slots)
+    {
+        rhiComputePassEncoderUseResidentResources(Get(), heap.Get(), static_cast<RHIResourceHeapSlotType>(type), slotCount, slots);
+    }
     void ComputePassEncoder::End()
     {
         rhiComputePassEncoderEnd(Get());
@@ -1274,6 +1427,11 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         RHIPipelineCache result = rhiDeviceCreatePipelineCache(Get(), reinterpret_cast<const RHIPipelineCacheDesc*>(&desc));
         return PipelineCache::Acquire(result);
     }
+    ResourceHeap Device::CreateResourceHeap(const ResourceHeapDesc& desc)
+    {
+        RHIResourceHeap result = rhiDeviceCreateResourceHeap(Get(), reinterpret_cast<const RHIResourceHeapDesc*>(&desc));
+        return ResourceHeap::Acquire(result);
+    }
     RenderPipeline Device::CreateRenderPipeline(const RenderPipelineDesc& desc)
     {
         RHIRenderPipeline result = rhiDeviceCreateRenderPipeline(Get(), reinterpret_cast<const RHIRenderPipelineDesc*>(&desc));
@@ -1284,6 +1442,14 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         RHIComputePipeline result = rhiDeviceCreateComputePipeline(Get(), reinterpret_cast<const RHIComputePipelineDesc*>(&desc));
         return ComputePipeline::Acquire(result);
     }
+    void Device::CreateRenderPipelineAsync(const RenderPipelineDesc& desc, CreateRenderPipelineAsyncCallback callback, void* userData)
+    {
+        rhiDeviceCreateRenderPipelineAsync(Get(), reinterpret_cast<const RHIRenderPipelineDesc*>(&desc), callback, userData);
+    }
+    void Device::CreateComputePipelineAsync(const ComputePipelineDesc& desc, CreateComputePipelineAsyncCallback callback, void* userData)
+    {
+        rhiDeviceCreateComputePipelineAsync(Get(), reinterpret_cast<const RHIComputePipelineDesc*>(&desc), callback, userData);
+    }
     BindSetLayout Device::CreateBindSetLayout(const BindSetLayoutDesc& desc)
     {
         RHIBindSetLayout result = rhiDeviceCreateBindSetLayout(Get(), reinterpret_cast<const RHIBindSetLayoutDesc*>(&desc));
@@ -1294,6 +1460,11 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         RHIBindSet result = rhiDeviceCreateBindSet(Get(), reinterpret_cast<const RHIBindSetDesc*>(&desc));
         return BindSet::Acquire(result);
     }
+    BindSet Device::CreateTransientBindSet(const BindSetDesc& desc)
+    {
+        RHIBindSet result = rhiDeviceCreateTransientBindSet(Get(), reinterpret_cast<const RHIBindSetDesc*>(&desc));
+        return BindSet::Acquire(result);
+    }
     Texture Device::CreateTexture(const TextureDesc& desc)
     {
         RHITexture result = rhiDeviceCreateTexture(Get(), reinterpret_cast<const RHITextureDesc*>(&desc));
@@ -1319,10 +1490,27 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         RHICommandEncoder result = rhiDeviceCreateCommandEncoder(Get());
         return CommandEncoder::Acquire(result);
     }
+    RenderBundleEncoder Device::CreateRenderBundleEncoder()
+    {
+        RHIRenderBundleEncoder result = rhiDeviceCreateRenderBundleEncoder(Get());
+        return RenderBundleEncoder::Acquire(result);
+    }
     void Device::Tick()
     {
         rhiDeviceTick(Get());
     }
+    void Device::GetBindSetCacheStats(BindSetCacheStats* stats) const
+    {
+        rhiDeviceGetBindSetCacheStats(Get(), reinterpret_cast<RHIBindSetCacheStats*>(stats));
+    }
+    void Device::GetPipelineObjectCacheStats(PipelineObjectCacheStats* stats) const
+    {
+        rhiDeviceGetPipelineObjectCacheStats(Get(), reinterpret_cast<RHIPipelineObjectCacheStats*>(stats));
+    }
+    void Device::GetShaderModuleCacheStats(ShaderModuleCacheStats* stats) const
+    {
+        rhiDeviceGetShaderModuleCacheStats(Get(), reinterpret_cast<RHIShaderModuleCacheStats*>(stats));
+    }
     void Device::AddRef(RHIDevice handle)
     {
         if (handle != nullptr)
@@ -1416,6 +1604,51 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
             rhiPipelineCacheRelease(handle);
         }
     }
+    // ResourceHeap implementations
+    BindSetLayout ResourceHeap::GetBindSetLayout() const
+    {
+        RHIBindSetLayout result = rhiResourceHeapGetBindSetLayout(Get());
+        return BindSetLayout::Acquire(result);
+    }
+    BindSet ResourceHeap::GetBindSet() const
+    {
+        RHIBindSet result = rhiResourceHeapGetBindSet(Get());
+        return BindSet::Acquire(result);
+    }
+    uint32_t ResourceHeap::AllocateSlot(ResourceHeapSlotType type)
+    {
+        return rhiResourceHeapAllocateSlot(Get(), static_cast<RHIResourceHeapSlotType>(type));
+    }
+    void ResourceHeap::FreeSlot(ResourceHeapSlotType type, uint32_t slot)
+    {
+        rhiResourceHeapFreeSlot(Get(), static_cast<RHIResourceHeapSlotType>(type), slot);
+    }
+    void ResourceHeap::WriteSampledTexture(uint32_t slot, TextureView& textureView)
+    {
+        rhiResourceHeapWriteSampledTexture(Get(), slot, textureView.Get());
+    }
+    void ResourceHeap::WriteStorageBuffer(uint32_t slot, Buffer& buffer, uint64_t offset, uint64_t size)
+    {
+        rhiResourceHeapWriteStorageBuffer(Get(), slot, buffer.Get(), offset, size);
+    }
+    void ResourceHeap::WriteSampler(uint32_t slot, Sampler& sampler)
+    {
+        rhiResourceHeapWriteSampler(Get(), slot, sampler.Get());
+    }
+    void ResourceHeap::AddRef(RHIResourceHeap handle)
+    {
+        if (handle != nullptr)
+        {
+            rhiResourceHeapAddRef(handle);
+        }
+    }
+    void ResourceHeap::Release(RHIResourceHeap handle)
+    {
+        if (handle != nullptr)
+        {
+            rhiResourceHeapRelease(handle);
+        }
+    }
     // Queue implementations
     void Queue::WriteBuffer(Buffer& buffer, const void* data, uint64_t dataSize, uint64_t offset)
     {
@@ -1433,6 +1666,42 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     {
         return rhiQueueSubmit(Get(), reinterpret_cast<RHICommandList const*>(commands), commandListCount, reinterpret_cast<RHIResourceTransfer const*>(transfers), transferCount);
     }
+    bool Queue::WaitForSerial(uint64_t serial, uint64_t timeoutNs)
+    {
+        return rhiQueueWaitForSerial(Get(), serial, timeoutNs);
+    }
+    void Queue::OnSerialCompleted(uint64_t serial, SerialCompletedCallback callback, void* userData)
+    {
+        rhiQueueOnSerialCompleted(Get(), serial, callback, userData);
+    }
+    void Queue::ReserveUpload(uint64_t size, uint64_t alignment, UploadReservation* reservation)
+    {
+        rhiQueueReserveUpload(Get(), size, alignment, reinterpret_cast<RHIUploadReservation*>(reservation));
+    }
+    void Queue::CommitUploadToBuffer(const UploadReservation& reservation, Buffer& buffer, uint64_t offset)
+    {
+        rhiQueueCommitUploadToBuffer(Get(), reinterpret_cast<const RHIUploadReservation*>(&reservation), buffer.Get(), offset);
+    }
+    void Queue::CommitUploadToTexture(const UploadReservation& reservation, const TextureSlice& dstTexture, const TextureDataLayout& dataLayout)
+    {
+        rhiQueueCommitUploadToTexture(Get(), reinterpret_cast<const RHIUploadReservation*>(&reservation), reinterpret_cast<const RHITextureSlice*>(&dstTexture), reinterpret_cast<const RHITextureDataLayout*>(&dataLayout));
+    }
+    void Queue::AllocateUniforms(uint64_t size, UniformAllocation* allocation)
+    {
+        rhiQueueAllocateUniforms(Get(), size, reinterpret_cast<RHIUniformAllocation*>(allocation));
+    }
+    void Queue::GetUniformAllocatorStats(UniformAllocatorStats* stats) const
+    {
+        rhiQueueGetUniformAllocatorStats(Get(), reinterpret_cast<RHIUniformAllocatorStats*>(stats));
+    }
+    void Queue::ReadBuffer(Buffer& buffer, uint64_t offset, uint64_t size, ReadbackCallback callback, void* userData)
+    {
+        rhiQueueReadBuffer(Get(), buffer.Get(), offset, size, callback, userData);
+    }
+    void Queue::ReadTexture(const TextureSlice& srcTexture, ReadbackCallback callback, void* userData)
+    {
+        rhiQueueReadTexture(Get(), reinterpret_cast<const RHITextureSlice*>(&srcTexture), callback, userData);
+    }
     void Queue::AddRef(RHIQueue handle)
     {
         if (handle != nullptr)
@@ -1472,6 +1741,29 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     {
         rhiRenderPassEncoderSetBlendConstant(Get(), reinterpret_cast<const RHIColor*>(&blendConstants));
     }
+    void RenderPassEncoder::SetCullMode(CullMode cullMode)
+    {
+        rhiRenderPassEncoderSetCullMode(Get(), static_cast<RHICullMode>(cullMode));
+    }
+    void RenderPassEncoder::SetFrontFace(FrontFace frontFace)
+    {
+        rhiRenderPassEncoderSetFrontFace(Get(), static_cast<RHIFrontFace>(frontFace));
+    }
+    void RenderPassEncoder::SetPrimitiveType(PrimitiveType primitiveType)
+    {
+        rhiRenderPassEncoderSetPrimitiveType(Get(), static_cast<RHIPrimitiveType>(primitiveType));
+    }
+    void RenderPassEncoder::SetDepthState(bool depthTestEnable, bool depthWriteEnable, CompareOp depthCompareOp)
+    {
+        rhiRenderPassEncoderSetDepthState(Get(), depthTestEnable, depthWriteEnable, static_cast<RHICompareOp>(depthCompareOp));
+    }
+    void RenderPassEncoder::SetStencilState(bool stencilTestEnable, const StencilOpState& front, const StencilOpState& back)
+    {
+        rhiRenderPassEncoderSetStencilState(Get(),
+                                            stencilTestEnable,
+                                            reinterpret_cast<const RHIStencilOpState*>(&front),
+                                            reinterpret_cast<const RHIStencilOpState*>(&back));
+    }
     void RenderPassEncoder::SetViewport(uint32_t firstViewport, Viewport const* viewports, uint32_t viewportCount)
     {
         rhiRenderPassEncoderSetViewport(Get(), firstViewport, reinterpret_cast<RHIViewport const*>(viewports), viewportCount);
@@ -1504,6 +1796,18 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     {
         rhiRenderPassEncoderSetBindSet(Get(), set.Get(), setIndex, dynamicOffsetCount, dynamicOffsets);
     }
+    void RenderPassEncoder::PushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries)
+    {
+        rhiRenderPassEncoderPushBindings(Get(), setIndex, entryCount, reinterpret_cast<const RHIBindSetEntry*>(entries));
+    }
+    void RenderPassEncoder::UseResidentResources(ResourceHeap& heap, ResourceHeapSlotType type, uint32_t slotCount, const uint32_t* slots)
+    {
+        rhiRenderPassEncoderUseResidentResources(Get(), heap.Get(), static_cast<RHIResourceHeapSlotType>(type), slotCount, slots);
+    }
+    void RenderPassEncoder::ExecuteBundles(RenderBundle const* bundles, uint32_t bundleCount)
+    {
+        rhiRenderPassEncoderExecuteBundles(Get(), reinterpret_cast<RHIRenderBundle const*>(bundles), bundleCount);
+    }
     void RenderPassEncoder::End()
     {
         rhiRenderPassEncoderEnd(Get());
@@ -1534,6 +1838,101 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
             rhiRenderPassEncoderRelease(handle);
         }
     }
+    // RenderBundleEncoder implementations
+    void RenderBundleEncoder::SetPipeline(RenderPipeline& pipeline)
+    {
+        rhiRenderBundleEncoderSetPipeline(Get(), pipeline.Get());
+    }
+    void RenderBundleEncoder::SetVertexBuffers(uint32_t firstSlot, uint32_t bufferCount, Buffer const* buffers, uint64_t* offsets)
+    {
+        rhiRenderBundleEncoderSetVertexBuffers(Get(), firstSlot, bufferCount, reinterpret_cast<RHIBuffer const*>(buffers), offsets);
+    }
+    void RenderBundleEncoder::SetIndexBuffer(Buffer& buffer, IndexFormat indexFormat, uint64_t offset, uint64_t size)
+    {
+        rhiRenderBundleEncoderSetIndexBuffer(Get(), buffer.Get(), offset, size, static_cast<RHIIndexFormat>(indexFormat));
+    }
+    void RenderBundleEncoder::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+    {
+        rhiRenderBundleEncoderDraw(Get(), vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+    void RenderBundleEncoder::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance)
+    {
+        rhiRenderBundleEncoderDrawIndexed(Get(), indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+    }
+    void RenderBundleEncoder::DrawIndirect(Buffer& indirectBuffer, uint64_t indirectOffset)
+    {
+        rhiRenderBundleEncoderDrawIndirect(Get(), indirectBuffer.Get(), indirectOffset);
+    }
+    void RenderBundleEncoder::DrawIndexedIndirect(Buffer& indirectBuffer, uint64_t indirectOffset)
+    {
+        rhiRenderBundleEncoderDrawIndexedIndirect(Get(), indirectBuffer.Get(), indirectOffset);
+    }
+    void RenderBundleEncoder::MultiDrawIndirect(Buffer& indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, Buffer drawCountBuffer, uint64_t drawCountBufferOffset)
+    {
+        rhiRenderBundleEncoderMultiDrawIndirect(Get(), indirectBuffer.Get(), indirectOffset, maxDrawCount, drawCountBuffer.Get(), drawCountBufferOffset);
+    }
+    void RenderBundleEncoder::MultiDrawIndexedIndirect(Buffer& indirectBuffer, uint64_t indirectOffset, uint32_t maxDrawCount, Buffer drawCountBuffer, uint64_t drawCountBufferOffset)
+    {
+        rhiRenderBundleEncoderMultiDrawIndexedIndirect(Get(), indirectBuffer.Get(), indirectOffset, maxDrawCount, drawCountBuffer.Get(), drawCountBufferOffset);
+    }
+    void RenderBundleEncoder::SetBindSet(BindSet& set, uint32_t setIndex, uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets)
+    {
+        rhiRenderBundleEncoderSetBindSet(Get(), set.Get(), setIndex, dynamicOffsetCount, dynamicOffsets);
+    }
+    void RenderBundleEncoder::PushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries)
+    {
+        rhiRenderBundleEncoderPushBindings(Get(), setIndex, entryCount, reinterpret_cast<const RHIBindSetEntry*>(entries));
+    }
+    void RenderBundleEncoder::UseResidentResources(ResourceHeap& heap, ResourceHeapSlotType type, uint32_t slotCount, const uint32_t* slots)
+    {
+        rhiRenderBundleEncoderUseResidentResources(Get(), heap.Get(), static_cast<RHIResourceHeapSlotType>(type), slotCount, slots);
+    }
+    void RenderBundleEncoder::SetPushConstant(ShaderStage stage, const void* data, uint32_t size, uint32_t offset)
+    {
+        rhiRenderBundleEncoderSetPushConstant(Get(), static_cast<RHIShaderStage>(stage), data, size, offset);
+    }
+    void RenderBundleEncoder::BeginDebugLabel(std::string_view label, const Color* color)
+    {
+        rhiRenderBundleEncoderBeginDebugLabel(Get(), { label.data(), label.size() }, reinterpret_cast<const RHIColor*>(color));
+    }
+    void RenderBundleEncoder::EndDebugLabel()
+    {
+        rhiRenderBundleEncoderEndDebugLabel(Get());
+    }
+    RenderBundle RenderBundleEncoder::Finish()
+    {
+        RHIRenderBundle result = rhiRenderBundleEncoderFinish(Get());
+        return RenderBundle::Acquire(result);
+    }
+    void RenderBundleEncoder::AddRef(RHIRenderBundleEncoder handle)
+    {
+        if (handle != nullptr)
+        {
+            rhiRenderBundleEncoderAddRef(handle);
+        }
+    }
+    void RenderBundleEncoder::Release(RHIRenderBundleEncoder handle)
+    {
+        if (handle != nullptr)
+        {
+            rhiRenderBundleEncoderRelease(handle);
+        }
+    }
+    // RenderBundle implementations
+    void RenderBundle::AddRef(RHIRenderBundle handle)
+    {
+        if (handle != nullptr)
+        {
+            rhiRenderBundleAddRef(handle);
+        }
+    }
+    void RenderBundle::Release(RHIRenderBundle handle)
+    {
+        if (handle != nullptr)
+        {
+            rhiRenderBundleRelease(handle);
+        }
+    }
     // RenderPipeline implementations
     void RenderPipeline::AddRef(RHIRenderPipeline handle)
     {
@@ -1828,6 +2227,40 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     static_assert(offsetof(TextureSlice, mipLevel) == offsetof(RHITextureSlice, mipLevel));
     static_assert(offsetof(TextureSlice, aspect) == offsetof(RHITextureSlice, aspect));
 
+    struct UploadReservation
+    {
+        // Mapped staging memory the caller writes the upload to.
+        void* data = nullptr;
+        uint64_t size = 0;
+        // Identify the staging memory for the commit, not to be modified.
+        void* stagingBuffer = nullptr;
+        uint64_t stagingOffset = 0;
+        uint64_t serial = 0;
+    };
+    static_assert(sizeof(UploadReservation) == sizeof(RHIUploadReservation), "sizeof mismatch for UploadReservation");
+    static_assert(alignof(UploadReservation) == alignof(RHIUploadReservation), "alignof mismatch for UploadReservation");
+    static_assert(offsetof(UploadReservation, data) == offsetof(RHIUploadReservation, data));
+    static_assert(offsetof(UploadReservation, size) == offsetof(RHIUploadReservation, size));
+    static_assert(offsetof(UploadReservation, stagingBuffer) == offsetof(RHIUploadReservation, stagingBuffer));
+    static_assert(offsetof(UploadReservation, stagingOffset) == offsetof(RHIUploadReservation, stagingOffset));
+    static_assert(offsetof(UploadReservation, serial) == offsetof(RHIUploadReservation, serial));
+
+    struct UniformAllocation
+    {
+        // Mapped memory the caller writes the uniforms to.
+        void* data = nullptr;
+        // Bound once through a dynamic uniform buffer binding with a range of at most 64KiB, the allocation is then
+        // selected with its dynamic offset. Devices with the DescriptorBuffer feature enabled have no dynamic
+        // bindings, the buffer can then only be bound at dynamicOffset through a bind set of its own.
+        Buffer buffer = nullptr;
+        uint32_t dynamicOffset = 0;
+    };
+    static_assert(sizeof(UniformAllocation) == sizeof(RHIUniformAllocation), "sizeof mismatch for UniformAllocation");
+    static_assert(alignof(UniformAllocation) == alignof(RHIUniformAllocation), "alignof mismatch for UniformAllocation");
+    static_assert(offsetof(UniformAllocation, data) == offsetof(RHIUniformAllocation, data));
+    static_assert(offsetof(UniformAllocation, buffer) == offsetof(RHIUniformAllocation, buffer));
+    static_assert(offsetof(UniformAllocation, dynamicOffset) == offsetof(RHIUniformAllocation, dynamicOffset));
+
     struct SpecializationConstant
     {
         uint32_t constantID = 0;
@@ -2237,6 +2670,90 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         float maxSamplerLodBias;
         float maxSamplerAnisotropy;
     };
+
+    // Descriptor sets allocated for the bind sets of one layout.
+    struct DescriptorStats
+    {
+        uint64_t poolCount;
+        // Sum of maxSets over the live pools.
+        uint64_t setCapacity;
+        uint64_t liveSets;
+        // Sets that can be handed out without creating a pool, allocated from their pool or not.
+        uint64_t freeSets;
+        uint64_t poolCreations;
+        // Pools destroyed after staying fully free for a while.
+        uint64_t poolReclaims;
+    };
+    static_assert(sizeof(DescriptorStats) == sizeof(RHIDescriptorStats), "sizeof mismatch for DescriptorStats");
+    static_assert(alignof(DescriptorStats) == alignof(RHIDescriptorStats), "alignof mismatch for DescriptorStats");
+    static_assert(offsetof(DescriptorStats, poolCount) == offsetof(RHIDescriptorStats, poolCount));
+    static_assert(offsetof(DescriptorStats, setCapacity) == offsetof(RHIDescriptorStats, setCapacity));
+    static_assert(offsetof(DescriptorStats, liveSets) == offsetof(RHIDescriptorStats, liveSets));
+    static_assert(offsetof(DescriptorStats, freeSets) == offsetof(RHIDescriptorStats, freeSets));
+    static_assert(offsetof(DescriptorStats, poolCreations) == offsetof(RHIDescriptorStats, poolCreations));
+    static_assert(offsetof(DescriptorStats, poolReclaims) == offsetof(RHIDescriptorStats, poolReclaims));
+
+    // Bind sets shared through the device cache, see rhiDeviceCreateBindSet.
+    struct BindSetCacheStats
+    {
+        // Bind set creations that returned an identical live bind set.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t cachedBindSets;
+    };
+    static_assert(sizeof(BindSetCacheStats) == sizeof(RHIBindSetCacheStats), "sizeof mismatch for BindSetCacheStats");
+    static_assert(alignof(BindSetCacheStats) == alignof(RHIBindSetCacheStats), "alignof mismatch for BindSetCacheStats");
+    static_assert(offsetof(BindSetCacheStats, hits) == offsetof(RHIBindSetCacheStats, hits));
+    static_assert(offsetof(BindSetCacheStats, misses) == offsetof(RHIBindSetCacheStats, misses));
+    static_assert(offsetof(BindSetCacheStats, cachedBindSets) == offsetof(RHIBindSetCacheStats, cachedBindSets));
+
+    // Ring buffers behind rhiQueueAllocateUniforms.
+    struct UniformAllocatorStats
+    {
+        uint64_t allocationCount;
+        uint64_t allocatedBytes;
+        uint64_t ringBufferCreations;
+        uint64_t ringBufferReleases;
+        // Ring buffers currently alive.
+        uint64_t ringBufferCount;
+    };
+    static_assert(sizeof(UniformAllocatorStats) == sizeof(RHIUniformAllocatorStats), "sizeof mismatch for UniformAllocatorStats");
+    static_assert(alignof(UniformAllocatorStats) == alignof(RHIUniformAllocatorStats), "alignof mismatch for UniformAllocatorStats");
+    static_assert(offsetof(UniformAllocatorStats, allocationCount) == offsetof(RHIUniformAllocatorStats, allocationCount));
+    static_assert(offsetof(UniformAllocatorStats, allocatedBytes) == offsetof(RHIUniformAllocatorStats, allocatedBytes));
+    static_assert(offsetof(UniformAllocatorStats, ringBufferCreations) == offsetof(RHIUniformAllocatorStats, ringBufferCreations));
+    static_assert(offsetof(UniformAllocatorStats, ringBufferReleases) == offsetof(RHIUniformAllocatorStats, ringBufferReleases));
+    static_assert(offsetof(UniformAllocatorStats, ringBufferCount) == offsetof(RHIUniformAllocatorStats, ringBufferCount));
+
+    // Pipelines shared through the device cache, see rhiDeviceCreateRenderPipeline.
+    struct PipelineObjectCacheStats
+    {
+        // Pipeline creations that returned an identical live pipeline instead of compiling a new one.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t cachedRenderPipelines;
+        uint64_t cachedComputePipelines;
+    };
+    static_assert(sizeof(PipelineObjectCacheStats) == sizeof(RHIPipelineObjectCacheStats), "sizeof mismatch for PipelineObjectCacheStats");
+    static_assert(alignof(PipelineObjectCacheStats) == alignof(RHIPipelineObjectCacheStats), "alignof mismatch for PipelineObjectCacheStats");
+    static_assert(offsetof(PipelineObjectCacheStats, hits) == offsetof(RHIPipelineObjectCacheStats, hits));
+    static_assert(offsetof(PipelineObjectCacheStats, misses) == offsetof(RHIPipelineObjectCacheStats, misses));
+    static_assert(offsetof(PipelineObjectCacheStats, cachedRenderPipelines) == offsetof(RHIPipelineObjectCacheStats, cachedRenderPipelines));
+    static_assert(offsetof(PipelineObjectCacheStats, cachedComputePipelines) == offsetof(RHIPipelineObjectCacheStats, cachedComputePipelines));
+
+    // Shader modules shared through the device cache, see rhiDeviceCreateShader.
+    struct ShaderModuleCacheStats
+    {
+        // Shader creations that returned a live module with the same code and entry point.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t cachedShaderModules;
+    };
+    static_assert(sizeof(ShaderModuleCacheStats) == sizeof(RHIShaderModuleCacheStats), "sizeof mismatch for ShaderModuleCacheStats");
+    static_assert(alignof(ShaderModuleCacheStats) == alignof(RHIShaderModuleCacheStats), "alignof mismatch for ShaderModuleCacheStats");
+    static_assert(offsetof(ShaderModuleCacheStats, hits) == offsetof(RHIShaderModuleCacheStats, hits));
+    static_assert(offsetof(ShaderModuleCacheStats, misses) == offsetof(RHIShaderModuleCacheStats, misses));
+    static_assert(offsetof(ShaderModuleCacheStats, cachedShaderModules) == offsetof(RHIShaderModuleCacheStats, cachedShaderModules));
     // todo: 
 
     struct SurfaceConfiguration
@@ -2303,12 +2820,14 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         std::string_view name;
         uint32_t entryCount;
         BindSetLayoutEntry const* entries;
+        bool pushDescriptor = false;
     };
     static_assert(sizeof(BindSetLayoutDesc) == sizeof(RHIBindSetLayoutDesc), "sizeof mismatch for BindSetLayoutDesc");
     static_assert(alignof(BindSetLayoutDesc) == alignof(RHIBindSetLayoutDesc), "alignof mismatch for BindSetLayoutDesc");
     static_assert(offsetof(BindSetLayoutDesc, name) == offsetof(RHIBindSetLayoutDesc, name));
     static_assert(offsetof(BindSetLayoutDesc, entryCount) == offsetof(RHIBindSetLayoutDesc, entryCount));
     static_assert(offsetof(BindSetLayoutDesc, entries) == offsetof(RHIBindSetLayoutDesc, entries));
+    static_assert(offsetof(BindSetLayoutDesc, pushDescriptor) == offsetof(RHIBindSetLayoutDesc, pushDescriptor));
 
     struct BindSetDesc
     {
@@ -2488,6 +3007,22 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     static_assert(offsetof(PipelineCacheDesc, data) == offsetof(RHIPipelineCacheDesc, data));
     static_assert(offsetof(PipelineCacheDesc, dataSize) == offsetof(RHIPipelineCacheDesc, dataSize));
 
+    struct ResourceHeapDesc
+    {
+        std::string_view name;
+        uint32_t sampledTextureCount = 0;
+        uint32_t storageBufferCount = 0;
+        uint32_t samplerCount = 0;
+        ShaderStage visibility = ShaderStage::All;
+    };
+    static_assert(sizeof(ResourceHeapDesc) == sizeof(RHIResourceHeapDesc), "sizeof mismatch for ResourceHeapDesc");
+    static_assert(alignof(ResourceHeapDesc) == alignof(RHIResourceHeapDesc), "alignof mismatch for ResourceHeapDesc");
+    static_assert(offsetof(ResourceHeapDesc, name) == offsetof(RHIResourceHeapDesc, name));
+    static_assert(offsetof(ResourceHeapDesc, sampledTextureCount) == offsetof(RHIResourceHeapDesc, sampledTextureCount));
+    static_assert(offsetof(ResourceHeapDesc, storageBufferCount) == offsetof(RHIResourceHeapDesc, storageBufferCount));
+    static_assert(offsetof(ResourceHeapDesc, samplerCount) == offsetof(RHIResourceHeapDesc, samplerCount));
+    static_assert(offsetof(ResourceHeapDesc, visibility) == offsetof(RHIResourceHeapDesc, visibility));
+
     struct RenderPipelineDesc
     {
         std::string_view name;
@@ -2514,6 +3049,7 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         TextureFormat depthStencilFormat = TextureFormat::Undefined;
 
         uint32_t patchControlPoints = 0;
+        bool extendedDynamicState = false;
     };
     static_assert(sizeof(RenderPipelineDesc) == sizeof(RHIRenderPipelineDesc), "sizeof mismatch for RenderPipelineDesc");
     static_assert(alignof(RenderPipelineDesc) == alignof(RHIRenderPipelineDesc), "alignof mismatch for RenderPipelineDesc");
@@ -2536,6 +3072,7 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
     static_assert(offsetof(RenderPipelineDesc, colorAttachmentFormats) == offsetof(RHIRenderPipelineDesc, colorAttachmentFormats));
     static_assert(offsetof(RenderPipelineDesc, depthStencilFormat) == offsetof(RHIRenderPipelineDesc, depthStencilFormat));
     static_assert(offsetof(RenderPipelineDesc, patchControlPoints) == offsetof(RHIRenderPipelineDesc, patchControlPoints));
+    static_assert(offsetof(RenderPipelineDesc, extendedDynamicState) == offsetof(RHIRenderPipelineDesc, extendedDynamicState));
 
     struct ComputePipelineDesc
     {
@@ -2584,10 +3121,28 @@ inline constexpr bool operator!=(EnumName a, uint32_t b) { \
         std::string_view name;
         uint32_t requiredFeatureCount = 0;
         FeatureName const* requiredFeatures;
+        // Threads used to translate command lists at submit time. 0 or 1 translates on the submitting thread.
+        uint32_t commandRecordingThreadCount = 0;
+        // Hands submissions to a per-queue thread so that Submit returns without waiting for the driver.
+        bool asyncSubmission = false;
+        // Initial size of the staging ring buffers behind Queue WriteBuffer and WriteTexture, 0 selects 4 MiB. They grow
+        // and shrink from there with the upload volume.
+        uint64_t uploadRingBufferSize = 0;
+        // Threads compiling the pipelines of CreateRenderPipelineAsync and CreateComputePipelineAsync, which bounds how
+        // many compile at once. 0 selects half of the hardware threads, at most 4.
+        uint32_t pipelineCompilationThreadCount = 0;
+        // Directory the device loads its pipeline cache from and saves it to, pipelines created without a cache then
+        // use it implicitly. Empty disables the persistent cache.
+        std::string_view pipelineCacheDirectory;
     };
     static_assert(sizeof(DeviceDesc) == sizeof(RHIDeviceDesc), "sizeof mismatch for DeviceDesc");
     static_assert(alignof(DeviceDesc) == alignof(RHIDeviceDesc), "alignof mismatch for DeviceDesc");
     static_assert(offsetof(DeviceDesc, name) == offsetof(RHIDeviceDesc, name));
     static_assert(offsetof(DeviceDesc, requiredFeatureCount) == offsetof(RHIDeviceDesc, requiredFeatureCount));
     static_assert(offsetof(DeviceDesc, requiredFeatures) == offsetof(RHIDeviceDesc, requiredFeatures));
+    static_assert(offsetof(DeviceDesc, commandRecordingThreadCount) == offsetof(RHIDeviceDesc, commandRecordingThreadCount));
+    static_assert(offsetof(DeviceDesc, asyncSubmission) == offsetof(RHIDeviceDesc, asyncSubmission));
+    static_assert(offsetof(DeviceDesc, uploadRingBufferSize) == offsetof(RHIDeviceDesc, uploadRingBufferSize));
+    static_assert(offsetof(DeviceDesc, pipelineCompilationThreadCount) == offsetof(RHIDeviceDesc, pipelineCompilationThreadCount));
+    static_assert(offsetof(DeviceDesc, pipelineCacheDirectory) == offsetof(RHIDeviceDesc, pipelineCacheDirectory));
 }
@@ -1,6 +1,13 @@
 #include "BindSetBase.h"
 
 #include "BindSetLayoutBase.h"
+#include "BufferBase.h"
+#include "DeviceBase.h"
+#include "SamplerBase.h"
+#include "TextureBase.h"
+#include "common/ObjectContentHasher.h"
+
+#include <cstdint>
 
 namespace rhi::impl
 {
@@ -12,6 +19,15 @@ namespace rhi::impl
         for (uint32_t i = 0; i < desc.entryCount; ++i)
         {
             mEntries[i] = desc.entries[i];
+            for (ResourceBase* resource : {static_cast<ResourceBase*>(mEntries[i].textureView),
+                                           static_cast<ResourceBase*>(mEntries[i].sampler),
+                                           static_cast<ResourceBase*>(mEntries[i].buffer)})
+            {
+                if (resource != nullptr)
+                {
+                    mResources.push_back(resource);
+                }
+            }
         }
     }
 
@@ -19,7 +35,12 @@ namespace rhi::impl
 
     void BindSetBase::APIDestroy()
     {
-        Destroy();
+        mDevice->UncacheBindSet(this);
+    }
+
+    void BindSetBase::DestroyImpl()
+    {
+        mDevice->UncacheBindSet(this);
     }
 
     ResourceType BindSetBase::GetType() const
@@ -36,4 +57,50 @@ namespace rhi::impl
     {
         return mEntries;
     }
+
+    const std::vector<ResourceBase*>& BindSetBase::GetResources() const
+    {
+        return mResources;
+    }
+
+    size_t BindSetBase::ComputeContentHash()
+    {
+        ObjectContentHasher recorder;
+        recorder.Record(reinterpret_cast<uintptr_t>(mLayout.Get()));
+
+        for (const BindSetEntry& entry : mEntries)
+        {
+            recorder.Record(entry.binding,
+                            entry.arrayElementIndex,
+                            reinterpret_cast<uintptr_t>(entry.textureView),
+                            reinterpret_cast<uintptr_t>(entry.sampler),
+                            reinterpret_cast<uintptr_t>(entry.buffer),
+                            entry.bufferOffset,
+                            entry.bufferRange);
+        }
+
+        return recorder.GetContentHash();
+    }
+
+    bool BindSetBase::Equal::operator()(const BindSetBase* a, const BindSetBase* b) const
+    {
+        if (a->mLayout != b->mLayout || a->mEntries.size() != b->mEntries.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a->mEntries.size(); ++i)
+        {
+            const BindSetEntry& entryA = a->mEntries[i];
+            const BindSetEntry& entryB = b->mEntries[i];
+            if (entryA.binding != entryB.binding || entryA.arrayElementIndex != entryB.arrayElementIndex ||
+                entryA.textureView != entryB.textureView || entryA.sampler != entryB.sampler ||
+                entryA.buffer != entryB.buffer || entryA.bufferOffset != entryB.bufferOffset ||
+                entryA.bufferRange != entryB.bufferRange)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 } // namespace rhi::impl
@@ -3,24 +3,39 @@
 #include <vector>
 #include "RHIStruct.h"
 #include "ResourceBase.h"
+#include "common/Cached.hpp"
 #include "common/Ref.hpp"
 
 namespace rhi::impl
 {
-    class BindSetBase : public ResourceBase
+    // Bind sets created through the device are deduplicated: identical descriptions share one live bind set.
+    class BindSetBase : public ResourceBase, public Cached<BindSetBase>
     {
     public:
+        explicit BindSetBase(DeviceBase* device, const BindSetDesc& desc);
+        ~BindSetBase() override;
+        // The bind set may be shared with other users of the same description, so this only removes it from the cache.
+        // Its descriptors are released once the last reference is dropped.
         void APIDestroy();
         ResourceType GetType() const override;
         BindSetLayoutBase* GetLayout();
         const std::vector<BindSetEntry>& GetBindingEntries() const;
+        const std::vector<ResourceBase*>& GetResources() const;
+        size_t ComputeContentHash() override;
+
+        struct Equal
+        {
+            bool operator()(const BindSetBase* a, const BindSetBase* b) const;
+        };
 
     protected:
-        explicit BindSetBase(DeviceBase* device, const BindSetDesc& desc);
-        ~BindSetBase() override;
+        void DestroyImpl() override;
 
     private:
         Ref<BindSetLayoutBase> mLayout;
         std::vector<BindSetEntry> mEntries;
+        // The entries are compared by address. The resources are not kept alive, destroying one of them evicts the
+        // bind set from the cache instead.
+        std::vector<ResourceBase*> mResources;
     };
 } // namespace rhi::impl
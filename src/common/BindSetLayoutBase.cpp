@@ -22,6 +22,7 @@ namespace rhi::impl
 
     BindSetLayoutBase::BindSetLayoutBase(DeviceBase* device, const BindSetLayoutDesc& desc)
         : ResourceBase(device, desc.name)
+        , mIsPushDescriptor(desc.pushDescriptor)
     {
         uint32_t maxBinding = 0;
         for (uint32_t i = 0; i < desc.entryCount; ++i)
@@ -46,6 +47,22 @@ namespace rhi::impl
                     entry.hasDynamicOffset,
             };
         }
+
+        if (mIsPushDescriptor)
+        {
+            uint32_t descriptorCount = 0;
+            for (uint32_t i = 0; i < desc.entryCount; ++i)
+            {
+                INVALID_IF(desc.entries[i].hasDynamicOffset,
+                           "Push descriptor bindings can't have dynamic offsets (binding %d)",
+                           desc.entries[i].binding);
+                descriptorCount += desc.entries[i].arrayElementCount;
+            }
+            INVALID_IF(descriptorCount > cMaxPushDescriptors,
+                       "Push descriptor layouts are limited to %d descriptors (%d given)",
+                       cMaxPushDescriptors,
+                       descriptorCount);
+        }
     }
 
     BindSetLayoutBase::~BindSetLayoutBase()
@@ -61,6 +78,11 @@ namespace rhi::impl
         return ResourceType::BindSetLayout;
     }
 
+    void BindSetLayoutBase::APIGetDescriptorStats(DescriptorStats* stats) const
+    {
+        *stats = {};
+    }
+
     BindingType BindSetLayoutBase::GetBindingType(uint32_t binding) const
     {
         ASSERT(binding < mBindingIndexToInfoMap.size());
@@ -75,6 +97,11 @@ namespace rhi::impl
         return mBindingIndexToInfoMap[binding].value().visibility;
     }
 
+    bool BindSetLayoutBase::IsPushDescriptor() const
+    {
+        return mIsPushDescriptor;
+    }
+
     bool BindSetLayoutBase::HasDynamicOffset(uint32_t binding) const
     {
         ASSERT(binding < mBindingIndexToInfoMap.size());
@@ -101,11 +128,13 @@ namespace rhi::impl
             }
         }
 
+        recorder.Record(mIsPushDescriptor);
+
         return recorder.GetContentHash();
     }
 
     bool BindSetLayoutBase::Equal::operator()(const BindSetLayoutBase* a, const BindSetLayoutBase* b) const
     {
-        return a->mBindingIndexToInfoMap == b->mBindingIndexToInfoMap;
+        return a->mIsPushDescriptor == b->mIsPushDescriptor && a->mBindingIndexToInfoMap == b->mBindingIndexToInfoMap;
     }
 } // namespace rhi::impl
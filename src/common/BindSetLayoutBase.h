@@ -15,9 +15,13 @@ namespace rhi::impl
         explicit BindSetLayoutBase(DeviceBase* device, const BindSetLayoutDesc& desc);
         ~BindSetLayoutBase() override;
         ResourceType GetType() const override;
+        // Layouts of backends without descriptor sets report no sets.
+        virtual void APIGetDescriptorStats(DescriptorStats* stats) const;
         BindingType GetBindingType(uint32_t binding) const;
         bool HasDynamicOffset(uint32_t binding) const;
         ShaderStage GetVisibility(uint32_t binding) const;
+        // Push descriptor layouts have no bind sets, their bindings are recorded in the command stream.
+        bool IsPushDescriptor() const;
         size_t ComputeContentHash() override;
 
         struct Equal
@@ -39,5 +43,6 @@ namespace rhi::impl
         };
 
         std::vector<std::optional<BindingInfo>> mBindingIndexToInfoMap;
+        bool mIsPushDescriptor = false;
     };
 } // namespace rhi::impl
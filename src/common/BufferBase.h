@@ -25,6 +25,8 @@ namespace rhi::impl
         BufferUsage APIGetUsage() const;
         uint64_t APIGetSize() const;
         virtual void* APIGetMappedPointer() = 0;
+        // Makes device writes to the mapped memory visible to the host, for memory that is not host coherent.
+        virtual void InvalidateMappedRange(uint64_t offset, uint64_t size) = 0;
         void APIDestroy();
         // internal methods
         ResourceType GetType() const override;
@@ -94,6 +94,8 @@ namespace rhi::impl
 
         bool Empty();
 
+        size_t Size();
+
     private:
         struct Hash
         {
@@ -214,6 +216,13 @@ namespace rhi::impl
         return mCache.empty();
     }
 
+    template <typename T>
+    size_t CachedObjects<T>::Size()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCache.size();
+    }
+
     template <typename T>
     size_t CachedObjects<T>::Hash::operator()(const T* ptr) const
     {
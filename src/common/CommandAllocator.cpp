@@ -4,16 +4,25 @@
 
 namespace rhi::impl
 {
-    CommandAllocator::CommandAllocator()
+    CommandAllocator::CommandAllocator(CommandBlockPool* blockPool)
+        : mBlockPool(blockPool)
     {
+        ASSERT(mBlockPool != nullptr);
         mCurrentPtr = reinterpret_cast<char*>(&mPlaceholderSpace[0]);
         mEndPtr = reinterpret_cast<char*>(&mPlaceholderSpace[1]); // just get address. no visit
     }
 
-    CommandAllocator::~CommandAllocator() = default;
+    CommandAllocator::~CommandAllocator()
+    {
+        if (mBlockPool != nullptr)
+        {
+            mBlockPool->Recycle(std::move(mBlocks));
+        }
+    }
 
     CommandAllocator::CommandAllocator(CommandAllocator&& other)
-        : mBlocks(std::move(other.mBlocks))
+        : mBlockPool(other.mBlockPool)
+        , mBlocks(std::move(other.mBlocks))
         , mLastAllocationSize(other.mLastAllocationSize)
     {
         mCurrentPtr = other.mCurrentPtr;
@@ -25,14 +34,21 @@ namespace rhi::impl
     CommandAllocator& CommandAllocator::operator=(CommandAllocator&& other)
     {
         Clear();
+        std::swap(mBlockPool, other.mBlockPool);
         std::swap(mBlocks, other.mBlocks);
         mLastAllocationSize = other.mLastAllocationSize;
         mCurrentPtr = other.mCurrentPtr;
         mEndPtr = other.mEndPtr;
+        mCurrentBlockIndex = other.mCurrentBlockIndex;
         other.Clear();
         return *this;
     }
 
+    CommandBlockPool* CommandAllocator::GetBlockPool() const
+    {
+        return mBlockPool.Get();
+    }
+
     char* CommandAllocator::Allocate(uint32_t commandId, size_t commandSize, size_t commandAlignment)
     {
         ASSERT(mCurrentPtr != nullptr);
@@ -73,12 +89,6 @@ namespace rhi::impl
         uint32_t* idAlloc = reinterpret_cast<uint32_t*>(mCurrentPtr);
         *idAlloc = cEndOfBlock;
 
-        if (mBlocks.empty() && mBlocksPool.size() > 0)
-        {
-            mBlocks = std::move((*(mBlocksPool.end() - 1)));
-            mBlocksPool.erase((mBlocksPool.end() - 1));
-        }
-
         // We can reuse the allocated memory.
         if (int32_t lastBlockIndex = (static_cast<int>(mBlocks.size()) - 1) > mCurrentBlockIndex)
         {
@@ -110,17 +120,19 @@ namespace rhi::impl
     bool CommandAllocator::GetNewBlock(size_t minimumSize)
     {
         // Allocate blocks doubling sizes each time, to a maximum of 16k (or at least minimumSize).
-        mLastAllocationSize = std::max(minimumSize, std::min(mLastAllocationSize * 2, size_t(16384)));
+        mLastAllocationSize =
+                std::max(minimumSize, std::min(mLastAllocationSize * 2, CommandBlockPool::cMaxBlockSize));
 
-        auto block = std::unique_ptr<char[]>(new (std::nothrow) char[mLastAllocationSize]);
-        if (block == nullptr)
+        Block block;
+        if (!mBlockPool->Acquire(mLastAllocationSize, &block))
         {
             return false;
         }
 
-        mCurrentPtr = AlignPtr(block.get(), alignof(uint32_t));
-        mEndPtr = block.get() + mLastAllocationSize;
-        mBlocks.push_back({mLastAllocationSize, std::move(block)});
+        mCurrentPtr = AlignPtr(block.data.get(), alignof(uint32_t));
+        mEndPtr = block.data.get() + block.size;
+        mBlocks.push_back(std::move(block));
+        ++mCurrentBlockIndex;
         return true;
     }
 
@@ -149,21 +161,16 @@ namespace rhi::impl
         return std::move(mBlocks);
     }
 
-    void CommandAllocator::Recycle(CommandBlocks&& blocks)
-    {
-        mBlocksPool.push_back(std::move(blocks));
-    }
-
     CommandIterator::CommandIterator(CommandAllocator& allocator)
         : mBlocks(allocator.AcquireCurrentBlocks())
-        , mAllocator(allocator)
+        , mBlockPool(allocator.GetBlockPool())
     {
         Reset();
     }
 
     CommandIterator::~CommandIterator()
     {
-        mAllocator.Recycle(std::move(mBlocks));
+        Clear();
     }
 
     bool CommandIterator::NextCommandId(uint32_t* commandId)
@@ -215,7 +222,8 @@ namespace rhi::impl
             return;
         }
 
-        mCurrentPtr = reinterpret_cast<char*>(&mEndOfBlock);
+        mBlockPool->Recycle(std::move(mBlocks));
+        mBlocks.clear();
         Reset();
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "CommandBlockPool.h"
 #include "common/NoCopyable.h"
 
 #include <limits>
@@ -15,14 +16,6 @@ namespace rhi::impl
     constexpr uint32_t cEndOfBlock = std::numeric_limits<uint32_t>::max();
     constexpr uint32_t cAdditionalData = std::numeric_limits<uint32_t>::max() - 1;
 
-    struct Block
-    {
-        size_t size;
-        std::unique_ptr<char[]> data;
-    };
-
-    using CommandBlocks = std::vector<Block>;
-
     class CommandAllocator;
 
     class CommandIterator : public NonCopyable
@@ -52,6 +45,7 @@ namespace rhi::impl
         // Sets iterator to the beginning of the commands without emptying the list. This method can
         // be used if iteration was stopped early and the iterator needs to be restarted.
         void Reset();
+        // Gives the blocks back to the device's block pool. The commands must already have been destroyed.
         void Clear();
         bool IsEmpty() const;
 
@@ -67,14 +61,14 @@ namespace rhi::impl
         // Used to avoid a special case for empty iterators.
         uint32_t mEndOfBlock = cEndOfBlock;
 
-        CommandAllocator& mAllocator;
+        Ref<CommandBlockPool> mBlockPool;
     };
 
 
     class CommandAllocator : public NonCopyable
     {
     public:
-        CommandAllocator();
+        explicit CommandAllocator(CommandBlockPool* blockPool);
         ~CommandAllocator();
         CommandAllocator(CommandAllocator&&);
         CommandAllocator& operator=(CommandAllocator&&);
@@ -111,7 +105,7 @@ namespace rhi::impl
             return result;
         }
 
-        void Recycle(CommandBlocks&& blocks);
+        CommandBlockPool* GetBlockPool() const;
 
     private:
         static constexpr uint32_t cMaxSupportedAlignment = 8;
@@ -134,7 +128,7 @@ namespace rhi::impl
 
         bool GetNewBlock(size_t minimumSize);
         void Reset();
-        std::vector<CommandBlocks> mBlocksPool;
+        Ref<CommandBlockPool> mBlockPool;
         CommandBlocks mBlocks;
         int64_t mCurrentBlockIndex = -1;
         // Data used for the block range at initialization so that the first call to Allocate sees
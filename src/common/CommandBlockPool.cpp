@@ -0,0 +1,160 @@
+#include "CommandBlockPool.h"
+#include "common/Error.h"
+
+namespace rhi::impl
+{
+    namespace
+    {
+        std::atomic<uint64_t> gNextPoolId = 1;
+    }
+
+    struct CommandBlockPool::ThreadCache
+    {
+        // A thread only caches blocks for one pool at a time. Blocks cached for a pool that is no longer the
+        // current one are simply freed, they are plain memory and don't depend on the pool being alive.
+        uint64_t poolId = 0;
+        std::array<std::vector<std::unique_ptr<char[]>>, cSizeClassCount> blocks;
+    };
+
+    CommandBlockPool::CommandBlockPool()
+        : mPoolId(gNextPoolId.fetch_add(1, std::memory_order_relaxed))
+    {}
+
+    CommandBlockPool::~CommandBlockPool() = default;
+
+    Ref<CommandBlockPool> CommandBlockPool::Create()
+    {
+        return AcquireRef(new CommandBlockPool());
+    }
+
+    uint32_t CommandBlockPool::GetSizeClass(size_t size)
+    {
+        uint32_t sizeClass = 0;
+        while (sizeClass < cSizeClassCount && (cMinBlockSize << sizeClass) < size)
+        {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    CommandBlockPool::ThreadCache& CommandBlockPool::GetThreadCache()
+    {
+        thread_local ThreadCache cache;
+        if (cache.poolId != mPoolId)
+        {
+            for (auto& blocks : cache.blocks)
+            {
+                blocks.clear();
+            }
+            cache.poolId = mPoolId;
+        }
+        return cache;
+    }
+
+    bool CommandBlockPool::Acquire(size_t minimumSize, Block* block)
+    {
+        ASSERT(block != nullptr);
+
+        const uint32_t sizeClass = GetSizeClass(minimumSize);
+        const size_t blockSize = sizeClass < cSizeClassCount ? cMinBlockSize << sizeClass : minimumSize;
+
+        std::unique_ptr<char[]> data;
+        if (sizeClass < cSizeClassCount)
+        {
+            auto& cachedBlocks = GetThreadCache().blocks[sizeClass];
+            if (!cachedBlocks.empty())
+            {
+                data = std::move(cachedBlocks.back());
+                cachedBlocks.pop_back();
+                mThreadCacheHits.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto& sharedBlocks = mSharedBlocks[sizeClass];
+                if (!sharedBlocks.empty())
+                {
+                    data = std::move(sharedBlocks.back());
+                    sharedBlocks.pop_back();
+                    mSharedBlockCount.fetch_sub(1, std::memory_order_relaxed);
+                    mSharedPoolHits.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        if (data == nullptr)
+        {
+            data = std::unique_ptr<char[]>(new (std::nothrow) char[blockSize]);
+            if (data == nullptr)
+            {
+                return false;
+            }
+            mHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        mAcquiredBlocks.fetch_add(1, std::memory_order_relaxed);
+        block->size = blockSize;
+        block->data = std::move(data);
+        return true;
+    }
+
+    void CommandBlockPool::Recycle(Block&& block)
+    {
+        if (block.data == nullptr)
+        {
+            return;
+        }
+        mRecycledBlocks.fetch_add(1, std::memory_order_relaxed);
+
+        const uint32_t sizeClass = GetSizeClass(block.size);
+        if (sizeClass >= cSizeClassCount || (cMinBlockSize << sizeClass) != block.size)
+        {
+            block.data.reset();
+            mHeapFrees.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto& cachedBlocks = GetThreadCache().blocks[sizeClass];
+        if (cachedBlocks.size() < cMaxThreadCacheBlocksPerClass)
+        {
+            cachedBlocks.push_back(std::move(block.data));
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto& sharedBlocks = mSharedBlocks[sizeClass];
+            if (sharedBlocks.size() < cMaxSharedBlocksPerClass)
+            {
+                sharedBlocks.push_back(std::move(block.data));
+                mSharedBlockCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        block.data.reset();
+        mHeapFrees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CommandBlockPool::Recycle(CommandBlocks&& blocks)
+    {
+        for (Block& block : blocks)
+        {
+            Recycle(std::move(block));
+        }
+        blocks.clear();
+    }
+
+    CommandBlockPoolStats CommandBlockPool::GetStats() const
+    {
+        CommandBlockPoolStats stats{};
+        stats.acquiredBlocks = mAcquiredBlocks.load(std::memory_order_relaxed);
+        stats.heapAllocations = mHeapAllocations.load(std::memory_order_relaxed);
+        stats.threadCacheHits = mThreadCacheHits.load(std::memory_order_relaxed);
+        stats.sharedPoolHits = mSharedPoolHits.load(std::memory_order_relaxed);
+        stats.recycledBlocks = mRecycledBlocks.load(std::memory_order_relaxed);
+        stats.heapFrees = mHeapFrees.load(std::memory_order_relaxed);
+        stats.sharedPoolBlockCount = mSharedBlockCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+} // namespace rhi::impl
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/Ref.hpp"
+#include "common/RefCounted.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rhi::impl
+{
+    struct Block
+    {
+        size_t size;
+        std::unique_ptr<char[]> data;
+    };
+
+    using CommandBlocks = std::vector<Block>;
+
+    struct CommandBlockPoolStats
+    {
+        // Blocks handed out to command allocators.
+        uint64_t acquiredBlocks;
+        // Blocks that had to be allocated from the heap. Stays constant once recording reaches a steady state.
+        uint64_t heapAllocations;
+        uint64_t threadCacheHits;
+        uint64_t sharedPoolHits;
+        // Blocks given back by command allocators and iterators.
+        uint64_t recycledBlocks;
+        // Blocks returned to the heap because they were oversized or the caches were full.
+        uint64_t heapFrees;
+        uint64_t sharedPoolBlockCount;
+    };
+
+    // Device-wide pool of command blocks shared by every CommandAllocator and CommandIterator of a device.
+    // Blocks are bucketed in power of two size classes. Each thread keeps a small cache per size class in front of a
+    // bounded, mutex protected shared free list so that the common path takes no lock at all.
+    class CommandBlockPool : public RefCounted
+    {
+    public:
+        static Ref<CommandBlockPool> Create();
+
+        // Returns a block of at least minimumSize bytes, rounded up to its size class.
+        bool Acquire(size_t minimumSize, Block* block);
+        void Recycle(Block&& block);
+        void Recycle(CommandBlocks&& blocks);
+
+        CommandBlockPoolStats GetStats() const;
+
+        static constexpr size_t cMinBlockSize = 2048;
+        static constexpr uint32_t cSizeClassCount = 4;
+        static constexpr size_t cMaxBlockSize = cMinBlockSize << (cSizeClassCount - 1);
+
+    private:
+        CommandBlockPool();
+        ~CommandBlockPool() override;
+
+        static constexpr uint32_t cMaxThreadCacheBlocksPerClass = 8;
+        static constexpr uint32_t cMaxSharedBlocksPerClass = 64;
+
+        struct ThreadCache;
+        ThreadCache& GetThreadCache();
+
+        static uint32_t GetSizeClass(size_t size);
+
+        const uint64_t mPoolId;
+
+        std::mutex mMutex;
+        std::array<std::vector<std::unique_ptr<char[]>>, cSizeClassCount> mSharedBlocks;
+
+        std::atomic<uint64_t> mAcquiredBlocks = 0;
+        std::atomic<uint64_t> mHeapAllocations = 0;
+        std::atomic<uint64_t> mThreadCacheHits = 0;
+        std::atomic<uint64_t> mSharedPoolHits = 0;
+        std::atomic<uint64_t> mRecycledBlocks = 0;
+        std::atomic<uint64_t> mHeapFrees = 0;
+        std::atomic<uint64_t> mSharedBlockCount = 0;
+    };
+} // namespace rhi::impl
@@ -13,6 +13,7 @@ namespace rhi::impl
 {
     CommandEncoder::CommandEncoder(DeviceBase* device)
         : mDevice(device)
+        , mEncodingContext(device)
     {}
 
     Ref<CommandEncoder> CommandEncoder::Create(DeviceBase* device)
@@ -221,6 +222,11 @@ namespace rhi::impl
         return commandBuffer.Detach();
     }
 
+    DeviceBase* CommandEncoder::GetDevice() const
+    {
+        return mDevice;
+    }
+
     CommandIterator CommandEncoder::AcquireCommands()
     {
         return mEncodingContext.AcquireCommands();
@@ -39,6 +39,7 @@ namespace rhi::impl
         Ref<ComputePassEncoder> BeginComputePass();
         CommandListBase* APIFinish();
 
+        DeviceBase* GetDevice() const;
         CommandIterator AcquireCommands();
         CommandListResourceUsage AcquireResourceUsages();
         void OnRenderPassEnd();
@@ -18,5 +18,6 @@ namespace rhi::impl
     CommandListBase::~CommandListBase()
     {
         FreeCommands(&mCommandIter);
+        mCommandIter.Clear();
     }
 } // namespace rhi::impl
@@ -1,7 +1,10 @@
 #include "Commands.h"
 #include "BindSetLayoutBase.h"
 #include "ComputePipelineBase.h"
+#include "RenderBundleBase.h"
 #include "RenderPipelineBase.h"
+#include "ResourceHeapBase.h"
+#include "SamplerBase.h"
 #include "TextureBase.h"
 #include "common/Error.h"
 
@@ -62,6 +65,15 @@ namespace rhi::impl
     SetBindSetCmd::SetBindSetCmd() {}
     SetBindSetCmd::~SetBindSetCmd() {}
 
+    PushBinding::PushBinding() {}
+    PushBinding::~PushBinding() {}
+
+    PushBindingsCmd::PushBindingsCmd() {}
+    PushBindingsCmd::~PushBindingsCmd() {}
+
+    UseResidentResourcesCmd::UseResidentResourcesCmd() {}
+    UseResidentResourcesCmd::~UseResidentResourcesCmd() {}
+
     SetPushConstantCmd::SetPushConstantCmd() {}
     SetPushConstantCmd::~SetPushConstantCmd() {}
 
@@ -71,6 +83,9 @@ namespace rhi::impl
     MultiDrawIndirectCmd::MultiDrawIndirectCmd() {}
     MultiDrawIndirectCmd::~MultiDrawIndirectCmd() {}
 
+    ExecuteBundlesCmd::ExecuteBundlesCmd() {}
+    ExecuteBundlesCmd::~ExecuteBundlesCmd() {}
+
     EndRenderPassCmd::EndRenderPassCmd(){}
     EndRenderPassCmd::~EndRenderPassCmd() {}
 
@@ -130,6 +145,7 @@ namespace rhi::impl
             case Command::BeginDebugLabel:
                 {
                     BeginDebugLabelCmd* begin = commands->NextCommand<BeginDebugLabelCmd>();
+                    commands->NextData<char>(begin->labelLength);
                     begin->~BeginDebugLabelCmd();
                     break;
                 }
@@ -244,6 +260,7 @@ namespace rhi::impl
             case Command::SetPushConstant:
                 {
                     SetPushConstantCmd* begin = commands->NextCommand<SetPushConstantCmd>();
+                    commands->NextData<uint8_t>(begin->size);
                     begin->~SetPushConstantCmd();
                     break;
                 }
@@ -259,12 +276,79 @@ namespace rhi::impl
                     begin->~SetBlendConstantCmd();
                     break;
                 }
+            case Command::SetCullMode:
+                {
+                    SetCullModeCmd* begin = commands->NextCommand<SetCullModeCmd>();
+                    begin->~SetCullModeCmd();
+                    break;
+                }
+            case Command::SetFrontFace:
+                {
+                    SetFrontFaceCmd* begin = commands->NextCommand<SetFrontFaceCmd>();
+                    begin->~SetFrontFaceCmd();
+                    break;
+                }
+            case Command::SetPrimitiveType:
+                {
+                    SetPrimitiveTypeCmd* begin = commands->NextCommand<SetPrimitiveTypeCmd>();
+                    begin->~SetPrimitiveTypeCmd();
+                    break;
+                }
+            case Command::SetDepthState:
+                {
+                    SetDepthStateCmd* begin = commands->NextCommand<SetDepthStateCmd>();
+                    begin->~SetDepthStateCmd();
+                    break;
+                }
+            case Command::SetStencilState:
+                {
+                    SetStencilStateCmd* begin = commands->NextCommand<SetStencilStateCmd>();
+                    begin->~SetStencilStateCmd();
+                    break;
+                }
             case Command::SetBindSet:
                 {
                     SetBindSetCmd* begin = commands->NextCommand<SetBindSetCmd>();
+                    if (begin->dynamicOffsetCount > 0)
+                    {
+                        commands->NextData<uint32_t>(begin->dynamicOffsetCount);
+                    }
                     begin->~SetBindSetCmd();
                     break;
                 }
+            case Command::PushBindings:
+                {
+                    PushBindingsCmd* begin = commands->NextCommand<PushBindingsCmd>();
+                    PushBinding* bindings = commands->NextData<PushBinding>(begin->entryCount);
+                    for (uint32_t i = 0; i < begin->entryCount; ++i)
+                    {
+                        bindings[i].~PushBinding();
+                    }
+                    begin->~PushBindingsCmd();
+                    break;
+                }
+            case Command::UseResidentResources:
+                {
+                    UseResidentResourcesCmd* begin = commands->NextCommand<UseResidentResourcesCmd>();
+                    Ref<ResourceBase>* resources = commands->NextData<Ref<ResourceBase>>(begin->resourceCount);
+                    for (uint32_t i = 0; i < begin->resourceCount; ++i)
+                    {
+                        resources[i].~Ref<ResourceBase>();
+                    }
+                    begin->~UseResidentResourcesCmd();
+                    break;
+                }
+            case Command::ExecuteBundles:
+                {
+                    ExecuteBundlesCmd* begin = commands->NextCommand<ExecuteBundlesCmd>();
+                    Ref<RenderBundleBase>* bundles = commands->NextData<Ref<RenderBundleBase>>(begin->count);
+                    for (uint32_t i = 0; i < begin->count; ++i)
+                    {
+                        bundles[i].~Ref<RenderBundleBase>();
+                    }
+                    begin->~ExecuteBundlesCmd();
+                    break;
+                }
             case Command::EndRenderPass:
                 {
                     EndRenderPassCmd* begin = commands->NextCommand<EndRenderPassCmd>();
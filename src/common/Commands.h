@@ -11,6 +11,9 @@
 
 namespace rhi::impl
 {
+    class RenderBundleBase;
+    class ResourceHeapBase;
+
     enum class Command
     {
         ClearBuffer,
@@ -38,7 +41,15 @@ namespace rhi::impl
         SetPushConstant,
         SetStencilReference,
         SetBlendConstant,
+        SetCullMode,
+        SetFrontFace,
+        SetPrimitiveType,
+        SetDepthState,
+        SetStencilState,
         SetBindSet,
+        PushBindings,
+        UseResidentResources,
+        ExecuteBundles,
         EndRenderPass,
         EndComputePass,
         EndDebugLabel,
@@ -242,6 +253,36 @@ namespace rhi::impl
         Color color;
     };
 
+    struct SetCullModeCmd
+    {
+        CullMode cullMode;
+    };
+
+    struct SetFrontFaceCmd
+    {
+        FrontFace frontFace;
+    };
+
+    struct SetPrimitiveTypeCmd
+    {
+        PrimitiveType primitiveType;
+    };
+
+    struct SetDepthStateCmd
+    {
+        bool depthTestEnable;
+        bool depthWriteEnable;
+        CompareOp depthCompareOp;
+    };
+
+    struct SetStencilStateCmd
+    {
+        bool stencilTestEnable;
+        // Only the ops are used.
+        StencilOpState front;
+        StencilOpState back;
+    };
+
     struct SetBindSetCmd
     {
         SetBindSetCmd();
@@ -252,6 +293,42 @@ namespace rhi::impl
         uint32_t dynamicOffsetCount;
     };
 
+    // A BindSetEntry that keeps its resources alive until the commands are freed.
+    struct PushBinding
+    {
+        PushBinding();
+        ~PushBinding();
+
+        uint32_t binding;
+        uint32_t arrayElementIndex;
+        Ref<TextureViewBase> textureView;
+        Ref<SamplerBase> sampler;
+        Ref<BufferBase> buffer;
+        uint32_t bufferOffset;
+        uint64_t bufferRange;
+    };
+
+    // Followed by entryCount PushBinding.
+    struct PushBindingsCmd
+    {
+        PushBindingsCmd();
+        ~PushBindingsCmd();
+
+        Ref<BindSetLayoutBase> layout;
+        uint32_t setIndex;
+        uint32_t entryCount;
+    };
+
+    // Followed by resourceCount Ref<ResourceBase>, the heap resources read by the pass are kept alive with the commands.
+    struct UseResidentResourcesCmd
+    {
+        UseResidentResourcesCmd();
+        ~UseResidentResourcesCmd();
+
+        Ref<ResourceHeapBase> heap;
+        uint32_t resourceCount;
+    };
+
     struct SetPushConstantCmd
     {
         SetPushConstantCmd();
@@ -303,6 +380,15 @@ namespace rhi::impl
     // clang-format off
     struct MultiDrawIndexedIndirectCmd : MultiDrawIndirectCmd {};
     // clang-format on
+    // Followed by count Ref<RenderBundleBase> as additional data.
+    struct ExecuteBundlesCmd
+    {
+        ExecuteBundlesCmd();
+        ~ExecuteBundlesCmd();
+
+        uint32_t count;
+    };
+
     struct EndRenderPassCmd
     {
         EndRenderPassCmd();
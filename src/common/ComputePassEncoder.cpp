@@ -2,12 +2,13 @@
 #include "CommandEncoder.h"
 #include "Commands.h"
 #include "ComputePipelineBase.h"
+#include "ResourceHeapBase.h"
 #include "common/Error.h"
 
 namespace rhi::impl
 {
     ComputePassEncoder::ComputePassEncoder(CommandEncoder* encoder, EncodingContext& encodingContext)
-        : PassEncoder(encoder, encodingContext)
+        : PassEncoder(encoder->GetDevice(), encoder, encodingContext)
     {}
 
     ComputePassEncoder::~ComputePassEncoder()
@@ -28,11 +29,14 @@ namespace rhi::impl
     {
         ASSERT(pipeline != nullptr);
 
+        if (!ShouldSetPipeline(pipeline))
+        {
+            return;
+        }
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
         SetComputePipelineCmd* cmd = allocator.Allocate<SetComputePipelineCmd>(Command::SetComputePipeline);
         cmd->pipeline = pipeline;
-
-        mLastPipeline = pipeline;
     }
 
     void ComputePassEncoder::APIDispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
@@ -60,15 +64,37 @@ namespace rhi::impl
                                            const uint32_t* dynamicOffsets)
     {
         ASSERT(set != nullptr);
-        RecordSetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets);
-        mUsageTracker.AddBindSet(set);
+        if (RecordSetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets))
+        {
+            mUsageTracker.AddBindSet(set);
+        }
+    }
+
+    void ComputePassEncoder::APIPushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries)
+    {
+        BindSetLayoutBase* layout = RecordPushBindings(setIndex, entryCount, entries);
+        mUsageTracker.AddBindings(layout, entries, entryCount);
+    }
+
+    void ComputePassEncoder::APIUseResidentResources(ResourceHeapBase* heap,
+                                                       ResourceHeapSlotType type,
+                                                       uint32_t slotCount,
+                                                       const uint32_t* slots)
+    {
+        uint32_t resourceCount;
+        const Ref<ResourceBase>* resources = RecordUseResidentResources(heap, type, slotCount, slots, &resourceCount);
+        if (resourceCount > 0)
+        {
+            mUsageTracker.AddResidentResources(type, heap->GetVisibility(), resources, resourceCount);
+        }
     }
 
     void ComputePassEncoder::APIEnd()
     {
         mIsEnded = true;
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        EndRenderPassCmd* cmd = allocator.Allocate<EndRenderPassCmd>(Command::EndRenderPass);
+        allocator.Allocate<EndComputePassCmd>(Command::EndComputePass);
+        ReportElidedCommands();
         mEncodingContext.ExitComputePass(mUsageTracker);
         mCommandEncoder->OnComputePassEnd();
     }
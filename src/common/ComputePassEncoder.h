@@ -18,6 +18,11 @@ namespace rhi::impl
                            uint32_t setIndex,
                            uint32_t dynamicOffsetCount = 0,
                            const uint32_t* dynamicOffsets = nullptr);
+        void APIPushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries);
+        void APIUseResidentResources(ResourceHeapBase* heap,
+                                     ResourceHeapSlotType type,
+                                     uint32_t slotCount,
+                                     const uint32_t* slots);
         void APIEnd();
 
     protected:
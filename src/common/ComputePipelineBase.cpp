@@ -1,4 +1,5 @@
 #include "ComputePipelineBase.h"
+#include "ObjectContentHasher.h"
 
 namespace rhi::impl
 {
@@ -6,10 +7,31 @@ namespace rhi::impl
         : PipelineBase(device, desc)
     {}
 
-    ComputePipelineBase::~ComputePipelineBase() = default;
+    ComputePipelineBase::~ComputePipelineBase()
+    {
+        // Pipelines whose compilation was skipped are never tracked, so DestroyImpl did not uncache them.
+        Uncache();
+    }
 
     ResourceType ComputePipelineBase::GetType() const
     {
         return ResourceType::ComputePipeline;
     }
+
+    void ComputePipelineBase::DestroyImpl()
+    {
+        Uncache();
+    }
+
+    size_t ComputePipelineBase::ComputeContentHash()
+    {
+        ObjectContentHasher recorder;
+        RecordLayoutAndStages(&recorder);
+        return recorder.GetContentHash();
+    }
+
+    bool ComputePipelineBase::Equal::operator()(const ComputePipelineBase* a, const ComputePipelineBase* b) const
+    {
+        return a->IsLayoutAndStagesEqual(b);
+    }
 } // namespace rhi::impl
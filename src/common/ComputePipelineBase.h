@@ -2,14 +2,24 @@
 
 #include "PipelineBase.h"
 #include "RHIStruct.h"
+#include "common/Cached.hpp"
 
 namespace rhi::impl
 {
-    class ComputePipelineBase : public PipelineBase
+    class ComputePipelineBase : public PipelineBase, public Cached<ComputePipelineBase>
     {
     public:
         explicit ComputePipelineBase(DeviceBase* device, const ComputePipelineDesc& desc);
         ~ComputePipelineBase() override;
         ResourceType GetType() const override;
+        size_t ComputeContentHash() override;
+
+        struct Equal
+        {
+            bool operator()(const ComputePipelineBase* a, const ComputePipelineBase* b) const;
+        };
+
+    protected:
+        void DestroyImpl() override;
     };
 } // namespace rhi::impl
@@ -21,6 +21,8 @@ namespace rhi::impl
     static constexpr uint32_t cMaxStorageTexturesPerShaderStage = 8;
     static constexpr uint32_t cMaxUniformBuffersPerShaderStage = 12;
     static constexpr uint32_t cMaxOptimalBindingsPerGroup = 32;
+    // The minimum maxPushDescriptors guaranteed by VK_KHR_push_descriptor.
+    static constexpr uint32_t cMaxPushDescriptors = 32;
 
     // Indirect command sizes
     static constexpr uint64_t cDispatchIndirectSize = 3 * sizeof(uint32_t);
@@ -1,22 +1,30 @@
 #include "DeviceBase.h"
+#include <algorithm>
 #include <functional>
+#include <thread>
 #include <type_traits>
 #include "AdapterBase.h"
 #include "BindSetBase.h"
 #include "BindSetLayoutBase.h"
 #include "BufferBase.h"
+#include "CommandBlockPool.h"
 #include "CommandEncoder.h"
 #include "ComputePipelineBase.h"
 #include "InstanceBase.h"
 #include "PipelineLayoutBase.h"
 #include "QueueBase.h"
+#include "RenderBundleEncoder.h"
 #include "RenderPipelineBase.h"
 #include "SamplerBase.h"
 #include "ShaderModuleBase.h"
 #include "TextureBase.h"
 #include "PipelineCacheBase.h"
+#include "ResourceHeapBase.h"
+#include "WorkerTaskPool.h"
 #include "common/Cached.hpp"
 
+#include <absl/container/flat_hash_map.h>
+
 namespace rhi::impl
 {
     struct DeviceBase::Cache
@@ -24,6 +32,14 @@ namespace rhi::impl
         CachedObjects<BindSetLayoutBase> bindSetLayouts;
         CachedObjects<PipelineLayoutBase> pipelineLayouts;
         CachedObjects<SamplerBase> samplers;
+        CachedObjects<BindSetBase> bindSets;
+        CachedObjects<ShaderModuleBase> shaderModules;
+        CachedObjects<RenderPipelineBase> renderPipelines;
+        CachedObjects<ComputePipelineBase> computePipelines;
+
+        // Cached bind sets by the resources they reference.
+        std::mutex bindSetsByResourceMutex;
+        absl::flat_hash_map<const ResourceBase*, std::vector<BindSetBase*>> bindSetsByResource;
     };
 
     template <typename T>
@@ -46,11 +62,74 @@ namespace rhi::impl
         return result;
     }
 
+    // The uninitialized pipeline is its own key, the returned one may be an identical pipeline created earlier.
+    template <typename Pipeline>
+    Ref<Pipeline> GetOrInsertPipeline(CachedObjects<Pipeline>& cache,
+                                      Ref<Pipeline> pipeline,
+                                      std::atomic<uint64_t>& hits,
+                                      std::atomic<uint64_t>& misses)
+    {
+        pipeline->SetContentHash(pipeline->ComputeContentHash());
+        bool inserted = false;
+        std::tie(pipeline, inserted) = cache.Insert(pipeline.Get());
+        (inserted ? misses : hits).fetch_add(1, std::memory_order_relaxed);
+        return pipeline;
+    }
+
+    template <typename Pipeline, typename Callback>
+    class CreatePipelineAsyncCallbackTask : public CallbackTask
+    {
+    public:
+        // A null pipeline reports that the compilation failed.
+        CreatePipelineAsyncCallbackTask(Ref<Pipeline> pipeline, Callback callback, void* userData)
+            : mPipeline(std::move(pipeline))
+            , mCallback(callback)
+            , mUserData(userData)
+        {}
+
+    private:
+        void FinishImpl() override
+        {
+            const CreatePipelineAsyncStatus status =
+                    mPipeline != nullptr ? CreatePipelineAsyncStatus::Success : CreatePipelineAsyncStatus::Error;
+            mCallback(status, mPipeline.Detach(), mUserData);
+        }
+
+        void HandleDeviceLossImpl() override
+        {
+            mCallback(CreatePipelineAsyncStatus::DeviceLost, nullptr, mUserData);
+        }
+
+        void HandleShutDownImpl() override
+        {
+            mCallback(CreatePipelineAsyncStatus::DestroyedBeforeCallback, nullptr, mUserData);
+        }
+
+        Ref<Pipeline> mPipeline;
+        Callback mCallback;
+        void* mUserData;
+    };
+
     DeviceBase::DeviceBase(AdapterBase* adapter, const DeviceDesc& desc)
         : mAdapter(adapter)
+        , mCommandBlockPool(CommandBlockPool::Create())
+        , mAsyncSubmission(desc.asyncSubmission)
+        , mUploadRingBufferSize(desc.uploadRingBufferSize)
+        , mPipelineCompilationThreadCount(desc.pipelineCompilationThreadCount)
     {
         SetFeatures(desc);
         // Todo: create cache object.
+
+        // The submitting thread takes part in the recording, so it counts as one of the threads.
+        if (desc.commandRecordingThreadCount > 1)
+        {
+            mCommandRecordingPool = std::make_unique<WorkerTaskPool>(desc.commandRecordingThreadCount - 1);
+        }
+
+        if (mPipelineCompilationThreadCount == 0)
+        {
+            mPipelineCompilationThreadCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+        }
     }
 
     DeviceBase::~DeviceBase() {}
@@ -94,6 +173,20 @@ namespace rhi::impl
                 queue->Tick();
             }
         }
+        GetTrackedObjectList(ResourceType::ResourceHeap)
+                ->ForEach([](ResourceBase* heap) { static_cast<ResourceHeapBase*>(heap)->Tick(); });
+        TickImpl();
+        mCallbackTaskManager.Flush();
+    }
+
+    void DeviceBase::ShutDownAsyncWork()
+    {
+        if (mPipelineCompilationPool != nullptr)
+        {
+            mPipelineCompilationCancelled.store(true, std::memory_order_relaxed);
+            mPipelineCompilationPool->WaitIdle();
+        }
+        mCallbackTaskManager.HandleShutDown();
         mCallbackTaskManager.Flush();
     }
 
@@ -105,6 +198,7 @@ namespace rhi::impl
                         ResourceType::ComputePipeline,
                         ResourceType::PipelineLayout,
                         ResourceType::PipelineCache,
+                        ResourceType::ResourceHeap,
                         ResourceType::BindSet,
                         ResourceType::BindSetLayout,
                         ResourceType::ShaderModule,
@@ -133,24 +227,108 @@ namespace rhi::impl
         return encoder.Detach();
     }
 
+    RenderBundleEncoder* DeviceBase::APICreateRenderBundleEncoder()
+    {
+        Ref<RenderBundleEncoder> encoder = RenderBundleEncoder::Create(this);
+        return encoder.Detach();
+    }
+
     RenderPipelineBase* DeviceBase::APICreateRenderPipeline(const RenderPipelineDesc& desc)
     {
-        Ref<RenderPipelineBase> pipeline = CreateRenderPipelineImpl(desc);
+        Ref<RenderPipelineBase> pipeline = GetOrInsertRenderPipeline(CreateUninitializedRenderPipelineImpl(desc));
+        if (!pipeline->Initialize(desc.cache))
+        {
+            return nullptr;
+        }
         return pipeline.Detach();
     }
 
     ComputePipelineBase* DeviceBase::APICreateComputePipeline(const ComputePipelineDesc& desc)
     {
-        Ref<ComputePipelineBase> pipeline = CreateComputePipelineImpl(desc);
+        Ref<ComputePipelineBase> pipeline = GetOrInsertComputePipeline(CreateUninitializedComputePipelineImpl(desc));
+        if (!pipeline->Initialize(desc.cache))
+        {
+            return nullptr;
+        }
         return pipeline.Detach();
     }
 
+    void DeviceBase::APICreateRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                                  CreateRenderPipelineAsyncCallback callback,
+                                                  void* userData)
+    {
+        ASSERT(callback != nullptr);
+        InitializePipelineAsync(
+                GetOrInsertRenderPipeline(CreateUninitializedRenderPipelineImpl(desc)), desc.cache, callback, userData);
+    }
+
+    void DeviceBase::APICreateComputePipelineAsync(const ComputePipelineDesc& desc,
+                                                   CreateComputePipelineAsyncCallback callback,
+                                                   void* userData)
+    {
+        ASSERT(callback != nullptr);
+        InitializePipelineAsync(
+                GetOrInsertComputePipeline(CreateUninitializedComputePipelineImpl(desc)), desc.cache, callback, userData);
+    }
+
+    WorkerTaskPool* DeviceBase::GetPipelineCompilationPool()
+    {
+        std::call_once(mPipelineCompilationPoolOnce,
+                       [this]()
+                       { mPipelineCompilationPool = std::make_unique<WorkerTaskPool>(mPipelineCompilationThreadCount); });
+        return mPipelineCompilationPool.get();
+    }
+
+    void DeviceBase::PostPipelineCompilationTask(std::function<void()> task)
+    {
+        GetPipelineCompilationPool()->PostTask(
+                [this, task = std::move(task)]()
+                {
+                    if (!mPipelineCompilationCancelled.load(std::memory_order_relaxed))
+                    {
+                        task();
+                    }
+                });
+    }
+
+    template <typename Pipeline, typename Callback>
+    void DeviceBase::InitializePipelineAsync(Ref<Pipeline> pipeline,
+                                             PipelineCacheBase* cache,
+                                             Callback callback,
+                                             void* userData)
+    {
+        // The desc only lives for this call, everything the compilation needs was copied into the pipeline and the cache
+        // is kept alive by the task.
+        GetPipelineCompilationPool()->PostTask(
+                [this, pipeline = std::move(pipeline), cache = Ref<PipelineCacheBase>(cache), callback, userData]()
+                {
+                    Ref<Pipeline> result;
+                    // Compilations still queued at shutdown are skipped, their callbacks report the destruction.
+                    if (!mPipelineCompilationCancelled.load(std::memory_order_relaxed) &&
+                        pipeline->Initialize(cache.Get()))
+                    {
+                        result = pipeline;
+                    }
+                    mCallbackTaskManager.AddCallbackTask(
+                            std::make_unique<CreatePipelineAsyncCallbackTask<Pipeline, Callback>>(
+                                    std::move(result), callback, userData));
+                });
+    }
+
     PipelineCacheBase* DeviceBase::APICreatePipelineCache(const PipelineCacheDesc& desc)
     {
         Ref<PipelineCacheBase> cache = CreatePipelineCacheImpl(desc);
         return cache.Detach();
     }
 
+    ResourceHeapBase* DeviceBase::APICreateResourceHeap(const ResourceHeapDesc& desc)
+    {
+        INVALID_IF(!HasRequiredFeature(FeatureName::DescriptorIndexing),
+                   "Resource heaps require FeatureName::DescriptorIndexing.");
+        Ref<ResourceHeapBase> heap = CreateResourceHeapImpl(desc);
+        return heap.Detach();
+    }
+
     BindSetLayoutBase* DeviceBase::APICreateBindSetLayout(const BindSetLayoutDesc& desc)
     {
         Ref<BindSetLayoutBase> bindSetLayout = GetOrCreateBindSetLayout(desc);
@@ -159,7 +337,15 @@ namespace rhi::impl
 
     BindSetBase* DeviceBase::APICreateBindSet(const BindSetDesc& desc)
     {
-        Ref<BindSetBase> bindSet = CreateBindSetImpl(desc);
+        INVALID_IF(desc.layout->IsPushDescriptor(), "Bind sets can't be created from a push descriptor layout.");
+        Ref<BindSetBase> bindSet = GetOrCreateBindSet(desc);
+        return bindSet.Detach();
+    }
+
+    BindSetBase* DeviceBase::APICreateTransientBindSet(const BindSetDesc& desc)
+    {
+        INVALID_IF(desc.layout->IsPushDescriptor(), "Bind sets can't be created from a push descriptor layout.");
+        Ref<BindSetBase> bindSet = CreateTransientBindSetImpl(desc);
         return bindSet.Detach();
     }
 
@@ -177,7 +363,7 @@ namespace rhi::impl
 
     ShaderModuleBase* DeviceBase::APICreateShader(const ShaderModuleDesc& desc)
     {
-        Ref<ShaderModuleBase> shader = CreateShaderImpl(desc);
+        Ref<ShaderModuleBase> shader = GetOrCreateShaderModule(desc);
         return shader.Detach();
     }
 
@@ -281,6 +467,136 @@ namespace rhi::impl
         return result;
     }
 
+    Ref<BindSetBase> DeviceBase::GetOrCreateBindSet(const BindSetDesc& desc)
+    {
+        BindSetBase key(this, desc);
+        const size_t hash = key.ComputeContentHash();
+        key.SetContentHash(hash);
+
+        Ref<BindSetBase> result = mCaches->bindSets.Find(&key);
+        if (result != nullptr)
+        {
+            mBindSetCacheHits.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+        mBindSetCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+        result = CreateBindSetImpl(desc);
+        if (result == nullptr)
+        {
+            return nullptr;
+        }
+        result->SetContentHash(hash);
+        // Another thread may have cached an identical bind set in the meantime, the one created here is then dropped.
+        bool inserted;
+        std::tie(result, inserted) = mCaches->bindSets.Insert(result.Get());
+        if (inserted)
+        {
+            std::lock_guard<std::mutex> lock(mCaches->bindSetsByResourceMutex);
+            for (const ResourceBase* resource : result->GetResources())
+            {
+                mCaches->bindSetsByResource[resource].push_back(result.Get());
+            }
+        }
+        return result;
+    }
+
+    void DeviceBase::EvictCachedBindSets(const ResourceBase* resource)
+    {
+        // The lock is held while the bind sets are uncached, they can't be destroyed before they unregistered.
+        std::lock_guard<std::mutex> lock(mCaches->bindSetsByResourceMutex);
+        auto it = mCaches->bindSetsByResource.find(resource);
+        if (it == mCaches->bindSetsByResource.end())
+        {
+            return;
+        }
+        for (BindSetBase* bindSet : it->second)
+        {
+            bindSet->Uncache();
+        }
+        mCaches->bindSetsByResource.erase(it);
+    }
+
+    void DeviceBase::UncacheBindSet(BindSetBase* bindSet)
+    {
+        // Uncached under the lock so that it doesn't race with EvictCachedBindSets.
+        std::lock_guard<std::mutex> lock(mCaches->bindSetsByResourceMutex);
+        bindSet->Uncache();
+        for (const ResourceBase* resource : bindSet->GetResources())
+        {
+            auto it = mCaches->bindSetsByResource.find(resource);
+            if (it == mCaches->bindSetsByResource.end())
+            {
+                continue;
+            }
+            std::vector<BindSetBase*>& bindSets = it->second;
+            bindSets.erase(std::remove(bindSets.begin(), bindSets.end(), bindSet), bindSets.end());
+            if (bindSets.empty())
+            {
+                mCaches->bindSetsByResource.erase(it);
+            }
+        }
+    }
+
+    void DeviceBase::APIGetBindSetCacheStats(BindSetCacheStats* stats) const
+    {
+        stats->hits = mBindSetCacheHits.load(std::memory_order_relaxed);
+        stats->misses = mBindSetCacheMisses.load(std::memory_order_relaxed);
+        stats->cachedBindSets = mCaches->bindSets.Size();
+    }
+
+    Ref<ShaderModuleBase> DeviceBase::GetOrCreateShaderModule(const ShaderModuleDesc& desc)
+    {
+        ShaderModuleBase key(this, desc);
+        const size_t hash = key.ComputeContentHash();
+        key.SetContentHash(hash);
+
+        Ref<ShaderModuleBase> result = mCaches->shaderModules.Find(&key);
+        if (result != nullptr)
+        {
+            mShaderModuleCacheHits.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+        mShaderModuleCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+        result = CreateShaderImpl(desc);
+        if (result == nullptr)
+        {
+            return nullptr;
+        }
+        result->SetContentHash(hash);
+        // Another thread may have cached the same module in the meantime, the one created here is then dropped.
+        std::tie(result, std::ignore) = mCaches->shaderModules.Insert(result.Get());
+        return result;
+    }
+
+    void DeviceBase::APIGetShaderModuleCacheStats(ShaderModuleCacheStats* stats) const
+    {
+        stats->hits = mShaderModuleCacheHits.load(std::memory_order_relaxed);
+        stats->misses = mShaderModuleCacheMisses.load(std::memory_order_relaxed);
+        stats->cachedShaderModules = mCaches->shaderModules.Size();
+    }
+
+    Ref<RenderPipelineBase> DeviceBase::GetOrInsertRenderPipeline(Ref<RenderPipelineBase> pipeline)
+    {
+        return GetOrInsertPipeline(
+                mCaches->renderPipelines, std::move(pipeline), mPipelineCacheHits, mPipelineCacheMisses);
+    }
+
+    Ref<ComputePipelineBase> DeviceBase::GetOrInsertComputePipeline(Ref<ComputePipelineBase> pipeline)
+    {
+        return GetOrInsertPipeline(
+                mCaches->computePipelines, std::move(pipeline), mPipelineCacheHits, mPipelineCacheMisses);
+    }
+
+    void DeviceBase::APIGetPipelineObjectCacheStats(PipelineObjectCacheStats* stats) const
+    {
+        stats->hits = mPipelineCacheHits.load(std::memory_order_relaxed);
+        stats->misses = mPipelineCacheMisses.load(std::memory_order_relaxed);
+        stats->cachedRenderPipelines = mCaches->renderPipelines.Size();
+        stats->cachedComputePipelines = mCaches->computePipelines.Size();
+    }
+
     BindSetLayoutBase* DeviceBase::GetEmptyBindSetLayout()
     {
         return mEmptyBindSetLayout.Get();
@@ -291,6 +607,36 @@ namespace rhi::impl
         return mCallbackTaskManager;
     }
 
+    CommandBlockPool* DeviceBase::GetCommandBlockPool() const
+    {
+        return mCommandBlockPool.Get();
+    }
+
+    void DeviceBase::AddElidedCommandCount(uint64_t count)
+    {
+        mElidedCommandCount.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    uint64_t DeviceBase::GetElidedCommandCount() const
+    {
+        return mElidedCommandCount.load(std::memory_order_relaxed);
+    }
+
+    WorkerTaskPool* DeviceBase::GetCommandRecordingPool() const
+    {
+        return mCommandRecordingPool.get();
+    }
+
+    bool DeviceBase::IsAsyncSubmissionEnabled() const
+    {
+        return mAsyncSubmission;
+    }
+
+    uint64_t DeviceBase::GetUploadRingBufferSize() const
+    {
+        return mUploadRingBufferSize;
+    }
+
     void DeviceBase::CreateEmptyBindSetLayout()
     {
         BindSetLayoutDesc desc{};
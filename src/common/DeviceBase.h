@@ -8,9 +8,15 @@
 #include "CallbackTaskManager.h"
 #include "QueueBase.h"
 #include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 namespace rhi::impl
 {
+    class CommandBlockPool;
+    class WorkerTaskPool;
+
     class DeviceBase : public RefCounted
     {
     public:
@@ -20,15 +26,27 @@ namespace rhi::impl
         PipelineLayoutBase* APICreatePipelineLayout2(const PipelineLayoutDesc2& desc);
         RenderPipelineBase* APICreateRenderPipeline(const RenderPipelineDesc& desc);
         ComputePipelineBase* APICreateComputePipeline(const ComputePipelineDesc& desc);
+        void APICreateRenderPipelineAsync(const RenderPipelineDesc& desc,
+                                          CreateRenderPipelineAsyncCallback callback,
+                                          void* userData);
+        void APICreateComputePipelineAsync(const ComputePipelineDesc& desc,
+                                           CreateComputePipelineAsyncCallback callback,
+                                           void* userData);
         PipelineCacheBase* APICreatePipelineCache(const PipelineCacheDesc& desc);
+        ResourceHeapBase* APICreateResourceHeap(const ResourceHeapDesc& desc);
         BindSetLayoutBase* APICreateBindSetLayout(const BindSetLayoutDesc& desc);
         BindSetBase* APICreateBindSet(const BindSetDesc& desc);
+        BindSetBase* APICreateTransientBindSet(const BindSetDesc& desc);
         TextureBase* APICreateTexture(const TextureDesc& desc);
         BufferBase* APICreateBuffer(const BufferDesc& desc);
         ShaderModuleBase* APICreateShader(const ShaderModuleDesc& desc);
         SamplerBase* APICreateSampler(const SamplerDesc& desc);
         CommandEncoder* APICreateCommandEncoder();
+        RenderBundleEncoder* APICreateRenderBundleEncoder();
         void APITick();
+        void APIGetBindSetCacheStats(BindSetCacheStats* stats) const;
+        void APIGetPipelineObjectCacheStats(PipelineObjectCacheStats* stats) const;
+        void APIGetShaderModuleCacheStats(ShaderModuleCacheStats* stats) const;
 
         Ref<QueueBase> GetQueue(QueueType queueType);
 
@@ -36,17 +54,34 @@ namespace rhi::impl
         Ref<PipelineLayoutBase> GetOrCreatePipelineLayout2(const PipelineLayoutDesc2& desc);
         Ref<BindSetLayoutBase> GetOrCreateBindSetLayout(const BindSetLayoutDesc& desc);
         Ref<SamplerBase> GetOrCreateSampler(const SamplerDesc& desc);
+        // Bind sets with the same layout and entries are shared while one of them is alive.
+        Ref<BindSetBase> GetOrCreateBindSet(const BindSetDesc& desc);
+        // Evicts the cached bind sets referencing the resource, so that a resource created later at the same address
+        // doesn't match them.
+        void EvictCachedBindSets(const ResourceBase* resource);
+        // Removes the bind set from the cache, it stays usable by the holders of a reference.
+        void UncacheBindSet(BindSetBase* bindSet);
+        Ref<ShaderModuleBase> GetOrCreateShaderModule(const ShaderModuleDesc& desc);
+        // Runs the task on the pipeline compilation threads, unless the device is shutting down by then.
+        void PostPipelineCompilationTask(std::function<void()> task);
+        Ref<RenderPipelineBase> GetOrInsertRenderPipeline(Ref<RenderPipelineBase> pipeline);
+        Ref<ComputePipelineBase> GetOrInsertComputePipeline(Ref<ComputePipelineBase> pipeline);
 
         virtual Ref<SwapChainBase> CreateSwapChainImpl(SurfaceBase* surface,
                                                    SwapChainBase* previous,
                                                    const SurfaceConfiguration& config) = 0;
         virtual Ref<PipelineLayoutBase> CreatePipelineLayoutImpl(const PipelineLayoutDesc& desc) = 0;
         virtual Ref<PipelineLayoutBase> CreatePipelineLayout2Impl(const PipelineLayoutDesc2& desc) = 0;
-        virtual Ref<RenderPipelineBase> CreateRenderPipelineImpl(const RenderPipelineDesc& desc) = 0;
-        virtual Ref<ComputePipelineBase> CreateComputePipelineImpl(const ComputePipelineDesc& desc) = 0;
+        // The returned pipelines are compiled later with PipelineBase::Initialize, once they were looked up in the
+        // pipeline cache.
+        virtual Ref<RenderPipelineBase> CreateUninitializedRenderPipelineImpl(const RenderPipelineDesc& desc) = 0;
+        virtual Ref<ComputePipelineBase> CreateUninitializedComputePipelineImpl(const ComputePipelineDesc& desc) = 0;
         virtual Ref<PipelineCacheBase> CreatePipelineCacheImpl(const PipelineCacheDesc& desc) = 0;
+        virtual Ref<ResourceHeapBase> CreateResourceHeapImpl(const ResourceHeapDesc& desc) = 0;
         virtual Ref<BindSetLayoutBase> CreateBindSetLayoutImpl(const BindSetLayoutDesc& desc) = 0;
         virtual Ref<BindSetBase> CreateBindSetImpl(const BindSetDesc& desc) = 0;
+        // Transient bind sets are neither cached nor freed one by one, their descriptors are recycled per Tick.
+        virtual Ref<BindSetBase> CreateTransientBindSetImpl(const BindSetDesc& desc) = 0;
         virtual Ref<TextureBase> CreateTextureImpl(const TextureDesc& desc) = 0;
         virtual Ref<BufferBase> CreateBufferImpl(const BufferDesc& desc, QueueType initialQueueOwner = QueueType::Undefined) = 0;
         virtual Ref<ShaderModuleBase> CreateShaderImpl(const ShaderModuleDesc& desc) = 0;
@@ -58,6 +93,15 @@ namespace rhi::impl
         bool IsDebugLayerEnabled() const;
         BindSetLayoutBase* GetEmptyBindSetLayout();
         CallbackTaskManager& GetCallbackTaskManager();
+        CommandBlockPool* GetCommandBlockPool() const;
+        void AddElidedCommandCount(uint64_t count);
+        // Total number of redundant state commands dropped by pass encoders of this device.
+        uint64_t GetElidedCommandCount() const;
+        // Workers used to translate command lists in parallel at submit time, nullptr if disabled.
+        WorkerTaskPool* GetCommandRecordingPool() const;
+        bool IsAsyncSubmissionEnabled() const;
+        // Configured size of the upload ring buffers, 0 if the default is used.
+        uint64_t GetUploadRingBufferSize() const;
 
     protected:
         explicit DeviceBase(AdapterBase* adapter, const DeviceDesc& desc);
@@ -66,11 +110,18 @@ namespace rhi::impl
         bool HasRequiredFeature(FeatureName feature);
         void CreateEmptyBindSetLayout();
         void DestroyObjects();
+        // Cancels the queued pipeline compilations, waits for the running ones and reports every pending callback as
+        // destroyed. Called before the backend objects are torn down.
+        void ShutDownAsyncWork();
+        virtual void TickImpl() = 0;
         Ref<AdapterBase> mAdapter;
         std::array<Ref<QueueBase>, 3> mQueues;
 
     private:
         void SetFeatures(const DeviceDesc& desc);
+        WorkerTaskPool* GetPipelineCompilationPool();
+        template <typename Pipeline, typename Callback>
+        void InitializePipelineAsync(Ref<Pipeline> pipeline, PipelineCacheBase* cache, Callback callback, void* userData);
 
         FeatureSet mRequiredFeatures;
 
@@ -81,7 +132,30 @@ namespace rhi::impl
 
         CallbackTaskManager mCallbackTaskManager;
 
+        Ref<CommandBlockPool> mCommandBlockPool;
+
+        std::atomic<uint64_t> mElidedCommandCount = 0;
+
+        std::unique_ptr<WorkerTaskPool> mCommandRecordingPool;
+
+        bool mAsyncSubmission = false;
+
+        uint64_t mUploadRingBufferSize = 0;
+
+        // The compilation threads are only started by the first asynchronous pipeline creation.
+        uint32_t mPipelineCompilationThreadCount = 0;
+        std::once_flag mPipelineCompilationPoolOnce;
+        std::unique_ptr<WorkerTaskPool> mPipelineCompilationPool;
+        std::atomic<bool> mPipelineCompilationCancelled = false;
+
         struct Cache;
         std::unique_ptr<Cache> mCaches;
+
+        std::atomic<uint64_t> mBindSetCacheHits = 0;
+        std::atomic<uint64_t> mBindSetCacheMisses = 0;
+        std::atomic<uint64_t> mShaderModuleCacheHits = 0;
+        std::atomic<uint64_t> mShaderModuleCacheMisses = 0;
+        std::atomic<uint64_t> mPipelineCacheHits = 0;
+        std::atomic<uint64_t> mPipelineCacheMisses = 0;
     };
 }
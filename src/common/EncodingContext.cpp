@@ -1,7 +1,12 @@
 #include "EncodingContext.h"
+#include "DeviceBase.h"
 
 namespace rhi::impl
 {
+    EncodingContext::EncodingContext(DeviceBase* device)
+        : mCommandAllocator(device->GetCommandBlockPool())
+    {}
+
     CommandAllocator& EncodingContext::GetCommandAllocator()
     {
         return mCommandAllocator;
@@ -12,6 +12,7 @@ namespace rhi::impl
     class EncodingContext
     {
     public:
+        explicit EncodingContext(DeviceBase* device);
         CommandAllocator& GetCommandAllocator();
         CommandIterator AcquireCommands();
         std::vector<SyncScopeResourceUsage> AcquireRenderPassUsages();
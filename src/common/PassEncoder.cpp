@@ -1,25 +1,43 @@
 #include "PassEncoder.h"
 #include "CommandEncoder.h"
 #include "Commands.h"
+#include "DeviceBase.h"
 #include "PipelineBase.h"
 #include "PipelineLayoutBase.h"
+#include "ResourceHeapBase.h"
+#include "SamplerBase.h"
+#include "TextureBase.h"
 #include "common/Error.h"
 
 namespace rhi::impl
 {
-    PassEncoder::PassEncoder(CommandEncoder* encoder, EncodingContext& encodingContext)
-        : mCommandEncoder(encoder)
+    PassEncoder::PassEncoder(DeviceBase* device, CommandEncoder* encoder, EncodingContext& encodingContext)
+        : mDevice(device)
         , mEncodingContext(encodingContext)
+        , mCommandEncoder(encoder)
     {}
 
     PassEncoder::~PassEncoder() {}
 
-    void PassEncoder::RecordSetBindSet(BindSetBase* set,
+    bool PassEncoder::RecordSetBindSet(BindSetBase* set,
                                        uint32_t setIndex,
                                        uint32_t dynamicOffsetCount,
                                        const uint32_t* dynamicOffsets)
     {
         INVALID_IF(mLastPipeline == nullptr, "Must set pipeline before set BindSet.");
+        ASSERT(setIndex < cMaxBindSets);
+
+        BindSetState& state = mBindSets[setIndex];
+        if (state.set == set && state.dynamicOffsets.size() == dynamicOffsetCount &&
+            (dynamicOffsetCount == 0 ||
+             memcmp(state.dynamicOffsets.data(), dynamicOffsets, dynamicOffsetCount * sizeof(uint32_t)) == 0))
+        {
+            ElideCommand();
+            return false;
+        }
+        state.set = set;
+        state.dynamicOffsets.assign(dynamicOffsets, dynamicOffsets + dynamicOffsetCount);
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
         SetBindSetCmd* cmd = allocator.Allocate<SetBindSetCmd>(Command::SetBindSet);
         cmd->set = set;
@@ -30,6 +48,111 @@ namespace rhi::impl
             uint32_t* offsets = allocator.AllocateData<uint32_t>(dynamicOffsetCount);
             memcpy(offsets, dynamicOffsets, dynamicOffsetCount * sizeof(uint32_t));
         }
+        return true;
+    }
+
+    BindSetLayoutBase* PassEncoder::RecordPushBindings(uint32_t setIndex,
+                                                       uint32_t entryCount,
+                                                       const BindSetEntry* entries)
+    {
+        INVALID_IF(mLastPipeline == nullptr, "Must set pipeline before push bindings.");
+        ASSERT(setIndex < cMaxBindSets);
+        ASSERT(entryCount == 0 || entries != nullptr);
+
+        BindSetLayoutBase* layout = mLastPipeline->GetLayout()->GetBindSetLayout(setIndex);
+        INVALID_IF(layout == nullptr || !layout->IsPushDescriptor(),
+                   "The bind set layout at index %u is not a push descriptor layout.",
+                   setIndex);
+
+        // The pushed bindings replace whatever bind set was bound at this index.
+        mBindSets[setIndex] = {};
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        PushBindingsCmd* cmd = allocator.Allocate<PushBindingsCmd>(Command::PushBindings);
+        cmd->layout = layout;
+        cmd->setIndex = setIndex;
+        cmd->entryCount = entryCount;
+        PushBinding* bindings = allocator.AllocateData<PushBinding>(entryCount);
+        for (uint32_t i = 0; i < entryCount; ++i)
+        {
+            bindings[i].binding = entries[i].binding;
+            bindings[i].arrayElementIndex = entries[i].arrayElementIndex;
+            bindings[i].textureView = entries[i].textureView;
+            bindings[i].sampler = entries[i].sampler;
+            bindings[i].buffer = entries[i].buffer;
+            bindings[i].bufferOffset = entries[i].bufferOffset;
+            bindings[i].bufferRange = entries[i].bufferRange;
+        }
+        return layout;
+    }
+
+    const Ref<ResourceBase>* PassEncoder::RecordUseResidentResources(ResourceHeapBase* heap,
+                                                                     ResourceHeapSlotType type,
+                                                                     uint32_t slotCount,
+                                                                     const uint32_t* slots,
+                                                                     uint32_t* resourceCount)
+    {
+        INVALID_IF(heap == nullptr, "The resource heap is null.");
+        *resourceCount = 0;
+        if (type == ResourceHeapSlotType::Sampler)
+        {
+            return nullptr;
+        }
+
+        std::vector<Ref<ResourceBase>> resources = heap->GetResidentResources(type, slotCount, slots);
+        if (resources.empty())
+        {
+            return nullptr;
+        }
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        UseResidentResourcesCmd* cmd = allocator.Allocate<UseResidentResourcesCmd>(Command::UseResidentResources);
+        cmd->heap = heap;
+        cmd->resourceCount = static_cast<uint32_t>(resources.size());
+        Ref<ResourceBase>* recordedResources = allocator.AllocateData<Ref<ResourceBase>>(resources.size());
+        std::move(resources.begin(), resources.end(), recordedResources);
+
+        *resourceCount = cmd->resourceCount;
+        return recordedResources;
+    }
+
+    bool PassEncoder::ShouldSetPipeline(PipelineBase* pipeline)
+    {
+        if (mLastPipeline == pipeline)
+        {
+            ElideCommand();
+            return false;
+        }
+
+        if (mLastPipeline == nullptr || mLastPipeline->GetLayout() != pipeline->GetLayout())
+        {
+            mBindSets = {};
+            mPushConstants = {};
+        }
+        mLastPipeline = pipeline;
+        return true;
+    }
+
+    void PassEncoder::ElideCommand()
+    {
+        ++mElidedCommandCount;
+    }
+
+    void PassEncoder::ReportElidedCommands()
+    {
+        mDevice->AddElidedCommandCount(mElidedCommandCount);
+    }
+
+    void PassEncoder::ResetBoundState()
+    {
+        mLastPipeline = nullptr;
+        mBindSets = {};
+        mPushConstants = {};
+    }
+
+    uint64_t PassEncoder::GetElidedCommandCount() const
+    {
+        return mElidedCommandCount;
     }
 
     void PassEncoder::APISetPushConstant(ShaderStage stage, const void* data, uint32_t size, uint32_t offset)
@@ -40,6 +163,16 @@ namespace rhi::impl
         ASSERT(offset + size <= mLastPipeline->GetLayout()->GetPushConstantRange(stage).value().size);
         INVALID_IF(size % 4 != 0, "PushConstant size (%u) is not  a multiple of 4.", size);
 
+        if (mPushConstants.stage == stage && mPushConstants.offset == offset && mPushConstants.data.size() == size &&
+            memcmp(mPushConstants.data.data(), data, size) == 0)
+        {
+            ElideCommand();
+            return;
+        }
+        mPushConstants.stage = stage;
+        mPushConstants.offset = offset;
+        mPushConstants.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
         SetPushConstantCmd* cmd = allocator.Allocate<SetPushConstantCmd>(Command::SetPushConstant);
         cmd->size = size;
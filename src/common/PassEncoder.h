@@ -2,29 +2,74 @@
 
 #include "EncodingContext.h"
 #include "RHIStruct.h"
+#include "common/Constants.h"
 #include "common/Ref.hpp"
 #include "common/RefCounted.h"
 
+#include <array>
+#include <vector>
+
 namespace rhi::impl
 {
     class PassEncoder : public RefCounted
     {
     public:
-        explicit PassEncoder(CommandEncoder* encoder, EncodingContext& encodingContext);
+        // encoder is null for encoders that record outside of a command encoder, like render bundles.
+        explicit PassEncoder(DeviceBase* device, CommandEncoder* encoder, EncodingContext& encodingContext);
         ~PassEncoder();
         void APISetPushConstant(ShaderStage stage, const void* data, uint32_t size, uint32_t offset);
         void APIBeginDebugLabel(std::string_view label, const Color* color);
         void APIEndDebugLabel();
 
+        // Number of state commands dropped because they matched the state already bound in this pass.
+        uint64_t GetElidedCommandCount() const;
+
     protected:
-        void RecordSetBindSet(BindSetBase* set,
+        // Returns false if the bind set and dynamic offsets are already bound at setIndex.
+        bool RecordSetBindSet(BindSetBase* set,
                               uint32_t setIndex,
                               uint32_t dynamicOffsetCount = 0,
                               const uint32_t* dynamicOffsets = nullptr);
+        // Records the bindings of the push descriptor layout at setIndex of the bound pipeline, and returns that layout.
+        BindSetLayoutBase* RecordPushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries);
+        // Records the resources of the heap slots read by the pass, and returns them. Samplers have no usage state and
+        // are skipped.
+        const Ref<ResourceBase>* RecordUseResidentResources(ResourceHeapBase* heap,
+                                                            ResourceHeapSlotType type,
+                                                            uint32_t slotCount,
+                                                            const uint32_t* slots,
+                                                            uint32_t* resourceCount);
+        // Returns false if the pipeline is already bound. Switching to a pipeline with a different layout
+        // forgets the bound bind sets and push constants as they may be disturbed by the new layout.
+        bool ShouldSetPipeline(PipelineBase* pipeline);
+        void ElideCommand();
+        void ReportElidedCommands();
+        // Forgets the bound pipeline, bind sets and push constants, e.g. after they were changed by a render bundle.
+        void ResetBoundState();
+
+        DeviceBase* mDevice;
         EncodingContext& mEncodingContext;
         Ref<CommandEncoder> mCommandEncoder;
         bool mIsEnded = false;
         uint64_t mDebugLabelCount = 0;
         PipelineBase* mLastPipeline = nullptr;
+
+    private:
+        struct BindSetState
+        {
+            BindSetBase* set = nullptr;
+            std::vector<uint32_t> dynamicOffsets;
+        };
+        std::array<BindSetState, cMaxBindSets> mBindSets;
+
+        struct PushConstantState
+        {
+            ShaderStage stage = ShaderStage::None;
+            uint32_t offset = 0;
+            std::vector<uint8_t> data;
+        };
+        PushConstantState mPushConstants;
+
+        uint64_t mElidedCommandCount = 0;
     };
 } // namespace rhi::impl
@@ -1,5 +1,7 @@
 #include "PipelineBase.h"
 #include "BindSetLayoutBase.h"
+#include "EnumFlagIterator.hpp"
+#include "ObjectContentHasher.h"
 #include "PipelineLayoutBase.h"
 #include "ShaderModuleBase.h"
 #include "common/Error.h"
@@ -32,6 +34,69 @@ namespace rhi::impl
 
     PipelineBase::~PipelineBase() = default;
 
+    bool PipelineBase::Initialize(PipelineCacheBase* cache)
+    {
+        // Identical pipelines created concurrently share this object, the lock makes them wait for one compilation.
+        std::lock_guard<std::mutex> lock(mInitializeMutex);
+        if (mInitializeState == InitializeState::Uninitialized)
+        {
+            mInitializeState = InitializeImpl(cache) ? InitializeState::Succeeded : InitializeState::Failed;
+            if (mInitializeState == InitializeState::Succeeded)
+            {
+                TrackResource();
+            }
+            else
+            {
+                // Failed pipelines are never tracked, release what was created and drop them from the device cache.
+                DestroyImpl();
+            }
+        }
+        return mInitializeState == InitializeState::Succeeded;
+    }
+
+    void PipelineBase::RecordLayoutAndStages(ObjectContentHasher* recorder) const
+    {
+        recorder->Record(mPipelineLayout != nullptr ? mPipelineLayout->GetContentHash() : 0);
+        recorder->Record(mShaderStageMask);
+        for (ShaderStage stage : IterateEnumFlags(mShaderStageMask))
+        {
+            const ShaderStageState& state = mShaderStageStates[stage];
+            recorder->Record(state.shaderModule->GetContentHash());
+            for (const SpecializationConstant& constant : state.constants)
+            {
+                recorder->Record(constant.constantID, constant.value.u);
+            }
+        }
+    }
+
+    bool PipelineBase::IsLayoutAndStagesEqual(const PipelineBase* other) const
+    {
+        if (mPipelineLayout != other->mPipelineLayout || mShaderStageMask != other->mShaderStageMask)
+        {
+            return false;
+        }
+
+        for (ShaderStage stage : IterateEnumFlags(mShaderStageMask))
+        {
+            const ShaderStageState& a = mShaderStageStates[stage];
+            const ShaderStageState& b = other->mShaderStageStates[stage];
+            // Shader modules are deduplicated, so identical code always yields the same module.
+            if (a.shaderModule != b.shaderModule || a.constants.size() != b.constants.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < a.constants.size(); ++i)
+            {
+                if (a.constants[i].constantID != b.constants[i].constantID ||
+                    a.constants[i].value.u != b.constants[i].value.u)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     void PipelineBase::AddShaderStageState(const ShaderState* shader, ShaderStage stage)
     {
         if (!shader)
@@ -5,8 +5,11 @@
 #include "ResourceBase.h"
 #include "common/Ref.hpp"
 
+#include <mutex>
+
 namespace rhi::impl
 {
+    class ObjectContentHasher;
     class DeviceBase;
     class BindSetLayoutBase;
     class PipelineLayoutBase;
@@ -28,17 +31,35 @@ namespace rhi::impl
         ShaderStage GetShaderStageMask() const;
         bool HasShaderStage(ShaderStage stage) const;
         const ShaderStageState& GetShaderStageState(ShaderStage stage) const;
+        // Compiles the backend pipeline and tracks it once that succeeded. Pipelines created asynchronously run this
+        // on a pipeline compilation thread. Only the first call compiles, concurrent callers wait for its result.
+        bool Initialize(PipelineCacheBase* cache);
 
     protected:
         explicit PipelineBase(DeviceBase* device, const RenderPipelineDesc& desc);
         explicit PipelineBase(DeviceBase* device, const ComputePipelineDesc& desc);
         ~PipelineBase() override;
         void AddShaderStageState(const ShaderState* shader, ShaderStage stage);
+        virtual bool InitializeImpl(PipelineCacheBase* cache) = 0;
+        // The layout and shader stages, shared by the content hash of render and compute pipelines.
+        void RecordLayoutAndStages(ObjectContentHasher* recorder) const;
+        bool IsLayoutAndStagesEqual(const PipelineBase* other) const;
 
         Ref<PipelineLayoutBase> mPipelineLayout;
 
         ShaderStage mShaderStageMask = ShaderStage::None;
 
         PerShaderStage<ShaderStageState> mShaderStageStates;
+
+    private:
+        enum class InitializeState
+        {
+            Uninitialized,
+            Succeeded,
+            Failed,
+        };
+
+        std::mutex mInitializeMutex;
+        InitializeState mInitializeState = InitializeState::Uninitialized;
     };
 } // namespace rhi::impl
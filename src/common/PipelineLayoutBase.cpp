@@ -1,6 +1,5 @@
 #include "PipelineLayoutBase.h"
 #include <array>
-#include <spirv_reflect.h>
 #include <vector>
 #include "BindSetLayoutBase.h"
 #include "DeviceBase.h"
@@ -12,58 +11,6 @@
 
 namespace rhi::impl
 {
-    BindingType ToBindingType(SpvReflectDescriptorType descriptorType)
-    {
-        switch (descriptorType)
-        {
-        case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER:
-            return BindingType::Sampler;
-        case SPV_REFLECT_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-            return BindingType::CombinedTextureSampler;
-        case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
-            return BindingType::SampledTexture;
-        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-            return BindingType::StorageTexture;
-        case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
-        case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
-            return BindingType::UniformBuffer;
-        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-        case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-            return BindingType::StorageBuffer;
-        case SPV_REFLECT_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
-            return BindingType::None; // todo : add ACCELERATION_STRUCTURE support?
-        default:
-            ASSERT(!"Unreachable");
-            return BindingType::None;
-        }
-    }
-
-    ShaderStage ToShaderStage(SpvReflectShaderStageFlagBits stage)
-    {
-        switch (stage)
-        {
-        case SPV_REFLECT_SHADER_STAGE_VERTEX_BIT:
-            return ShaderStage::Vertex;
-        case SPV_REFLECT_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
-            return ShaderStage::TessellationControl;
-        case SPV_REFLECT_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
-            return ShaderStage::TessellationEvaluation;
-        case SPV_REFLECT_SHADER_STAGE_GEOMETRY_BIT:
-            return ShaderStage::Geometry;
-        case SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT:
-            return ShaderStage::Fragment;
-        case SPV_REFLECT_SHADER_STAGE_COMPUTE_BIT:
-            return ShaderStage::Compute;
-        case SPV_REFLECT_SHADER_STAGE_TASK_BIT_NV:
-            return ShaderStage::Task;
-        case SPV_REFLECT_SHADER_STAGE_MESH_BIT_NV:
-            return ShaderStage::Mesh;
-        default:
-            ASSERT(!"Unreachable");
-            return ShaderStage::None;
-        }
-    }
-
     PipelineLayoutBase::PipelineLayoutBase(DeviceBase* device, const PipelineLayoutDesc& desc)
         : ResourceBase(device, desc.name)
     {
@@ -95,45 +42,18 @@ namespace rhi::impl
 
         for (uint32_t i = 0; i < desc.shaderCount; ++i)
         {
-            ShaderModuleBase* shader = desc.shaders[i];
-            SpvReflectShaderModule reflectModule{};
-            SpvReflectResult result = spvReflectCreateShaderModule(
-                    shader->GetSpirvData().size() * sizeof(uint32_t), shader->GetSpirvData().data(), &reflectModule);
-            ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
-
-
-            for (uint32_t bindingIndex = 0; bindingIndex < reflectModule.descriptor_binding_count; ++bindingIndex)
+            const ShaderReflection& reflection = desc.shaders[i]->GetReflection();
+            for (uint32_t setIndex = 0; setIndex < cMaxBindSets; ++setIndex)
             {
-                const SpvReflectDescriptorBinding& reflectBinding = reflectModule.descriptor_bindings[bindingIndex];
-
-                BindSetLayoutEntry entry{};
-                entry.binding = reflectBinding.binding;
-                entry.type = ToBindingType(reflectBinding.descriptor_type);
-                entry.arrayElementCount = 1;
-                for (uint32_t dim = 0; dim < reflectBinding.array.dims_count; ++dim)
-                {
-                    entry.arrayElementCount *= reflectBinding.array.dims[dim];
-                }
-                entry.visibleStages = ToShaderStage(reflectModule.shader_stage);
-                entry.hasDynamicOffset =
-                        reflectBinding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
-                        reflectBinding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-
-                bindSetLayoutEntriesPerSet[reflectBinding.set].push_back(std::move(entry));
+                const std::vector<BindSetLayoutEntry>& bindings = reflection.bindingsPerSet[setIndex];
+                bindSetLayoutEntriesPerSet[setIndex].insert(
+                        bindSetLayoutEntriesPerSet[setIndex].end(), bindings.begin(), bindings.end());
             }
 
-            ASSERT(reflectModule.push_constant_block_count <= 1);
-            for (uint32_t pushConstantIndex = 0; pushConstantIndex < reflectModule.push_constant_block_count;
-                 ++pushConstantIndex)
+            if (reflection.pushConstantRange.has_value())
             {
-                PushConstantRange pcr{};
-                pcr.size = reflectModule.push_constant_blocks[pushConstantIndex].size;
-                pcr.visibility = ToShaderStage(reflectModule.shader_stage);
-
-                mPushConstantRanges[pcr.visibility] = pcr;
+                mPushConstantRanges[reflection.stage] = reflection.pushConstantRange;
             }
-
-            spvReflectDestroyShaderModule(&reflectModule);
         }
 
         for (uint32_t setIndex = 0; setIndex < cMaxBindSets; ++setIndex)
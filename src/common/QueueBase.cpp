@@ -1,19 +1,213 @@
 #include "QueueBase.h"
 #include "BufferBase.h"
+#include "CommandListBase.h"
 #include "DeviceBase.h"
 #include "TextureBase.h"
+#include "WorkerTaskPool.h"
 #include "common/Error.h"
 #include "common/Utils.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace rhi::impl
 {
+    namespace
+    {
+        // How long the completion thread sleeps in the driver before it checks whether it must stop.
+        constexpr uint64_t cCompletionWaitTimeoutNs = 100'000'000;
+
+        class SerialCompletedCallbackTask : public CallbackTask
+        {
+        public:
+            SerialCompletedCallbackTask(SerialCompletedCallback callback, void* userData)
+                : mCallback(callback)
+                , mUserData(userData)
+            {}
+
+        private:
+            void FinishImpl() override
+            {
+                mCallback(SerialCompletedStatus::Success, mUserData);
+            }
+
+            void HandleDeviceLossImpl() override
+            {
+                mCallback(SerialCompletedStatus::DeviceLost, mUserData);
+            }
+
+            void HandleShutDownImpl() override
+            {
+                mCallback(SerialCompletedStatus::DestroyedBeforeCallback, mUserData);
+            }
+
+            SerialCompletedCallback mCallback;
+            void* mUserData;
+        };
+    } // namespace
+
+    // Every readback of a serial completes through one task, which frees their staging memory once the callbacks
+    // have run.
+    class ReadbackBatchTask : public CallbackTask
+    {
+    public:
+        explicit ReadbackBatchTask(Ref<ReadbackAllocator> allocator)
+            : mAllocator(std::move(allocator))
+        {}
+
+        ~ReadbackBatchTask() override
+        {
+            for (const Request& request : mRequests)
+            {
+                mAllocator->Free(request.allocation);
+            }
+        }
+
+        void Add(const ReadbackAllocation& allocation, uint64_t size, ReadbackCallback callback, void* userData)
+        {
+            mRequests.push_back({allocation, size, callback, userData});
+        }
+
+    private:
+        void FinishImpl() override
+        {
+            for (const Request& request : mRequests)
+            {
+                request.allocation.buffer->InvalidateMappedRange(request.allocation.offset, request.size);
+                request.callback(ReadbackStatus::Success, request.allocation.mappedAddress, request.size, request.userData);
+            }
+        }
+
+        void HandleDeviceLossImpl() override
+        {
+            for (const Request& request : mRequests)
+            {
+                request.callback(ReadbackStatus::DeviceLost, nullptr, 0, request.userData);
+            }
+        }
+
+        void HandleShutDownImpl() override
+        {
+            for (const Request& request : mRequests)
+            {
+                request.callback(ReadbackStatus::DestroyedBeforeCallback, nullptr, 0, request.userData);
+            }
+        }
+
+        struct Request
+        {
+            ReadbackAllocation allocation;
+            uint64_t size;
+            ReadbackCallback callback;
+            void* userData;
+        };
+
+        Ref<ReadbackAllocator> mAllocator;
+        std::vector<Request> mRequests;
+    };
+
     QueueBase::QueueBase(DeviceBase* device, QueueType type)
         : mDevice(device)
         , mQueueType(type)
         , mUploadAllocator(std::make_unique<UploadAllocator>(device, this))
-    {}
+        , mUniformRingAllocator(std::make_unique<UniformRingAllocator>(device, this))
+        , mReadbackAllocator(ReadbackAllocator::Create(device, type))
+    {
+        if (device->IsAsyncSubmissionEnabled())
+        {
+            mSubmissionThread = std::make_unique<WorkerTaskPool>(1);
+        }
+    }
 
-    QueueBase::~QueueBase() = default;
+    QueueBase::~QueueBase()
+    {
+        StopCompletionThread();
+
+        // Readbacks recorded after the last submit never execute.
+        if (mPendingReadbacks != nullptr)
+        {
+            mPendingReadbacks->OnShutDown();
+            mPendingReadbacks->Execute();
+        }
+    }
+
+    void QueueBase::StartCompletionThread()
+    {
+        ASSERT(!mCompletionThread.joinable());
+        mCompletionThread = std::thread([this]() { CompletionThreadLoop(); });
+    }
+
+    void QueueBase::StopCompletionThread()
+    {
+        if (!mCompletionThread.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mCompletionMutex);
+            mStopCompletionThread = true;
+        }
+        mCompletionCondition.notify_one();
+        mCompletionThread.join();
+
+        // The callbacks of serials that did not complete are still called, telling that the queue went away first.
+        RunSerialCallbacks(UINT64_MAX, CallbackState::ShutDown);
+    }
+
+    void QueueBase::CompletionThreadLoop()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mCompletionMutex);
+                mCompletionCondition.wait(lock,
+                                          [this]()
+                                          { return mStopCompletionThread || mCompletionFlushRequested ||
+                                                   HasScheduledCommands(); });
+                if (mStopCompletionThread)
+                {
+                    return;
+                }
+                mCompletionFlushRequested = false;
+            }
+
+            if (HasScheduledCommands())
+            {
+                SerialWaitResult result = WaitForSerialImpl(GetCompletedSerial() + 1, cCompletionWaitTimeoutNs);
+                if (result == SerialWaitResult::Failed)
+                {
+                    // Waiting again would fail right away and spin, so the pending callbacks are told the device is
+                    // lost and the thread exits.
+                    mLost.store(true);
+                    RunSerialCallbacks(UINT64_MAX, CallbackState::DeviceLoss);
+                    return;
+                }
+                if (result == SerialWaitResult::Completed)
+                {
+                    CheckAndUpdateCompletedSerial();
+                }
+            }
+
+            uint64_t completedSerial = GetCompletedSerial();
+            MoveCompletedTasks(completedSerial);
+            mUploadAllocator->Deallocate(completedSerial);
+            mUniformRingAllocator->Deallocate(completedSerial);
+            mReadbackAllocator->Deallocate(completedSerial);
+            TickImpl(completedSerial);
+            // The other completed tasks may touch state owned by the device thread, they wait for Device::Tick.
+            RunSerialCallbacks(completedSerial);
+        }
+    }
+
+    void QueueBase::IncrementLastSubmittedSerial()
+    {
+        mLastSubmittedSerial.fetch_add(1u, std::memory_order_release);
+        {
+            // Taking the lock makes sure the completion thread is either before its check or already waiting.
+            std::lock_guard<std::mutex> lock(mCompletionMutex);
+        }
+        mCompletionCondition.notify_one();
+    }
 
     QueueType QueueBase::GetType() const
     {
@@ -27,7 +221,11 @@ namespace rhi::impl
 
     uint64_t QueueBase::GetPendingSubmitSerial() const
     {
-        return mLastSubmittedSerial.load(std::memory_order_acquire) + 1;
+        // While submissions are queued, the next commands recorded on the caller thread can only be submitted after
+        // all of them.
+        return std::max(mLastSubmittedSerial.load(std::memory_order_acquire),
+                        mLastEnqueuedSerial.load(std::memory_order_acquire)) +
+               1;
     }
 
     uint64_t QueueBase::GetCompletedSerial() const
@@ -43,7 +241,8 @@ namespace rhi::impl
 
     void QueueBase::TrackTask(std::unique_ptr<CallbackTask> callback, uint64_t serial)
     {
-        if (serial < GetCompletedSerial())
+        std::lock_guard<std::mutex> lock(mTasksMutex);
+        if (serial <= GetCompletedSerial())
         {
             mDevice->GetCallbackTaskManager().AddCallbackTask(std::move(callback));
         }
@@ -53,9 +252,9 @@ namespace rhi::impl
         }
     }
 
-    void QueueBase::Tick()
+    void QueueBase::MoveCompletedTasks(uint64_t completedSerial)
     {
-        uint64_t completedSerial = GetCompletedSerial();
+        std::lock_guard<std::mutex> lock(mTasksMutex);
         // Tasks' serials have passed. Move them to the callback task manager. They
         // are ready to be called.
         for (auto& task : mTasksInFlight.IterateUpTo(completedSerial))
@@ -63,8 +262,46 @@ namespace rhi::impl
             mDevice->GetCallbackTaskManager().AddCallbackTask(std::move(task));
         }
         mTasksInFlight.ClearUpTo(completedSerial);
+    }
+
+    void QueueBase::RunSerialCallbacks(uint64_t serial, CallbackState state)
+    {
+        std::vector<std::unique_ptr<CallbackTask>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(mTasksMutex);
+            for (auto& task : mSerialCallbacksInFlight.IterateUpTo(serial))
+            {
+                tasks.push_back(std::move(task));
+            }
+            mSerialCallbacksInFlight.ClearUpTo(serial);
+        }
+
+        // Called outside of the lock, so that the callbacks may register new ones.
+        for (auto& task : tasks)
+        {
+            switch (state)
+            {
+            case CallbackState::ShutDown:
+                task->OnShutDown();
+                break;
+            case CallbackState::DeviceLoss:
+                task->OnDeviceLoss();
+                break;
+            default:
+                break;
+            }
+            task->Execute();
+        }
+    }
+
+    void QueueBase::Tick()
+    {
+        uint64_t completedSerial = GetCompletedSerial();
+        MoveCompletedTasks(completedSerial);
 
         mUploadAllocator->Deallocate(completedSerial);
+        mUniformRingAllocator->Deallocate(completedSerial);
+        mReadbackAllocator->Deallocate(completedSerial);
 
         TickImpl(completedSerial);
     }
@@ -74,13 +311,166 @@ namespace rhi::impl
                                   ResourceTransfer const* transfers,
                                   uint32_t transferCount)
     {
-        return SubmitImpl(commands, commandListCount, transfers, transferCount);
+        if (mSubmissionThread != nullptr)
+        {
+            return SubmitAsync(commands, commandListCount, transfers, transferCount);
+        }
+        std::unique_lock<std::shared_mutex> lock(mSubmitMutex);
+        return EnqueueSubmitLocked([&]() { SubmitImpl(commands, commandListCount, transfers, transferCount); });
         // Tick();
     }
 
+    uint64_t QueueBase::SubmitAsync(CommandListBase* const* commands,
+                                    uint32_t commandListCount,
+                                    ResourceTransfer const* transfers,
+                                    uint32_t transferCount)
+    {
+        // The caller's arrays don't outlive this call, so the submission keeps its own copy of them.
+        struct PendingSubmission
+        {
+            std::vector<Ref<CommandListBase>> commandLists;
+            std::vector<CommandListBase*> commands;
+            std::vector<ResourceTransfer> transfers;
+            std::vector<std::vector<BufferBase*>> transferBuffers;
+            std::vector<std::vector<TextureSubresources>> transferTextures;
+        };
+        auto submission = std::make_shared<PendingSubmission>();
+
+        submission->commandLists.reserve(commandListCount);
+        submission->commands.reserve(commandListCount);
+        for (uint32_t i = 0; i < commandListCount; ++i)
+        {
+            ASSERT(commands[i] != nullptr);
+            submission->commandLists.emplace_back(commands[i]);
+            submission->commands.push_back(commands[i]);
+        }
+
+        submission->transfers.assign(transfers, transfers + transferCount);
+        submission->transferBuffers.resize(transferCount);
+        submission->transferTextures.resize(transferCount);
+        for (uint32_t i = 0; i < transferCount; ++i)
+        {
+            ResourceTransfer& transfer = submission->transfers[i];
+            INVALID_IF(transfer.receivingQueue == nullptr, "The receiving queue of resource transfer %u is null.", i);
+            submission->transferBuffers[i].assign(transfer.buffers, transfer.buffers + transfer.bufferCount);
+            submission->transferTextures[i].assign(transfer.textureSubresources,
+                                                   transfer.textureSubresources + transfer.textureSubresourceCount);
+            transfer.buffers = submission->transferBuffers[i].data();
+            transfer.textureSubresources = submission->transferTextures[i].data();
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mSubmitMutex);
+        return EnqueueSubmitLocked(
+                [this, submission]()
+                {
+                    SubmitImpl(submission->commands.data(),
+                               static_cast<uint32_t>(submission->commands.size()),
+                               submission->transfers.data(),
+                               static_cast<uint32_t>(submission->transfers.size()));
+                });
+    }
+
+    void QueueBase::EnqueueRecording(std::function<void()> record)
+    {
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        EnqueueRecordingLocked(std::move(record));
+    }
+
+    void QueueBase::EnqueueRecordingLocked(std::function<void()> record)
+    {
+        if (mSubmissionThread != nullptr)
+        {
+            // The submission thread is the only one touching the pending commands, so the recording lands after the
+            // submissions queued before and before the next one.
+            mSubmissionThread->PostTask(std::move(record));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mStagingCopyMutex);
+        record();
+    }
+
+    uint64_t QueueBase::EnqueueSubmit(std::function<void()> submit)
+    {
+        std::unique_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        return EnqueueSubmitLocked(std::move(submit));
+    }
+
+    uint64_t QueueBase::EnqueueSubmitLocked(std::function<void()> submit)
+    {
+        TrackPendingReadbacks();
+        if (mSubmissionThread == nullptr)
+        {
+            submit();
+            return GetLastSubmittedSerial();
+        }
+
+        const uint64_t serial = GetPendingSubmitSerial();
+        mLastEnqueuedSerial.store(serial, std::memory_order_release);
+        mSubmissionThread->PostTask(
+                [this, serial, submit = std::move(submit)]()
+                {
+                    // Every queued submission must signal its own serial, even when it records no commands.
+                    MarkRecordingContextIsUsed();
+                    submit();
+                    ASSERT(GetLastSubmittedSerial() == serial);
+                });
+        return serial;
+    }
+
+    void QueueBase::WaitForPendingSubmissions()
+    {
+        if (mSubmissionThread != nullptr && !mSubmissionThread->IsWorkerThread())
+        {
+            mSubmissionThread->WaitIdle();
+        }
+    }
+
+    bool QueueBase::APIWaitForSerial(uint64_t serial, uint64_t timeoutNs)
+    {
+        INVALID_IF(serial >= GetPendingSubmitSerial(), "Serial %u has not been submitted to the queue.", serial);
+        if (serial <= GetCompletedSerial())
+        {
+            return true;
+        }
+        // A serial still queued on the submission thread can be waited for, the driver allows waiting on a timeline
+        // value before the submission that signals it.
+        if (WaitForSerialImpl(serial, timeoutNs) != SerialWaitResult::Completed)
+        {
+            return false;
+        }
+        UpdateCompletedSerial(serial);
+        return true;
+    }
+
+    void QueueBase::APIOnSerialCompleted(uint64_t serial, SerialCompletedCallback callback, void* userData)
+    {
+        INVALID_IF(serial >= GetPendingSubmitSerial(), "Serial %u has not been submitted to the queue.", serial);
+        {
+            std::lock_guard<std::mutex> lock(mTasksMutex);
+            mSerialCallbacksInFlight.Push(serial, std::make_unique<SerialCompletedCallbackTask>(callback, userData));
+        }
+        if (mLost.load())
+        {
+            // The completion thread has exited, nothing else would run the callback.
+            RunSerialCallbacks(UINT64_MAX, CallbackState::DeviceLoss);
+            return;
+        }
+
+        // Serials that already completed are only run by the completion thread when it is woken up.
+        {
+            std::lock_guard<std::mutex> lock(mCompletionMutex);
+            mCompletionFlushRequested = true;
+        }
+        mCompletionCondition.notify_one();
+    }
+
     void QueueBase::CheckAndUpdateCompletedSerial()
     {
-        uint64_t completedSerial = QueryCompletedSerial();
+        UpdateCompletedSerial(QueryCompletedSerial());
+    }
+
+    void QueueBase::UpdateCompletedSerial(uint64_t completedSerial)
+    {
         uint64_t current = mCompletedSerial.load(std::memory_order_acquire);
         while (uint64_t(completedSerial) > current &&
                !mCompletedSerial.compare_exchange_weak(current, uint64_t(completedSerial), std::memory_order_acq_rel))
@@ -93,16 +483,32 @@ namespace rhi::impl
         return mLastSubmittedSerial.load(std::memory_order_acquire) > mCompletedSerial.load(std::memory_order_acquire);
     }
 
-    bool QueueBase::NeedsTick() const
+    bool QueueBase::NeedsTick()
     {
+        std::lock_guard<std::mutex> lock(mTasksMutex);
         return HasScheduledCommands() || !mTasksInFlight.Empty();
     }
 
+    UploadAllocatorStats QueueBase::GetUploadAllocatorStats() const
+    {
+        return mUploadAllocator->GetStats();
+    }
+
+    void QueueBase::APIGetUniformAllocatorStats(UniformAllocatorStats* stats) const
+    {
+        *stats = mUniformRingAllocator->GetStats();
+    }
+
     void QueueBase::CopyFromStagingToBuffer(
             BufferBase* src, uint64_t srcOffset, BufferBase* dst, uint64_t dstOffset, uint64_t size)
     {
-        CopyFromStagingToBufferImpl(src, srcOffset, dst, dstOffset, size);
-        MarkRecordingContextIsUsed();
+        // The caller may release the destination before the copy is recorded.
+        EnqueueRecordingLocked(
+                [this, src, srcOffset, dst = Ref<BufferBase>(dst), dstOffset, size]()
+                {
+                    CopyFromStagingToBufferImpl(src, srcOffset, dst.Get(), dstOffset, size);
+                    MarkRecordingContextIsUsed();
+                });
     }
 
     void QueueBase::APIWriteBuffer(BufferBase* buffer, const void* data, uint64_t dataSize, uint64_t offset)
@@ -121,15 +527,65 @@ namespace rhi::impl
             uint8_t* src = static_cast<uint8_t*>(buffer->APIGetMappedPointer()) + offset;
             memcpy(src, data, dataSize);
         }
+        else if (dataSize <= mUploadAllocator->GetBaseRingBufferSize())
+        {
+            // For device visible buffer, we use stage buffer to upload. No submit may happen until the copy is
+            // enqueued, otherwise it would land in a later serial than the one the staging memory is tracked with.
+            std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+            WriteBufferChunk(buffer, static_cast<const uint8_t*>(data), dataSize, offset);
+        }
         else
         {
-            // For device visible buffer, we use stage buffer to upload.
-            UploadAllocation allocation = mUploadAllocator->Allocate(dataSize, GetPendingSubmitSerial(), 4);
-            ASSERT(allocation.mappedAddress != nullptr);
-            memcpy(allocation.mappedAddress, data, dataSize);
+            // Larger uploads are streamed through the ring buffers instead of getting a staging buffer of their size.
+            std::unique_lock<std::shared_mutex> submitLock(mSubmitMutex);
+            const uint64_t chunkSize = GetStreamingChunkSize();
+            std::deque<uint64_t> chunkSerials;
+            for (uint64_t chunkOffset = 0; chunkOffset < dataSize; chunkOffset += chunkSize)
+            {
+                if (chunkOffset != 0)
+                {
+                    FlushStreamingChunk(chunkSerials);
+                }
+                WriteBufferChunk(buffer,
+                                 static_cast<const uint8_t*>(data) + chunkOffset,
+                                 std::min(chunkSize, dataSize - chunkOffset),
+                                 offset + chunkOffset);
+            }
+        }
+    }
+
+    void QueueBase::WriteBufferChunk(BufferBase* buffer, const uint8_t* data, uint64_t size, uint64_t offset)
+    {
+        UploadAllocation allocation = mUploadAllocator->Allocate(size, GetPendingSubmitSerial(), 4);
+        ASSERT(allocation.mappedAddress != nullptr);
+        memcpy(allocation.mappedAddress, data, size);
 
-            CopyFromStagingToBuffer(allocation.buffer, allocation.offset, buffer, offset, dataSize);
+        CopyFromStagingToBuffer(allocation.buffer, allocation.offset, buffer, offset, size);
+    }
+
+    uint64_t QueueBase::GetStreamingChunkSize() const
+    {
+        // Two chunks fit in a ring buffer, so that a chunk can be written while the previous one is copied.
+        return AlignUp(mUploadAllocator->GetBaseRingBufferSize() / 2, 4u);
+    }
+
+    void QueueBase::FlushStreamingChunk(std::deque<uint64_t>& chunkSerials)
+    {
+        // Every chunk is submitted on its own. Once cStreamingChunksInFlight of them are queued, the oldest one is
+        // waited for and its staging memory reused, which bounds the staging memory of any upload.
+        chunkSerials.push_back(EnqueueSubmitLocked([this]() { FlushPendingCommands(); }));
+        if (chunkSerials.size() < cStreamingChunksInFlight)
+        {
+            return;
+        }
+
+        const uint64_t serial = chunkSerials.front();
+        chunkSerials.pop_front();
+        if (serial > GetCompletedSerial() && WaitForSerialImpl(serial, UINT64_MAX) == SerialWaitResult::Completed)
+        {
+            UpdateCompletedSerial(serial);
         }
+        mUploadAllocator->Deallocate(GetCompletedSerial());
     }
 
     uint64_t ComputeRequiredBytesInCopy(TextureFormat format,
@@ -221,8 +677,81 @@ namespace rhi::impl
                    dataLayout.offset,
                    dataSize);
         TextureFormat format = dstTexture.texture->APIGetFormat();
-        ASSERT(dstTexture.size.width % GetFormatInfo(format).blockSize == 0);
-        ASSERT(dstTexture.size.height % GetFormatInfo(format).blockSize == 0);
+        const FormatInfo& formatInfo = GetFormatInfo(format);
+        ASSERT(dstTexture.size.width % formatInfo.blockSize == 0);
+        ASSERT(dstTexture.size.height % formatInfo.blockSize == 0);
+
+        uint32_t alignedBytesPerRow = dstTexture.size.width / formatInfo.blockSize * formatInfo.bytesPerBlock;
+        uint32_t alignedRowsPerImage = dstTexture.size.height / formatInfo.blockSize;
+        uint32_t optimallyAlignedBytesPerRow = AlignUp(alignedBytesPerRow, mDevice->GetOptimalBytesPerRowAlignment());
+
+        uint64_t requiredBytesInCopy =
+                ComputeRequiredBytesInCopy(format, dstTexture.size, optimallyAlignedBytesPerRow, alignedRowsPerImage);
+
+        const uint8_t* src = static_cast<const uint8_t*>(data) + dataLayout.offset;
+
+        if (requiredBytesInCopy <= mUploadAllocator->GetBaseRingBufferSize())
+        {
+            std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+            WriteTextureChunk(dstTexture, src, dataLayout);
+            return;
+        }
+
+        // Larger uploads are streamed through the ring buffers by whole images when they fit in a chunk, by bands of
+        // rows otherwise.
+        std::unique_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        const uint64_t chunkSize = GetStreamingChunkSize();
+        const uint64_t stagingBytesPerImage = uint64_t(optimallyAlignedBytesPerRow) * alignedRowsPerImage;
+        const uint64_t srcBytesPerImage = uint64_t(dataLayout.bytesPerRow) * dataLayout.rowsPerImage;
+        const uint32_t depth = dstTexture.size.depthOrArrayLayers;
+        std::deque<uint64_t> chunkSerials;
+        bool firstChunk = true;
+        auto writeChunk = [&](const TextureSlice& chunk, const uint8_t* chunkSrc)
+        {
+            if (!firstChunk)
+            {
+                FlushStreamingChunk(chunkSerials);
+            }
+            firstChunk = false;
+            WriteTextureChunk(chunk, chunkSrc, dataLayout);
+        };
+
+        if (stagingBytesPerImage <= chunkSize)
+        {
+            const uint32_t imagesPerChunk = static_cast<uint32_t>(chunkSize / stagingBytesPerImage);
+            for (uint32_t z = 0; z < depth; z += imagesPerChunk)
+            {
+                TextureSlice chunk = dstTexture;
+                chunk.origin.z += z;
+                chunk.size.depthOrArrayLayers = std::min(imagesPerChunk, depth - z);
+                writeChunk(chunk, src + z * srcBytesPerImage);
+            }
+        }
+        else
+        {
+            // A single row larger than a chunk still goes through a dedicated staging buffer.
+            const uint32_t rowsPerChunk =
+                    static_cast<uint32_t>(std::max(chunkSize / optimallyAlignedBytesPerRow, uint64_t(1)));
+            for (uint32_t z = 0; z < depth; ++z)
+            {
+                for (uint32_t row = 0; row < alignedRowsPerImage; row += rowsPerChunk)
+                {
+                    TextureSlice chunk = dstTexture;
+                    chunk.origin.z += z;
+                    chunk.origin.y += row * formatInfo.blockSize;
+                    chunk.size.depthOrArrayLayers = 1;
+                    chunk.size.height = std::min(rowsPerChunk, alignedRowsPerImage - row) * formatInfo.blockSize;
+                    writeChunk(chunk, src + z * srcBytesPerImage + uint64_t(row) * dataLayout.bytesPerRow);
+                }
+            }
+        }
+    }
+
+    void QueueBase::WriteTextureChunk(const TextureSlice& dstTexture,
+                                      const uint8_t* data,
+                                      const TextureDataLayout& dataLayout)
+    {
+        TextureFormat format = dstTexture.texture->APIGetFormat();
 
         uint32_t alignedBytesPerRow =
                 dstTexture.size.width / GetFormatInfo(format).blockSize * GetFormatInfo(format).bytesPerBlock;
@@ -242,7 +771,6 @@ namespace rhi::impl
                 mUploadAllocator->Allocate(requiredBytesInCopy, GetPendingSubmitSerial(), offsetAlignment);
         ASSERT(allocation.mappedAddress != nullptr);
 
-        const uint8_t* copySrc = static_cast<const uint8_t*>(data) + dataLayout.offset;
         uint8_t* copyDst = static_cast<uint8_t*>(allocation.mappedAddress);
 
         ASSERT(dataLayout.rowsPerImage >= alignedRowsPerImage);
@@ -250,7 +778,7 @@ namespace rhi::impl
         uint64_t additionalStridePerImage = dataLayout.bytesPerRow * (dataLayout.rowsPerImage - alignedRowsPerImage);
 
         CopyTextureData(copyDst,
-                        copySrc,
+                        data,
                         dstTexture.size.depthOrArrayLayers,
                         alignedRowsPerImage,
                         additionalStridePerImage,
@@ -263,11 +791,192 @@ namespace rhi::impl
         alignedDataLayout.bytesPerRow = optimallyAlignedBytesPerRow;
         alignedDataLayout.rowsPerImage = alignedRowsPerImage;
 
-        CopyFromStagingToTextureImpl(allocation.buffer, dstTexture, alignedDataLayout);
+        EnqueueRecordingLocked(
+                [this, src = allocation.buffer, dstTexture, texture = Ref<TextureBase>(dstTexture.texture), alignedDataLayout]()
+                { CopyFromStagingToTextureImpl(src, dstTexture, alignedDataLayout); });
+    }
+
+    UniformAllocation QueueBase::APIAllocateUniforms(uint64_t size)
+    {
+        INVALID_IF(size == 0, "Uniform allocations must not be empty.");
+        INVALID_IF(size > mUniformRingAllocator->GetMaxAllocationSize(),
+                   "Uniform allocation size (%u) is larger than the maximum (%u).",
+                   size,
+                   mUniformRingAllocator->GetMaxAllocationSize());
+
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        return mUniformRingAllocator->Allocate(size, GetPendingSubmitSerial());
+    }
+
+    UploadReservation QueueBase::APIReserveUpload(uint64_t size, uint64_t alignment)
+    {
+        INVALID_IF(size == 0, "Upload reservations must not be empty.");
+        INVALID_IF(alignment != 0 && !IsPowerOfTwo(alignment),
+                   "Upload reservation alignment (%u) is not a power of two.",
+                   alignment);
+
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        UploadReservation reservation{};
+        reservation.serial = GetPendingSubmitSerial();
+        UploadAllocation allocation =
+                mUploadAllocator->Reserve(size, reservation.serial, std::max(alignment, uint64_t(4)));
+        ASSERT(allocation.mappedAddress != nullptr);
+
+        reservation.data = allocation.mappedAddress;
+        reservation.size = size;
+        reservation.stagingBuffer = allocation.buffer;
+        reservation.stagingOffset = allocation.offset;
+        return reservation;
+    }
+
+    void QueueBase::APICommitUploadToBuffer(const UploadReservation& reservation, BufferBase* buffer, uint64_t offset)
+    {
+        INVALID_IF(reservation.stagingBuffer == nullptr, "The upload reservation was not made by ReserveUpload.");
+        INVALID_IF(reservation.size > buffer->APIGetSize() - offset || offset > buffer->APIGetSize(),
+                   "Write range (bufferOffset: %u, size: %u) does not fit in Buffer(%s) size (%u).",
+                   offset,
+                   reservation.size,
+                   buffer->GetName(),
+                   buffer->APIGetSize());
+
+        // The copy may land in a later serial than the reservation was made for when a submit happened meanwhile.
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        mUploadAllocator->CommitReservation(reservation.stagingBuffer, reservation.serial, GetPendingSubmitSerial());
+        CopyFromStagingToBuffer(reservation.stagingBuffer, reservation.stagingOffset, buffer, offset, reservation.size);
+    }
+
+    void QueueBase::APICommitUploadToTexture(const UploadReservation& reservation,
+                                             const TextureSlice& dstTexture,
+                                             const TextureDataLayout& dataLayout)
+    {
+        INVALID_IF(reservation.stagingBuffer == nullptr, "The upload reservation was not made by ReserveUpload.");
+        ASSERT(HasFlag(dstTexture.texture->APIGetUsage(), TextureUsage::CopyDst));
+        TextureFormat format = dstTexture.texture->APIGetFormat();
+        const FormatInfo& formatInfo = GetFormatInfo(format);
+        ASSERT(dstTexture.size.width % formatInfo.blockSize == 0);
+        ASSERT(dstTexture.size.height % formatInfo.blockSize == 0);
+        INVALID_IF(dataLayout.bytesPerRow % formatInfo.bytesPerBlock != 0 ||
+                           dataLayout.bytesPerRow < dstTexture.size.width / formatInfo.blockSize * formatInfo.bytesPerBlock,
+                   "Bytes per row (%u) is not a valid row pitch for the copy.",
+                   dataLayout.bytesPerRow);
+        INVALID_IF(dataLayout.rowsPerImage < dstTexture.size.height / formatInfo.blockSize,
+                   "Rows per image (%u) is smaller than the copy height.",
+                   dataLayout.rowsPerImage);
+        INVALID_IF((reservation.stagingOffset + dataLayout.offset) % formatInfo.bytesPerBlock != 0,
+                   "Data offset (%u) is not aligned to the texel block size (%u).",
+                   dataLayout.offset,
+                   formatInfo.bytesPerBlock);
+
+        uint64_t requiredBytesInCopy =
+                ComputeRequiredBytesInCopy(format, dstTexture.size, dataLayout.bytesPerRow, dataLayout.rowsPerImage);
+        INVALID_IF(dataLayout.offset > reservation.size || requiredBytesInCopy > reservation.size - dataLayout.offset,
+                   "Copy of %u bytes at offset %u does not fit in the upload reservation size (%u).",
+                   requiredBytesInCopy,
+                   dataLayout.offset,
+                   reservation.size);
+
+        TextureDataLayout stagingDataLayout = dataLayout;
+        stagingDataLayout.offset += reservation.stagingOffset;
+
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        mUploadAllocator->CommitReservation(reservation.stagingBuffer, reservation.serial, GetPendingSubmitSerial());
+        EnqueueRecordingLocked(
+                [this,
+                 src = reservation.stagingBuffer,
+                 dstTexture,
+                 texture = Ref<TextureBase>(dstTexture.texture),
+                 stagingDataLayout]() { CopyFromStagingToTextureImpl(src, dstTexture, stagingDataLayout); });
+    }
+
+    void QueueBase::APIReadBuffer(BufferBase* buffer,
+                                  uint64_t offset,
+                                  uint64_t size,
+                                  ReadbackCallback callback,
+                                  void* userData)
+    {
+        INVALID_IF(size == 0, "Readbacks must not be empty.");
+        INVALID_IF(size > buffer->APIGetSize() - offset || offset > buffer->APIGetSize(),
+                   "Read range (bufferOffset: %u, size: %u) does not fit in Buffer(%s) size (%u).",
+                   offset,
+                   size,
+                   buffer->GetName(),
+                   buffer->APIGetSize());
+        INVALID_IF(!HasFlag(buffer->APIGetUsage(), BufferUsage::CopySrc),
+                   "Buffer(%s) was not created with the CopySrc usage.",
+                   buffer->GetName());
+
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        ReadbackAllocation allocation = mReadbackAllocator->Allocate(size, GetPendingSubmitSerial(), 4);
+        EnqueueRecordingLocked(
+                [this, src = Ref<BufferBase>(buffer), offset, dst = allocation.buffer, dstOffset = allocation.offset, size]()
+                {
+                    CopyFromBufferToStagingImpl(src.Get(), offset, dst, dstOffset, size);
+                    MarkRecordingContextIsUsed();
+                });
+        TrackReadback(allocation, size, callback, userData);
+    }
+
+    void QueueBase::APIReadTexture(const TextureSlice& srcTexture, ReadbackCallback callback, void* userData)
+    {
+        ASSERT(HasFlag(srcTexture.texture->APIGetUsage(), TextureUsage::CopySrc));
+        TextureFormat format = srcTexture.texture->APIGetFormat();
+        const FormatInfo& formatInfo = GetFormatInfo(format);
+        ASSERT(srcTexture.size.width % formatInfo.blockSize == 0);
+        ASSERT(srcTexture.size.height % formatInfo.blockSize == 0);
+
+        // The data is handed out tightly packed, so that callers don't need to know the copy alignments.
+        TextureDataLayout dataLayout{};
+        dataLayout.bytesPerRow = srcTexture.size.width / formatInfo.blockSize * formatInfo.bytesPerBlock;
+        dataLayout.rowsPerImage = srcTexture.size.height / formatInfo.blockSize;
+        uint64_t size = ComputeRequiredBytesInCopy(format, srcTexture.size, dataLayout.bytesPerRow, dataLayout.rowsPerImage);
+        INVALID_IF(size == 0, "Readbacks must not be empty.");
+
+        // Depth and stencil copies need 4 byte aligned offsets.
+        uint64_t offsetAlignment = std::max({uint64_t(mDevice->GetOptimalBufferToTextureCopyOffsetAlignment()),
+                                             uint64_t(formatInfo.bytesPerBlock),
+                                             uint64_t(4)});
+
+        std::shared_lock<std::shared_mutex> submitLock(mSubmitMutex);
+        ReadbackAllocation allocation = mReadbackAllocator->Allocate(size, GetPendingSubmitSerial(), offsetAlignment);
+        dataLayout.offset = allocation.offset;
+        EnqueueRecordingLocked(
+                [this, srcTexture, texture = Ref<TextureBase>(srcTexture.texture), dst = allocation.buffer, dataLayout]()
+                {
+                    CopyFromTextureToStagingImpl(srcTexture, dst, dataLayout);
+                    MarkRecordingContextIsUsed();
+                });
+        TrackReadback(allocation, size, callback, userData);
+    }
+
+    void QueueBase::TrackReadback(const ReadbackAllocation& allocation,
+                                  uint64_t size,
+                                  ReadbackCallback callback,
+                                  void* userData)
+    {
+        // The caller holds the submit mutex, so the pending serial can't be submitted meanwhile.
+        std::lock_guard<std::mutex> lock(mReadbackMutex);
+        if (mPendingReadbacks == nullptr)
+        {
+            mPendingReadbacks = std::make_unique<ReadbackBatchTask>(mReadbackAllocator);
+            mPendingReadbacksSerial = allocation.serial;
+        }
+        ASSERT(mPendingReadbacksSerial == allocation.serial);
+        mPendingReadbacks->Add(allocation, size, callback, userData);
+    }
+
+    void QueueBase::TrackPendingReadbacks()
+    {
+        std::lock_guard<std::mutex> lock(mReadbackMutex);
+        if (mPendingReadbacks == nullptr)
+        {
+            return;
+        }
+        ASSERT(mPendingReadbacksSerial == GetPendingSubmitSerial());
+        TrackTask(std::move(mPendingReadbacks), mPendingReadbacksSerial);
     }
 
     void QueueBase::APIWaitFor(QueueBase* queue, uint64_t submitSerial)
     {
-        WaitForImpl(queue, submitSerial);
+        EnqueueRecording([this, queue, submitSerial]() { WaitForImpl(queue, submitSerial); });
     }
 } // namespace rhi::impl
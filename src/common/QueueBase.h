@@ -1,9 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include "CallbackTaskManager.h"
 #include "RHIStruct.h"
+#include "ReadbackAllocator.h"
+#include "UniformRingAllocator.h"
 #include "UploadAllocator.h"
 #include "common/RefCounted.h"
 #include "common/SerialMap.hpp"
@@ -14,6 +22,16 @@ namespace rhi::impl
     class CommandListBase;
     class CommandEncoder;
     class BufferBase;
+    class WorkerTaskPool;
+    class ReadbackBatchTask;
+
+    enum class SerialWaitResult
+    {
+        Completed,
+        TimedOut,
+        // The wait itself failed, e.g. because the device was lost.
+        Failed,
+    };
 
     class QueueBase : public RefCounted
     {
@@ -24,10 +42,28 @@ namespace rhi::impl
                              size_t dataSize,
                              const TextureDataLayout& dataLayout);
         void APIWaitFor(QueueBase* queue, uint64_t submitSerial);
+        // The reserved staging memory is written by the caller and must be committed exactly once, from any thread.
+        UploadReservation APIReserveUpload(uint64_t size, uint64_t alignment);
+        void APICommitUploadToBuffer(const UploadReservation& reservation, BufferBase* buffer, uint64_t offset);
+        void APICommitUploadToTexture(const UploadReservation& reservation,
+                                      const TextureSlice& dstTexture,
+                                      const TextureDataLayout& dataLayout);
+        // The memory is read by the commands of the next submit and recycled once that submit has completed. With
+        // descriptor buffers there are no dynamic offset bindings to select an allocation with.
+        UniformAllocation APIAllocateUniforms(uint64_t size);
+        void APIGetUniformAllocatorStats(UniformAllocatorStats* stats) const;
+        // The copy executes with the next submit, the callback runs once that submit has completed.
+        void APIReadBuffer(BufferBase* buffer, uint64_t offset, uint64_t size, ReadbackCallback callback, void* userData);
+        void APIReadTexture(const TextureSlice& srcTexture, ReadbackCallback callback, void* userData);
         uint64_t APISubmit(CommandListBase* const* commands,
                            uint32_t commandListCount,
                            ResourceTransfer const* transfers = nullptr,
                            uint32_t transferCount = 0);
+        // Sleeps until the serial has completed on the GPU or the timeout expired, returns whether it completed.
+        bool APIWaitForSerial(uint64_t serial, uint64_t timeoutNs);
+        // The callback runs on the completion thread of the queue once the serial has completed, without waiting for
+        // the device to be ticked.
+        void APIOnSerialCompleted(uint64_t serial, SerialCompletedCallback callback, void* userData);
 
         void Tick();
         QueueType GetType() const;
@@ -35,12 +71,23 @@ namespace rhi::impl
         uint64_t GetPendingSubmitSerial() const;
         uint64_t GetCompletedSerial() const;
         void AssumeCommandsComplete();
-        bool NeedsTick() const;
+        bool NeedsTick();
         bool HasScheduledCommands() const;
         void CheckAndUpdateCompletedSerial();
         void TrackTask(std::unique_ptr<CallbackTask>, uint64_t serial);
+        // Records into the pending commands after the submissions queued before, on the submission thread when
+        // submission is asynchronous.
+        void EnqueueRecording(std::function<void()> record);
+        // Submits the pending commands after everything recorded before and returns the serial the submit signals.
+        uint64_t EnqueueSubmit(std::function<void()> submit);
+        // Must be called with the submit mutex held.
         void CopyFromStagingToBuffer(
                 BufferBase* src, uint64_t srcOffset, BufferBase* dst, uint64_t dstOffset, uint64_t size);
+        UploadAllocatorStats GetUploadAllocatorStats() const;
+        // Blocks until the submissions queued on the submission thread are handed to the driver. Does nothing when
+        // submission is synchronous or when called from the submission thread itself.
+        void WaitForPendingSubmissions();
+        void StopCompletionThread();
         virtual void Destroy() = 0;
 
     protected:
@@ -57,12 +104,35 @@ namespace rhi::impl
         virtual void CopyFromStagingToTextureImpl(BufferBase* src,
                                                   const TextureSlice& dst,
                                                   const TextureDataLayout& dataLayout) = 0;
+        virtual void CopyFromBufferToStagingImpl(
+                BufferBase* src, uint64_t srcOffset, BufferBase* dst, uint64_t dstOffset, uint64_t size) = 0;
+        virtual void CopyFromTextureToStagingImpl(const TextureSlice& src,
+                                                  BufferBase* dst,
+                                                  const TextureDataLayout& dataLayout) = 0;
         virtual void MarkRecordingContextIsUsed() = 0;
+        // Submits the commands recorded directly into the queue, like staging copies, on their own serial.
+        virtual void FlushPendingCommands() = 0;
         virtual void WaitForImpl(QueueBase* queue, uint64_t submitSerial) = 0;
+        virtual SerialWaitResult WaitForSerialImpl(uint64_t serial, uint64_t timeoutNs) = 0;
+        // Must be called once the backend can wait for serials.
+        void StartCompletionThread();
+        void IncrementLastSubmittedSerial();
 
+        // Guards mTasksInFlight and mSerialCallbacksInFlight, which are shared with the completion thread.
+        std::mutex mTasksMutex;
         SerialMap<uint64_t, std::unique_ptr<CallbackTask>> mTasksInFlight;
+        // Only executed by the completion thread, the other tasks are flushed by Device::Tick.
+        SerialMap<uint64_t, std::unique_ptr<CallbackTask>> mSerialCallbacksInFlight;
 
         std::unique_ptr<UploadAllocator> mUploadAllocator;
+        std::unique_ptr<UniformRingAllocator> mUniformRingAllocator;
+        Ref<ReadbackAllocator> mReadbackAllocator;
+        // Writes from several threads hold it shared from the staging allocation until their copy is recorded, which
+        // keeps the pending serial stable. Submits hold it exclusively.
+        std::shared_mutex mSubmitMutex;
+        // Without a submission thread, staging copies are recorded into the same pending commands one at a time.
+        std::mutex mStagingCopyMutex;
+        static constexpr size_t cStreamingChunksInFlight = 2;
 
         DeviceBase* mDevice;
 
@@ -70,5 +140,51 @@ namespace rhi::impl
 
         std::atomic<uint64_t> mCompletedSerial = 0;
         std::atomic<uint64_t> mLastSubmittedSerial = 0;
+
+    private:
+        void WriteBufferChunk(BufferBase* buffer, const uint8_t* data, uint64_t size, uint64_t offset);
+        void WriteTextureChunk(const TextureSlice& dstTexture, const uint8_t* data, const TextureDataLayout& dataLayout);
+        uint64_t GetStreamingChunkSize() const;
+        // Must be called with the submit mutex held.
+        void EnqueueRecordingLocked(std::function<void()> record);
+        // Must be called with the submit mutex held exclusively.
+        uint64_t EnqueueSubmitLocked(std::function<void()> submit);
+        // Must be called with the submit mutex held exclusively.
+        void FlushStreamingChunk(std::deque<uint64_t>& chunkSerials);
+        void TrackReadback(const ReadbackAllocation& allocation,
+                           uint64_t size,
+                           ReadbackCallback callback,
+                           void* userData);
+        // Must be called with the submit mutex held exclusively, right before the pending serial is submitted.
+        void TrackPendingReadbacks();
+        void UpdateCompletedSerial(uint64_t completedSerial);
+        void MoveCompletedTasks(uint64_t completedSerial);
+        void RunSerialCallbacks(uint64_t serial, CallbackState state = CallbackState::Normal);
+        void CompletionThreadLoop();
+        uint64_t SubmitAsync(CommandListBase* const* commands,
+                             uint32_t commandListCount,
+                             ResourceTransfer const* transfers,
+                             uint32_t transferCount);
+
+        // Only created when asynchronous submission is enabled.
+        std::unique_ptr<WorkerTaskPool> mSubmissionThread;
+        // Serial of the last submission handed to the submission thread. Each of them signals exactly one serial, in
+        // order, so it is ahead of mLastSubmittedSerial while submissions are queued.
+        std::atomic<uint64_t> mLastEnqueuedSerial = 0;
+
+        // Readbacks recorded for the pending serial. The batch is owned here until the submit of its serial, which
+        // hands it to mTasksInFlight.
+        std::mutex mReadbackMutex;
+        std::unique_ptr<ReadbackBatchTask> mPendingReadbacks;
+        uint64_t mPendingReadbacksSerial = 0;
+
+        // Sleeps on the tracking semaphore and retires the completed serials without anybody polling the queue.
+        std::thread mCompletionThread;
+        std::mutex mCompletionMutex;
+        std::condition_variable mCompletionCondition;
+        bool mStopCompletionThread = false;
+        bool mCompletionFlushRequested = false;
+        // Set once a wait failed, the completion thread has exited and the serials will not complete anymore.
+        std::atomic<bool> mLost = false;
     };
 } // namespace rhi::impl
@@ -12,6 +12,8 @@
 #include "InstanceBase.h"
 #include "PipelineLayoutBase.h"
 #include "QueueBase.h"
+#include "RenderBundleBase.h"
+#include "RenderBundleEncoder.h"
 #include "RenderPassEncoder.h"
 #include "RenderPipelineBase.h"
 #include "SamplerBase.h"
@@ -19,6 +21,7 @@
 #include "SurfaceBase.h"
 #include "TextureBase.h"
 #include "PipelineCacheBase.h"
+#include "ResourceHeapBase.h"
 #include "vulkan/InstanceVk.h"
 
 using namespace rhi::impl;
@@ -36,6 +39,8 @@ struct ComputePipelineImpl : public ComputePipelineBase {};
 struct CommandEncoderImpl : public CommandEncoder {};
 struct RenderPassEncoderImpl : public RenderPassEncoder {};
 struct ComputePassEncoderImpl : public ComputePassEncoder {};
+struct RenderBundleEncoderImpl : public RenderBundleEncoder {};
+struct RenderBundleImpl : public RenderBundleBase {};
 struct CommandListImpl : public CommandListBase {};
 struct PipelineLayoutImpl : public PipelineLayoutBase {};
 struct SamplerImpl : public SamplerBase {};
@@ -44,6 +49,7 @@ struct BufferImpl : public BufferBase {};
 struct TextureImpl : public TextureBase {};
 struct TextureViewImpl : public TextureViewBase {};
 struct PipelineCacheImpl : public PipelineCacheBase {};
+struct ResourceHeapImpl : public ResourceHeapBase {};
 
 // clang-format on
 
@@ -127,6 +133,11 @@ RHIPipelineCache rhiDeviceCreatePipelineCache(RHIDevice device, const RHIPipelin
     auto result = device->APICreatePipelineCache(*reinterpret_cast<const PipelineCacheDesc*>(desc));
     return static_cast<RHIPipelineCache>(result);
 }
+RHIResourceHeap rhiDeviceCreateResourceHeap(RHIDevice device, const RHIResourceHeapDesc* desc)
+{
+    auto result = device->APICreateResourceHeap(*reinterpret_cast<const ResourceHeapDesc*>(desc));
+    return static_cast<RHIResourceHeap>(result);
+}
 RHIRenderPipeline rhiDeviceCreateRenderPipeline(RHIDevice device, const RHIRenderPipelineDesc* desc)
 {
     auto result = device->APICreateRenderPipeline(*reinterpret_cast<const RenderPipelineDesc*>(desc));
@@ -137,6 +148,24 @@ RHIComputePipeline rhiDeviceCreateComputePipeline(RHIDevice device, const RHICom
     auto result = device->APICreateComputePipeline(*reinterpret_cast<const ComputePipelineDesc*>(desc));
     return static_cast<RHIComputePipeline>(result);
 }
+void rhiDeviceCreateRenderPipelineAsync(RHIDevice device,
+                                        const RHIRenderPipelineDesc* desc,
+                                        RHICreateRenderPipelineAsyncCallback callback,
+                                        void* userData)
+{
+    device->APICreateRenderPipelineAsync(*reinterpret_cast<const RenderPipelineDesc*>(desc),
+                                         reinterpret_cast<CreateRenderPipelineAsyncCallback>(callback),
+                                         userData);
+}
+void rhiDeviceCreateComputePipelineAsync(RHIDevice device,
+                                         const RHIComputePipelineDesc* desc,
+                                         RHICreateComputePipelineAsyncCallback callback,
+                                         void* userData)
+{
+    device->APICreateComputePipelineAsync(*reinterpret_cast<const ComputePipelineDesc*>(desc),
+                                          reinterpret_cast<CreateComputePipelineAsyncCallback>(callback),
+                                          userData);
+}
 RHIBindSetLayout rhiDeviceCreateBindSetLayout(RHIDevice device, const RHIBindSetLayoutDesc* desc)
 {
     auto result = device->APICreateBindSetLayout(*reinterpret_cast<const BindSetLayoutDesc*>(desc));
@@ -147,6 +176,11 @@ RHIBindSet rhiDeviceCreateBindSet(RHIDevice device, const RHIBindSetDesc* desc)
     auto result = device->APICreateBindSet(*reinterpret_cast<const BindSetDesc*>(desc));
     return static_cast<RHIBindSet>(result);
 }
+RHIBindSet rhiDeviceCreateTransientBindSet(RHIDevice device, const RHIBindSetDesc* desc)
+{
+    auto result = device->APICreateTransientBindSet(*reinterpret_cast<const BindSetDesc*>(desc));
+    return static_cast<RHIBindSet>(result);
+}
 RHITexture rhiDeviceCreateTexture(RHIDevice device, const RHITextureDesc* desc)
 {
     auto result = device->APICreateTexture(*reinterpret_cast<const TextureDesc*>(desc));
@@ -172,10 +206,27 @@ RHICommandEncoder rhiDeviceCreateCommandEncoder(RHIDevice device)
     auto result = device->APICreateCommandEncoder();
     return static_cast<RHICommandEncoder>(result);
 }
+RHIRenderBundleEncoder rhiDeviceCreateRenderBundleEncoder(RHIDevice device)
+{
+    auto result = device->APICreateRenderBundleEncoder();
+    return static_cast<RHIRenderBundleEncoder>(result);
+}
 void rhiDeviceTick(RHIDevice device)
 {
     device->APITick();
 }
+void rhiDeviceGetBindSetCacheStats(RHIDevice device, RHIBindSetCacheStats* stats)
+{
+    device->APIGetBindSetCacheStats(reinterpret_cast<BindSetCacheStats*>(stats));
+}
+void rhiDeviceGetPipelineObjectCacheStats(RHIDevice device, RHIPipelineObjectCacheStats* stats)
+{
+    device->APIGetPipelineObjectCacheStats(reinterpret_cast<PipelineObjectCacheStats*>(stats));
+}
+void rhiDeviceGetShaderModuleCacheStats(RHIDevice device, RHIShaderModuleCacheStats* stats)
+{
+    device->APIGetShaderModuleCacheStats(reinterpret_cast<ShaderModuleCacheStats*>(stats));
+}
 void rhiDeviceAddRef(RHIDevice device)
 {
     device->AddRef();
@@ -215,6 +266,63 @@ uint64_t rhiQueueSubmit(RHIQueue queue,
                             reinterpret_cast<ResourceTransfer const*>(transfers),
                             transferCount);
 }
+bool rhiQueueWaitForSerial(RHIQueue queue, uint64_t serial, uint64_t timeoutNs)
+{
+    return queue->APIWaitForSerial(serial, timeoutNs);
+}
+void rhiQueueOnSerialCompleted(RHIQueue queue,
+                               uint64_t serial,
+                               RHISerialCompletedCallback callback,
+                               void* userData)
+{
+    queue->APIOnSerialCompleted(serial, reinterpret_cast<SerialCompletedCallback>(callback), userData);
+}
+void rhiQueueReserveUpload(RHIQueue queue, uint64_t size, uint64_t alignment, RHIUploadReservation* reservation)
+{
+    *reinterpret_cast<UploadReservation*>(reservation) = queue->APIReserveUpload(size, alignment);
+}
+void rhiQueueCommitUploadToBuffer(RHIQueue queue,
+                                  const RHIUploadReservation* reservation,
+                                  RHIBuffer buffer,
+                                  uint64_t offset)
+{
+    queue->APICommitUploadToBuffer(*reinterpret_cast<const UploadReservation*>(reservation), buffer, offset);
+}
+void rhiQueueCommitUploadToTexture(RHIQueue queue,
+                                   const RHIUploadReservation* reservation,
+                                   const RHITextureSlice* dstTexture,
+                                   const RHITextureDataLayout* dataLayout)
+{
+    queue->APICommitUploadToTexture(*reinterpret_cast<const UploadReservation*>(reservation),
+                                    *reinterpret_cast<const TextureSlice*>(dstTexture),
+                                    *reinterpret_cast<const TextureDataLayout*>(dataLayout));
+}
+void rhiQueueAllocateUniforms(RHIQueue queue, uint64_t size, RHIUniformAllocation* allocation)
+{
+    *reinterpret_cast<UniformAllocation*>(allocation) = queue->APIAllocateUniforms(size);
+}
+void rhiQueueGetUniformAllocatorStats(RHIQueue queue, RHIUniformAllocatorStats* stats)
+{
+    queue->APIGetUniformAllocatorStats(reinterpret_cast<UniformAllocatorStats*>(stats));
+}
+void rhiQueueReadBuffer(RHIQueue queue,
+                        RHIBuffer buffer,
+                        uint64_t offset,
+                        uint64_t size,
+                        RHIReadbackCallback callback,
+                        void* userData)
+{
+    queue->APIReadBuffer(buffer, offset, size, reinterpret_cast<ReadbackCallback>(callback), userData);
+}
+void rhiQueueReadTexture(RHIQueue queue,
+                         const RHITextureSlice* srcTexture,
+                         RHIReadbackCallback callback,
+                         void* userData)
+{
+    queue->APIReadTexture(*reinterpret_cast<const TextureSlice*>(srcTexture),
+                          reinterpret_cast<ReadbackCallback>(callback),
+                          userData);
+}
 void rhiQueueAddRef(RHIQueue queue)
 {
     queue->AddRef();
@@ -379,6 +487,34 @@ void rhiRenderPassEncoderSetBlendConstant(RHIRenderPassEncoder encoder, const RH
 {
     encoder->APISetBlendConstant(*reinterpret_cast<const Color*>(blendConstants));
 }
+void rhiRenderPassEncoderSetCullMode(RHIRenderPassEncoder encoder, RHICullMode cullMode)
+{
+    encoder->APISetCullMode(static_cast<CullMode>(cullMode));
+}
+void rhiRenderPassEncoderSetFrontFace(RHIRenderPassEncoder encoder, RHIFrontFace frontFace)
+{
+    encoder->APISetFrontFace(static_cast<FrontFace>(frontFace));
+}
+void rhiRenderPassEncoderSetPrimitiveType(RHIRenderPassEncoder encoder, RHIPrimitiveType primitiveType)
+{
+    encoder->APISetPrimitiveType(static_cast<PrimitiveType>(primitiveType));
+}
+void rhiRenderPassEncoderSetDepthState(RHIRenderPassEncoder encoder,
+                                       bool depthTestEnable,
+                                       bool depthWriteEnable,
+                                       RHICompareOp depthCompareOp)
+{
+    encoder->APISetDepthState(depthTestEnable, depthWriteEnable, static_cast<CompareOp>(depthCompareOp));
+}
+void rhiRenderPassEncoderSetStencilState(RHIRenderPassEncoder encoder,
+                                         bool stencilTestEnable,
+                                         const RHIStencilOpState* front,
+                                         const RHIStencilOpState* back)
+{
+    encoder->APISetStencilState(stencilTestEnable,
+                                *reinterpret_cast<const StencilOpState*>(front),
+                                *reinterpret_cast<const StencilOpState*>(back));
+}
 void rhiRenderPassEncoderSetViewport(RHIRenderPassEncoder encoder,
                                      uint32_t firstViewport,
                                      RHIViewport const* viewports,
@@ -394,6 +530,21 @@ void rhiRenderPassEncoderSetBindSet(RHIRenderPassEncoder encoder,
 {
     encoder->APISetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets);
 }
+void rhiRenderPassEncoderPushBindings(RHIRenderPassEncoder encoder,
+                                      uint32_t setIndex,
+                                      uint32_t entryCount,
+                                      const RHIBindSetEntry* entries)
+{
+    encoder->APIPushBindings(setIndex, entryCount, reinterpret_cast<const BindSetEntry*>(entries));
+}
+void rhiRenderPassEncoderUseResidentResources(RHIRenderPassEncoder encoder,
+                                              RHIResourceHeap heap,
+                                              RHIResourceHeapSlotType type,
+                                              uint32_t slotCount,
+                                              const uint32_t* slots)
+{
+    encoder->APIUseResidentResources(heap, static_cast<ResourceHeapSlotType>(type), slotCount, slots);
+}
 void rhiRenderPassEncoderDraw(RHIRenderPassEncoder encoder,
                               uint32_t vertexCount,
                               uint32_t instanceCount,
@@ -428,8 +579,7 @@ void rhiRenderPassEncoderMultiDrawIndirect(RHIRenderPassEncoder encoder,
                                            RHIBuffer drawCountBuffer,
                                            uint64_t drawCountBufferOffset)
 {
-    encoder->APIMultiDrawIndexedIndirect(
-            indirectBuffer, indirectOffset, maxDrawCount, drawCountBuffer, drawCountBufferOffset);
+    encoder->APIMultiDrawIndirect(indirectBuffer, indirectOffset, maxDrawCount, drawCountBuffer, drawCountBufferOffset);
 }
 void rhiRenderPassEncoderMultiDrawIndexedIndirect(RHIRenderPassEncoder encoder,
                                                   RHIBuffer indirectBuffer,
@@ -438,7 +588,8 @@ void rhiRenderPassEncoderMultiDrawIndexedIndirect(RHIRenderPassEncoder encoder,
                                                   RHIBuffer drawCountBuffer,
                                                   uint64_t drawCountBufferOffset)
 {
-    encoder->APIMultiDrawIndirect(indirectBuffer, indirectOffset, maxDrawCount, drawCountBuffer, drawCountBufferOffset);
+    encoder->APIMultiDrawIndexedIndirect(
+            indirectBuffer, indirectOffset, maxDrawCount, drawCountBuffer, drawCountBufferOffset);
 }
 void rhiRenderPassEncoderSetPushConstant(
         RHIRenderPassEncoder encoder, RHIShaderStage stage, const void* data, uint32_t size, uint32_t offset)
@@ -453,6 +604,12 @@ void rhiRenderPassEncoderEndDebugLabel(RHIRenderPassEncoder encoder)
 {
     encoder->APIEndDebugLabel();
 }
+void rhiRenderPassEncoderExecuteBundles(RHIRenderPassEncoder encoder,
+                                        RHIRenderBundle const* bundles,
+                                        uint32_t bundleCount)
+{
+    encoder->APIExecuteBundles(reinterpret_cast<RenderBundleBase* const*>(bundles), bundleCount);
+}
 void rhiRenderPassEncoderEnd(RHIRenderPassEncoder encoder)
 {
     encoder->APIEnd();
@@ -465,6 +622,128 @@ void rhiRenderPassEncoderRelease(RHIRenderPassEncoder encoder)
 {
     encoder->Release();
 }
+// methods of RenderBundleEncoder
+void rhiRenderBundleEncoderSetPipeline(RHIRenderBundleEncoder encoder, RHIRenderPipeline pipeline)
+{
+    encoder->APISetPipeline(pipeline);
+}
+void rhiRenderBundleEncoderSetVertexBuffers(RHIRenderBundleEncoder encoder,
+                                            uint32_t firstSlot,
+                                            uint32_t bufferCount,
+                                            RHIBuffer const* buffers,
+                                            uint64_t* offsets)
+{
+    encoder->APISetVertexBuffers(firstSlot, bufferCount, reinterpret_cast<BufferBase* const*>(buffers), offsets);
+}
+void rhiRenderBundleEncoderSetIndexBuffer(
+        RHIRenderBundleEncoder encoder, RHIBuffer buffer, uint64_t offset, uint64_t size, RHIIndexFormat indexFormat)
+{
+    encoder->APISetIndexBuffer(buffer, static_cast<IndexFormat>(indexFormat), offset, size);
+}
+void rhiRenderBundleEncoderSetBindSet(RHIRenderBundleEncoder encoder,
+                                      RHIBindSet set,
+                                      uint32_t setIndex,
+                                      uint32_t dynamicOffsetCount,
+                                      const uint32_t* dynamicOffsets)
+{
+    encoder->APISetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets);
+}
+void rhiRenderBundleEncoderPushBindings(RHIRenderBundleEncoder encoder,
+                                        uint32_t setIndex,
+                                        uint32_t entryCount,
+                                        const RHIBindSetEntry* entries)
+{
+    encoder->APIPushBindings(setIndex, entryCount, reinterpret_cast<const BindSetEntry*>(entries));
+}
+void rhiRenderBundleEncoderUseResidentResources(RHIRenderBundleEncoder encoder,
+                                                RHIResourceHeap heap,
+                                                RHIResourceHeapSlotType type,
+                                                uint32_t slotCount,
+                                                const uint32_t* slots)
+{
+    encoder->APIUseResidentResources(heap, static_cast<ResourceHeapSlotType>(type), slotCount, slots);
+}
+void rhiRenderBundleEncoderDraw(RHIRenderBundleEncoder encoder,
+                                uint32_t vertexCount,
+                                uint32_t instanceCount,
+                                uint32_t firstVertex,
+                                uint32_t firstInstance)
+{
+    encoder->APIDraw(vertexCount, instanceCount, firstVertex, firstInstance);
+}
+void rhiRenderBundleEncoderDrawIndexed(RHIRenderBundleEncoder encoder,
+                                       uint32_t indexCount,
+                                       uint32_t instanceCount,
+                                       uint32_t firstIndex,
+                                       int32_t baseVertex,
+                                       uint32_t firstInstance)
+{
+    encoder->APIDrawIndexed(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
+void rhiRenderBundleEncoderDrawIndirect(RHIRenderBundleEncoder encoder, RHIBuffer indirectBuffer, uint64_t indirectOffset)
+{
+    encoder->APIDrawIndirect(indirectBuffer, indirectOffset);
+}
+void rhiRenderBundleEncoderDrawIndexedIndirect(RHIRenderBundleEncoder encoder,
+                                               RHIBuffer indirectBuffer,
+                                               uint64_t indirectOffset)
+{
+    encoder->APIDrawIndexedIndirect(indirectBuffer, indirectOffset);
+}
+void rhiRenderBundleEncoderMultiDrawIndirect(RHIRenderBundleEncoder encoder,
+                                             RHIBuffer indirectBuffer,
+                                             uint64_t indirectOffset,
+                                             uint32_t maxDrawCount,
+                                             RHIBuffer drawCountBuffer,
+                                             uint64_t drawCountBufferOffset)
+{
+    encoder->APIMultiDrawIndirect(indirectBuffer, indirectOffset, maxDrawCount, drawCountBuffer, drawCountBufferOffset);
+}
+void rhiRenderBundleEncoderMultiDrawIndexedIndirect(RHIRenderBundleEncoder encoder,
+                                                    RHIBuffer indirectBuffer,
+                                                    uint64_t indirectOffset,
+                                                    uint32_t maxDrawCount,
+                                                    RHIBuffer drawCountBuffer,
+                                                    uint64_t drawCountBufferOffset)
+{
+    encoder->APIMultiDrawIndexedIndirect(
+            indirectBuffer, indirectOffset, maxDrawCount, drawCountBuffer, drawCountBufferOffset);
+}
+void rhiRenderBundleEncoderSetPushConstant(
+        RHIRenderBundleEncoder encoder, RHIShaderStage stage, const void* data, uint32_t size, uint32_t offset)
+{
+    encoder->APISetPushConstant(static_cast<ShaderStage>(stage), data, size, offset);
+}
+void rhiRenderBundleEncoderBeginDebugLabel(RHIRenderBundleEncoder encoder, RHIStringView label, const RHIColor* color)
+{
+    encoder->APIBeginDebugLabel({label.data, label.length}, reinterpret_cast<const Color*>(color));
+}
+void rhiRenderBundleEncoderEndDebugLabel(RHIRenderBundleEncoder encoder)
+{
+    encoder->APIEndDebugLabel();
+}
+RHIRenderBundle rhiRenderBundleEncoderFinish(RHIRenderBundleEncoder encoder)
+{
+    auto result = encoder->APIFinish();
+    return static_cast<RHIRenderBundle>(result);
+}
+void rhiRenderBundleEncoderAddRef(RHIRenderBundleEncoder encoder)
+{
+    encoder->AddRef();
+}
+void rhiRenderBundleEncoderRelease(RHIRenderBundleEncoder encoder)
+{
+    encoder->Release();
+}
+// methods of RenderBundle
+void rhiRenderBundleAddRef(RHIRenderBundle bundle)
+{
+    bundle->AddRef();
+}
+void rhiRenderBundleRelease(RHIRenderBundle bundle)
+{
+    bundle->Release();
+}
 // methods of ComputePassEncoder
 void rhiComputePassEncoderSetPipeline(RHIComputePassEncoder encoder, RHIComputePipeline pipeline)
 {
@@ -491,6 +770,21 @@ void rhiComputePassEncoderSetBindSet(RHIComputePassEncoder encoder,
 {
     encoder->APISetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets);
 }
+void rhiComputePassEncoderPushBindings(RHIComputePassEncoder encoder,
+                                       uint32_t setIndex,
+                                       uint32_t entryCount,
+                                       const RHIBindSetEntry* entries)
+{
+    encoder->APIPushBindings(setIndex, entryCount, reinterpret_cast<const BindSetEntry*>(entries));
+}
+void rhiComputePassEncoderUseResidentResources(RHIComputePassEncoder encoder,
+                                               RHIResourceHeap heap,
+                                               RHIResourceHeapSlotType type,
+                                               uint32_t slotCount,
+                                               const uint32_t* slots)
+{
+    encoder->APIUseResidentResources(heap, static_cast<ResourceHeapSlotType>(type), slotCount, slots);
+}
 void rhiComputePassEncoderSetPushConstant(
         RHIComputePassEncoder encoder, RHIShaderStage stage, const void* data, uint32_t size, uint32_t offset)
 {
@@ -572,6 +866,10 @@ void rhiPipelineCacheRelease(RHIPipelineCache pipelineLayout)
 }
 
 // methods of BindSetLayout
+void rhiBindSetLayoutGetDescriptorStats(RHIBindSetLayout bindSetLayout, RHIDescriptorStats* stats)
+{
+    bindSetLayout->APIGetDescriptorStats(reinterpret_cast<DescriptorStats*>(stats));
+}
 void rhiBindSetLayoutAddRef(RHIBindSetLayout bindSetLayout)
 {
     bindSetLayout->AddRef();
@@ -593,6 +891,45 @@ void rhiBindSetRelease(RHIBindSet bindSet)
 {
     bindSet->Release();
 }
+// methods of ResourceHeap
+RHIBindSetLayout rhiResourceHeapGetBindSetLayout(RHIResourceHeap heap)
+{
+    auto result = heap->APIGetBindSetLayout();
+    return static_cast<RHIBindSetLayout>(result);
+}
+RHIBindSet rhiResourceHeapGetBindSet(RHIResourceHeap heap)
+{
+    auto result = heap->APIGetBindSet();
+    return static_cast<RHIBindSet>(result);
+}
+uint32_t rhiResourceHeapAllocateSlot(RHIResourceHeap heap, RHIResourceHeapSlotType type)
+{
+    return heap->APIAllocateSlot(static_cast<ResourceHeapSlotType>(type));
+}
+void rhiResourceHeapFreeSlot(RHIResourceHeap heap, RHIResourceHeapSlotType type, uint32_t slot)
+{
+    heap->APIFreeSlot(static_cast<ResourceHeapSlotType>(type), slot);
+}
+void rhiResourceHeapWriteSampledTexture(RHIResourceHeap heap, uint32_t slot, RHITextureView textureView)
+{
+    heap->APIWriteSampledTexture(slot, textureView);
+}
+void rhiResourceHeapWriteStorageBuffer(RHIResourceHeap heap, uint32_t slot, RHIBuffer buffer, uint64_t offset, uint64_t size)
+{
+    heap->APIWriteStorageBuffer(slot, buffer, offset, size);
+}
+void rhiResourceHeapWriteSampler(RHIResourceHeap heap, uint32_t slot, RHISampler sampler)
+{
+    heap->APIWriteSampler(slot, sampler);
+}
+void rhiResourceHeapAddRef(RHIResourceHeap heap)
+{
+    heap->AddRef();
+}
+void rhiResourceHeapRelease(RHIResourceHeap heap)
+{
+    heap->Release();
+}
 // methods of Buffer
 RHIBufferUsage rhiBufferGetUsage(RHIBuffer buffer)
 {
@@ -21,6 +21,8 @@ namespace rhi::impl
     class PipelineLayoutBase;
     // class QuerySetBase;
     class QueueBase;
+    class RenderBundleBase;
+    class RenderBundleEncoder;
     class RenderPassEncoder;
     class RenderPipelineBase;
     class ResourceHeapBase;
@@ -37,6 +39,7 @@ namespace rhi::impl
     constexpr uint32_t CAutoCompute = uint32_t(-1);
     constexpr uint32_t CArraySizeUndefined = uint32_t(-1);
     constexpr uint32_t CMipLevelCountUndefined = uint32_t(-1);
+    constexpr uint32_t CResourceHeapSlotInvalid = uint32_t(-1);
 
 
 #define ENUM_CLASS_FLAG_OPERATORS(EnumName)                                                                            \
@@ -93,6 +96,28 @@ namespace rhi::impl
         DestroyedBeforeCallback,
     };
 
+    enum class SerialCompletedStatus
+    {
+        Success,
+        DeviceLost,
+        DestroyedBeforeCallback,
+    };
+
+    enum class ReadbackStatus
+    {
+        Success,
+        DeviceLost,
+        DestroyedBeforeCallback,
+    };
+
+    enum class CreatePipelineAsyncStatus
+    {
+        Success,
+        Error,
+        DeviceLost,
+        DestroyedBeforeCallback,
+    };
+
     // defualt VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
     enum class BufferUsage : uint32_t
     {
@@ -355,6 +380,14 @@ namespace rhi::impl
         CombinedTextureSampler
     };
 
+    enum class ResourceHeapSlotType : uint32_t
+    {
+        SampledTexture,
+        StorageBuffer,
+        Sampler,
+        Count
+    };
+
     enum class ShaderStage : uint32_t
     {
         None = (0 << 0),
@@ -480,6 +513,8 @@ namespace rhi::impl
         DepthBiasClamp,
         DepthClamp,
         R8UnormStorage,
+        DescriptorIndexing,
+        DescriptorBuffer,
         Count
     };
 
@@ -522,6 +557,14 @@ namespace rhi::impl
     };
 
     using BufferMapCallback = void (*)(BufferMapAsyncStatus status, void* mappedAdress, void* userdata);
+    using SerialCompletedCallback = void (*)(SerialCompletedStatus status, void* userdata);
+    using ReadbackCallback = void (*)(ReadbackStatus status, const void* data, uint64_t size, void* userdata);
+    using CreateRenderPipelineAsyncCallback = void (*)(CreatePipelineAsyncStatus status,
+                                                       RenderPipelineBase* pipeline,
+                                                       void* userdata);
+    using CreateComputePipelineAsyncCallback = void (*)(CreatePipelineAsyncStatus status,
+                                                        ComputePipelineBase* pipeline,
+                                                        void* userdata);
     typedef void(_stdcall* LoggingCallback)(LoggingSeverity severity, const char* msg, void* userData);
     // using DebugMessageCallbackFunc = std::function<void(MessageSeverity severity, const char* msg)>;
 
@@ -613,6 +656,22 @@ namespace rhi::impl
         TextureAspect aspect = TextureAspect::All;
     };
 
+    struct UploadReservation
+    {
+        void* data = nullptr;
+        uint64_t size = 0;
+        BufferBase* stagingBuffer = nullptr;
+        uint64_t stagingOffset = 0;
+        uint64_t serial = 0;
+    };
+
+    struct UniformAllocation
+    {
+        void* data = nullptr;
+        BufferBase* buffer = nullptr;
+        uint32_t dynamicOffset = 0;
+    };
+
     struct SpecializationConstant
     {
         uint32_t constantID = 0;
@@ -902,6 +961,7 @@ namespace rhi::impl
         std::string_view name;
         uint32_t entryCount;
         BindSetLayoutEntry const* entries;
+        bool pushDescriptor = false;
     };
 
     struct BindSetDesc
@@ -994,6 +1054,15 @@ namespace rhi::impl
         size_t dataSize;
     };
 
+    struct ResourceHeapDesc
+    {
+        std::string_view name;
+        uint32_t sampledTextureCount = 0;
+        uint32_t storageBufferCount = 0;
+        uint32_t samplerCount = 0;
+        ShaderStage visibility = ShaderStage::All;
+    };
+
     struct PipelineLayoutDesc
     {
         std::string_view name;
@@ -1036,6 +1105,7 @@ namespace rhi::impl
         TextureFormat depthStencilFormat = TextureFormat::Undefined;
 
         uint32_t patchControlPoints = 0;
+        bool extendedDynamicState = false;
     };
 
     struct ComputePipelineDesc
@@ -1138,6 +1208,59 @@ namespace rhi::impl
         float maxSamplerAnisotropy;
     };
 
+    // Descriptor sets allocated for the bind sets of one layout.
+    struct DescriptorStats
+    {
+        uint64_t poolCount;
+        // Sum of maxSets over the live pools.
+        uint64_t setCapacity;
+        uint64_t liveSets;
+        // Sets that can be handed out without creating a pool, allocated from their pool or not.
+        uint64_t freeSets;
+        uint64_t poolCreations;
+        // Pools destroyed after staying fully free for a while.
+        uint64_t poolReclaims;
+    };
+
+    // Bind sets shared through the device cache, see rhiDeviceCreateBindSet.
+    struct BindSetCacheStats
+    {
+        // Bind set creations that returned an identical live bind set.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t cachedBindSets;
+    };
+
+    // Ring buffers behind rhiQueueAllocateUniforms.
+    struct UniformAllocatorStats
+    {
+        uint64_t allocationCount;
+        uint64_t allocatedBytes;
+        uint64_t ringBufferCreations;
+        uint64_t ringBufferReleases;
+        // Ring buffers currently alive.
+        uint64_t ringBufferCount;
+    };
+
+    // Pipelines shared through the device cache, see rhiDeviceCreateRenderPipeline.
+    struct PipelineObjectCacheStats
+    {
+        // Pipeline creations that returned an identical live pipeline instead of compiling a new one.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t cachedRenderPipelines;
+        uint64_t cachedComputePipelines;
+    };
+
+    // Shader modules shared through the device cache, see rhiDeviceCreateShader.
+    struct ShaderModuleCacheStats
+    {
+        // Shader creations that returned a live module with the same code and entry point.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t cachedShaderModules;
+    };
+
     struct InstanceDesc
     {
         BackendType backend = BackendType::Vulkan;
@@ -1151,5 +1274,10 @@ namespace rhi::impl
         std::string_view name;
         uint32_t requiredFeatureCount = 0;
         FeatureName const* requiredFeatures;
+        uint32_t commandRecordingThreadCount = 0;
+        bool asyncSubmission = false;
+        uint64_t uploadRingBufferSize = 0;
+        uint32_t pipelineCompilationThreadCount = 0;
+        std::string_view pipelineCacheDirectory;
     };
 } // namespace rhi::impl
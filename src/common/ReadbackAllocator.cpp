@@ -0,0 +1,114 @@
+#include "ReadbackAllocator.h"
+#include "BufferBase.h"
+#include "DeviceBase.h"
+#include "common/Error.h"
+#include "common/Utils.h"
+
+namespace rhi::impl
+{
+    ReadbackAllocator::ReadbackAllocator(DeviceBase* device, QueueType queueType)
+        : mDevice(device)
+        , mQueueType(queueType)
+    {}
+
+    ReadbackAllocator::~ReadbackAllocator() = default;
+
+    Ref<ReadbackAllocator> ReadbackAllocator::Create(DeviceBase* device, QueueType queueType)
+    {
+        return AcquireRef(new ReadbackAllocator(device, queueType));
+    }
+
+    Ref<BufferBase> ReadbackAllocator::CreateStagingBuffer(uint64_t size)
+    {
+        BufferDesc desc{};
+        desc.usage = BufferUsage::CopyDst | BufferUsage::MapRead;
+        desc.size = AlignUp(size, 4u);
+        desc.name = "ReadbackStageBuffer";
+
+        Ref<BufferBase> buffer = mDevice->CreateBufferImpl(desc, mQueueType);
+        ASSERT(buffer != nullptr && buffer->APIGetMappedPointer() != nullptr);
+        return buffer;
+    }
+
+    ReadbackAllocation ReadbackAllocator::Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment)
+    {
+        ReadbackAllocation allocation{};
+        allocation.serial = serial;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (allocationSize > cRingBufferSize)
+        {
+            Ref<BufferBase> buffer = CreateStagingBuffer(allocationSize);
+            allocation.buffer = buffer.Get();
+            allocation.mappedAddress = buffer->APIGetMappedPointer();
+            mDedicatedBuffers.emplace(buffer.Get(), std::move(buffer));
+            return allocation;
+        }
+
+        uint64_t startOffset = RingBuffer::cInvalidOffset;
+        RingBuffer* targetRingBuffer = nullptr;
+        for (auto& ringBuffer : mRingBuffers)
+        {
+            startOffset = ringBuffer->Allocate(allocationSize, serial, offsetAlignment);
+            if (startOffset != RingBuffer::cInvalidOffset)
+            {
+                targetRingBuffer = ringBuffer.get();
+                break;
+            }
+        }
+
+        if (startOffset == RingBuffer::cInvalidOffset)
+        {
+            mRingBuffers.emplace_back(std::make_unique<RingBuffer>(cRingBufferSize));
+            targetRingBuffer = mRingBuffers.back().get();
+            targetRingBuffer->buffer = CreateStagingBuffer(cRingBufferSize);
+            startOffset = targetRingBuffer->Allocate(allocationSize, serial, offsetAlignment);
+        }
+        ASSERT(startOffset != RingBuffer::cInvalidOffset);
+
+        // The data is read after the serial completed, nothing can be recycled before it is freed.
+        targetRingBuffer->OpenReservation(serial);
+
+        allocation.buffer = targetRingBuffer->buffer.Get();
+        allocation.offset = startOffset;
+        allocation.mappedAddress = static_cast<uint8_t*>(targetRingBuffer->buffer->APIGetMappedPointer()) + startOffset;
+        return allocation;
+    }
+
+    void ReadbackAllocator::Free(const ReadbackAllocation& allocation)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mDedicatedBuffers.erase(allocation.buffer) != 0)
+        {
+            return;
+        }
+
+        for (auto& ringBuffer : mRingBuffers)
+        {
+            if (ringBuffer->buffer.Get() == allocation.buffer)
+            {
+                ringBuffer->CloseReservation(allocation.serial, allocation.serial);
+                return;
+            }
+        }
+        ASSERT(false);
+    }
+
+    void ReadbackAllocator::Deallocate(uint64_t lastCompletedSerial)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto ringBufferIter = mRingBuffers.begin(); ringBufferIter != mRingBuffers.end();)
+        {
+            (*ringBufferIter)->Deallocate(lastCompletedSerial);
+            if ((*ringBufferIter)->Empty() && mRingBuffers.size() > 1)
+            {
+                // Never erase the last buffer as to prevent re-creating smaller buffers.
+                ringBufferIter = mRingBuffers.erase(ringBufferIter);
+            }
+            else
+            {
+                ++ringBufferIter;
+            }
+        }
+    }
+} // namespace rhi::impl
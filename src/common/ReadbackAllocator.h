@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "RHIStruct.h"
+#include "RingBuffer.h"
+#include "common/Ref.hpp"
+#include "common/RefCounted.h"
+
+namespace rhi::impl
+{
+    struct ReadbackAllocation
+    {
+        BufferBase* buffer;
+        uint64_t offset;
+        void* mappedAddress;
+        uint64_t serial;
+    };
+
+    // Host cached staging memory for queue readbacks, the download counterpart of UploadAllocator. An allocation
+    // stays alive after its serial completed, until it is freed by whoever consumed the data.
+    class ReadbackAllocator : public RefCounted
+    {
+    public:
+        static Ref<ReadbackAllocator> Create(DeviceBase* device, QueueType queueType);
+
+        ReadbackAllocation Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment);
+        void Free(const ReadbackAllocation& allocation);
+        void Deallocate(uint64_t lastCompletedSerial);
+
+    private:
+        ReadbackAllocator(DeviceBase* device, QueueType queueType);
+        ~ReadbackAllocator() override;
+
+        Ref<BufferBase> CreateStagingBuffer(uint64_t size);
+
+        static constexpr uint64_t cRingBufferSize = 4 * 1024 * 1024;
+
+        std::mutex mMutex;
+        std::list<std::unique_ptr<RingBuffer>> mRingBuffers;
+        std::unordered_map<BufferBase*, Ref<BufferBase>> mDedicatedBuffers;
+
+        DeviceBase* mDevice;
+        QueueType mQueueType;
+    };
+} // namespace rhi::impl
@@ -0,0 +1,43 @@
+#include "RenderBundleBase.h"
+#include "Commands.h"
+#include "RenderBundleEncoder.h"
+
+namespace rhi::impl
+{
+    RenderBundleBase::RenderBundleBase(RenderBundleEncoder* encoder)
+        : mCommandIter(encoder->AcquireCommands())
+        , mResourceUsage(encoder->AcquireResourceUsage())
+        , mBindSets(encoder->AcquireBindSets())
+    {}
+
+    RenderBundleBase::~RenderBundleBase()
+    {
+        FreeCommands(&mCommandIter);
+        mCommandIter.Clear();
+    }
+
+    Ref<RenderBundleBase> RenderBundleBase::Create(RenderBundleEncoder* encoder)
+    {
+        return AcquireRef(new RenderBundleBase(encoder));
+    }
+
+    const SyncScopeResourceUsage& RenderBundleBase::GetResourceUsage() const
+    {
+        return mResourceUsage;
+    }
+
+    const std::vector<BindSetBase*>& RenderBundleBase::GetBindSets() const
+    {
+        return mBindSets;
+    }
+
+    std::unique_lock<std::mutex> RenderBundleBase::LockCommands()
+    {
+        return std::unique_lock<std::mutex>(mCommandMutex);
+    }
+
+    CommandIterator* RenderBundleBase::GetCommands()
+    {
+        return &mCommandIter;
+    }
+} // namespace rhi::impl
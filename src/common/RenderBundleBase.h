@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CommandAllocator.h"
+#include "PassResourceUsage.h"
+#include "common/RefCounted.h"
+
+#include <mutex>
+#include <vector>
+
+namespace rhi::impl
+{
+    class RenderBundleEncoder;
+
+    // A validated sequence of draw commands whose resource usage is tracked once at creation, and which can be
+    // executed in any number of render passes.
+    class RenderBundleBase : public RefCounted
+    {
+    public:
+        static Ref<RenderBundleBase> Create(RenderBundleEncoder* encoder);
+
+        const SyncScopeResourceUsage& GetResourceUsage() const;
+        const std::vector<BindSetBase*>& GetBindSets() const;
+        // The commands are shared by every execution of the bundle, they must only be iterated while the
+        // returned lock is held.
+        std::unique_lock<std::mutex> LockCommands();
+        CommandIterator* GetCommands();
+
+    protected:
+        explicit RenderBundleBase(RenderBundleEncoder* encoder);
+        ~RenderBundleBase() override;
+
+    private:
+
+        std::mutex mCommandMutex;
+        CommandIterator mCommandIter;
+        SyncScopeResourceUsage mResourceUsage;
+        std::vector<BindSetBase*> mBindSets;
+    };
+} // namespace rhi::impl
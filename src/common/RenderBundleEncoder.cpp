@@ -0,0 +1,74 @@
+#include "RenderBundleEncoder.h"
+#include "Commands.h"
+#include "DeviceBase.h"
+#include "RenderBundleBase.h"
+#include "common/Error.h"
+
+namespace rhi::impl
+{
+    RenderBundleEncoder::RenderBundleEncoder(DeviceBase* device)
+        : RenderEncoderBase(device, nullptr, mBundleEncodingContext, SyncScopeUsageTracker())
+        , mBundleEncodingContext(device)
+    {}
+
+    RenderBundleEncoder::~RenderBundleEncoder()
+    {
+        if (!mIsEnded)
+        {
+            // Destroy the commands of a bundle that was never finished.
+            CommandIterator commands = AcquireCommands();
+            FreeCommands(&commands);
+        }
+    }
+
+    Ref<RenderBundleEncoder> RenderBundleEncoder::Create(DeviceBase* device)
+    {
+        return AcquireRef(new RenderBundleEncoder(device));
+    }
+
+    void RenderBundleEncoder::APISetBindSet(BindSetBase* set,
+                                            uint32_t setIndex,
+                                            uint32_t dynamicOffsetCount,
+                                            const uint32_t* dynamicOffsets)
+    {
+        RenderEncoderBase::APISetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets);
+        mBindSets.insert(set);
+    }
+
+    Ref<RenderBundleBase> RenderBundleEncoder::Finish()
+    {
+        INVALID_IF(mIsEnded, "The render bundle encoder has already been finished.");
+        INVALID_IF(mDebugLabelCount != 0, "BeginDebugLabel and EndDebugLabel are not balanced in the render bundle.");
+
+        mIsEnded = true;
+        ReportElidedCommands();
+        return RenderBundleBase::Create(this);
+    }
+
+    RenderBundleBase* RenderBundleEncoder::APIFinish()
+    {
+        return Finish().Detach();
+    }
+
+    DeviceBase* RenderBundleEncoder::GetDevice() const
+    {
+        return mDevice;
+    }
+
+    CommandIterator RenderBundleEncoder::AcquireCommands()
+    {
+        return mBundleEncodingContext.AcquireCommands();
+    }
+
+    SyncScopeResourceUsage RenderBundleEncoder::AcquireResourceUsage()
+    {
+        return mUsageTracker.AcquireSyncScopeUsage();
+    }
+
+    std::vector<BindSetBase*> RenderBundleEncoder::AcquireBindSets()
+    {
+        std::vector<BindSetBase*> bindSets(mBindSets.begin(), mBindSets.end());
+        mBindSets.clear();
+        return bindSets;
+    }
+} // namespace rhi::impl
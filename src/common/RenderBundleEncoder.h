@@ -0,0 +1,41 @@
+#pragma once
+
+#include "EncodingContext.h"
+#include "RenderEncoderBase.h"
+
+#include <absl/container/flat_hash_set.h>
+#include <vector>
+
+namespace rhi::impl
+{
+    class RenderBundleBase;
+
+    class RenderBundleEncoder : public RenderEncoderBase
+    {
+    public:
+        static Ref<RenderBundleEncoder> Create(DeviceBase* device);
+
+        void APISetBindSet(BindSetBase* set,
+                           uint32_t setIndex,
+                           uint32_t dynamicOffsetCount = 0,
+                           const uint32_t* dynamicOffsets = nullptr);
+        RenderBundleBase* APIFinish();
+        Ref<RenderBundleBase> Finish();
+
+        DeviceBase* GetDevice() const;
+        CommandIterator AcquireCommands();
+        SyncScopeResourceUsage AcquireResourceUsage();
+        std::vector<BindSetBase*> AcquireBindSets();
+
+    protected:
+        explicit RenderBundleEncoder(DeviceBase* device);
+        ~RenderBundleEncoder();
+
+    private:
+
+        // The base classes only keep a reference to the context while it is constructed after them, it must not
+        // be used before this constructor body runs.
+        EncodingContext mBundleEncodingContext;
+        absl::flat_hash_set<BindSetBase*> mBindSets;
+    };
+} // namespace rhi::impl
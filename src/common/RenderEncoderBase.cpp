@@ -0,0 +1,246 @@
+#include "RenderEncoderBase.h"
+#include "BufferBase.h"
+#include "Commands.h"
+#include "RenderPipelinebase.h"
+#include "ResourceHeapBase.h"
+#include "common/Error.h"
+
+namespace rhi::impl
+{
+    RenderEncoderBase::RenderEncoderBase(DeviceBase* device,
+                                         CommandEncoder* encoder,
+                                         EncodingContext& encodingContext,
+                                         SyncScopeUsageTracker&& usageTracker)
+        : PassEncoder(device, encoder, encodingContext)
+        , mUsageTracker(std::move(usageTracker))
+    {}
+
+    RenderEncoderBase::~RenderEncoderBase() {}
+
+    void RenderEncoderBase::ResetDrawState()
+    {
+        ResetBoundState();
+        mVertexBuffers = {};
+        mIndexBuffer = {};
+    }
+
+    void RenderEncoderBase::APISetPipeline(RenderPipelineBase* pipeline)
+    {
+        ASSERT(pipeline != nullptr);
+
+        if (!ShouldSetPipeline(pipeline))
+        {
+            return;
+        }
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        SetRenderPipelineCmd* cmd = allocator.Allocate<SetRenderPipelineCmd>(Command::SetRenderPipeline);
+        cmd->pipeline = pipeline;
+    }
+
+    void RenderEncoderBase::APISetVertexBuffers(uint32_t firstSlot,
+                                                uint32_t bufferCount,
+                                                BufferBase* const* buffers,
+                                                uint64_t* offsets)
+    {
+        ASSERT(firstSlot + bufferCount <= cMaxVertexBuffers);
+
+        // Only record the range of slots whose binding actually changes.
+        uint32_t firstChanged = bufferCount;
+        uint32_t lastChanged = 0;
+        for (uint32_t i = 0; i < bufferCount; ++i)
+        {
+            ASSERT(buffers[i] != nullptr);
+            ASSERT(HasFlag(buffers[i]->APIGetUsage(), BufferUsage::Vertex));
+            const uint64_t offset = offsets == nullptr ? 0ull : offsets[i];
+            VertexBufferState& state = mVertexBuffers[firstSlot + i];
+            if (state.buffer != buffers[i] || state.offset != offset)
+            {
+                firstChanged = std::min(firstChanged, i);
+                lastChanged = i;
+                state.buffer = buffers[i];
+                state.offset = offset;
+            }
+        }
+
+        if (firstChanged == bufferCount)
+        {
+            ElideCommand();
+            return;
+        }
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        SetVertexBufferCmd* cmd = allocator.Allocate<SetVertexBufferCmd>(Command::SetVertexBuffer);
+        for (uint32_t i = firstChanged; i <= lastChanged; ++i)
+        {
+            VertexBuffer& vertexBuffer = cmd->buffers[i - firstChanged];
+            vertexBuffer.buffer = buffers[i];
+            vertexBuffer.offset = offsets == nullptr ? 0ull : offsets[i];
+
+            mUsageTracker.BufferUsedAs(buffers[i], BufferUsage::Vertex);
+        }
+        cmd->firstSlot = firstSlot + firstChanged;
+        cmd->bufferCount = lastChanged - firstChanged + 1;
+    }
+
+    void RenderEncoderBase::APISetIndexBuffer(BufferBase* buffer,
+                                              IndexFormat indexFormat,
+                                              uint64_t offset,
+                                              uint64_t size)
+    {
+        ASSERT(buffer != nullptr);
+        ASSERT(HasFlag(buffer->APIGetUsage(), BufferUsage::Index));
+
+        if (mIndexBuffer.buffer == buffer && mIndexBuffer.format == indexFormat && mIndexBuffer.offset == offset &&
+            mIndexBuffer.size == size)
+        {
+            ElideCommand();
+            return;
+        }
+        mIndexBuffer = {buffer, indexFormat, offset, size};
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        SetIndexBufferCmd* cmd = allocator.Allocate<SetIndexBufferCmd>(Command::SetIndexBuffer);
+        cmd->buffer = buffer;
+        cmd->format = indexFormat;
+        cmd->offset = offset;
+
+        mUsageTracker.BufferUsedAs(buffer, BufferUsage::Index);
+    }
+
+    void RenderEncoderBase::APISetBindSet(BindSetBase* set,
+                                          uint32_t setIndex,
+                                          uint32_t dynamicOffsetCount,
+                                          const uint32_t* dynamicOffsets)
+    {
+        ASSERT(set != nullptr);
+        if (RecordSetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets))
+        {
+            mUsageTracker.AddBindSet(set);
+        }
+    }
+
+    void RenderEncoderBase::APIPushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries)
+    {
+        BindSetLayoutBase* layout = RecordPushBindings(setIndex, entryCount, entries);
+        mUsageTracker.AddBindings(layout, entries, entryCount);
+    }
+
+    void RenderEncoderBase::APIUseResidentResources(ResourceHeapBase* heap,
+                                                      ResourceHeapSlotType type,
+                                                      uint32_t slotCount,
+                                                      const uint32_t* slots)
+    {
+        uint32_t resourceCount;
+        const Ref<ResourceBase>* resources = RecordUseResidentResources(heap, type, slotCount, slots, &resourceCount);
+        if (resourceCount > 0)
+        {
+            mUsageTracker.AddResidentResources(type, heap->GetVisibility(), resources, resourceCount);
+        }
+    }
+
+    void RenderEncoderBase::APIDraw(uint32_t vertexCount,
+                                    uint32_t instanceCount,
+                                    uint32_t firstVertex,
+                                    uint32_t firstInstance)
+    {
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        DrawCmd* draw = allocator.Allocate<DrawCmd>(Command::Draw);
+        draw->vertexCount = vertexCount;
+        draw->instanceCount = instanceCount;
+        draw->firstVertex = firstVertex;
+        draw->firstInstance = firstInstance;
+    }
+
+    void RenderEncoderBase::APIDrawIndexed(uint32_t indexCount,
+                                           uint32_t instanceCount,
+                                           uint32_t firstIndex,
+                                           int32_t baseVertex,
+                                           uint32_t firstInstance)
+    {
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        DrawIndexedCmd* draw = allocator.Allocate<DrawIndexedCmd>(Command::DrawIndexed);
+        draw->indexCount = indexCount;
+        draw->instanceCount = instanceCount;
+        draw->firstIndex = firstIndex;
+        draw->baseVertex = baseVertex;
+        draw->firstInstance = firstInstance;
+    }
+
+    void RenderEncoderBase::APIDrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset)
+    {
+        ASSERT(indirectBuffer != nullptr);
+        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        DrawIndirectCmd* cmd = allocator.Allocate<DrawIndirectCmd>(Command::DrawIndirect);
+        cmd->indirectBuffer = indirectBuffer;
+        cmd->indirectOffset = indirectOffset;
+        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
+    }
+
+
+    void RenderEncoderBase::APIDrawIndexedIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset)
+    {
+        ASSERT(indirectBuffer != nullptr);
+        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
+        INVALID_IF(indirectOffset % 4 != 0, "Indirect offset (%u) is not a multiple of 4.", indirectOffset);
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        DrawIndexedIndirectCmd* cmd = allocator.Allocate<DrawIndexedIndirectCmd>(Command::DrawIndexedIndirect);
+        cmd->indirectBuffer = indirectBuffer;
+        cmd->indirectOffset = indirectOffset;
+        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
+    }
+
+    void RenderEncoderBase::APIMultiDrawIndirect(BufferBase* indirectBuffer,
+                                                 uint64_t indirectOffset,
+                                                 uint32_t maxDrawCount,
+                                                 BufferBase* drawCountBuffer,
+                                                 uint64_t drawCountBufferOffset)
+    {
+        ASSERT(indirectBuffer != nullptr);
+        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
+        INVALID_IF(drawCountBuffer && !HasFlag(drawCountBuffer->APIGetUsage(), BufferUsage::Indirect),
+                   "drawCountBuffer must has Indirect usage.");
+
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        MultiDrawIndirectCmd* cmd = allocator.Allocate<MultiDrawIndirectCmd>(Command::MultiDrawIndirect);
+        cmd->indirectBuffer = indirectBuffer;
+        cmd->indirectOffset = indirectOffset;
+        cmd->maxDrawCount = maxDrawCount;
+        cmd->drawCountBuffer = drawCountBuffer;
+        cmd->drawCountOffset = drawCountBufferOffset;
+        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
+        if (drawCountBuffer)
+        {
+            mUsageTracker.BufferUsedAs(drawCountBuffer, BufferUsage::Indirect);
+        }
+    }
+
+    void RenderEncoderBase::APIMultiDrawIndexedIndirect(BufferBase* indirectBuffer,
+                                                        uint64_t indirectOffset,
+                                                        uint32_t maxDrawCount,
+                                                        BufferBase* drawCountBuffer,
+                                                        uint64_t drawCountBufferOffset)
+    {
+        ASSERT(indirectBuffer != nullptr);
+        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
+        INVALID_IF(drawCountBuffer && !HasFlag(drawCountBuffer->APIGetUsage(), BufferUsage::Indirect),
+                   "drawCountBuffer must has Indirect usage.");
+
+
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        MultiDrawIndexedIndirectCmd* cmd =
+                allocator.Allocate<MultiDrawIndexedIndirectCmd>(Command::MultiDrawIndexedIndirect);
+        cmd->indirectBuffer = indirectBuffer;
+        cmd->indirectOffset = indirectOffset;
+        cmd->maxDrawCount = maxDrawCount;
+        cmd->drawCountBuffer = drawCountBuffer;
+        cmd->drawCountOffset = drawCountBufferOffset;
+        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
+        if (drawCountBuffer)
+        {
+            mUsageTracker.BufferUsedAs(drawCountBuffer, BufferUsage::Indirect);
+        }
+    }
+} // namespace rhi::impl
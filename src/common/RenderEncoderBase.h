@@ -0,0 +1,88 @@
+#pragma once
+
+#include "EncodingContext.h"
+#include "PassEncoder.h"
+#include "RHIStruct.h"
+#include "SyncScopeUsageTracker.h"
+
+#include <array>
+
+namespace rhi::impl
+{
+    class CommandEncoder;
+    class RenderPipelineBase;
+
+    // The draw commands shared by render passes and render bundles.
+    class RenderEncoderBase : public PassEncoder
+    {
+    public:
+        void APISetPipeline(RenderPipelineBase* pipeline);
+        void APISetVertexBuffers(uint32_t firstSlot,
+                                 uint32_t bufferCount,
+                                 BufferBase* const* buffers,
+                                 uint64_t* offsets = nullptr);
+        void APISetIndexBuffer(BufferBase* buffer,
+                               IndexFormat indexFormat,
+                               uint64_t offset = 0,
+                               uint64_t size = CWholeSize);
+        void APISetBindSet(BindSetBase* set,
+                           uint32_t setIndex,
+                           uint32_t dynamicOffsetCount = 0,
+                           const uint32_t* dynamicOffsets = nullptr);
+        void APIPushBindings(uint32_t setIndex, uint32_t entryCount, const BindSetEntry* entries);
+        void APIUseResidentResources(ResourceHeapBase* heap,
+                                     ResourceHeapSlotType type,
+                                     uint32_t slotCount,
+                                     const uint32_t* slots);
+        void APIDraw(uint32_t vertexCount,
+                     uint32_t instanceCount = 1,
+                     uint32_t firstVertex = 0,
+                     uint32_t firstInstance = 0);
+        void APIDrawIndexed(uint32_t indexCount,
+                            uint32_t instanceCount,
+                            uint32_t firstIndex,
+                            int32_t baseVertex,
+                            uint32_t firstInstance);
+        void APIDrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
+        void APIDrawIndexedIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
+        void APIMultiDrawIndirect(BufferBase* indirectBuffer,
+                                  uint64_t indirectOffset,
+                                  uint32_t maxDrawCount,
+                                  BufferBase* drawCountBuffer = nullptr,
+                                  uint64_t drawCountBufferOffset = 0);
+        void APIMultiDrawIndexedIndirect(BufferBase* indirectBuffer,
+                                         uint64_t indirectOffset,
+                                         uint32_t maxDrawCount,
+                                         BufferBase* drawCountBuffer = nullptr,
+                                         uint64_t drawCountBufferOffset = 0);
+
+    protected:
+        explicit RenderEncoderBase(DeviceBase* device,
+                                   CommandEncoder* encoder,
+                                   EncodingContext& encodingContext,
+                                   SyncScopeUsageTracker&& usageTracker);
+        ~RenderEncoderBase();
+        // Forgets all the state recorded so far, the next commands must set it again.
+        void ResetDrawState();
+
+        SyncScopeUsageTracker mUsageTracker;
+
+    private:
+        // Shadow of the state already recorded in this encoder, used to drop redundant commands.
+        struct VertexBufferState
+        {
+            BufferBase* buffer = nullptr;
+            uint64_t offset = 0;
+        };
+        std::array<VertexBufferState, cMaxVertexBuffers> mVertexBuffers;
+
+        struct IndexBufferState
+        {
+            BufferBase* buffer = nullptr;
+            IndexFormat format = IndexFormat::Uint16;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+        IndexBufferState mIndexBuffer;
+    };
+} // namespace rhi::impl
@@ -1,17 +1,33 @@
 #include "RenderPassEncoder.h"
 #include "BufferBase.h"
 #include "CommandEncoder.h"
+#include "RenderBundleBase.h"
 #include "RenderPipelinebase.h"
 #include "common/Error.h"
 
+#include <cstring>
 
 namespace rhi::impl
 {
+    namespace
+    {
+        template <typename T>
+        bool IsSameState(const std::optional<T>& state, const T& value)
+        {
+            return state.has_value() && memcmp(&state.value(), &value, sizeof(T)) == 0;
+        }
+
+        bool IsSameStencilOps(const StencilOpState& a, const StencilOpState& b)
+        {
+            return a.failOp == b.failOp && a.passOp == b.passOp && a.depthFailOp == b.depthFailOp &&
+                   a.compareOp == b.compareOp;
+        }
+    } // namespace
+
     RenderPassEncoder::RenderPassEncoder(CommandEncoder* encoder,
                                          EncodingContext& encodingContext,
                                          SyncScopeUsageTracker&& usageTracker)
-        : PassEncoder(encoder, encodingContext)
-        , mUsageTracker(std::move(usageTracker))
+        : RenderEncoderBase(encoder->GetDevice(), encoder, encodingContext, std::move(usageTracker))
     {}
 
     Ref<RenderPassEncoder> RenderPassEncoder::Create(CommandEncoder* encoder,
@@ -23,68 +39,46 @@ namespace rhi::impl
         return renderPassEncoder;
     }
 
-
-    RenderPassEncoder::~RenderPassEncoder()
+    void RenderPassEncoder::APISetPipeline(RenderPipelineBase* pipeline)
     {
-        if (!mIsEnded)
+        RenderEncoderBase::APISetPipeline(pipeline);
+
+        // Binding a pipeline of another topology class resets the dynamic primitive type to the pipeline's one.
+        if (mPrimitiveType.has_value() && pipeline->HasExtendedDynamicState() &&
+            GetTopologyClass(*mPrimitiveType) != pipeline->GetPrimitiveType())
         {
-            APIEnd();
+            mPrimitiveType.reset();
         }
     }
 
-    void RenderPassEncoder::APISetPipeline(RenderPipelineBase* pipeline)
-    {
-        ASSERT(pipeline != nullptr);
-
-        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        SetRenderPipelineCmd* cmd = allocator.Allocate<SetRenderPipelineCmd>(Command::SetRenderPipeline);
-        cmd->pipeline = pipeline;
-
-        mLastPipeline = pipeline;
-    }
 
-    void RenderPassEncoder::APISetVertexBuffers(uint32_t firstSlot,
-                                                uint32_t bufferCount,
-                                                BufferBase* const* buffers,
-                                                uint64_t* offsets)
+    RenderPassEncoder::~RenderPassEncoder()
     {
-        ASSERT(bufferCount <= cMaxVertexBuffers);
-        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        SetVertexBufferCmd* cmd = allocator.Allocate<SetVertexBufferCmd>(Command::SetVertexBuffer);
-        for (uint32_t i = 0; i < bufferCount; ++i)
+        if (!mIsEnded)
         {
-            ASSERT(buffers[i] != nullptr);
-            ASSERT(HasFlag(buffers[i]->APIGetUsage(), BufferUsage::Vertex));
-            VertexBuffer& vertexBuffer = cmd->buffers[i];
-            vertexBuffer.buffer = buffers[i];
-            vertexBuffer.offset = offsets == nullptr ? 0ull : offsets[i];
-
-            mUsageTracker.BufferUsedAs(buffers[i], BufferUsage::Vertex);
+            APIEnd();
         }
-        cmd->firstSlot = firstSlot;
-        cmd->bufferCount = bufferCount;
     }
 
-    void RenderPassEncoder::APISetIndexBuffer(BufferBase* buffer,
-                                              IndexFormat indexFormat,
-                                              uint64_t offset,
-                                              uint64_t size)
+    void RenderPassEncoder::APISetScissorRect(uint32_t firstScissor, const Rect* scissors, uint32_t scissorCount)
     {
-        ASSERT(buffer != nullptr);
-        ASSERT(HasFlag(buffer->APIGetUsage(), BufferUsage::Index));
-
-        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        SetIndexBufferCmd* cmd = allocator.Allocate<SetIndexBufferCmd>(Command::SetIndexBuffer);
-        cmd->buffer = buffer;
-        cmd->format = indexFormat;
-        cmd->offset = offset;
+        ASSERT(firstScissor + scissorCount <= cMaxViewports);
 
-        mUsageTracker.BufferUsedAs(buffer, BufferUsage::Index);
-    }
+        bool changed = false;
+        for (uint32_t i = 0; i < scissorCount; ++i)
+        {
+            if (!IsSameState(mScissors[firstScissor + i], scissors[i]))
+            {
+                mScissors[firstScissor + i] = scissors[i];
+                changed = true;
+            }
+        }
+        if (!changed)
+        {
+            ElideCommand();
+            return;
+        }
 
-    void RenderPassEncoder::APISetScissorRect(uint32_t firstScissor, const Rect* scissors, uint32_t scissorCount)
-    {
-        ASSERT(firstScissor + scissorCount <= cMaxColorAttachments);
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
         SetScissorRectsCmd* cmd = allocator.Allocate<SetScissorRectsCmd>(Command::SetScissorRects);
         for (uint32_t i = 0; i < scissorCount; ++i)
@@ -97,6 +91,13 @@ namespace rhi::impl
 
     void RenderPassEncoder::APISetStencilReference(uint32_t reference)
     {
+        if (mStencilReference == reference)
+        {
+            ElideCommand();
+            return;
+        }
+        mStencilReference = reference;
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
         SetStencilReferenceCmd* cmd = allocator.Allocate<SetStencilReferenceCmd>(Command::SetStencilReference);
         cmd->reference = reference;
@@ -104,144 +105,161 @@ namespace rhi::impl
 
     void RenderPassEncoder::APISetBlendConstant(const Color& blendConstants)
     {
+        if (IsSameState(mBlendConstant, blendConstants))
+        {
+            ElideCommand();
+            return;
+        }
+        mBlendConstant = blendConstants;
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
         SetBlendConstantCmd* cmd = allocator.Allocate<SetBlendConstantCmd>(Command::SetBlendConstant);
         cmd->color = blendConstants;
     }
 
-    void RenderPassEncoder::APISetViewport(uint32_t firstViewport, Viewport const* viewports, uint32_t viewportCount)
+    void RenderPassEncoder::APISetCullMode(CullMode cullMode)
     {
-        ASSERT(viewportCount < cMaxViewports);
-        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        SetViewportCmd* cmd = allocator.Allocate<SetViewportCmd>(Command::SetViewport);
-        for (uint32_t i = 0; i < viewportCount; ++i)
+        if (mCullMode == cullMode)
         {
-            cmd->viewports[i] = viewports[i];
+            ElideCommand();
+            return;
         }
-        cmd->viewportCount = viewportCount;
-        cmd->firstViewport = firstViewport;
-    }
-
+        mCullMode = cullMode;
 
-    void RenderPassEncoder::APISetBindSet(BindSetBase* set,
-                                          uint32_t setIndex,
-                                          uint32_t dynamicOffsetCount,
-                                          const uint32_t* dynamicOffsets)
-    {
-        ASSERT(set != nullptr);
-        RecordSetBindSet(set, setIndex, dynamicOffsetCount, dynamicOffsets);
-        mUsageTracker.AddBindSet(set);
+        CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
+        SetCullModeCmd* cmd = allocator.Allocate<SetCullModeCmd>(Command::SetCullMode);
+        cmd->cullMode = cullMode;
     }
 
-    void RenderPassEncoder::APIDraw(uint32_t vertexCount,
-                                    uint32_t instanceCount,
-                                    uint32_t firstVertex,
-                                    uint32_t firstInstance)
+    void RenderPassEncoder::APISetFrontFace(FrontFace frontFace)
     {
+        if (mFrontFace == frontFace)
+        {
+            ElideCommand();
+            return;
+        }
+        mFrontFace = frontFace;
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        DrawCmd* draw = allocator.Allocate<DrawCmd>(Command::Draw);
-        draw->vertexCount = vertexCount;
-        draw->instanceCount = instanceCount;
-        draw->firstVertex = firstVertex;
-        draw->firstInstance = firstInstance;
+        SetFrontFaceCmd* cmd = allocator.Allocate<SetFrontFaceCmd>(Command::SetFrontFace);
+        cmd->frontFace = frontFace;
     }
 
-    void RenderPassEncoder::APIDrawIndexed(uint32_t indexCount,
-                                           uint32_t instanceCount,
-                                           uint32_t firstIndex,
-                                           int32_t baseVertex,
-                                           uint32_t firstInstance)
+    void RenderPassEncoder::APISetPrimitiveType(PrimitiveType primitiveType)
     {
+        auto pipeline = static_cast<RenderPipelineBase*>(mLastPipeline);
+        INVALID_IF(pipeline != nullptr && pipeline->HasExtendedDynamicState() &&
+                           GetTopologyClass(primitiveType) != pipeline->GetPrimitiveType(),
+                   "The primitive type is not in the topology class of the bound pipeline.");
+
+        if (mPrimitiveType == primitiveType)
+        {
+            ElideCommand();
+            return;
+        }
+        mPrimitiveType = primitiveType;
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        DrawIndexedCmd* draw = allocator.Allocate<DrawIndexedCmd>(Command::DrawIndexed);
-        draw->indexCount = indexCount;
-        draw->instanceCount = instanceCount;
-        draw->firstIndex = firstIndex;
-        draw->baseVertex = baseVertex;
-        draw->firstInstance = firstInstance;
+        SetPrimitiveTypeCmd* cmd = allocator.Allocate<SetPrimitiveTypeCmd>(Command::SetPrimitiveType);
+        cmd->primitiveType = primitiveType;
     }
 
-    void RenderPassEncoder::APIDrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset)
+    void RenderPassEncoder::APISetDepthState(bool depthTestEnable, bool depthWriteEnable, CompareOp depthCompareOp)
     {
-        ASSERT(indirectBuffer != nullptr);
-        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
+        if (mDepthState.has_value() && mDepthState->depthTestEnable == depthTestEnable &&
+            mDepthState->depthWriteEnable == depthWriteEnable && mDepthState->depthCompareOp == depthCompareOp)
+        {
+            ElideCommand();
+            return;
+        }
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        DrawIndirectCmd* cmd = allocator.Allocate<DrawIndirectCmd>(Command::DrawIndirect);
-        cmd->indirectBuffer = indirectBuffer;
-        cmd->indirectOffset = indirectOffset;
-        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
+        SetDepthStateCmd* cmd = allocator.Allocate<SetDepthStateCmd>(Command::SetDepthState);
+        cmd->depthTestEnable = depthTestEnable;
+        cmd->depthWriteEnable = depthWriteEnable;
+        cmd->depthCompareOp = depthCompareOp;
+        mDepthState = *cmd;
     }
 
-
-    void RenderPassEncoder::APIDrawIndexedIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset)
+    void RenderPassEncoder::APISetStencilState(bool stencilTestEnable,
+                                               const StencilOpState& front,
+                                               const StencilOpState& back)
     {
-        ASSERT(indirectBuffer != nullptr);
-        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
-        INVALID_IF(indirectOffset % 4 != 0, "Indirect offset (%u) is not a multiple of 4.", indirectOffset);
+        if (mStencilState.has_value() && mStencilState->stencilTestEnable == stencilTestEnable &&
+            IsSameStencilOps(mStencilState->front, front) && IsSameStencilOps(mStencilState->back, back))
+        {
+            ElideCommand();
+            return;
+        }
+
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        DrawIndexedIndirectCmd* cmd = allocator.Allocate<DrawIndexedIndirectCmd>(Command::DrawIndexedIndirect);
-        cmd->indirectBuffer = indirectBuffer;
-        cmd->indirectOffset = indirectOffset;
-        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
+        SetStencilStateCmd* cmd = allocator.Allocate<SetStencilStateCmd>(Command::SetStencilState);
+        cmd->stencilTestEnable = stencilTestEnable;
+        cmd->front = front;
+        cmd->back = back;
+        mStencilState = *cmd;
     }
 
-    void RenderPassEncoder::APIMultiDrawIndirect(BufferBase* indirectBuffer,
-                                                 uint64_t indirectOffset,
-                                                 uint32_t maxDrawCount,
-                                                 BufferBase* drawCountBuffer,
-                                                 uint64_t drawCountBufferOffset)
+    void RenderPassEncoder::APISetViewport(uint32_t firstViewport, Viewport const* viewports, uint32_t viewportCount)
     {
-        ASSERT(indirectBuffer != nullptr);
-        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
-        INVALID_IF(drawCountBuffer && !HasFlag(drawCountBuffer->APIGetUsage(), BufferUsage::Indirect),
-                   "drawCountBuffer must has Indirect usage.");
+        ASSERT(firstViewport + viewportCount <= cMaxViewports);
 
+        bool changed = false;
+        for (uint32_t i = 0; i < viewportCount; ++i)
+        {
+            if (!IsSameState(mViewports[firstViewport + i], viewports[i]))
+            {
+                mViewports[firstViewport + i] = viewports[i];
+                changed = true;
+            }
+        }
+        if (!changed)
+        {
+            ElideCommand();
+            return;
+        }
 
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        MultiDrawIndirectCmd* cmd = allocator.Allocate<MultiDrawIndirectCmd>(Command::MultiDrawIndirect);
-        cmd->indirectBuffer = indirectBuffer;
-        cmd->indirectOffset = indirectOffset;
-        cmd->maxDrawCount = maxDrawCount;
-        cmd->drawCountBuffer = drawCountBuffer;
-        cmd->drawCountOffset = drawCountBufferOffset;
-        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
-        if (drawCountBuffer)
+        SetViewportCmd* cmd = allocator.Allocate<SetViewportCmd>(Command::SetViewport);
+        for (uint32_t i = 0; i < viewportCount; ++i)
         {
-            mUsageTracker.BufferUsedAs(drawCountBuffer, BufferUsage::Indirect);
+            cmd->viewports[i] = viewports[i];
         }
+        cmd->viewportCount = viewportCount;
+        cmd->firstViewport = firstViewport;
     }
 
-    void RenderPassEncoder::APIMultiDrawIndexedIndirect(BufferBase* indirectBuffer,
-                                                        uint64_t indirectOffset,
-                                                        uint32_t maxDrawCount,
-                                                        BufferBase* drawCountBuffer,
-                                                        uint64_t drawCountBufferOffset)
+    void RenderPassEncoder::APIExecuteBundles(RenderBundleBase* const* bundles, uint32_t bundleCount)
     {
-        ASSERT(indirectBuffer != nullptr);
-        ASSERT(HasFlag(indirectBuffer->APIGetUsage(), BufferUsage::Indirect));
-        INVALID_IF(drawCountBuffer && !HasFlag(drawCountBuffer->APIGetUsage(), BufferUsage::Indirect),
-                   "drawCountBuffer must has Indirect usage.");
-
+        if (bundleCount == 0)
+        {
+            return;
+        }
 
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        MultiDrawIndexedIndirectCmd* cmd = allocator.Allocate<MultiDrawIndexedIndirectCmd>(Command::MultiDrawIndirect);
-        cmd->indirectBuffer = indirectBuffer;
-        cmd->indirectOffset = indirectOffset;
-        cmd->maxDrawCount = maxDrawCount;
-        cmd->drawCountBuffer = drawCountBuffer;
-        cmd->drawCountOffset = drawCountBufferOffset;
-        mUsageTracker.BufferUsedAs(indirectBuffer, BufferUsage::Indirect);
-        if (drawCountBuffer)
+        ExecuteBundlesCmd* cmd = allocator.Allocate<ExecuteBundlesCmd>(Command::ExecuteBundles);
+        cmd->count = bundleCount;
+
+        Ref<RenderBundleBase>* bundleRefs = allocator.AllocateData<Ref<RenderBundleBase>>(bundleCount);
+        for (uint32_t i = 0; i < bundleCount; ++i)
         {
-            mUsageTracker.BufferUsedAs(drawCountBuffer, BufferUsage::Indirect);
+            ASSERT(bundles[i] != nullptr);
+            bundleRefs[i] = bundles[i];
+            mUsageTracker.AddSyncScopeUsage(bundles[i]->GetResourceUsage());
         }
+
+        // The bundles leave their own state bound, so nothing recorded before can be assumed anymore.
+        ResetDrawState();
+        // Their pipelines may have reset the dynamic primitive type.
+        mPrimitiveType.reset();
     }
 
     void RenderPassEncoder::APIEnd()
     {
         mIsEnded = true;
         CommandAllocator& allocator = mEncodingContext.GetCommandAllocator();
-        EndRenderPassCmd* cmd = allocator.Allocate<EndRenderPassCmd>(Command::EndRenderPass);
+        allocator.Allocate<EndRenderPassCmd>(Command::EndRenderPass);
+        ReportElidedCommands();
         mEncodingContext.ExitRenderPass(mUsageTracker);
         mCommandEncoder->OnRenderPassEnd();
     }
@@ -1,16 +1,20 @@
 #pragma once
 
+#include "Commands.h"
 #include "EncodingContext.h"
-#include "PassEncoder.h"
 #include "RHIStruct.h"
+#include "RenderEncoderBase.h"
 #include "SyncScopeUsageTracker.h"
 
+#include <array>
+#include <optional>
+
 namespace rhi::impl
 {
     class CommandEncoder;
-    class RenderPipelineBase;
+    class RenderBundleBase;
 
-    class RenderPassEncoder : public PassEncoder
+    class RenderPassEncoder : public RenderEncoderBase
     {
     public:
         static Ref<RenderPassEncoder> Create(CommandEncoder* encoder,
@@ -18,43 +22,17 @@ namespace rhi::impl
                                              SyncScopeUsageTracker&& usageTracker);
 
         void APISetPipeline(RenderPipelineBase* pipeline);
-        void APISetVertexBuffers(uint32_t firstSlot,
-                                 uint32_t bufferCount,
-                                 BufferBase* const* buffers,
-                                 uint64_t* offsets = nullptr);
-        void APISetIndexBuffer(BufferBase* buffer,
-                               IndexFormat indexFormat,
-                               uint64_t offset = 0,
-                               uint64_t size = CWholeSize);
         void APISetScissorRect(uint32_t firstScissor, const Rect* scissors, uint32_t scissorCount);
         void APISetStencilReference(uint32_t reference);
         void APISetBlendConstant(const Color& blendConstants);
+        // Extended dynamic state, only used by pipelines created with extendedDynamicState.
+        void APISetCullMode(CullMode cullMode);
+        void APISetFrontFace(FrontFace frontFace);
+        void APISetPrimitiveType(PrimitiveType primitiveType);
+        void APISetDepthState(bool depthTestEnable, bool depthWriteEnable, CompareOp depthCompareOp);
+        void APISetStencilState(bool stencilTestEnable, const StencilOpState& front, const StencilOpState& back);
         void APISetViewport(uint32_t firstViewport, Viewport const* viewports, uint32_t viewportCount);
-        void APISetBindSet(BindSetBase* set,
-                           uint32_t setIndex,
-                           uint32_t dynamicOffsetCount = 0,
-                           const uint32_t* dynamicOffsets = nullptr);
-        void APIDraw(uint32_t vertexCount,
-                     uint32_t instanceCount = 1,
-                     uint32_t firstVertex = 0,
-                     uint32_t firstInstance = 0);
-        void APIDrawIndexed(uint32_t indexCount,
-                            uint32_t instanceCount,
-                            uint32_t firstIndex,
-                            int32_t baseVertex,
-                            uint32_t firstInstance);
-        void APIDrawIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
-        void APIDrawIndexedIndirect(BufferBase* indirectBuffer, uint64_t indirectOffset);
-        void APIMultiDrawIndirect(BufferBase* indirectBuffer,
-                                  uint64_t indirectOffset,
-                                  uint32_t maxDrawCount,
-                                  BufferBase* drawCountBuffer = nullptr,
-                                  uint64_t drawCountBufferOffset = 0);
-        void APIMultiDrawIndexedIndirect(BufferBase* indirectBuffer,
-                                         uint64_t indirectOffset,
-                                         uint32_t maxDrawCount,
-                                         BufferBase* drawCountBuffer = nullptr,
-                                         uint64_t drawCountBufferOffset = 0);
+        void APIExecuteBundles(RenderBundleBase* const* bundles, uint32_t bundleCount);
         void APIEnd();
 
     protected:
@@ -62,6 +40,17 @@ namespace rhi::impl
                                    EncodingContext& encodingContext,
                                    SyncScopeUsageTracker&& usageTracker);
         ~RenderPassEncoder();
-        SyncScopeUsageTracker mUsageTracker;
+
+    private:
+        // Shadow of the dynamic state already recorded in this pass, used to drop redundant commands.
+        std::array<std::optional<Viewport>, cMaxViewports> mViewports;
+        std::array<std::optional<Rect>, cMaxViewports> mScissors;
+        std::optional<uint32_t> mStencilReference;
+        std::optional<Color> mBlendConstant;
+        std::optional<CullMode> mCullMode;
+        std::optional<FrontFace> mFrontFace;
+        std::optional<PrimitiveType> mPrimitiveType;
+        std::optional<SetDepthStateCmd> mDepthState;
+        std::optional<SetStencilStateCmd> mStencilState;
     };
 } // namespace rhi::impl
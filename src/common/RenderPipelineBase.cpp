@@ -1,5 +1,6 @@
 #include "RenderPipelinebase.h"
 #include "DeviceBase.h"
+#include "ObjectContentHasher.h"
 #include "TextureBase.h"
 
 namespace rhi::impl
@@ -95,6 +96,34 @@ namespace rhi::impl
         return TextureFormat::Undefined;
     }
 
+    PrimitiveType GetTopologyClass(PrimitiveType type)
+    {
+        switch (type)
+        {
+        case PrimitiveType::LineList:
+        case PrimitiveType::LineStrip:
+            return PrimitiveType::LineList;
+        case PrimitiveType::TriangleList:
+        case PrimitiveType::TriangleStrip:
+        case PrimitiveType::TriangleFan:
+            return PrimitiveType::TriangleList;
+        default:
+            return type;
+        }
+    }
+
+    namespace
+    {
+        void ResetStencilOps(StencilOpState* state)
+        {
+            const StencilOpState defaultState{};
+            state->failOp = defaultState.failOp;
+            state->passOp = defaultState.passOp;
+            state->depthFailOp = defaultState.depthFailOp;
+            state->compareOp = defaultState.compareOp;
+        }
+    } // namespace
+
     RenderPipelineBase::RenderPipelineBase(DeviceBase* device, const RenderPipelineDesc& desc)
         : PipelineBase(device, desc)
         , mRasterState(desc.rasterState)
@@ -103,6 +132,7 @@ namespace rhi::impl
         , mDepthStencilState(desc.depthStencilState)
         , mViewportCount(desc.viewportCount)
         , mPatchControlPoints(desc.patchControlPoints)
+        , mExtendedDynamicState(desc.extendedDynamicState)
         , mDepthStencilFormat(desc.depthStencilFormat)
         , mVertexInputAttributes(desc.vertexAttributeCount)
         , mColorAttachmentFormats(desc.colorAttachmentCount)
@@ -118,6 +148,23 @@ namespace rhi::impl
         }
 
         ResolveVertexInputOffsetAndStride();
+
+        if (mExtendedDynamicState)
+        {
+            // The render pass encoder sets these states, so they are reset to make pipelines differing only by them
+            // hash and compare equal.
+            const RasterState defaultRasterState{};
+            const DepthStencilState defaultDepthStencilState{};
+            mRasterState.primitiveType = GetTopologyClass(mRasterState.primitiveType);
+            mRasterState.cullMode = defaultRasterState.cullMode;
+            mRasterState.frontFace = defaultRasterState.frontFace;
+            mDepthStencilState.depthTestEnable = defaultDepthStencilState.depthTestEnable;
+            mDepthStencilState.depthWriteEnable = defaultDepthStencilState.depthWriteEnable;
+            mDepthStencilState.depthCompareOp = defaultDepthStencilState.depthCompareOp;
+            mDepthStencilState.stencilTestEnable = defaultDepthStencilState.stencilTestEnable;
+            ResetStencilOps(&mDepthStencilState.frontFaceStencil);
+            ResetStencilOps(&mDepthStencilState.backFaceStencil);
+        }
     }
 
     void RenderPipelineBase::ResolveVertexInputOffsetAndStride()
@@ -176,5 +223,183 @@ namespace rhi::impl
         return ResourceType::RenderPipeline;
     }
 
-    RenderPipelineBase::~RenderPipelineBase() = default;
+    bool RenderPipelineBase::HasExtendedDynamicState() const
+    {
+        return mExtendedDynamicState;
+    }
+
+    PrimitiveType RenderPipelineBase::GetPrimitiveType() const
+    {
+        return mRasterState.primitiveType;
+    }
+
+    void RenderPipelineBase::DestroyImpl()
+    {
+        Uncache();
+    }
+
+    namespace
+    {
+        void RecordStencilOpState(ObjectContentHasher* recorder, const StencilOpState& state)
+        {
+            recorder->Record(state.failOp,
+                             state.passOp,
+                             state.depthFailOp,
+                             state.compareOp,
+                             state.writeMask,
+                             state.compareMak,
+                             state.referenceValue);
+        }
+
+        bool IsStencilOpStateEqual(const StencilOpState& a, const StencilOpState& b)
+        {
+            return a.failOp == b.failOp && a.passOp == b.passOp && a.depthFailOp == b.depthFailOp &&
+                   a.compareOp == b.compareOp && a.writeMask == b.writeMask && a.compareMak == b.compareMak &&
+                   a.referenceValue == b.referenceValue;
+        }
+
+        bool IsColorAttachmentBlendStateEqual(const ColorAttachmentBlendState& a, const ColorAttachmentBlendState& b)
+        {
+            return a.blendEnable == b.blendEnable && a.srcColorBlend == b.srcColorBlend &&
+                   a.destColorBlend == b.destColorBlend && a.colorBlendOp == b.colorBlendOp &&
+                   a.srcAlphaBlend == b.srcAlphaBlend && a.destAlphaBlend == b.destAlphaBlend &&
+                   a.alphaBlendOp == b.alphaBlendOp && a.colorWriteMask == b.colorWriteMask;
+        }
+    } // namespace
+
+    size_t RenderPipelineBase::ComputeContentHash()
+    {
+        ObjectContentHasher recorder;
+        RecordLayoutAndStages(&recorder);
+
+        // Offsets and strides were resolved by the constructor, so automatic and explicit layouts hash the same.
+        for (const VertexInputAttribute& attribute : mVertexInputAttributes)
+        {
+            recorder.Record(attribute.bindingBufferSlot,
+                            attribute.location,
+                            attribute.format,
+                            attribute.rate,
+                            attribute.offsetInElement,
+                            attribute.elementStride);
+        }
+
+        recorder.Record(mColorAttachmentFormats);
+        recorder.Record(mDepthStencilFormat);
+
+        // Only the blend states of the bound color attachments are used.
+        recorder.Record(mBlendState.alphaToCoverageEnable);
+        for (size_t i = 0; i < mColorAttachmentFormats.size(); ++i)
+        {
+            const ColorAttachmentBlendState& state = mBlendState.colorAttachmentBlendStates[i];
+            recorder.Record(state.blendEnable,
+                            state.srcColorBlend,
+                            state.destColorBlend,
+                            state.colorBlendOp,
+                            state.srcAlphaBlend,
+                            state.destAlphaBlend,
+                            state.alphaBlendOp,
+                            state.colorWriteMask);
+        }
+
+        recorder.Record(mRasterState.primitiveType,
+                        mRasterState.fillMode,
+                        mRasterState.cullMode,
+                        mRasterState.frontFace,
+                        mRasterState.depthClampEnable,
+                        mRasterState.lineWidth);
+        recorder.Record(mSampleState.count, mSampleState.quality, mSampleState.mask);
+        recorder.Record(mDepthStencilState.depthTestEnable,
+                        mDepthStencilState.depthWriteEnable,
+                        mDepthStencilState.depthCompareOp,
+                        mDepthStencilState.depthBias,
+                        mDepthStencilState.depthBiasSlopeScale,
+                        mDepthStencilState.depthBiasClamp,
+                        mDepthStencilState.stencilTestEnable,
+                        mDepthStencilState.stencilReadMask,
+                        mDepthStencilState.stencilWriteMask);
+        RecordStencilOpState(&recorder, mDepthStencilState.frontFaceStencil);
+        RecordStencilOpState(&recorder, mDepthStencilState.backFaceStencil);
+        recorder.Record(mViewportCount, mPatchControlPoints, mExtendedDynamicState);
+
+        return recorder.GetContentHash();
+    }
+
+    bool RenderPipelineBase::Equal::operator()(const RenderPipelineBase* a, const RenderPipelineBase* b) const
+    {
+        if (!a->IsLayoutAndStagesEqual(b))
+        {
+            return false;
+        }
+
+        if (a->mVertexInputAttributes.size() != b->mVertexInputAttributes.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a->mVertexInputAttributes.size(); ++i)
+        {
+            const VertexInputAttribute& attributeA = a->mVertexInputAttributes[i];
+            const VertexInputAttribute& attributeB = b->mVertexInputAttributes[i];
+            if (attributeA.bindingBufferSlot != attributeB.bindingBufferSlot ||
+                attributeA.location != attributeB.location || attributeA.format != attributeB.format ||
+                attributeA.rate != attributeB.rate || attributeA.offsetInElement != attributeB.offsetInElement ||
+                attributeA.elementStride != attributeB.elementStride)
+            {
+                return false;
+            }
+        }
+
+        if (a->mColorAttachmentFormats != b->mColorAttachmentFormats ||
+            a->mDepthStencilFormat != b->mDepthStencilFormat)
+        {
+            return false;
+        }
+
+        if (a->mBlendState.alphaToCoverageEnable != b->mBlendState.alphaToCoverageEnable)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a->mColorAttachmentFormats.size(); ++i)
+        {
+            if (!IsColorAttachmentBlendStateEqual(a->mBlendState.colorAttachmentBlendStates[i],
+                                                  b->mBlendState.colorAttachmentBlendStates[i]))
+            {
+                return false;
+            }
+        }
+
+        const RasterState& rasterA = a->mRasterState;
+        const RasterState& rasterB = b->mRasterState;
+        if (rasterA.primitiveType != rasterB.primitiveType || rasterA.fillMode != rasterB.fillMode ||
+            rasterA.cullMode != rasterB.cullMode || rasterA.frontFace != rasterB.frontFace ||
+            rasterA.depthClampEnable != rasterB.depthClampEnable || rasterA.lineWidth != rasterB.lineWidth)
+        {
+            return false;
+        }
+
+        if (a->mSampleState.count != b->mSampleState.count || a->mSampleState.quality != b->mSampleState.quality ||
+            a->mSampleState.mask != b->mSampleState.mask)
+        {
+            return false;
+        }
+
+        const DepthStencilState& depthA = a->mDepthStencilState;
+        const DepthStencilState& depthB = b->mDepthStencilState;
+        return depthA.depthTestEnable == depthB.depthTestEnable && depthA.depthWriteEnable == depthB.depthWriteEnable &&
+               depthA.depthCompareOp == depthB.depthCompareOp && depthA.depthBias == depthB.depthBias &&
+               depthA.depthBiasSlopeScale == depthB.depthBiasSlopeScale &&
+               depthA.depthBiasClamp == depthB.depthBiasClamp &&
+               depthA.stencilTestEnable == depthB.stencilTestEnable &&
+               depthA.stencilReadMask == depthB.stencilReadMask &&
+               depthA.stencilWriteMask == depthB.stencilWriteMask &&
+               IsStencilOpStateEqual(depthA.frontFaceStencil, depthB.frontFaceStencil) &&
+               IsStencilOpStateEqual(depthA.backFaceStencil, depthB.backFaceStencil) &&
+               a->mViewportCount == b->mViewportCount && a->mPatchControlPoints == b->mPatchControlPoints &&
+               a->mExtendedDynamicState == b->mExtendedDynamicState;
+    }
+
+    RenderPipelineBase::~RenderPipelineBase()
+    {
+        // Pipelines whose compilation was skipped are never tracked, so DestroyImpl did not uncache them.
+        Uncache();
+    }
 } // namespace rhi::impl
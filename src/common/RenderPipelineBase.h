@@ -2,17 +2,33 @@
 
 #include "PipelineBase.h"
 #include "RHIStruct.h"
+#include "common/Cached.hpp"
 
 namespace rhi::impl
 {
-    class RenderPipelineBase : public PipelineBase
+    // A dynamic primitive type may only change within the topology class the pipeline was created with. Returns the
+    // list topology of the class.
+    PrimitiveType GetTopologyClass(PrimitiveType type);
+
+    class RenderPipelineBase : public PipelineBase, public Cached<RenderPipelineBase>
     {
     public:
         explicit RenderPipelineBase(DeviceBase* device, const RenderPipelineDesc& desc);
         ~RenderPipelineBase() override;
         ResourceType GetType() const override;
+        size_t ComputeContentHash() override;
+        // Cull mode, front face, primitive type, depth test and stencil ops are set by the render pass encoder.
+        bool HasExtendedDynamicState() const;
+        // With extended dynamic state, this is the topology class of the pipeline, used until the encoder sets one.
+        PrimitiveType GetPrimitiveType() const;
+
+        struct Equal
+        {
+            bool operator()(const RenderPipelineBase* a, const RenderPipelineBase* b) const;
+        };
 
     protected:
+        void DestroyImpl() override;
         void ResolveVertexInputOffsetAndStride();
 
         std::vector<VertexInputAttribute> mVertexInputAttributes;
@@ -24,5 +40,6 @@ namespace rhi::impl
         DepthStencilState mDepthStencilState;
         uint32_t mViewportCount = 1;
         uint32_t mPatchControlPoints = 0;
+        bool mExtendedDynamicState = false;
     };
 } // namespace rhi::impl
@@ -22,6 +22,18 @@ namespace rhi::impl
     {
         ResourceList* list = GetList();
         assert(list);
+        switch (GetType())
+        {
+        case ResourceType::Buffer:
+        case ResourceType::TextureView:
+        case ResourceType::Sampler:
+            // Cached bind sets are keyed by the addresses of their resources. This also runs when a resource destroyed
+            // by its owner, like the views of a texture, is freed.
+            mDevice->EvictCachedBindSets(this);
+            break;
+        default:
+            break;
+        }
         if (list->Untrack(this))
         {
             DestroyImpl();
@@ -19,6 +19,7 @@ namespace rhi::impl
         PipelineLayout,
         PipelineCache,
         // QuerySet,
+        ResourceHeap,
         BindSet,
         BindSetLayout,
         Sampler,
@@ -37,13 +38,12 @@ namespace rhi::impl
         void Destroy();
 
         template <typename F>
-        void ForEach(F fn) const
+        void ForEach(F fn)
         {
             mObjects.Use(
-                    [&fn](const auto lockedObjects)
+                    [&fn](auto lockedObjects)
                     {
-                        for (const auto* node = lockedObjects->head(); node != lockedObjects->end();
-                             node = node->next())
+                        for (auto* node = lockedObjects->head(); node != lockedObjects->end(); node = node->next())
                         {
                             fn(node->value());
                         }
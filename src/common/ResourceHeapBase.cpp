@@ -0,0 +1,265 @@
+#include "ResourceHeapBase.h"
+
+#include "BindSetBase.h"
+#include "BindSetLayoutBase.h"
+#include "BufferBase.h"
+#include "DeviceBase.h"
+#include "SamplerBase.h"
+#include "TextureBase.h"
+#include "common/Error.h"
+#include "common/Utils.h"
+
+namespace rhi::impl
+{
+    ResourceHeapBase::ResourceHeapBase(DeviceBase* device, const ResourceHeapDesc& desc)
+        : ResourceBase(device, desc.name)
+        , mVisibility(desc.visibility)
+    {
+        GetSlotPool(ResourceHeapSlotType::SampledTexture).slotCount = desc.sampledTextureCount;
+        GetSlotPool(ResourceHeapSlotType::StorageBuffer).slotCount = desc.storageBufferCount;
+        GetSlotPool(ResourceHeapSlotType::Sampler).slotCount = desc.samplerCount;
+
+        for (SlotPool& pool : mSlotPools)
+        {
+            pool.allocated.resize(pool.slotCount, false);
+            pool.resources.resize(pool.slotCount);
+        }
+    }
+
+    ResourceHeapBase::~ResourceHeapBase() = default;
+
+    void ResourceHeapBase::DestroyImpl()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (SlotPool& pool : mSlotPools)
+        {
+            pool.resources.clear();
+        }
+        mFrameFrees.clear();
+        mRetiredSlots.clear();
+        mBindSet = nullptr;
+        mBindSetLayout = nullptr;
+    }
+
+    ResourceType ResourceHeapBase::GetType() const
+    {
+        return ResourceType::ResourceHeap;
+    }
+
+    ShaderStage ResourceHeapBase::GetVisibility() const
+    {
+        return mVisibility;
+    }
+
+    BindSetLayoutBase* ResourceHeapBase::APIGetBindSetLayout() const
+    {
+        Ref<BindSetLayoutBase> bindSetLayout = mBindSetLayout;
+        return bindSetLayout.Detach();
+    }
+
+    BindSetBase* ResourceHeapBase::APIGetBindSet() const
+    {
+        Ref<BindSetBase> bindSet = mBindSet;
+        return bindSet.Detach();
+    }
+
+    ResourceHeapBase::SlotPool& ResourceHeapBase::GetSlotPool(ResourceHeapSlotType type)
+    {
+        ASSERT(type < ResourceHeapSlotType::Count);
+        return mSlotPools[static_cast<uint32_t>(type)];
+    }
+
+    uint32_t ResourceHeapBase::GetSlotCount(ResourceHeapSlotType type) const
+    {
+        ASSERT(type < ResourceHeapSlotType::Count);
+        return mSlotPools[static_cast<uint32_t>(type)].slotCount;
+    }
+
+    uint32_t ResourceHeapBase::GetAllocatedSlotCount(ResourceHeapSlotType type)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return GetSlotPool(type).allocatedSlotCount;
+    }
+
+    bool ResourceHeapBase::IsSlotAllocated(ResourceHeapSlotType type, uint32_t slot)
+    {
+        SlotPool& pool = GetSlotPool(type);
+        return slot < pool.slotCount && pool.allocated[slot];
+    }
+
+    std::vector<Ref<ResourceBase>> ResourceHeapBase::GetResidentResources(ResourceHeapSlotType type,
+                                                                          uint32_t slotCount,
+                                                                          const uint32_t* slots)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        SlotPool& pool = GetSlotPool(type);
+        std::vector<Ref<ResourceBase>> resources;
+        if (slots == nullptr)
+        {
+            for (uint32_t slot = 0; slot < pool.nextUnusedSlot; ++slot)
+            {
+                if (pool.allocated[slot] && pool.resources[slot] != nullptr)
+                {
+                    resources.push_back(pool.resources[slot]);
+                }
+            }
+            return resources;
+        }
+
+        resources.reserve(slotCount);
+        for (uint32_t i = 0; i < slotCount; ++i)
+        {
+            INVALID_IF(!IsSlotAllocated(type, slots[i]) || pool.resources[slots[i]] == nullptr,
+                       "Slot %u of the resource heap is not written.",
+                       slots[i]);
+            resources.push_back(pool.resources[slots[i]]);
+        }
+        return resources;
+    }
+
+    void ResourceHeapBase::Tick()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (!mFrameFrees.empty())
+        {
+            // Command lists referencing the slots may have been recorded before the free and submitted after it, so
+            // the serials are taken now rather than when the slots were freed.
+            RetiredSlots retired{std::move(mFrameFrees), {}};
+            mFrameFrees.clear();
+            for (QueueType queueType : {QueueType::Graphics, QueueType::Compute})
+            {
+                Ref<QueueBase> queue = mDevice->GetQueue(queueType);
+                if (queue != nullptr)
+                {
+                    retired.serials[static_cast<uint32_t>(queueType)] = queue->GetPendingSubmitSerial();
+                }
+            }
+            mRetiredSlots.push_back(std::move(retired));
+        }
+
+        ReclaimRetiredSlots();
+    }
+
+    void ResourceHeapBase::ReclaimRetiredSlots()
+    {
+        std::array<uint64_t, 2> completedSerials = {};
+        for (QueueType queueType : {QueueType::Graphics, QueueType::Compute})
+        {
+            Ref<QueueBase> queue = mDevice->GetQueue(queueType);
+            completedSerials[static_cast<uint32_t>(queueType)] = queue != nullptr ? queue->GetCompletedSerial() : 0;
+        }
+
+        // Slots are retired in serial order, so the first batch still in flight ends the scan.
+        while (!mRetiredSlots.empty())
+        {
+            const RetiredSlots& retired = mRetiredSlots.front();
+            if (retired.serials[0] > completedSerials[0] || retired.serials[1] > completedSerials[1])
+            {
+                break;
+            }
+
+            for (const FreedSlot& freedSlot : retired.slots)
+            {
+                SlotPool& pool = GetSlotPool(freedSlot.type);
+                pool.resources[freedSlot.slot] = nullptr;
+                pool.freeSlots.push_back(freedSlot.slot);
+            }
+            mRetiredSlots.pop_front();
+        }
+    }
+
+    uint32_t ResourceHeapBase::APIAllocateSlot(ResourceHeapSlotType type)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        ReclaimRetiredSlots();
+
+        SlotPool& pool = GetSlotPool(type);
+        uint32_t slot;
+        if (!pool.freeSlots.empty())
+        {
+            slot = pool.freeSlots.back();
+            pool.freeSlots.pop_back();
+        }
+        else if (pool.nextUnusedSlot < pool.slotCount)
+        {
+            slot = pool.nextUnusedSlot++;
+        }
+        else
+        {
+            LOG_WARNING("ResourceHeap %s has no free slot left.", std::string(GetName()));
+            return CResourceHeapSlotInvalid;
+        }
+
+        ASSERT(!pool.allocated[slot]);
+        pool.allocated[slot] = true;
+        pool.allocatedSlotCount++;
+        return slot;
+    }
+
+    void ResourceHeapBase::APIFreeSlot(ResourceHeapSlotType type, uint32_t slot)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        INVALID_IF(!IsSlotAllocated(type, slot), "Slot %u of the resource heap is not allocated.", slot);
+
+        SlotPool& pool = GetSlotPool(type);
+        pool.allocated[slot] = false;
+        pool.allocatedSlotCount--;
+
+        // Commands recorded so far may still read the descriptor, the slot waits for the next Tick to be retired.
+        mFrameFrees.push_back({type, slot});
+    }
+
+    void ResourceHeapBase::APIWriteSampledTexture(uint32_t slot, TextureViewBase* textureView)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        INVALID_IF(!IsSlotAllocated(ResourceHeapSlotType::SampledTexture, slot),
+                   "Slot %u of the resource heap is not allocated.",
+                   slot);
+        INVALID_IF(textureView == nullptr, "The texture view is null.");
+        INVALID_IF(!HasFlag(textureView->GetTexture()->APIGetUsage(), TextureUsage::SampledBinding),
+                   "The texture was not created with TextureUsage::SampledBinding.");
+
+        WriteSampledTextureImpl(slot, textureView);
+        GetSlotPool(ResourceHeapSlotType::SampledTexture).resources[slot] = textureView;
+    }
+
+    void ResourceHeapBase::APIWriteStorageBuffer(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        INVALID_IF(!IsSlotAllocated(ResourceHeapSlotType::StorageBuffer, slot),
+                   "Slot %u of the resource heap is not allocated.",
+                   slot);
+        INVALID_IF(buffer == nullptr, "The buffer is null.");
+        INVALID_IF(!HasFlag(buffer->APIGetUsage(), BufferUsage::Storage),
+                   "The buffer was not created with BufferUsage::Storage.");
+
+        if (size == CWholeSize)
+        {
+            INVALID_IF(offset > buffer->APIGetSize(), "The offset is out of the buffer.");
+            size = buffer->APIGetSize() - offset;
+        }
+        INVALID_IF(offset + size > buffer->APIGetSize(), "The range is out of the buffer.");
+
+        WriteStorageBufferImpl(slot, buffer, offset, size);
+        GetSlotPool(ResourceHeapSlotType::StorageBuffer).resources[slot] = buffer;
+    }
+
+    void ResourceHeapBase::APIWriteSampler(uint32_t slot, SamplerBase* sampler)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        INVALID_IF(!IsSlotAllocated(ResourceHeapSlotType::Sampler, slot),
+                   "Slot %u of the resource heap is not allocated.",
+                   slot);
+        INVALID_IF(sampler == nullptr, "The sampler is null.");
+
+        WriteSamplerImpl(slot, sampler);
+        GetSlotPool(ResourceHeapSlotType::Sampler).resources[slot] = sampler;
+    }
+} // namespace rhi::impl
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "RHIStruct.h"
+#include "ResourceBase.h"
+#include "common/Ref.hpp"
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace rhi::impl
+{
+    // A bind set of large descriptor arrays that shaders index by slot. Slots are allocated and written one at a time
+    // and can be rewritten while the set is bound, so one bind per pass covers every draw. Binding the heap does not
+    // track the resources written into it, passes declare the ones they read with UseResidentResources.
+    class ResourceHeapBase : public ResourceBase
+    {
+    public:
+        BindSetLayoutBase* APIGetBindSetLayout() const;
+        BindSetBase* APIGetBindSet() const;
+        // Returns CResourceHeapSlotInvalid when every slot of this type is in use.
+        uint32_t APIAllocateSlot(ResourceHeapSlotType type);
+        // The slot is retired by the next device tick and only handed out again once the queues are done with the
+        // commands submitted or being recorded at that point.
+        void APIFreeSlot(ResourceHeapSlotType type, uint32_t slot);
+        void APIWriteSampledTexture(uint32_t slot, TextureViewBase* textureView);
+        void APIWriteStorageBuffer(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size);
+        void APIWriteSampler(uint32_t slot, SamplerBase* sampler);
+
+        ResourceType GetType() const override;
+        ShaderStage GetVisibility() const;
+        uint32_t GetSlotCount(ResourceHeapSlotType type) const;
+        // Returns the resources written into the slots, or into every written slot of the type if slots is null.
+        std::vector<Ref<ResourceBase>> GetResidentResources(ResourceHeapSlotType type,
+                                                            uint32_t slotCount,
+                                                            const uint32_t* slots);
+        uint32_t GetAllocatedSlotCount(ResourceHeapSlotType type);
+        void Tick();
+
+    protected:
+        explicit ResourceHeapBase(DeviceBase* device, const ResourceHeapDesc& desc);
+        ~ResourceHeapBase() override;
+        void DestroyImpl() override;
+
+        virtual void WriteSampledTextureImpl(uint32_t slot, TextureViewBase* textureView) = 0;
+        virtual void WriteStorageBufferImpl(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size) = 0;
+        virtual void WriteSamplerImpl(uint32_t slot, SamplerBase* sampler) = 0;
+
+        Ref<BindSetLayoutBase> mBindSetLayout;
+        Ref<BindSetBase> mBindSet;
+
+    private:
+        struct SlotPool
+        {
+            uint32_t slotCount = 0;
+            // Slots below this index have been handed out at least once.
+            uint32_t nextUnusedSlot = 0;
+            uint32_t allocatedSlotCount = 0;
+            std::vector<uint32_t> freeSlots;
+            std::vector<bool> allocated;
+            // Keeps the written resources alive while their descriptor may be read.
+            std::vector<Ref<ResourceBase>> resources;
+        };
+
+        struct FreedSlot
+        {
+            ResourceHeapSlotType type;
+            uint32_t slot;
+        };
+
+        struct RetiredSlots
+        {
+            std::vector<FreedSlot> slots;
+            // Last serial of the graphics and compute queues that may read these slots.
+            std::array<uint64_t, 2> serials;
+        };
+
+        SlotPool& GetSlotPool(ResourceHeapSlotType type);
+        bool IsSlotAllocated(ResourceHeapSlotType type, uint32_t slot);
+        void ReclaimRetiredSlots();
+
+        ShaderStage mVisibility;
+
+        std::mutex mMutex;
+        std::array<SlotPool, static_cast<uint32_t>(ResourceHeapSlotType::Count)> mSlotPools;
+        // Slots freed since the last Tick.
+        std::vector<FreedSlot> mFrameFrees;
+        std::deque<RetiredSlots> mRetiredSlots;
+    };
+} // namespace rhi::impl
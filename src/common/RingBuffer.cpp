@@ -0,0 +1,144 @@
+#include "RingBuffer.h"
+#include "BufferBase.h"
+#include "common/Error.h"
+#include "common/Utils.h"
+
+#include <algorithm>
+
+namespace rhi::impl
+{
+    RingBuffer::RingBuffer(uint64_t maxSize)
+        : mMaxBlockSize(maxSize)
+    {}
+
+    RingBuffer::~RingBuffer() {};
+
+    uint64_t RingBuffer::Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment)
+    {
+        if (mUsedSize >= mMaxBlockSize)
+        {
+            return cInvalidOffset;
+        }
+
+        const uint64_t remainingSize = (mMaxBlockSize - mUsedSize);
+        if (allocationSize > remainingSize)
+        {
+            return cInvalidOffset;
+        }
+
+        uint64_t startOffset = cInvalidOffset;
+        uint64_t currentRequestSize = 0;
+
+        // Compute an alignment offset for the buffer if allocating at the end.
+        const uint64_t alignmentOffset = AlignUp(mUsedEndOffset, offsetAlignment) - mUsedEndOffset;
+        const uint64_t alignedUsedEndOffset = mUsedEndOffset + alignmentOffset;
+
+        // Check if the buffer is NOT split (i.e sub-alloc on ends)
+        if (mUsedStartOffset <= mUsedEndOffset)
+        {
+            // Order is important (try to sub-alloc at end first).
+            // This is due to FIFO order where sub-allocs are inserted from left-to-right (when not
+            // wrapped).
+            if (alignedUsedEndOffset + allocationSize <= mMaxBlockSize)
+            {
+                startOffset = alignedUsedEndOffset;
+                mUsedSize += allocationSize + alignmentOffset;
+                currentRequestSize = allocationSize + alignmentOffset;
+            }
+            else if (allocationSize <= mUsedStartOffset) // Try to sub-alloc at front.
+            {
+                // Count the space at the end so that a subsequent
+                // sub-alloc cannot fail when the buffer is full.
+                const uint64_t requestSize = (mMaxBlockSize - mUsedEndOffset) + allocationSize;
+
+                startOffset = 0;
+                mUsedSize += requestSize;
+                currentRequestSize = requestSize;
+            }
+        }
+        else if (alignedUsedEndOffset + allocationSize <= mUsedStartOffset)
+        {
+            // Otherwise, buffer is split where sub-alloc must be in-between.
+            startOffset = alignedUsedEndOffset;
+            mUsedSize += allocationSize + alignmentOffset;
+            currentRequestSize = allocationSize + alignmentOffset;
+        }
+
+        if (startOffset != cInvalidOffset)
+        {
+            mUsedEndOffset = startOffset + allocationSize;
+
+            Request request;
+            request.endOffset = mUsedEndOffset;
+            request.size = currentRequestSize;
+
+            mInflightRequests.Push(serial, std::move(request));
+        }
+
+        return startOffset;
+    }
+
+    void RingBuffer::Deallocate(uint64_t lastCompletedSerial)
+    {
+        uint64_t releasableSerial = lastCompletedSerial;
+        if (!mOpenReservationSerials.empty())
+        {
+            releasableSerial = std::min(releasableSerial, *mOpenReservationSerials.begin() - 1);
+        }
+        if (mHoldUntilSerial != 0)
+        {
+            if (lastCompletedSerial >= mHoldUntilSerial)
+            {
+                mHoldFromSerial = 0;
+                mHoldUntilSerial = 0;
+            }
+            else
+            {
+                releasableSerial = std::min(releasableSerial, mHoldFromSerial - 1);
+            }
+        }
+
+        for (Request& request : mInflightRequests.IterateUpTo(releasableSerial))
+        {
+            mUsedStartOffset = request.endOffset;
+            mUsedSize -= request.size;
+        }
+
+        // Dequeue previously recorded requests.
+        mInflightRequests.ClearUpTo(releasableSerial);
+    }
+
+    void RingBuffer::OpenReservation(uint64_t serial)
+    {
+        ASSERT(serial > 0);
+        mOpenReservationSerials.insert(serial);
+    }
+
+    void RingBuffer::CloseReservation(uint64_t reservedSerial, uint64_t serial)
+    {
+        auto iter = mOpenReservationSerials.find(reservedSerial);
+        ASSERT(iter != mOpenReservationSerials.end());
+        mOpenReservationSerials.erase(iter);
+
+        if (serial > reservedSerial)
+        {
+            mHoldFromSerial = mHoldUntilSerial == 0 ? reservedSerial : std::min(mHoldFromSerial, reservedSerial);
+            mHoldUntilSerial = std::max(mHoldUntilSerial, serial);
+        }
+    }
+
+    uint64_t RingBuffer::GetSize() const
+    {
+        return mMaxBlockSize;
+    }
+
+    uint64_t RingBuffer::GetUsedSize() const
+    {
+        return mUsedSize;
+    }
+
+    bool RingBuffer::Empty() const
+    {
+        return mInflightRequests.Empty();
+    }
+} // namespace rhi::impl
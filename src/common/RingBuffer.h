@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include "RHIStruct.h"
+#include "common/Ref.hpp"
+#include "common/SerialQueue.hpp"
+
+#if defined(max)
+#undef max
+#endif
+
+namespace rhi::impl
+{
+    // Sub-allocates a staging buffer in FIFO order, releasing requests once their serial has completed.
+    class RingBuffer
+    {
+    public:
+        explicit RingBuffer(uint64_t maxSize);
+        ~RingBuffer();
+
+        // Sub-allocate the ring-buffer by requesting a chunk of the specified size.
+        // return the starting offset.
+        uint64_t Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment = 1);
+        void Deallocate(uint64_t lastCompletedSerial);
+        void OpenReservation(uint64_t serial);
+        void CloseReservation(uint64_t reservedSerial, uint64_t serial);
+
+        uint64_t GetSize() const;
+        uint64_t GetUsedSize() const;
+        bool Empty() const;
+
+        static constexpr uint64_t cInvalidOffset = std::numeric_limits<uint64_t>::max();
+
+        Ref<BufferBase> buffer;
+
+    private:
+        struct Request
+        {
+            uint64_t endOffset;
+            uint64_t size;
+        };
+
+        SerialQueue<uint64_t, Request> mInflightRequests;
+
+        // Nothing from the first open reservation on can be released, they are still being written.
+        std::multiset<uint64_t> mOpenReservationSerials;
+        // Reservations committed after their serial was submitted hold back the requests from
+        // mHoldFromSerial on until mHoldUntilSerial has completed.
+        uint64_t mHoldFromSerial = 0;
+        uint64_t mHoldUntilSerial = 0;
+
+        uint64_t mUsedEndOffset = 0;   // Tail of used sub-alloc requests (in bytes).
+        uint64_t mUsedStartOffset = 0; // Head of used sub-alloc requests (in bytes).
+        uint64_t mMaxBlockSize = 0;    // Max size of the ring buffer (in bytes).
+        uint64_t mUsedSize = 0;        // Size of the sub-alloc requests (in bytes) of the ring buffer.
+    };
+} // namespace rhi::impl
@@ -1,18 +1,245 @@
 #include "ShaderModuleBase.h"
+#include "ObjectContentHasher.h"
+#include "common/Error.h"
 
+#include <algorithm>
 #include <cstring>
+#include <spirv_reflect.h>
 
 namespace rhi::impl
 {
+    namespace
+    {
+        BindingType ToBindingType(SpvReflectDescriptorType descriptorType)
+        {
+            switch (descriptorType)
+            {
+            case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLER:
+                return BindingType::Sampler;
+            case SPV_REFLECT_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                return BindingType::CombinedTextureSampler;
+            case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                return BindingType::SampledTexture;
+            case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                return BindingType::StorageTexture;
+            case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+                return BindingType::UniformBuffer;
+            case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                return BindingType::StorageBuffer;
+            case SPV_REFLECT_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+                return BindingType::None; // todo : add ACCELERATION_STRUCTURE support?
+            default:
+                ASSERT(!"Unreachable");
+                return BindingType::None;
+            }
+        }
+
+        ShaderStage ToShaderStage(SpvReflectShaderStageFlagBits stage)
+        {
+            switch (stage)
+            {
+            case SPV_REFLECT_SHADER_STAGE_VERTEX_BIT:
+                return ShaderStage::Vertex;
+            case SPV_REFLECT_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+                return ShaderStage::TessellationControl;
+            case SPV_REFLECT_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+                return ShaderStage::TessellationEvaluation;
+            case SPV_REFLECT_SHADER_STAGE_GEOMETRY_BIT:
+                return ShaderStage::Geometry;
+            case SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT:
+                return ShaderStage::Fragment;
+            case SPV_REFLECT_SHADER_STAGE_COMPUTE_BIT:
+                return ShaderStage::Compute;
+            case SPV_REFLECT_SHADER_STAGE_TASK_BIT_NV:
+                return ShaderStage::Task;
+            case SPV_REFLECT_SHADER_STAGE_MESH_BIT_NV:
+                return ShaderStage::Mesh;
+            default:
+                ASSERT(!"Unreachable");
+                return ShaderStage::None;
+            }
+        }
+
+        uint64_t RotateLeft(uint64_t value, int shift)
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+
+        uint64_t FinalMix(uint64_t k)
+        {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdull;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ull;
+            k ^= k >> 33;
+            return k;
+        }
+
+        uint64_t ReadWord64(const uint8_t* data)
+        {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            return word;
+        }
+
+        // MurmurHash3_x64_128 of the bytes, reading them in place whatever their alignment.
+        std::array<uint64_t, 2> ComputeDigest(std::string_view bytes)
+        {
+            constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+            constexpr uint64_t c2 = 0x4cf5ad432745937full;
+            const auto data = reinterpret_cast<const uint8_t*>(bytes.data());
+            const size_t blockCount = bytes.size() / 16;
+
+            uint64_t h1 = 0;
+            uint64_t h2 = 0;
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                uint64_t k1 = ReadWord64(data + i * 16);
+                uint64_t k2 = ReadWord64(data + i * 16 + 8);
+
+                k1 *= c1;
+                k1 = RotateLeft(k1, 31);
+                k1 *= c2;
+                h1 ^= k1;
+                h1 = RotateLeft(h1, 27);
+                h1 += h2;
+                h1 = h1 * 5 + 0x52dce729;
+
+                k2 *= c2;
+                k2 = RotateLeft(k2, 33);
+                k2 *= c1;
+                h2 ^= k2;
+                h2 = RotateLeft(h2, 31);
+                h2 += h1;
+                h2 = h2 * 5 + 0x38495ab5;
+            }
+
+            const uint8_t* tail = data + blockCount * 16;
+            const size_t tailSize = bytes.size() & 15;
+            uint64_t k1 = 0;
+            uint64_t k2 = 0;
+            for (size_t i = tailSize; i > 8; --i)
+            {
+                k2 ^= uint64_t(tail[i - 1]) << ((i - 9) * 8);
+            }
+            for (size_t i = std::min<size_t>(tailSize, 8); i > 0; --i)
+            {
+                k1 ^= uint64_t(tail[i - 1]) << ((i - 1) * 8);
+            }
+            if (tailSize > 8)
+            {
+                k2 *= c2;
+                k2 = RotateLeft(k2, 33);
+                k2 *= c1;
+                h2 ^= k2;
+            }
+            if (tailSize > 0)
+            {
+                k1 *= c1;
+                k1 = RotateLeft(k1, 31);
+                k1 *= c2;
+                h1 ^= k1;
+            }
+
+            h1 ^= bytes.size();
+            h2 ^= bytes.size();
+            h1 += h2;
+            h2 += h1;
+            h1 = FinalMix(h1);
+            h2 = FinalMix(h2);
+            h1 += h2;
+            h2 += h1;
+            return {h1, h2};
+        }
+    } // namespace
+
     ShaderModuleBase::ShaderModuleBase(DeviceBase* device, const ShaderModuleDesc& desc)
         : ResourceBase(device, desc.name)
         , mEntry(desc.entry)
+        , mSpirvDigest(ComputeDigest(desc.code))
+        , mSpirvSize(desc.code.size())
+    {}
+
+    ShaderModuleBase::~ShaderModuleBase() = default;
+
+    void ShaderModuleBase::DestroyImpl()
     {
-        mSpirvData.resize(desc.code.size() / sizeof(uint32_t));
-        std::memcpy(mSpirvData.data(), desc.code.data(), desc.code.size());
+        Uncache();
     }
 
-    ShaderModuleBase::~ShaderModuleBase() = default;
+    size_t ShaderModuleBase::ComputeContentHash()
+    {
+        ObjectContentHasher recorder;
+        recorder.Record(mSpirvDigest[0], mSpirvDigest[1], mSpirvSize);
+        recorder.Record(mEntry);
+        return recorder.GetContentHash();
+    }
+
+    bool ShaderModuleBase::Equal::operator()(const ShaderModuleBase* a, const ShaderModuleBase* b) const
+    {
+        return a->mSpirvDigest == b->mSpirvDigest && a->mSpirvSize == b->mSpirvSize && a->mEntry == b->mEntry;
+    }
+
+    void ShaderModuleBase::Reflect(const uint32_t* spirv, size_t spirvSize)
+    {
+        SpvReflectShaderModule reflectModule{};
+        SpvReflectResult result = spvReflectCreateShaderModule(spirvSize, spirv, &reflectModule);
+        ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
+
+        mReflection.stage = ToShaderStage(reflectModule.shader_stage);
+
+        for (uint32_t bindingIndex = 0; bindingIndex < reflectModule.descriptor_binding_count; ++bindingIndex)
+        {
+            const SpvReflectDescriptorBinding& reflectBinding = reflectModule.descriptor_bindings[bindingIndex];
+            ASSERT(reflectBinding.set < cMaxBindSets);
+
+            BindSetLayoutEntry entry{};
+            entry.binding = reflectBinding.binding;
+            entry.type = ToBindingType(reflectBinding.descriptor_type);
+            entry.arrayElementCount = 1;
+            for (uint32_t dim = 0; dim < reflectBinding.array.dims_count; ++dim)
+            {
+                entry.arrayElementCount *= reflectBinding.array.dims[dim];
+            }
+            entry.visibleStages = mReflection.stage;
+            entry.hasDynamicOffset = reflectBinding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                                     reflectBinding.descriptor_type == SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+
+            mReflection.bindingsPerSet[reflectBinding.set].push_back(entry);
+        }
+
+        ASSERT(reflectModule.push_constant_block_count <= 1);
+        if (reflectModule.push_constant_block_count > 0)
+        {
+            PushConstantRange pcr{};
+            pcr.size = reflectModule.push_constant_blocks[0].size;
+            pcr.visibility = mReflection.stage;
+            mReflection.pushConstantRange = pcr;
+        }
+
+        const SpvReflectEntryPoint* entryPoint = spvReflectGetEntryPoint(&reflectModule, mEntry.c_str());
+        if (entryPoint != nullptr)
+        {
+            mReflection.workgroupSize = {entryPoint->local_size.x, entryPoint->local_size.y, entryPoint->local_size.z};
+        }
+
+        if (mReflection.stage == ShaderStage::Vertex)
+        {
+            for (uint32_t i = 0; i < reflectModule.input_variable_count; ++i)
+            {
+                const SpvReflectInterfaceVariable* variable = reflectModule.input_variables[i];
+                if ((variable->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) == 0 &&
+                    variable->location < cMaxVertexAttributes)
+                {
+                    mReflection.vertexInputLocations.set(variable->location);
+                }
+            }
+        }
+
+        spvReflectDestroyShaderModule(&reflectModule);
+    }
 
     ResourceType ShaderModuleBase::GetType() const
     {
@@ -23,8 +250,9 @@ namespace rhi::impl
     {
         return mEntry;
     }
-    const std::vector<uint32_t>& ShaderModuleBase::GetSpirvData() const
+
+    const ShaderReflection& ShaderModuleBase::GetReflection() const
     {
-        return mSpirvData;
+        return mReflection;
     }
 } // namespace rhi::impl
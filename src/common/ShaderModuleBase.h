@@ -1,24 +1,58 @@
 #pragma once
 
+#include <array>
+#include <bitset>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 #include "RHIStruct.h"
 #include "ResourceBase.h"
+#include "common/Cached.hpp"
+#include "common/Constants.h"
 
 namespace rhi::impl
 {
-    class ShaderModuleBase : public ResourceBase
+    // What layouts and pipelines need to know about a shader, reflected once when the module is created.
+    struct ShaderReflection
+    {
+        ShaderStage stage = ShaderStage::None;
+        std::array<std::vector<BindSetLayoutEntry>, cMaxBindSets> bindingsPerSet;
+        std::optional<PushConstantRange> pushConstantRange;
+        // Only set for compute, task and mesh entry points.
+        std::array<uint32_t, 3> workgroupSize = {};
+        // Locations of the vertex shader inputs, built-ins excluded.
+        std::bitset<cMaxVertexAttributes> vertexInputLocations;
+    };
+
+    // Modules are cached by a 128-bit digest of their code and their entry point, so the same code submitted under
+    // different names shares one module. The code itself is not kept once the backend created the module.
+    class ShaderModuleBase : public ResourceBase, public Cached<ShaderModuleBase>
     {
     public:
+        // Digests the code without copying it, the backend reflects it when it creates the module.
+        explicit ShaderModuleBase(DeviceBase* device, const ShaderModuleDesc& desc);
+        ~ShaderModuleBase() override;
         ResourceType GetType() const override;
         std::string_view GetEntry() const;
-        const std::vector<uint32_t>& GetSpirvData() const;
+        const ShaderReflection& GetReflection() const;
+        size_t ComputeContentHash() override;
+
+        struct Equal
+        {
+            bool operator()(const ShaderModuleBase* a, const ShaderModuleBase* b) const;
+        };
 
     protected:
-        explicit ShaderModuleBase(DeviceBase* device, const ShaderModuleDesc& desc);
-        ~ShaderModuleBase() override;
+        void DestroyImpl() override;
+        void Reflect(const uint32_t* spirv, size_t spirvSize);
 
         std::string mEntry;
-        std::vector<uint32_t> mSpirvData;
+        // Wide enough for Equal to tell modules apart by it, the content hash only picks the bucket.
+        std::array<uint64_t, 2> mSpirvDigest = {};
+        size_t mSpirvSize = 0;
+
+    private:
+        ShaderReflection mReflection;
     };
 } // namespace rhi::impl
@@ -2,6 +2,7 @@
 
 #include "BindSetBase.h"
 #include "BindSetLayoutBase.h"
+#include "BufferBase.h"
 #include "TextureBase.h"
 #include "common/Constants.h"
 #include "common/Error.h"
@@ -41,10 +42,17 @@ namespace rhi::impl
 
     void SyncScopeUsageTracker::AddBindSet(BindSetBase* set)
     {
-        for (const BindSetEntry& bindingEntry : set->GetBindingEntries())
+        const std::vector<BindSetEntry>& entries = set->GetBindingEntries();
+        AddBindings(set->GetLayout(), entries.data(), static_cast<uint32_t>(entries.size()));
+    }
+
+    void SyncScopeUsageTracker::AddBindings(BindSetLayoutBase* layout, const BindSetEntry* entries, uint32_t entryCount)
+    {
+        for (uint32_t i = 0; i < entryCount; ++i)
         {
-            BindingType type = set->GetLayout()->GetBindingType(bindingEntry.binding);
-            ShaderStage visibility = set->GetLayout()->GetVisibility(bindingEntry.binding);
+            const BindSetEntry& bindingEntry = entries[i];
+            BindingType type = layout->GetBindingType(bindingEntry.binding);
+            ShaderStage visibility = layout->GetVisibility(bindingEntry.binding);
             switch (type)
             {
             case BindingType::CombinedTextureSampler:
@@ -88,6 +96,50 @@ namespace rhi::impl
         }
     }
 
+    void SyncScopeUsageTracker::AddResidentResources(ResourceHeapSlotType type,
+                                                     ShaderStage visibility,
+                                                     const Ref<ResourceBase>* resources,
+                                                     uint32_t resourceCount)
+    {
+        for (uint32_t i = 0; i < resourceCount; ++i)
+        {
+            switch (type)
+            {
+            case ResourceHeapSlotType::SampledTexture:
+                TextureViewUsedAs(
+                        static_cast<TextureViewBase*>(resources[i].Get()), TextureUsage::SampledBinding, visibility);
+                break;
+            case ResourceHeapSlotType::StorageBuffer:
+                BufferUsedAs(static_cast<BufferBase*>(resources[i].Get()), BufferUsage::Storage, visibility);
+                break;
+            default:
+                ASSERT(!"Unreachable");
+                break;
+            }
+        }
+    }
+
+    void SyncScopeUsageTracker::AddSyncScopeUsage(const SyncScopeResourceUsage& usage)
+    {
+        for (size_t i = 0; i < usage.buffers.size(); ++i)
+        {
+            BufferUsedAs(usage.buffers[i], usage.bufferSyncInfos[i].usage, usage.bufferSyncInfos[i].shaderStages);
+        }
+
+        for (size_t i = 0; i < usage.textures.size(); ++i)
+        {
+            TextureBase* texture = usage.textures[i];
+            usage.textureSyncInfos[i].Iterate(
+                    [&](const SubresourceRange& range, const TextureSyncInfo& syncInfo)
+                    {
+                        if (syncInfo.usage != TextureUsage::None)
+                        {
+                            TextureRangeUsedAs(texture, range, syncInfo.usage, syncInfo.shaderStages);
+                        }
+                    });
+        }
+    }
+
     SyncScopeResourceUsage SyncScopeUsageTracker::AcquireSyncScopeUsage()
     {
         SyncScopeResourceUsage usages;
@@ -2,11 +2,14 @@
 
 #include <absl/container/flat_hash_map.h>
 #include "PassResourceUsage.h"
+#include "common/Ref.hpp"
 
 
 namespace rhi::impl
 {
     class BindSetBase;
+    class BindSetLayoutBase;
+    class ResourceBase;
 
     class SyncScopeUsageTracker
     {
@@ -24,6 +27,14 @@ namespace rhi::impl
                                 TextureUsage usage,
                                 ShaderStage shaderStages = ShaderStage::None);
         void AddBindSet(BindSetBase* set);
+        void AddBindings(BindSetLayoutBase* layout, const BindSetEntry* entries, uint32_t entryCount);
+        // Resources read through the slots of a resource heap.
+        void AddResidentResources(ResourceHeapSlotType type,
+                                  ShaderStage visibility,
+                                  const Ref<ResourceBase>* resources,
+                                  uint32_t resourceCount);
+        // Merges the usages of a scope that was tracked ahead of time, e.g. by a render bundle.
+        void AddSyncScopeUsage(const SyncScopeResourceUsage& usage);
         SyncScopeResourceUsage AcquireSyncScopeUsage();
 
     private:
@@ -0,0 +1,122 @@
+#include "UniformRingAllocator.h"
+#include "AdapterBase.h"
+#include "BufferBase.h"
+#include "DeviceBase.h"
+#include "QueueBase.h"
+#include "common/Error.h"
+
+#include <algorithm>
+
+namespace rhi::impl
+{
+    namespace
+    {
+        Limits GetAdapterLimits(DeviceBase* device)
+        {
+            Limits limits{};
+            device->APIGetAdapter()->APIGetLimits(&limits);
+            return limits;
+        }
+    } // namespace
+
+    UniformRingAllocator::UniformRingAllocator(DeviceBase* device, QueueBase* queueOwner)
+        : mOffsetAlignment(std::max(GetAdapterLimits(device).minUniformBufferOffsetAlignment, 4u))
+        , mMaxAllocationSize(std::min(GetAdapterLimits(device).maxUniformBufferBindingSize, cMaxBindingRange))
+        , mDevice(device)
+        , mQueueOwner(queueOwner)
+    {}
+
+    UniformRingAllocator::~UniformRingAllocator() {}
+
+    RingBuffer* UniformRingAllocator::CreateRingBuffer()
+    {
+        auto ringBuffer = std::make_unique<RingBuffer>(cRingBufferSize);
+
+        BufferDesc desc{};
+        desc.usage = BufferUsage::Uniform | BufferUsage::MapWrite;
+        // The tail padding lets a binding of up to mMaxAllocationSize bytes stay in bounds at any dynamic offset.
+        desc.size = ringBuffer->GetSize() + mMaxAllocationSize;
+        desc.name = "UniformRingBuffer";
+        ringBuffer->buffer = mDevice->CreateBufferImpl(desc, mQueueOwner->GetType());
+        ASSERT(ringBuffer->buffer != nullptr);
+
+        mRingBufferCreations.fetch_add(1, std::memory_order_relaxed);
+        mRingBufferCount.fetch_add(1, std::memory_order_relaxed);
+
+        mRingBuffers.push_back(std::move(ringBuffer));
+        return mRingBuffers.back().get();
+    }
+
+    UniformAllocation UniformRingAllocator::Allocate(uint64_t allocationSize, uint64_t serial)
+    {
+        ASSERT(allocationSize != 0 && allocationSize <= mMaxAllocationSize);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        RingBuffer* targetRingBuffer = nullptr;
+        uint64_t offset = RingBuffer::cInvalidOffset;
+        // The newest ring buffer is the most likely to have room, the older ones are only full of in-flight frames.
+        for (auto iter = mRingBuffers.rbegin(); iter != mRingBuffers.rend(); ++iter)
+        {
+            offset = (*iter)->Allocate(allocationSize, serial, mOffsetAlignment);
+            if (offset != RingBuffer::cInvalidOffset)
+            {
+                targetRingBuffer = iter->get();
+                break;
+            }
+        }
+
+        if (targetRingBuffer == nullptr)
+        {
+            targetRingBuffer = CreateRingBuffer();
+            offset = targetRingBuffer->Allocate(allocationSize, serial, mOffsetAlignment);
+        }
+        ASSERT(offset != RingBuffer::cInvalidOffset);
+
+        mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        mAllocatedBytes.fetch_add(allocationSize, std::memory_order_relaxed);
+
+        UniformAllocation allocation{};
+        allocation.buffer = targetRingBuffer->buffer.Get();
+        allocation.dynamicOffset = static_cast<uint32_t>(offset);
+        allocation.data = static_cast<uint8_t*>(allocation.buffer->APIGetMappedPointer()) + offset;
+        return allocation;
+    }
+
+    void UniformRingAllocator::Deallocate(uint64_t lastCompletedSerial)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto iter = mRingBuffers.begin(); iter != mRingBuffers.end();)
+        {
+            RingBuffer* ringBuffer = iter->get();
+            ringBuffer->Deallocate(lastCompletedSerial);
+            // Bind sets created against a released ring buffer keep its buffer alive, they just stop being useful.
+            if (ringBuffer->Empty() && mRingBuffers.size() > 1)
+            {
+                mRingBufferReleases.fetch_add(1, std::memory_order_relaxed);
+                mRingBufferCount.fetch_sub(1, std::memory_order_relaxed);
+                iter = mRingBuffers.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    UniformAllocatorStats UniformRingAllocator::GetStats() const
+    {
+        UniformAllocatorStats stats{};
+        stats.allocationCount = mAllocationCount.load(std::memory_order_relaxed);
+        stats.allocatedBytes = mAllocatedBytes.load(std::memory_order_relaxed);
+        stats.ringBufferCreations = mRingBufferCreations.load(std::memory_order_relaxed);
+        stats.ringBufferReleases = mRingBufferReleases.load(std::memory_order_relaxed);
+        stats.ringBufferCount = mRingBufferCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    uint64_t UniformRingAllocator::GetMaxAllocationSize() const
+    {
+        return mMaxAllocationSize;
+    }
+} // namespace rhi::impl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "RHIStruct.h"
+#include "RingBuffer.h"
+#include "common/NoCopyable.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace rhi::impl
+{
+    // Persistently mapped uniform memory handed out in place of small per-draw uniform buffers. Allocations are
+    // sub-ranges of a few fixed size ring buffers, meant to be bound once through a dynamic uniform buffer binding and
+    // addressed by their dynamic offset, and are recycled once their serial has completed.
+    class UniformRingAllocator : public NonCopyable
+    {
+    public:
+        explicit UniformRingAllocator(DeviceBase* device, QueueBase* queueOwner);
+        ~UniformRingAllocator();
+
+        // Thread safe, the serials passed by concurrent callers must not go backwards.
+        UniformAllocation Allocate(uint64_t allocationSize, uint64_t serial);
+        void Deallocate(uint64_t lastCompletedSerial);
+
+        UniformAllocatorStats GetStats() const;
+        uint64_t GetMaxAllocationSize() const;
+
+        static constexpr uint64_t cRingBufferSize = 4 * 1024 * 1024;
+        static constexpr uint64_t cMaxBindingRange = 64 * 1024;
+
+    private:
+        RingBuffer* CreateRingBuffer();
+
+        const uint64_t mOffsetAlignment;
+        const uint64_t mMaxAllocationSize;
+
+        std::mutex mMutex;
+        std::list<std::unique_ptr<RingBuffer>> mRingBuffers;
+
+        std::atomic<uint64_t> mAllocationCount = 0;
+        std::atomic<uint64_t> mAllocatedBytes = 0;
+        std::atomic<uint64_t> mRingBufferCreations = 0;
+        std::atomic<uint64_t> mRingBufferReleases = 0;
+        std::atomic<uint64_t> mRingBufferCount = 0;
+
+        DeviceBase* mDevice;
+        QueueBase* mQueueOwner;
+    };
+} // namespace rhi::impl
@@ -4,139 +4,154 @@
 #include "common/Error.h"
 #include "common/Utils.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace rhi::impl
 {
-    UploadAllocator::RingBuffer::RingBuffer(uint64_t maxSize)
-        : mMaxBlockSize(maxSize)
-    {}
-
-    UploadAllocator::RingBuffer::~RingBuffer() {};
-
-    uint64_t UploadAllocator::RingBuffer::Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment)
+    UploadAllocator::UploadAllocator(DeviceBase* device, QueueBase* queueOwner)
+        : mBaseRingBufferSize(device->GetUploadRingBufferSize() != 0
+                                      ? AlignUp(device->GetUploadRingBufferSize(), 4u)
+                                      : cDefaultRingBufferSize)
+        , mDevice(device)
+        , mQueueOwner(queueOwner)
     {
-        if (mUsedSize >= mMaxBlockSize)
+        const uint32_t shardCount = std::clamp(std::thread::hardware_concurrency(), 1u, cMaxShardCount);
+        mShards.reserve(shardCount);
+        for (uint32_t i = 0; i < shardCount; ++i)
         {
-            return cInvalidOffset;
+            mShards.push_back(std::make_unique<Shard>());
+            mShards.back()->ringBufferSize = mBaseRingBufferSize;
         }
+    }
 
-        const uint64_t remainingSize = (mMaxBlockSize - mUsedSize);
-        if (allocationSize > remainingSize)
-        {
-            return cInvalidOffset;
-        }
-
-        uint64_t startOffset = cInvalidOffset;
-        uint64_t currentRequestSize = 0;
-
-        // Compute an alignment offset for the buffer if allocating at the end.
-        const uint64_t alignmentOffset = AlignUp(mUsedEndOffset, offsetAlignment) - mUsedEndOffset;
-        const uint64_t alignedUsedEndOffset = mUsedEndOffset + alignmentOffset;
-
-        // Check if the buffer is NOT split (i.e sub-alloc on ends)
-        if (mUsedStartOffset <= mUsedEndOffset)
-        {
-            // Order is important (try to sub-alloc at end first).
-            // This is due to FIFO order where sub-allocs are inserted from left-to-right (when not
-            // wrapped).
-            if (alignedUsedEndOffset + allocationSize <= mMaxBlockSize)
-            {
-                startOffset = alignedUsedEndOffset;
-                mUsedSize += allocationSize + alignmentOffset;
-                currentRequestSize = allocationSize + alignmentOffset;
-            }
-            else if (allocationSize <= mUsedStartOffset) // Try to sub-alloc at front.
-            {
-                // Count the space at the end so that a subsequent
-                // sub-alloc cannot fail when the buffer is full.
-                const uint64_t requestSize = (mMaxBlockSize - mUsedEndOffset) + allocationSize;
+    UploadAllocator::~UploadAllocator() {}
 
-                startOffset = 0;
-                mUsedSize += requestSize;
-                currentRequestSize = requestSize;
-            }
-        }
-        else if (alignedUsedEndOffset + allocationSize <= mUsedStartOffset)
-        {
-            // Otherwise, buffer is split where sub-alloc must be in-between.
-            startOffset = alignedUsedEndOffset;
-            mUsedSize += allocationSize + alignmentOffset;
-            currentRequestSize = allocationSize + alignmentOffset;
-        }
+    UploadAllocator::Shard& UploadAllocator::GetShard()
+    {
+        // Threads are spread over the shards in the order they first upload, which keeps them apart better than
+        // hashing their ids.
+        static std::atomic<uint32_t> nextThreadIndex = 0;
+        thread_local const uint32_t threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+        return *mShards[threadIndex % mShards.size()];
+    }
 
-        if (startOffset != cInvalidOffset)
-        {
-            mUsedEndOffset = startOffset + allocationSize;
+    RingBuffer* UploadAllocator::CreateRingBuffer(Shard& shard)
+    {
+        auto ringBuffer = std::make_unique<RingBuffer>(shard.ringBufferSize);
 
-            Request request;
-            request.endOffset = mUsedEndOffset;
-            request.size = currentRequestSize;
+        BufferDesc desc{};
+        desc.usage = BufferUsage::CopySrc | BufferUsage::MapWrite;
+        desc.size = ringBuffer->GetSize();
+        desc.name = "UploadStageBuffer";
+        ringBuffer->buffer = mDevice->CreateBufferImpl(desc, mQueueOwner->GetType());
+        ASSERT(ringBuffer->buffer != nullptr);
 
-            mInflightRequests.Push(serial, std::move(request));
-        }
+        mRingBufferCreations.fetch_add(1, std::memory_order_relaxed);
+        mRingBufferCount.fetch_add(1, std::memory_order_relaxed);
+        mRingBufferBytes.fetch_add(ringBuffer->GetSize(), std::memory_order_relaxed);
 
-        return startOffset;
+        shard.ringBuffers.push_back(std::move(ringBuffer));
+        return shard.ringBuffers.back().get();
     }
 
-    void UploadAllocator::RingBuffer::Deallocate(uint64_t lastCompletedSerial)
+    UploadAllocation UploadAllocator::AllocateDedicated(uint64_t allocationSize, uint64_t serial, bool isReservation)
     {
-        for (Request& request : mInflightRequests.IterateUpTo(lastCompletedSerial))
+        BufferDesc desc{};
+        desc.usage = BufferUsage::CopySrc | BufferUsage::MapWrite;
+        desc.size = AlignUp(allocationSize, 4u);
+        desc.name = "UploadStageBuffer";
+
+        Ref<BufferBase> buffer = mDevice->CreateBufferImpl(desc, mQueueOwner->GetType());
+        UploadAllocation allocation{};
+        allocation.buffer = buffer.Get();
+        allocation.mappedAddress = buffer->APIGetMappedPointer();
+
+        mDedicatedBufferCount.fetch_add(1, std::memory_order_relaxed);
+        if (isReservation)
         {
-            mUsedStartOffset = request.endOffset;
-            mUsedSize -= request.size;
+            mReservedDedicatedBuffers->emplace(buffer.Get(), std::move(buffer));
         }
-
-        // Dequeue previously recorded requests.
-        mInflightRequests.ClearUpTo(lastCompletedSerial);
+        else
+        {
+            mDedicatedBuffersToDelete->Push(serial, std::move(buffer));
+        }
+        return allocation;
     }
 
-    uint64_t UploadAllocator::RingBuffer::GetSize() const
+    UploadAllocation UploadAllocator::Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment)
     {
-        return mMaxBlockSize;
+        return AllocateImpl(allocationSize, serial, offsetAlignment, false);
     }
 
-    uint64_t UploadAllocator::RingBuffer::GetUsedSize() const
+    UploadAllocation UploadAllocator::Reserve(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment)
     {
-        return mUsedSize;
+        return AllocateImpl(allocationSize, serial, offsetAlignment, true);
     }
 
-    bool UploadAllocator::RingBuffer::Empty() const
+    void UploadAllocator::CommitReservation(BufferBase* buffer, uint64_t reservedSerial, uint64_t serial)
     {
-        return mInflightRequests.Empty();
-    }
-
-    UploadAllocator::UploadAllocator(DeviceBase* device, QueueBase* queueOwner)
-        : mDevice(device)
-        , mQueueOwner(queueOwner)
-    {}
+        ASSERT(serial >= reservedSerial);
+        const bool isDedicated = mReservedDedicatedBuffers.Use(
+                [&](auto reservedBuffers)
+                {
+                    auto iter = reservedBuffers->find(buffer);
+                    if (iter == reservedBuffers->end())
+                    {
+                        return false;
+                    }
+                    mDedicatedBuffersToDelete->Push(serial, std::move(iter->second));
+                    reservedBuffers->erase(iter);
+                    return true;
+                });
+        if (isDedicated)
+        {
+            return;
+        }
 
-    UploadAllocator::~UploadAllocator() {}
+        // The reservation may be committed from another thread than the one that made it.
+        for (auto& shard : mShards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto& ringBuffer : shard->ringBuffers)
+            {
+                if (ringBuffer->buffer.Get() == buffer)
+                {
+                    ringBuffer->CloseReservation(reservedSerial, serial);
+                    return;
+                }
+            }
+        }
+        ASSERT(false);
+    }
 
-    UploadAllocation UploadAllocator::Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment)
+    UploadAllocation UploadAllocator::AllocateImpl(uint64_t allocationSize,
+                                                   uint64_t serial,
+                                                   uint64_t offsetAlignment,
+                                                   bool isReservation)
     {
-        if (allocationSize > cRingBufferSize)
+        mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        mAllocatedBytes.fetch_add(allocationSize, std::memory_order_relaxed);
+
+        Shard& shard = GetShard();
+        std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock())
         {
-            BufferDesc desc{};
-            desc.usage = BufferUsage::CopySrc | BufferUsage::MapWrite;
-            desc.size = AlignUp(allocationSize, 4u);
-            desc.name = "UploadStageBuffer";
-
-            Ref<BufferBase> buffer = mDevice->CreateBufferImpl(desc);
-            UploadAllocation allocation{};
-            allocation.buffer = buffer.Get();
-            allocation.mappedAddress = buffer->APIGetMappedPointer();
-
-            mLargeStageBuffersToDelete.Push(serial, std::move(buffer));
-            return allocation;
+            mContendedAllocations.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
         }
 
-        if (mRingBuffers.empty())
+        shard.bytesSinceDeallocate += allocationSize;
+
+        if (allocationSize > shard.ringBufferSize)
         {
-            mRingBuffers.emplace_back(std::make_unique<RingBuffer>(cRingBufferSize));
+            lock.unlock();
+            return AllocateDedicated(allocationSize, serial, isReservation);
         }
 
         uint64_t startOffset = RingBuffer::cInvalidOffset;
-        RingBuffer* targetRingBuffer;
-        for (auto& ringBuffer : mRingBuffers)
+        RingBuffer* targetRingBuffer = nullptr;
+        for (auto& ringBuffer : shard.ringBuffers)
         {
             ASSERT(ringBuffer->GetSize() >= ringBuffer->GetUsedSize());
             startOffset = ringBuffer->Allocate(allocationSize, serial, offsetAlignment);
@@ -150,26 +165,17 @@ namespace rhi::impl
         // append a newly created ring buffer to fulfill the request.
         if (startOffset == RingBuffer::cInvalidOffset)
         {
-            mRingBuffers.emplace_back(std::make_unique<RingBuffer>(cRingBufferSize));
-            targetRingBuffer = mRingBuffers.back().get();
-            startOffset = targetRingBuffer->Allocate(allocationSize, serial);
+            targetRingBuffer = CreateRingBuffer(shard);
+            startOffset = targetRingBuffer->Allocate(allocationSize, serial, offsetAlignment);
         }
 
         ASSERT(startOffset != RingBuffer::cInvalidOffset);
-
-        if (targetRingBuffer->buffer == nullptr)
+        ASSERT(targetRingBuffer->buffer != nullptr);
+        if (isReservation)
         {
-            BufferDesc desc{};
-            desc.usage = BufferUsage::CopySrc | BufferUsage::MapWrite;
-            desc.size = AlignUp(targetRingBuffer->GetSize(), 4u);
-            desc.name = "UploadStageBuffer";
-
-            Ref<BufferBase> buffer = mDevice->CreateBufferImpl(desc, mQueueOwner->GetType());
-            targetRingBuffer->buffer = std::move(buffer);
+            targetRingBuffer->OpenReservation(serial);
         }
 
-        ASSERT(targetRingBuffer->buffer != nullptr);
-
         UploadAllocation allocation{};
         allocation.buffer = targetRingBuffer->buffer.Get();
         allocation.mappedAddress = static_cast<uint8_t*>(targetRingBuffer->buffer->APIGetMappedPointer()) + startOffset;
@@ -178,21 +184,83 @@ namespace rhi::impl
         return allocation;
     }
 
+    void UploadAllocator::UpdateRingBufferSize(Shard& shard, uint64_t elapsedSerials)
+    {
+        // Only serials that completed since the last deallocation give a meaningful volume, keep accumulating
+        // otherwise.
+        if (elapsedSerials == 0)
+        {
+            return;
+        }
+
+        const uint64_t bytesPerSerial = shard.bytesSinceDeallocate / elapsedSerials;
+        shard.bytesSinceDeallocate = 0;
+        shard.peakBytesPerSerial =
+                std::max(bytesPerSerial, shard.peakBytesPerSerial - shard.peakBytesPerSerial / cPeakDecay);
+
+        // Sized in power of two multiples of the configured size, so that small changes of the volume don't
+        // recreate ring buffers.
+        uint64_t ringBufferSize = mBaseRingBufferSize;
+        while (ringBufferSize < shard.peakBytesPerSerial &&
+               ringBufferSize < mBaseRingBufferSize * cMaxRingBufferGrowth)
+        {
+            ringBufferSize *= 2;
+        }
+        shard.ringBufferSize = ringBufferSize;
+    }
+
     void UploadAllocator::Deallocate(uint64_t lastCompletedSerial)
     {
-        for (auto ringBufferIter = mRingBuffers.begin(); ringBufferIter != mRingBuffers.end();)
+        const uint64_t lastDeallocatedSerial = mLastDeallocatedSerial.exchange(lastCompletedSerial);
+        const uint64_t elapsedSerials =
+                lastCompletedSerial > lastDeallocatedSerial ? lastCompletedSerial - lastDeallocatedSerial : 0;
+
+        for (auto& shard : mShards)
         {
-            (*ringBufferIter)->Deallocate(lastCompletedSerial);
-            if ((*ringBufferIter)->Empty() && mRingBuffers.size() > 1)
-            {
-                // Never erase the last buffer as to prevent re-creating smaller buffers.
-                ringBufferIter = mRingBuffers.erase(ringBufferIter);
-            }
-            else
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            UpdateRingBufferSize(*shard, elapsedSerials);
+
+            auto& ringBuffers = shard->ringBuffers;
+            for (auto ringBufferIter = ringBuffers.begin(); ringBufferIter != ringBuffers.end();)
             {
-                ++ringBufferIter;
+                RingBuffer* ringBuffer = ringBufferIter->get();
+                ringBuffer->Deallocate(lastCompletedSerial);
+                // Keep one idle buffer of the right size around as to prevent re-creating it every frame, the
+                // others are released so that the shard shrinks back after a burst of uploads.
+                const bool wrongSize = ringBuffer->GetSize() != shard->ringBufferSize;
+                if (ringBuffer->Empty() && (ringBuffers.size() > 1 || wrongSize))
+                {
+                    mRingBufferReleases.fetch_add(1, std::memory_order_relaxed);
+                    mRingBufferCount.fetch_sub(1, std::memory_order_relaxed);
+                    mRingBufferBytes.fetch_sub(ringBuffer->GetSize(), std::memory_order_relaxed);
+                    ringBufferIter = ringBuffers.erase(ringBufferIter);
+                }
+                else
+                {
+                    ++ringBufferIter;
+                }
             }
         }
-        mLargeStageBuffersToDelete.CIterateUpTo(lastCompletedSerial);
+
+        mDedicatedBuffersToDelete->ClearUpTo(lastCompletedSerial);
+    }
+
+    uint64_t UploadAllocator::GetBaseRingBufferSize() const
+    {
+        return mBaseRingBufferSize;
+    }
+
+    UploadAllocatorStats UploadAllocator::GetStats() const
+    {
+        UploadAllocatorStats stats{};
+        stats.allocationCount = mAllocationCount.load(std::memory_order_relaxed);
+        stats.allocatedBytes = mAllocatedBytes.load(std::memory_order_relaxed);
+        stats.dedicatedBufferCount = mDedicatedBufferCount.load(std::memory_order_relaxed);
+        stats.contendedAllocations = mContendedAllocations.load(std::memory_order_relaxed);
+        stats.ringBufferCreations = mRingBufferCreations.load(std::memory_order_relaxed);
+        stats.ringBufferReleases = mRingBufferReleases.load(std::memory_order_relaxed);
+        stats.ringBufferCount = mRingBufferCount.load(std::memory_order_relaxed);
+        stats.ringBufferBytes = mRingBufferBytes.load(std::memory_order_relaxed);
+        return stats;
     }
 } // namespace rhi::impl
@@ -1,17 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <limits>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "RHIStruct.h"
+#include "RingBuffer.h"
+#include "common/MutexProtected.hpp"
 #include "common/Ref.hpp"
 #include "common/SerialQueue.hpp"
 
-#if defined(max)
-#undef max
-#endif
-
 namespace rhi::impl
 {
     struct UploadAllocation
@@ -21,55 +22,85 @@ namespace rhi::impl
         void* mappedAddress;
     };
 
+    struct UploadAllocatorStats
+    {
+        uint64_t allocationCount;
+        uint64_t allocatedBytes;
+        // Allocations larger than the ring buffers, each of them got a buffer of its own.
+        uint64_t dedicatedBufferCount;
+        // Allocations that found their shard locked by another thread.
+        uint64_t contendedAllocations;
+        uint64_t ringBufferCreations;
+        uint64_t ringBufferReleases;
+        uint64_t ringBufferCount;
+        uint64_t ringBufferBytes;
+    };
+
+    // Staging memory for queue uploads. Every thread allocates from its own shard of ring buffers so that concurrent
+    // uploads rarely wait on each other. The ring buffer size of a shard follows the upload volume it observed per
+    // serial: rings grow when a frame does not fit and shrink back once the volume has decayed.
     class UploadAllocator
     {
     public:
         explicit UploadAllocator(DeviceBase* device, QueueBase* queueOwner);
         ~UploadAllocator();
 
+        // Thread safe, the serials passed by concurrent callers must not go backwards.
         UploadAllocation Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment);
+        // Like Allocate, but the memory stays alive past its serial until CommitReservation tells the serial whose
+        // commands actually read it.
+        UploadAllocation Reserve(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment);
+        void CommitReservation(BufferBase* buffer, uint64_t reservedSerial, uint64_t serial);
         void Deallocate(uint64_t lastCompletedSerial);
 
+        UploadAllocatorStats GetStats() const;
+        uint64_t GetBaseRingBufferSize() const;
+
     private:
-        class RingBuffer
+        struct Shard
         {
-        public:
-            explicit RingBuffer(uint64_t maxSize);
-            ~RingBuffer();
-
-            // Sub-allocate the ring-buffer by requesting a chunk of the specified size.
-            // return the starting offset.
-            uint64_t Allocate(uint64_t allocationSize, uint64_t serial, uint64_t offsetAlignment = 1);
-            void Deallocate(uint64_t lastCompletedSerial);
-
-            uint64_t GetSize() const;
-            uint64_t GetUsedSize() const;
-            bool Empty() const;
-
-            static constexpr uint64_t cInvalidOffset = std::numeric_limits<uint64_t>::max();
-
-            Ref<BufferBase> buffer;
-
-        private:
-            struct Request
-            {
-                uint64_t endOffset;
-                uint64_t size;
-            };
-
-            SerialQueue<uint64_t, Request> mInflightRequests;
-
-            uint64_t mUsedEndOffset = 0;   // Tail of used sub-alloc requests (in bytes).
-            uint64_t mUsedStartOffset = 0; // Head of used sub-alloc requests (in bytes).
-            uint64_t mMaxBlockSize = 0;    // Max size of the ring buffer (in bytes).
-            uint64_t mUsedSize = 0;        // Size of the sub-alloc requests (in bytes) of the ring buffer.
+            std::mutex mutex;
+            std::list<std::unique_ptr<RingBuffer>> ringBuffers;
+            // Size given to new ring buffers of this shard.
+            uint64_t ringBufferSize = 0;
+            uint64_t bytesSinceDeallocate = 0;
+            // Largest upload volume per serial, decaying a bit on every deallocation.
+            uint64_t peakBytesPerSerial = 0;
         };
 
-        static constexpr uint64_t cRingBufferSize = 4 * 1024 * 1024;
-
-        std::list<std::unique_ptr<RingBuffer>> mRingBuffers;
-
-        SerialQueue<uint64_t, Ref<BufferBase>> mLargeStageBuffersToDelete;
+        Shard& GetShard();
+        RingBuffer* CreateRingBuffer(Shard& shard);
+        UploadAllocation AllocateImpl(uint64_t allocationSize,
+                                      uint64_t serial,
+                                      uint64_t offsetAlignment,
+                                      bool isReservation);
+        UploadAllocation AllocateDedicated(uint64_t allocationSize, uint64_t serial, bool isReservation);
+        void UpdateRingBufferSize(Shard& shard, uint64_t elapsedSerials);
+
+        static constexpr uint64_t cDefaultRingBufferSize = 4 * 1024 * 1024;
+        // Ring buffers never grow beyond this multiple of the configured size.
+        static constexpr uint64_t cMaxRingBufferGrowth = 16;
+        // The peak volume loses 1/cPeakDecay of its value on every deallocation.
+        static constexpr uint64_t cPeakDecay = 32;
+        static constexpr uint32_t cMaxShardCount = 8;
+
+        const uint64_t mBaseRingBufferSize;
+        std::vector<std::unique_ptr<Shard>> mShards;
+
+        MutexProtected<SerialQueue<uint64_t, Ref<BufferBase>>> mDedicatedBuffersToDelete;
+        // Dedicated buffers of reservations are only scheduled for deletion once committed.
+        MutexProtected<std::unordered_map<BufferBase*, Ref<BufferBase>>> mReservedDedicatedBuffers;
+
+        std::atomic<uint64_t> mLastDeallocatedSerial = 0;
+
+        std::atomic<uint64_t> mAllocationCount = 0;
+        std::atomic<uint64_t> mAllocatedBytes = 0;
+        std::atomic<uint64_t> mDedicatedBufferCount = 0;
+        std::atomic<uint64_t> mContendedAllocations = 0;
+        std::atomic<uint64_t> mRingBufferCreations = 0;
+        std::atomic<uint64_t> mRingBufferReleases = 0;
+        std::atomic<uint64_t> mRingBufferCount = 0;
+        std::atomic<uint64_t> mRingBufferBytes = 0;
 
         DeviceBase* mDevice;
         QueueBase* mQueueOwner;
@@ -0,0 +1,133 @@
+#include "WorkerTaskPool.h"
+#include "common/Error.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace rhi::impl
+{
+    WorkerTaskPool::WorkerTaskPool(uint32_t threadCount)
+    {
+        ASSERT(threadCount > 0);
+        mThreads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            mThreads.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    WorkerTaskPool::~WorkerTaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mCondition.notify_all();
+
+        for (std::thread& thread : mThreads)
+        {
+            thread.join();
+        }
+    }
+
+    uint32_t WorkerTaskPool::GetThreadCount() const
+    {
+        return static_cast<uint32_t>(mThreads.size());
+    }
+
+    void WorkerTaskPool::PostTask(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push_back(std::move(task));
+            ++mUnfinishedTaskCount;
+        }
+        mCondition.notify_one();
+    }
+
+    void WorkerTaskPool::WaitIdle()
+    {
+        ASSERT(!IsWorkerThread());
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdleCondition.wait(lock, [this]() { return mUnfinishedTaskCount == 0; });
+    }
+
+    bool WorkerTaskPool::IsWorkerThread() const
+    {
+        const std::thread::id currentId = std::this_thread::get_id();
+        return std::any_of(mThreads.begin(),
+                           mThreads.end(),
+                           [currentId](const std::thread& thread) { return thread.get_id() == currentId; });
+    }
+
+    void WorkerTaskPool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+                // Drain the queue before stopping so that nobody waits forever on a posted task.
+                if (mTasks.empty())
+                {
+                    return;
+                }
+                task = std::move(mTasks.front());
+                mTasks.pop_front();
+            }
+            task();
+            // Whatever the task captured is released before it counts as finished.
+            task = nullptr;
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mUnfinishedTaskCount == 0)
+            {
+                mIdleCondition.notify_all();
+            }
+        }
+    }
+
+    void WorkerTaskPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& task)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Helpers may only get scheduled after the loop is done, so the shared state must outlive this call. The task
+        // itself is only touched while an index is still unclaimed, which keeps the caller blocked below.
+        struct State
+        {
+            std::atomic<uint32_t> nextIndex = 0;
+            std::atomic<uint32_t> finishedCount = 0;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto state = std::make_shared<State>();
+
+        auto runIndices = [state, count, &task]()
+        {
+            for (uint32_t i = state->nextIndex.fetch_add(1); i < count; i = state->nextIndex.fetch_add(1))
+            {
+                task(i);
+                if (state->finishedCount.fetch_add(1) + 1 == count)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        const uint32_t helperCount = std::min(count - 1, GetThreadCount());
+        for (uint32_t i = 0; i < helperCount; ++i)
+        {
+            PostTask(runIndices);
+        }
+        runIndices();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&]() { return state->finishedCount.load() == count; });
+    }
+} // namespace rhi::impl
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common/NoCopyable.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rhi::impl
+{
+    // A fixed set of worker threads executing tasks in FIFO order.
+    class WorkerTaskPool : public NonCopyable
+    {
+    public:
+        explicit WorkerTaskPool(uint32_t threadCount);
+        ~WorkerTaskPool();
+
+        void PostTask(std::function<void()> task);
+        // Runs task(i) for every i in [0, count) on the workers and the calling thread, and returns once all of them
+        // have finished.
+        void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& task);
+        // Blocks until every posted task has finished running.
+        void WaitIdle();
+        bool IsWorkerThread() const;
+        uint32_t GetThreadCount() const;
+
+    private:
+        void WorkerLoop();
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::condition_variable mIdleCondition;
+        std::deque<std::function<void()>> mTasks;
+        // Tasks posted and not finished yet, including the running ones.
+        uint64_t mUnfinishedTaskCount = 0;
+        bool mStopping = false;
+
+        std::vector<std::thread> mThreads;
+    };
+} // namespace rhi::impl
@@ -8,6 +8,9 @@ export namespace rhi
 {
 	using rhi::MapMode;
 	using rhi::BufferMapAsyncStatus;
+	using rhi::SerialCompletedStatus;
+	using rhi::ReadbackStatus;
+	using rhi::CreatePipelineAsyncStatus;
 	using rhi::BufferUsage;
 	using rhi::TextureDimension;
 	using rhi::TextureFormat;
@@ -22,6 +25,7 @@ export namespace rhi
 	using rhi::FilterMode;
 	using rhi::BorderColor;
 	using rhi::BindingType;
+	using rhi::ResourceHeapSlotType;
 	using rhi::ShaderStage;
 	using rhi::FillMode;
 	using rhi::CullMode;
@@ -41,6 +45,10 @@ export namespace rhi
 	using rhi::PresentMode;
 	using rhi::SurfaceAcquireNextTextureStatus;
 	using rhi::BufferMapCallback;
+	using rhi::SerialCompletedCallback;
+	using rhi::ReadbackCallback;
+	using rhi::CreateRenderPipelineAsyncCallback;
+	using rhi::CreateComputePipelineAsyncCallback;
 	using rhi::LoggingCallback;
 
 	using rhi::Adapter;
@@ -57,8 +65,11 @@ export namespace rhi
 	using rhi::PipelineCache;
 	//using rhi::QuerySet;
 	using rhi::Queue;
+	using rhi::RenderBundle;
+	using rhi::RenderBundleEncoder;
 	using rhi::RenderPassEncoder;
 	using rhi::RenderPipeline;
+	using rhi::ResourceHeap;
 	using rhi::Sampler;
 	using rhi::ShaderModule;
 	using rhi::Surface;
@@ -77,6 +88,7 @@ export namespace rhi
 	using rhi::PipelineCacheDesc;
 	using rhi::RenderPassDesc;
 	using rhi::RenderPipelineDesc;
+	using rhi::ResourceHeapDesc;
 	using rhi::SamplerDesc;
 	using rhi::ShaderModuleDesc;
 	using rhi::SurfaceConfiguration;
@@ -89,6 +101,8 @@ export namespace rhi
 	using rhi::Rect;
 	using rhi::TextureDataLayout;
 	using rhi::TextureSlice;
+	using rhi::UploadReservation;
+	using rhi::UniformAllocation;
 	using rhi::SpecializationConstant;
 	using rhi::BindSetLayoutEntry;
 	using rhi::BindSetEntry;
@@ -105,6 +119,11 @@ export namespace rhi
 	using rhi::DepthStencilAattachment;
 	using rhi::AdapterInfo;
 	using rhi::Limits;
+	using rhi::DescriptorStats;
+	using rhi::BindSetCacheStats;
+	using rhi::UniformAllocatorStats;
+	using rhi::PipelineObjectCacheStats;
+	using rhi::ShaderModuleCacheStats;
 	using rhi::TextureSubresourceRange;
 	using rhi::TextureSubresources;
 	using rhi::ResourceTransfer;
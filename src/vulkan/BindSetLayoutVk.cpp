@@ -61,17 +61,37 @@ namespace rhi::impl::vulkan
         return bindSetLayout;
     }
 
+    Ref<BindSetLayout> BindSetLayout::CreateUpdateAfterBind(DeviceBase* device, const BindSetLayoutDesc& desc)
+    {
+        Ref<BindSetLayout> bindSetLayout = AcquireRef(new BindSetLayout(device, desc));
+        bindSetLayout->mUpdateAfterBind = true;
+        if (!bindSetLayout->Initialize(desc))
+        {
+            return nullptr;
+        }
+        bindSetLayout->TrackResource();
+        return bindSetLayout;
+    }
+
     BindSetLayout::~BindSetLayout()
     {}
 
     bool BindSetLayout::Initialize(const BindSetLayoutDesc& desc)
     {
+        ASSERT(mDevice);
+        Device* device = checked_cast<Device>(mDevice);
+        const bool useDescriptorBuffer = device->IsDescriptorBufferEnabled();
+
         std::vector<VkDescriptorSetLayoutBinding> vkBindings;
         vkBindings.reserve(desc.entryCount);
 
         for (uint32_t i = 0; i < desc.entryCount; ++i)
         {
             const BindSetLayoutEntry& entry = desc.entries[i];
+            INVALID_IF(useDescriptorBuffer && entry.hasDynamicOffset,
+                       "Binding %u has a dynamic offset, which is not supported with the DescriptorBuffer feature. "
+                       "Uniform allocations have to be bound through a bind set at their offset instead.",
+                       entry.binding);
             VkDescriptorSetLayoutBinding& vkBinding = vkBindings.emplace_back();
             vkBinding.binding = entry.binding;
             vkBinding.descriptorType = ToVkDescriptorType(entry.type, entry.hasDynamicOffset);
@@ -87,12 +107,52 @@ namespace rhi::impl::vulkan
         createInfo.bindingCount = vkBindings.size();
         createInfo.pBindings = vkBindings.data();
 
-        ASSERT(mDevice);
-        Device* device = checked_cast<Device>(mDevice);
+        // Without the extension, push descriptor layouts are regular layouts written to transient sets.
+        if (IsPushDescriptor() && device->IsPushDescriptorSupported())
+        {
+            createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
+
+        std::vector<VkDescriptorBindingFlags> bindingFlags;
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        if (mUpdateAfterBind)
+        {
+            // Descriptor buffer memory can be written while bound anyway, only partial binding is still needed.
+            bindingFlags.resize(vkBindings.size(),
+                                useDescriptorBuffer ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                                                    : VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                              VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                              VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT);
+            bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+            bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+            bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+            createInfo.pNext = &bindingFlagsInfo;
+            createInfo.flags = useDescriptorBuffer ? 0 : VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        }
+
+        if (useDescriptorBuffer)
+        {
+            createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
 
         VkResult err = vkCreateDescriptorSetLayout(device->GetHandle(), &createInfo, nullptr, &mHandle);
         CHECK_VK_RESULT_FALSE(err, "CreateDescriptorSetLayout");
 
+        SetDebugName(device, mHandle, "BindSetLayout", GetName());
+
+        // Bind sets, push bindings included, are ranges of the descriptor buffer heap, there are no pools to size.
+        if (useDescriptorBuffer)
+        {
+            InitializeDescriptorBufferOffsets(desc);
+            return true;
+        }
+
+        // Push descriptor layouts never allocate sets from pools of their own.
+        if (IsPushDescriptor())
+        {
+            return true;
+        }
+
         // Compute the size of descriptor pools used for this layout.
 
         std::unordered_map<VkDescriptorType, uint32_t> descriptorCountPerType;
@@ -101,16 +161,96 @@ namespace rhi::impl::vulkan
         {
 
             VkDescriptorType vkType = ToVkDescriptorType(desc.entries[i].type, desc.entries[i].hasDynamicOffset);
-            descriptorCountPerType[vkType] += 1;
+            descriptorCountPerType[vkType] += desc.entries[i].arrayElementCount;
         }
 
-        mDescriptorSetAllocator = DescriptorSetAllocator::Create(device, std::move(descriptorCountPerType));
+        if (mUpdateAfterBind)
+        {
+            // These layouts hold large arrays and are allocated a few sets at most, one set per pool is enough.
+            mDescriptorSetAllocator = DescriptorSetAllocator::Create(
+                    device, std::move(descriptorCountPerType), VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT, 1);
+        }
+        else
+        {
+            mDescriptorSetAllocator = DescriptorSetAllocator::Create(device, std::move(descriptorCountPerType));
+        }
 
-        SetDebugName(device, mHandle, "BindSetLayout", GetName());
+        // Update-after-bind layouts hold large arrays that are written a few descriptors at a time.
+        if (!mUpdateAfterBind && !CreateUpdateTemplate(desc))
+        {
+            return false;
+        }
 
         return true;
     }
 
+    bool BindSetLayout::CreateUpdateTemplate(const BindSetLayoutDesc& desc)
+    {
+        uint32_t descriptorCount = 0;
+        for (uint32_t i = 0; i < desc.entryCount; ++i)
+        {
+            descriptorCount += desc.entries[i].arrayElementCount;
+        }
+        if (descriptorCount == 0 || descriptorCount > cMaxUpdateTemplateDescriptors)
+        {
+            return true;
+        }
+
+        mBindingPayloadOffsets.assign(mBindingIndexToInfoMap.size(), 0);
+
+        std::vector<VkDescriptorUpdateTemplateEntry> templateEntries(desc.entryCount);
+        uint32_t payloadOffset = 0;
+        for (uint32_t i = 0; i < desc.entryCount; ++i)
+        {
+            const BindSetLayoutEntry& entry = desc.entries[i];
+            mBindingPayloadOffsets[entry.binding] = payloadOffset;
+
+            VkDescriptorUpdateTemplateEntry& templateEntry = templateEntries[i];
+            templateEntry.dstBinding = entry.binding;
+            templateEntry.dstArrayElement = 0;
+            templateEntry.descriptorCount = entry.arrayElementCount;
+            templateEntry.descriptorType = ToVkDescriptorType(entry.type, entry.hasDynamicOffset);
+            templateEntry.offset = payloadOffset * sizeof(DescriptorUpdatePayload);
+            templateEntry.stride = sizeof(DescriptorUpdatePayload);
+
+            payloadOffset += entry.arrayElementCount;
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(templateEntries.size());
+        createInfo.pDescriptorUpdateEntries = templateEntries.data();
+        createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        createInfo.descriptorSetLayout = mHandle;
+
+        Device* device = checked_cast<Device>(mDevice);
+        VkResult err = vkCreateDescriptorUpdateTemplate(device->GetHandle(), &createInfo, nullptr, &mUpdateTemplate);
+        CHECK_VK_RESULT_FALSE(err, "CreateDescriptorUpdateTemplate");
+
+        mUpdateTemplateDescriptorCount = descriptorCount;
+        return true;
+    }
+
+    void BindSetLayout::InitializeDescriptorBufferOffsets(const BindSetLayoutDesc& desc)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+
+        VkDeviceSize layoutSize = 0;
+        device->Fn.vkGetDescriptorSetLayoutSizeEXT(device->GetHandle(), mHandle, &layoutSize);
+        mDescriptorBufferSize =
+                AlignUp(static_cast<uint64_t>(layoutSize),
+                        static_cast<uint64_t>(device->GetDescriptorBufferProperties().descriptorBufferOffsetAlignment));
+
+        mDescriptorBufferBindingOffsets.assign(mBindingIndexToInfoMap.size(), 0);
+        for (uint32_t i = 0; i < desc.entryCount; ++i)
+        {
+            const uint32_t binding = desc.entries[i].binding;
+            VkDeviceSize offset = 0;
+            device->Fn.vkGetDescriptorSetLayoutBindingOffsetEXT(device->GetHandle(), mHandle, binding, &offset);
+            mDescriptorBufferBindingOffsets[binding] = offset;
+        }
+    }
+
     void BindSetLayout::DestroyImpl()
     {
         BindSetLayoutBase::DestroyImpl();
@@ -123,6 +263,12 @@ namespace rhi::impl::vulkan
             mHandle = VK_NULL_HANDLE;
         }
 
+        if (mUpdateTemplate != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorUpdateTemplate(device->GetHandle(), mUpdateTemplate, nullptr);
+            mUpdateTemplate = VK_NULL_HANDLE;
+        }
+
         mDescriptorSetAllocator = nullptr;
     }
 
@@ -134,15 +280,67 @@ namespace rhi::impl::vulkan
     Ref<BindSet> BindSetLayout::AllocateBindSet(const BindSetDesc& desc)
     {
         ASSERT(mDevice);
+        Device* device = checked_cast<Device>(mDevice);
+        if (device->IsDescriptorBufferEnabled())
+        {
+            const uint64_t offset = device->GetDescriptorBufferHeap()->Allocate(mDescriptorBufferSize);
+            if (offset == DescriptorBufferHeap::cInvalidOffset)
+            {
+                LOG_ERROR("The descriptor buffer heap is full.");
+                return nullptr;
+            }
+            return AcquireRef(new BindSet(device, desc, offset));
+        }
+
         DescriptorSetAllocation descriptorSetAllocation = mDescriptorSetAllocator->Allocate(this);
 
-        return AcquireRef(new BindSet(checked_cast<Device>(mDevice), desc, descriptorSetAllocation));
+        return AcquireRef(new BindSet(device, desc, descriptorSetAllocation));
     }
 
     void BindSetLayout::DeallocateBindSet(BindSet* bindSet, DescriptorSetAllocation* descriptorSetAllocation)
     {
+        ASSERT(mDescriptorSetAllocator != nullptr);
         mDescriptorSetAllocator->Deallocate(descriptorSetAllocation,
                                             bindSet->IsUsedInQueue(QueueType::Graphics),
                                             bindSet->IsUsedInQueue(QueueType::Compute));
     }
+
+    VkDescriptorUpdateTemplate BindSetLayout::GetUpdateTemplate() const
+    {
+        return mUpdateTemplate;
+    }
+
+    uint32_t BindSetLayout::GetUpdateTemplateDescriptorCount() const
+    {
+        return mUpdateTemplateDescriptorCount;
+    }
+
+    uint32_t BindSetLayout::GetUpdateTemplatePayloadIndex(uint32_t binding, uint32_t arrayElementIndex) const
+    {
+        if (binding >= mBindingPayloadOffsets.size() || !mBindingIndexToInfoMap[binding].has_value() ||
+            arrayElementIndex >= mBindingIndexToInfoMap[binding]->arrayElementCount)
+        {
+            return mUpdateTemplateDescriptorCount;
+        }
+        return mBindingPayloadOffsets[binding] + arrayElementIndex;
+    }
+
+    uint64_t BindSetLayout::GetDescriptorBufferSize() const
+    {
+        return mDescriptorBufferSize;
+    }
+
+    uint64_t BindSetLayout::GetDescriptorBufferOffset(uint32_t binding, uint32_t arrayElementIndex) const
+    {
+        ASSERT(binding < mDescriptorBufferBindingOffsets.size());
+        // Elements of an array binding are tightly packed.
+        return mDescriptorBufferBindingOffsets[binding] +
+                arrayElementIndex * checked_cast<Device>(mDevice)->GetDescriptorSize(GetBindingType(binding));
+    }
+
+    void BindSetLayout::APIGetDescriptorStats(DescriptorStats* stats) const
+    {
+        // Push descriptor layouts allocate no sets.
+        *stats = mDescriptorSetAllocator != nullptr ? mDescriptorSetAllocator->GetStats() : DescriptorStats{};
+    }
 } // namespace rhi::impl::vulkan
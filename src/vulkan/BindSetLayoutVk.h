@@ -6,15 +6,25 @@
 #include "DescriptorSetAllocator.h"
 
 #include <vulkan/vulkan.h>
+#include <vector>
 
 namespace rhi::impl::vulkan
 {
     class BindSet;
 
+    // One element of the data read by the descriptor update template of a layout.
+    union DescriptorUpdatePayload
+    {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+    };
+
     class BindSetLayout final : public BindSetLayoutBase
     {
     public:
         static Ref<BindSetLayout> Create(DeviceBase* device, const BindSetLayoutDesc& desc);
+        // A layout whose descriptors may be partially bound and updated after the set was bound.
+        static Ref<BindSetLayout> CreateUpdateAfterBind(DeviceBase* device, const BindSetLayoutDesc& desc);
         VkDescriptorSetLayout GetHandle() const;
 
         Ref<BindSet> AllocateBindSet(const BindSetDesc& desc);
@@ -22,13 +32,40 @@ namespace rhi::impl::vulkan
         void DeallocateBindSet(BindSet* bindSet,
                                DescriptorSetAllocation* descriptorSetAllocation);
 
+        void APIGetDescriptorStats(DescriptorStats* stats) const override;
+
+        // VK_NULL_HANDLE if the layout is written with vkUpdateDescriptorSets only.
+        VkDescriptorUpdateTemplate GetUpdateTemplate() const;
+        uint32_t GetUpdateTemplateDescriptorCount() const;
+        // Index of the descriptor in the template payload, out of range if the layout has no such descriptor.
+        uint32_t GetUpdateTemplatePayloadIndex(uint32_t binding, uint32_t arrayElementIndex) const;
+
+        // Size of a bind set of this layout in the descriptor buffer heap, aligned for its offsets.
+        uint64_t GetDescriptorBufferSize() const;
+        // Offset of a descriptor from the start of its bind set in the descriptor buffer heap.
+        uint64_t GetDescriptorBufferOffset(uint32_t binding, uint32_t arrayElementIndex) const;
+
     private:
         explicit BindSetLayout(DeviceBase* device, const BindSetLayoutDesc& desc);
         ~BindSetLayout() override;
         bool Initialize(const BindSetLayoutDesc& desc);
+        bool CreateUpdateTemplate(const BindSetLayoutDesc& desc);
+        void InitializeDescriptorBufferOffsets(const BindSetLayoutDesc& desc);
         void DestroyImpl() override;
         VkDescriptorSetLayout mHandle = VK_NULL_HANDLE;
+        bool mUpdateAfterBind = false;
         Ref<DescriptorSetAllocator> mDescriptorSetAllocator;
+
+        // Layouts with more descriptors than this keep writing their sets with vkUpdateDescriptorSets.
+        static constexpr uint32_t cMaxUpdateTemplateDescriptors = 256;
+        VkDescriptorUpdateTemplate mUpdateTemplate = VK_NULL_HANDLE;
+        uint32_t mUpdateTemplateDescriptorCount = 0;
+        // First payload index of each binding, indexed by binding number.
+        std::vector<uint32_t> mBindingPayloadOffsets;
+
+        uint64_t mDescriptorBufferSize = 0;
+        // Offset of the first descriptor of each binding, indexed by binding number.
+        std::vector<uint64_t> mDescriptorBufferBindingOffsets;
     };
 
     VkDescriptorType ToVkDescriptorType(BindingType bindType, bool hasDynamicOffset);
@@ -17,12 +17,133 @@ namespace rhi::impl::vulkan
         return checked_cast<BindSetLayout>(desc.layout)->AllocateBindSet(desc);
     }
 
-    BindSet::BindSet(Device* device, const BindSetDesc& desc, DescriptorSetAllocation descriptorSetAllocation)
+    bool FillDescriptorInfo(BindingType bindingType,
+                            const BindSetEntry& entry,
+                            VkDescriptorImageInfo* imageInfo,
+                            VkDescriptorBufferInfo* bufferInfo)
+    {
+        switch (bindingType)
+        {
+        case BindingType::SampledTexture:
+            imageInfo->sampler = VK_NULL_HANDLE;
+            imageInfo->imageView = checked_cast<TextureView>(entry.textureView)->GetHandle();
+            imageInfo->imageLayout =
+                    ImageLayoutConvert(TextureUsage::SampledBinding, entry.textureView->GetTexture()->APIGetFormat());
+            return true;
+        case BindingType::StorageTexture:
+            imageInfo->sampler = VK_NULL_HANDLE;
+            imageInfo->imageView = checked_cast<TextureView>(entry.textureView)->GetHandle();
+            imageInfo->imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            return true;
+        case BindingType::StorageBuffer:
+        case BindingType::UniformBuffer:
+            bufferInfo->buffer = checked_cast<Buffer>(entry.buffer)->GetHandle();
+            bufferInfo->offset = entry.bufferOffset;
+            // Resolved here because descriptor buffers take no VK_WHOLE_SIZE.
+            bufferInfo->range = entry.bufferRange == CWholeSize ? entry.buffer->APIGetSize() - entry.bufferOffset
+                                                                : entry.bufferRange;
+            return true;
+        case BindingType::Sampler:
+            imageInfo->sampler = checked_cast<Sampler>(entry.sampler)->GetHandle();
+            imageInfo->imageView = VK_NULL_HANDLE;
+            imageInfo->imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            return true;
+        case BindingType::CombinedTextureSampler:
+            imageInfo->imageView = checked_cast<TextureView>(entry.textureView)->GetHandle();
+            imageInfo->imageLayout =
+                    ImageLayoutConvert(TextureUsage::StorageBinding, entry.textureView->GetTexture()->APIGetFormat());
+            imageInfo->sampler = checked_cast<Sampler>(entry.sampler)->GetHandle();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void WriteDescriptorToBuffer(Device* device,
+                                 BindingType bindingType,
+                                 const VkDescriptorImageInfo* imageInfo,
+                                 const VkDescriptorBufferInfo* bufferInfo,
+                                 void* dst)
+    {
+        VkDescriptorAddressInfoEXT addressInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+        VkDescriptorGetInfoEXT getInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+        getInfo.type = ToVkDescriptorType(bindingType, false);
+        switch (bindingType)
+        {
+        case BindingType::SampledTexture:
+            getInfo.data.pSampledImage = imageInfo;
+            break;
+        case BindingType::StorageTexture:
+            getInfo.data.pStorageImage = imageInfo;
+            break;
+        case BindingType::UniformBuffer:
+        case BindingType::StorageBuffer:
+            {
+                VkBufferDeviceAddressInfo bufferAddressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+                bufferAddressInfo.buffer = bufferInfo->buffer;
+                addressInfo.address = vkGetBufferDeviceAddress(device->GetHandle(), &bufferAddressInfo) +
+                        bufferInfo->offset;
+            }
+            addressInfo.range = bufferInfo->range;
+            addressInfo.format = VK_FORMAT_UNDEFINED;
+            if (bindingType == BindingType::UniformBuffer)
+            {
+                getInfo.data.pUniformBuffer = &addressInfo;
+            }
+            else
+            {
+                getInfo.data.pStorageBuffer = &addressInfo;
+            }
+            break;
+        case BindingType::Sampler:
+            getInfo.data.pSampler = &imageInfo->sampler;
+            break;
+        case BindingType::CombinedTextureSampler:
+            getInfo.data.pCombinedImageSampler = imageInfo;
+            break;
+        default:
+            ASSERT(!"unreachable");
+            return;
+        }
+
+        device->Fn.vkGetDescriptorEXT(device->GetHandle(), &getInfo, device->GetDescriptorSize(bindingType), dst);
+    }
+
+    Ref<BindSet> BindSet::CreateTransient(Device* device, const BindSetDesc& desc)
+    {
+        // Descriptor buffer ranges are cheap to allocate and free, transient sets need no pools of their own.
+        if (device->IsDescriptorBufferEnabled())
+        {
+            return Create(device, desc);
+        }
+
+        VkDescriptorSet set =
+                device->GetTransientDescriptorAllocator()->Allocate(checked_cast<BindSetLayout>(desc.layout));
+        if (set == VK_NULL_HANDLE)
+        {
+            return nullptr;
+        }
+        return AcquireRef(new BindSet(device, desc, {set, 0}, true));
+    }
+
+    BindSet::BindSet(Device* device,
+                     const BindSetDesc& desc,
+                     DescriptorSetAllocation descriptorSetAllocation,
+                     bool isTransient)
         : BindSetBase(device, desc)
         , mDescriptorSetAllocation(descriptorSetAllocation)
+        , mIsTransient(isTransient)
+        , mDescriptorBufferOffset(DescriptorBufferHeap::cInvalidOffset)
     {
         BindSetBase::TrackResource();
 
+        BindSetLayout* layout = checked_cast<BindSetLayout>(desc.layout);
+        if (WriteWithTemplate(layout, desc))
+        {
+            device->AddDescriptorUpdate(true);
+            return;
+        }
+
         absl::InlinedVector<VkWriteDescriptorSet, cMaxOptimalBindingsPerGroup> writes(desc.entryCount);
         absl::InlinedVector<VkDescriptorBufferInfo, cMaxOptimalBindingsPerGroup> writeBufferInfo(desc.entryCount);
         absl::InlinedVector<VkDescriptorImageInfo, cMaxOptimalBindingsPerGroup> writeImageInfo(desc.entryCount);
@@ -37,63 +158,92 @@ namespace rhi::impl::vulkan
             write.dstArrayElement = desc.entries[i].arrayElementIndex;
             write.descriptorCount = 1;
 
-            BindingType bindingType = desc.layout->GetBindingType(desc.entries[i].binding);
+            BindingType bindingType = layout->GetBindingType(desc.entries[i].binding);
 
-            write.descriptorType =
-                    ToVkDescriptorType(bindingType, desc.layout->HasDynamicOffset(desc.entries[i].binding));
+            write.descriptorType = ToVkDescriptorType(bindingType, layout->HasDynamicOffset(desc.entries[i].binding));
 
-            switch (bindingType)
+            if (FillDescriptorInfo(bindingType, desc.entries[i], &writeImageInfo[i], &writeBufferInfo[i]))
             {
-            case BindingType::SampledTexture:
-                {
-                    VkDescriptorImageInfo& imageInfo = writeImageInfo[i];
-                    imageInfo.imageView = checked_cast<TextureView>(desc.entries[i].textureView)->GetHandle();
-                    imageInfo.imageLayout = ImageLayoutConvert(
-                            TextureUsage::SampledBinding, desc.entries[i].textureView->GetTexture()->APIGetFormat());
-                    write.pImageInfo = &imageInfo;
-                    break;
-                }
-            case BindingType::StorageTexture:
-                {
-                    VkDescriptorImageInfo& imageInfo = writeImageInfo[i];
-                    imageInfo.imageView = checked_cast<TextureView>(desc.entries[i].textureView)->GetHandle();
-                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-                    write.pImageInfo = &imageInfo;
-                    break;
-                }
-            case BindingType::StorageBuffer:
-            case BindingType::UniformBuffer:
-                {
-                    VkDescriptorBufferInfo& bufferInfo = writeBufferInfo[i];
-                    bufferInfo.buffer = checked_cast<Buffer>(desc.entries[i].buffer)->GetHandle();
-                    bufferInfo.offset = desc.entries[i].bufferOffset;
-                    bufferInfo.range = desc.entries[i].bufferRange;
-                    write.pBufferInfo = &bufferInfo;
-                    break;
-                }
-            case BindingType::Sampler:
+                if (bindingType == BindingType::StorageBuffer || bindingType == BindingType::UniformBuffer)
                 {
-                    VkDescriptorImageInfo& imageInfo = writeImageInfo[i];
-                    imageInfo.sampler = checked_cast<Sampler>(desc.entries[i].sampler)->GetHandle();
-                    write.pImageInfo = &imageInfo;
-                    break;
+                    write.pBufferInfo = &writeBufferInfo[i];
                 }
-            case BindingType::CombinedTextureSampler:
+                else
                 {
-                    VkDescriptorImageInfo& imageInfo = writeImageInfo[i];
-                    imageInfo.imageView = checked_cast<TextureView>(desc.entries[i].textureView)->GetHandle();
-                    imageInfo.imageLayout = ImageLayoutConvert(
-                            TextureUsage::StorageBinding, desc.entries[i].textureView->GetTexture()->APIGetFormat());
-                    imageInfo.sampler = checked_cast<Sampler>(desc.entries[i].sampler)->GetHandle();
-                    write.pImageInfo = &imageInfo;
-                    break;
+                    write.pImageInfo = &writeImageInfo[i];
                 }
-            default:
-                break;
             }
         }
 
         vkUpdateDescriptorSets(device->GetHandle(), desc.entryCount, writes.data(), 0, nullptr);
+        device->AddDescriptorUpdate(false);
+    }
+
+    BindSet::BindSet(Device* device, const BindSetDesc& desc, uint64_t descriptorBufferOffset)
+        : BindSetBase(device, desc)
+        , mDescriptorSetAllocation{}
+        , mIsTransient(false)
+        , mDescriptorBufferOffset(descriptorBufferOffset)
+    {
+        BindSetBase::TrackResource();
+
+        BindSetLayout* layout = checked_cast<BindSetLayout>(desc.layout);
+        for (uint32_t i = 0; i < desc.entryCount; ++i)
+        {
+            const BindSetEntry& entry = desc.entries[i];
+            VkDescriptorImageInfo imageInfo{};
+            VkDescriptorBufferInfo bufferInfo{};
+            FillDescriptorInfo(layout->GetBindingType(entry.binding), entry, &imageInfo, &bufferInfo);
+            WriteDescriptorBuffer(entry.binding, entry.arrayElementIndex, &imageInfo, &bufferInfo);
+        }
+    }
+
+    void BindSet::WriteDescriptorBuffer(uint32_t binding,
+                                        uint32_t arrayElementIndex,
+                                        const VkDescriptorImageInfo* imageInfo,
+                                        const VkDescriptorBufferInfo* bufferInfo)
+    {
+        ASSERT(mDescriptorBufferOffset != DescriptorBufferHeap::cInvalidOffset);
+        Device* device = checked_cast<Device>(mDevice);
+        BindSetLayout* layout = checked_cast<BindSetLayout>(GetLayout());
+
+        uint8_t* dst = device->GetDescriptorBufferHeap()->GetMappedPointer() + mDescriptorBufferOffset +
+                layout->GetDescriptorBufferOffset(binding, arrayElementIndex);
+        WriteDescriptorToBuffer(device, layout->GetBindingType(binding), imageInfo, bufferInfo, dst);
+    }
+
+    bool BindSet::WriteWithTemplate(BindSetLayout* layout, const BindSetDesc& desc)
+    {
+        // The template writes every descriptor of the layout, so it is only usable when the entries cover all of them.
+        const uint32_t descriptorCount = layout->GetUpdateTemplateDescriptorCount();
+        if (layout->GetUpdateTemplate() == VK_NULL_HANDLE || desc.entryCount != descriptorCount)
+        {
+            return false;
+        }
+
+        absl::InlinedVector<DescriptorUpdatePayload, cMaxOptimalBindingsPerGroup> payload(descriptorCount);
+        absl::InlinedVector<bool, cMaxOptimalBindingsPerGroup> written(descriptorCount, false);
+
+        for (uint32_t i = 0; i < desc.entryCount; ++i)
+        {
+            const BindSetEntry& entry = desc.entries[i];
+            const uint32_t index = layout->GetUpdateTemplatePayloadIndex(entry.binding, entry.arrayElementIndex);
+            if (index >= descriptorCount || written[index])
+            {
+                return false;
+            }
+            written[index] = true;
+
+            DescriptorUpdatePayload& descriptor = payload[index];
+            if (!FillDescriptorInfo(layout->GetBindingType(entry.binding), entry, &descriptor.image, &descriptor.buffer))
+            {
+                return false;
+            }
+        }
+
+        vkUpdateDescriptorSetWithTemplate(
+                checked_cast<Device>(mDevice)->GetHandle(), GetHandle(), layout->GetUpdateTemplate(), payload.data());
+        return true;
     }
 
     BindSet::~BindSet() {}
@@ -103,6 +253,11 @@ namespace rhi::impl::vulkan
         return mDescriptorSetAllocation.set;
     }
 
+    uint64_t BindSet::GetDescriptorBufferOffset() const
+    {
+        return mDescriptorBufferOffset;
+    }
+
     void BindSet::MarkUsedInQueue(QueueType queueType)
     {
         static_assert(static_cast<uint32_t>(QueueType::Graphics) == 0 &&
@@ -123,7 +278,19 @@ namespace rhi::impl::vulkan
 
     void BindSet::DestroyImpl()
     {
-        checked_cast<BindSetLayout>(GetLayout())->DeallocateBindSet(this, &mDescriptorSetAllocation);
+        BindSetBase::DestroyImpl();
+        BindSetLayout* layout = checked_cast<BindSetLayout>(GetLayout());
+        if (mDescriptorBufferOffset != DescriptorBufferHeap::cInvalidOffset)
+        {
+            checked_cast<Device>(mDevice)->GetDescriptorBufferHeap()->Free(mDescriptorBufferOffset,
+                                                                           layout->GetDescriptorBufferSize());
+            return;
+        }
+        // Transient sets go back to their pool when it is reset.
+        if (!mIsTransient)
+        {
+            layout->DeallocateBindSet(this, &mDescriptorSetAllocation);
+        }
     }
 
 } // namespace rhi::impl::vulkan
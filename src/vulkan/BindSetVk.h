@@ -8,23 +8,54 @@
 
 namespace rhi::impl::vulkan
 {
+    class BindSetLayout;
     class Device;
 
     class BindSet final : public BindSetBase
     {
     public:
         static Ref<BindSet> Create(Device* device, const BindSetDesc& desc);
-        explicit BindSet(Device* device, const BindSetDesc& desc, DescriptorSetAllocation descriptorSetAllocation);
+        // The descriptor set comes from the device's transient pools and is recycled with them.
+        static Ref<BindSet> CreateTransient(Device* device, const BindSetDesc& desc);
+        explicit BindSet(Device* device,
+                         const BindSetDesc& desc,
+                         DescriptorSetAllocation descriptorSetAllocation,
+                         bool isTransient = false);
+        // A bind set whose descriptors are written to a range of the device's descriptor buffer heap.
+        explicit BindSet(Device* device, const BindSetDesc& desc, uint64_t descriptorBufferOffset);
 
         VkDescriptorSet GetHandle() const;
+        uint64_t GetDescriptorBufferOffset() const;
+        // Writes one descriptor to the descriptor buffer range of the set.
+        void WriteDescriptorBuffer(uint32_t binding,
+                                   uint32_t arrayElementIndex,
+                                   const VkDescriptorImageInfo* imageInfo,
+                                   const VkDescriptorBufferInfo* bufferInfo);
         void MarkUsedInQueue(QueueType queueType);
         bool IsUsedInQueue(QueueType queueType);
 
     private:
         ~BindSet() override;
         void DestroyImpl() override;
+        bool WriteWithTemplate(BindSetLayout* layout, const BindSetDesc& desc);
 
         DescriptorSetAllocation mDescriptorSetAllocation;
-        std::array<bool, 2> mUsedInQueues;
+        std::array<bool, 2> mUsedInQueues = {};
+        bool mIsTransient;
+        uint64_t mDescriptorBufferOffset;
     };
+
+    // Fills the image or buffer info of an entry, returns false if the binding takes neither.
+    bool FillDescriptorInfo(BindingType bindingType,
+                            const BindSetEntry& entry,
+                            VkDescriptorImageInfo* imageInfo,
+                            VkDescriptorBufferInfo* bufferInfo);
+
+    // Writes the descriptor described by the image or buffer info to dst, which must hold
+    // Device::GetDescriptorSize(bindingType) bytes.
+    void WriteDescriptorToBuffer(Device* device,
+                                 BindingType bindingType,
+                                 const VkDescriptorImageInfo* imageInfo,
+                                 const VkDescriptorBufferInfo* bufferInfo,
+                                 void* dst);
 }
@@ -176,9 +176,10 @@ namespace rhi::impl::vulkan
 
     bool Buffer::Initialize()
     {
-        constexpr BufferUsage cMapWriteAllowedUsages = BufferUsage::CopySrc | BufferUsage::MapWrite;
+        constexpr BufferUsage cMapWriteAllowedUsages =
+                BufferUsage::CopySrc | BufferUsage::Uniform | BufferUsage::MapWrite;
         INVALID_IF(HasFlag(BufferUsage::MapWrite, mUsage) && !IsSubset(mUsage, cMapWriteAllowedUsages),
-                   "The BufferUsage::MapWrite flag can only compatible with BufferUsage::CopySrc.");
+                   "The BufferUsage::MapWrite flag can only compatible with BufferUsage::CopySrc and BufferUsage::Uniform.");
         constexpr BufferUsage cMapReadAllowedUsages = BufferUsage::CopyDst | BufferUsage::MapRead;
         INVALID_IF(HasFlag(BufferUsage::MapRead, mUsage) && !IsSubset(mUsage, cMapReadAllowedUsages),
                    "The BufferUsage::MapRead flag can only compatible with BufferUsage::CopyDst.");
@@ -194,6 +195,11 @@ namespace rhi::impl::vulkan
         bufferCI.size = toAllocatedSize;
         bufferCI.sharingMode = ShareModeConvert(mShareMode);
         bufferCI.usage = BufferUsageConvert(mInternalUsage | BufferUsage::CopyDst);
+        // Descriptor buffers reference shader buffers by address.
+        if (device->IsDescriptorBufferEnabled() && HasFlag(mInternalUsage, cShaderBufferUsages))
+        {
+            bufferCI.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        }
         if (mShareMode == ShareMode::Concurrent)
         {
             std::vector<uint32_t> queueFamiles;
@@ -484,6 +490,13 @@ namespace rhi::impl::vulkan
         return mAllocationInfo.pMappedData;
     }
 
+    void Buffer::InvalidateMappedRange(uint64_t offset, uint64_t size)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+        VkResult err = vmaInvalidateAllocation(device->GetMemoryAllocator(), mAllocation, offset, size);
+        CHECK_VK_RESULT(err, "vmaInvalidateAllocation");
+    }
+
     void Buffer::MapAsyncImpl(QueueBase* queue, MapMode mode)
     {
         CommandRecordContext* recordContext = checked_cast<Queue>(queue)->GetPendingRecordingContext();
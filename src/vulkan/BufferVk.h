@@ -19,6 +19,7 @@ namespace rhi::impl::vulkan
         static Ref<Buffer> Create(DeviceBase* device, const BufferDesc& desc, QueueType initialQueueOwner);
         // interface
         void* APIGetMappedPointer() override;
+        void InvalidateMappedRange(uint64_t offset, uint64_t size) override;
         // internal
         VkBuffer GetHandle() const;
         void TransitionOwnership(Queue* queue, Queue* receivingQueue);
@@ -1,7 +1,10 @@
 #include "CommandListVk.h"
 
 #include "common/Commands.h"
+#include "common/Constants.h"
 #include "common/PassResourceUsage.h"
+#include "common/RenderBundleBase.h"
+#include "BindSetLayoutVk.h"
 #include "BindSetVk.h"
 #include "BufferVk.h"
 #include "CommandRecordContextVk.h"
@@ -68,7 +71,184 @@ namespace rhi::impl::vulkan
         }
     }
 
-    void TransitionSyncScope(Queue* queue, const SyncScopeResourceUsage& scopeUsage)
+    void RecordSetBindSet(Device* device,
+                          VkCommandBuffer commandBuffer,
+                          VkPipelineBindPoint bindPoint,
+                          VkPipelineLayout pipelineLayout,
+                          uint32_t setIndex,
+                          BindSet* bindSet,
+                          uint32_t dynamicOffsetCount,
+                          const uint32_t* dynamicOffsets)
+    {
+        if (device->IsDescriptorBufferEnabled())
+        {
+            ASSERT(dynamicOffsetCount == 0);
+            const uint32_t bufferIndex = 0;
+            const VkDeviceSize offset = bindSet->GetDescriptorBufferOffset();
+            device->Fn.vkCmdSetDescriptorBufferOffsetsEXT(
+                    commandBuffer, bindPoint, pipelineLayout, setIndex, 1, &bufferIndex, &offset);
+            return;
+        }
+
+        VkDescriptorSet set = bindSet->GetHandle();
+        vkCmdBindDescriptorSets(
+                commandBuffer, bindPoint, pipelineLayout, setIndex, 1, &set, dynamicOffsetCount, dynamicOffsets);
+    }
+
+    BindSetEntry ToBindSetEntry(const PushBinding& binding)
+    {
+        BindSetEntry entry{};
+        entry.binding = binding.binding;
+        entry.arrayElementIndex = binding.arrayElementIndex;
+        entry.textureView = binding.textureView.Get();
+        entry.sampler = binding.sampler.Get();
+        entry.buffer = binding.buffer.Get();
+        entry.bufferOffset = binding.bufferOffset;
+        entry.bufferRange = binding.bufferRange;
+        return entry;
+    }
+
+    // The bindings are written to a range of the descriptor buffer heap that is freed right away, the heap only
+    // reuses it once the commands recorded so far have completed.
+    void RecordPushBindingsToDescriptorBuffer(Device* device,
+                                              VkCommandBuffer commandBuffer,
+                                              VkPipelineBindPoint bindPoint,
+                                              PipelineLayout* pipelineLayout,
+                                              const PushBindingsCmd* cmd,
+                                              const PushBinding* bindings)
+    {
+        BindSetLayout* layout = checked_cast<BindSetLayout>(cmd->layout.Get());
+        DescriptorBufferHeap* heap = device->GetDescriptorBufferHeap();
+
+        const uint64_t size = layout->GetDescriptorBufferSize();
+        const uint64_t offset = heap->Allocate(size);
+        if (offset == DescriptorBufferHeap::cInvalidOffset)
+        {
+            LOG_ERROR("The descriptor buffer heap is full.");
+            return;
+        }
+
+        for (uint32_t i = 0; i < cmd->entryCount; ++i)
+        {
+            const BindSetEntry entry = ToBindSetEntry(bindings[i]);
+            const BindingType bindingType = layout->GetBindingType(entry.binding);
+            VkDescriptorImageInfo imageInfo{};
+            VkDescriptorBufferInfo bufferInfo{};
+            FillDescriptorInfo(bindingType, entry, &imageInfo, &bufferInfo);
+            WriteDescriptorToBuffer(device,
+                                    bindingType,
+                                    &imageInfo,
+                                    &bufferInfo,
+                                    heap->GetMappedPointer() + offset +
+                                            layout->GetDescriptorBufferOffset(entry.binding, entry.arrayElementIndex));
+        }
+
+        const uint32_t bufferIndex = 0;
+        const VkDeviceSize bufferOffset = offset;
+        device->Fn.vkCmdSetDescriptorBufferOffsetsEXT(
+                commandBuffer, bindPoint, pipelineLayout->GetHandle(), cmd->setIndex, 1, &bufferIndex, &bufferOffset);
+        heap->Free(offset, size);
+    }
+
+    void RecordPushBindings(Device* device,
+                            VkCommandBuffer commandBuffer,
+                            VkPipelineBindPoint bindPoint,
+                            PipelineLayout* pipelineLayout,
+                            const PushBindingsCmd* cmd,
+                            const PushBinding* bindings)
+    {
+        if (device->IsDescriptorBufferEnabled())
+        {
+            RecordPushBindingsToDescriptorBuffer(device, commandBuffer, bindPoint, pipelineLayout, cmd, bindings);
+            return;
+        }
+
+        BindSetLayout* layout = checked_cast<BindSetLayout>(cmd->layout.Get());
+
+        // Without VK_KHR_push_descriptor the bindings are written to a set of the transient pools instead.
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        if (!device->IsPushDescriptorSupported())
+        {
+            set = device->GetTransientDescriptorAllocator()->Allocate(layout);
+            if (set == VK_NULL_HANDLE)
+            {
+                return;
+            }
+        }
+
+        std::array<VkWriteDescriptorSet, cMaxPushDescriptors> writes;
+        std::array<VkDescriptorImageInfo, cMaxPushDescriptors> imageInfos;
+        std::array<VkDescriptorBufferInfo, cMaxPushDescriptors> bufferInfos;
+        ASSERT(cmd->entryCount <= cMaxPushDescriptors);
+
+        for (uint32_t i = 0; i < cmd->entryCount; ++i)
+        {
+            const PushBinding& binding = bindings[i];
+            const BindSetEntry entry = ToBindSetEntry(binding);
+
+            BindingType bindingType = layout->GetBindingType(binding.binding);
+
+            VkWriteDescriptorSet& write = writes[i];
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.pNext = nullptr;
+            write.dstSet = set;
+            write.dstBinding = binding.binding;
+            write.dstArrayElement = binding.arrayElementIndex;
+            write.descriptorCount = 1;
+            write.descriptorType = ToVkDescriptorType(bindingType, false);
+            write.pImageInfo = nullptr;
+            write.pBufferInfo = nullptr;
+            write.pTexelBufferView = nullptr;
+            FillDescriptorInfo(bindingType, entry, &imageInfos[i], &bufferInfos[i]);
+            if (bindingType == BindingType::StorageBuffer || bindingType == BindingType::UniformBuffer)
+            {
+                write.pBufferInfo = &bufferInfos[i];
+            }
+            else
+            {
+                write.pImageInfo = &imageInfos[i];
+            }
+        }
+
+        if (device->IsPushDescriptorSupported())
+        {
+            device->Fn.vkCmdPushDescriptorSetKHR(
+                    commandBuffer, bindPoint, pipelineLayout->GetHandle(), cmd->setIndex, cmd->entryCount, writes.data());
+        }
+        else
+        {
+            vkUpdateDescriptorSets(device->GetHandle(), cmd->entryCount, writes.data(), 0, nullptr);
+            vkCmdBindDescriptorSets(
+                    commandBuffer, bindPoint, pipelineLayout->GetHandle(), cmd->setIndex, 1, &set, 0, nullptr);
+        }
+    }
+
+    void RecordSetStencilOps(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, const StencilOpState& state)
+    {
+        vkCmdSetStencilOp(commandBuffer,
+                          faceMask,
+                          StencilOpConvert(state.failOp),
+                          StencilOpConvert(state.passOp),
+                          StencilOpConvert(state.depthFailOp),
+                          CompareOpConvert(state.compareOp));
+    }
+
+    void RecordExtendedDynamicState(VkCommandBuffer commandBuffer,
+                                    const RasterState& raster,
+                                    const DepthStencilState& depthStencil)
+    {
+        vkCmdSetPrimitiveTopology(commandBuffer, PrimitiveTopologyConvert(raster.primitiveType));
+        vkCmdSetCullMode(commandBuffer, CullModeConvert(raster.cullMode));
+        vkCmdSetFrontFace(commandBuffer, FrontFaceConvert(raster.frontFace));
+        vkCmdSetDepthTestEnable(commandBuffer, depthStencil.depthTestEnable);
+        vkCmdSetDepthWriteEnable(commandBuffer, depthStencil.depthWriteEnable);
+        vkCmdSetDepthCompareOp(commandBuffer, CompareOpConvert(depthStencil.depthCompareOp));
+        vkCmdSetStencilTestEnable(commandBuffer, depthStencil.stencilTestEnable);
+        RecordSetStencilOps(commandBuffer, VK_STENCIL_FACE_FRONT_BIT, depthStencil.frontFaceStencil);
+        RecordSetStencilOps(commandBuffer, VK_STENCIL_FACE_BACK_BIT, depthStencil.backFaceStencil);
+    }
+
+    void TrackSyncScope(Queue* queue, const SyncScopeResourceUsage& scopeUsage)
     {
         for (uint32_t i = 0; i < scopeUsage.buffers.size(); ++i)
         {
@@ -82,16 +262,75 @@ namespace rhi::impl::vulkan
             auto texture = checked_cast<Texture>(scopeUsage.textures[i]);
             texture->TransitionUsageForMultiRange(queue, scopeUsage.textureSyncInfos[i]);
         }
+    }
 
-        queue->GetPendingRecordingContext()->EmitBarriers();
+    void TrackCopyUsage(Queue* queue, const CopyBufferToBufferCmd* cmd)
+    {
+        checked_cast<Buffer>(cmd->srcBuffer.Get())->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopySrc);
+        checked_cast<Buffer>(cmd->dstBuffer.Get())->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopyDst);
     }
 
-    void CommandList::RecordRenderPass(Queue* queue, BeginRenderPassCmd* renderPassCmd)
+    void TrackCopyUsage(Queue* queue, const CopyBufferToTextureCmd* cmd)
     {
-        Device* device = checked_cast<Device>(mDevice);
+        SubresourceRange range = {cmd->aspect, cmd->origin.z, cmd->size.depthOrArrayLayers, cmd->mipLevel, 1};
 
-        VkCommandBuffer commandBuffer = queue->GetPendingRecordingContext()->commandBufferAndPool.bufferHandle;
+        checked_cast<Buffer>(cmd->srcBuffer.Get())->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopySrc);
+        checked_cast<Texture>(cmd->dstTexture.Get())
+                ->TransitionUsageAndGetResourceBarrier(queue, TextureUsage::CopyDst, ShaderStage::None, range);
+    }
+
+    void TrackCopyUsage(Queue* queue, const CopyTextureToBufferCmd* cmd)
+    {
+        SubresourceRange range = {cmd->aspect, cmd->origin.z, cmd->size.depthOrArrayLayers, cmd->mipLevel, 1};
 
+        checked_cast<Texture>(cmd->srcTexture.Get())
+                ->TransitionUsageAndGetResourceBarrier(queue, TextureUsage::CopySrc, ShaderStage::None, range);
+        checked_cast<Buffer>(cmd->dstBuffer.Get())->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopyDst);
+    }
+
+    Extent3D GetCopySize(const CopyTextureToTextureCmd* cmd)
+    {
+        return {(std::min)(cmd->srcSize.width, cmd->dstSize.width),
+                (std::min)(cmd->srcSize.height, cmd->dstSize.height),
+                (std::min)(cmd->srcSize.depthOrArrayLayers, cmd->dstSize.depthOrArrayLayers)};
+    }
+
+    void TrackCopyUsage(Queue* queue, const CopyTextureToTextureCmd* cmd)
+    {
+        Extent3D size = GetCopySize(cmd);
+        SubresourceRange srcRange = {cmd->srcAspect, cmd->srcOrigin.z, size.depthOrArrayLayers, cmd->srcMipLevel, 1};
+        SubresourceRange dstRange = {cmd->dstAspect, cmd->dstOrigin.z, size.depthOrArrayLayers, cmd->dstMipLevel, 1};
+
+        checked_cast<Texture>(cmd->srcTexture.Get())
+                ->TransitionUsageAndGetResourceBarrier(queue, TextureUsage::CopySrc, ShaderStage::None, srcRange);
+        checked_cast<Texture>(cmd->dstTexture.Get())
+                ->TransitionUsageAndGetResourceBarrier(queue, TextureUsage::CopyDst, ShaderStage::None, dstRange);
+    }
+
+    bool IsEmptyCopy(const Extent3D& size)
+    {
+        return size.width == 0 || size.height == 0 || size.depthOrArrayLayers == 0;
+    }
+
+    template <typename TrackUsage>
+    void CommandList::TrackAndEmitBarriers(Queue* queue, VkCommandBuffer commandBuffer, TrackUsage&& trackUsage)
+    {
+        if (!mUsePreparedBarriers)
+        {
+            CommandRecordContext* recordContext = queue->GetPendingRecordingContext();
+            ASSERT(recordContext->commandBufferAndPool.bufferHandle == commandBuffer);
+            trackUsage();
+            recordContext->EmitBarriers();
+            return;
+        }
+
+        ASSERT(mNextPreparedBarrier < mPreparedBarriers.size());
+        const BarrierBatch& batch = mPreparedBarriers[mNextPreparedBarrier++];
+        RecordBarriers(commandBuffer, batch.imageMemoryBarriers, batch.bufferMemoryBarriers);
+    }
+
+    void CommandList::RecordRenderPass(Queue* queue, VkCommandBuffer commandBuffer, BeginRenderPassCmd* renderPassCmd)
+    {
         VkRenderingInfo renderingInfo{};
         renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
 
@@ -203,46 +442,105 @@ namespace rhi::impl::vulkan
         scissorRect.extent.height = renderHeight;
         vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
 
+        // Recorded with the first pipeline using it.
+        mExtendedDynamicState = {};
+
+        RecordRenderCommands(queue, commandBuffer, &mCommandIter);
+    }
+
+    void CommandList::RecordRenderCommands(Queue* queue, VkCommandBuffer commandBuffer, CommandIterator* commands)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+
         RenderPipeline* lastPipeline = nullptr;
         Command type;
-        while (mCommandIter.NextCommandId(&type))
+        while (commands->NextCommandId(&type))
         {
             switch (type)
             {
             case Command::SetRenderPipeline:
                 {
-                    SetRenderPipelineCmd* cmd = mCommandIter.NextCommand<SetRenderPipelineCmd>();
+                    SetRenderPipelineCmd* cmd = commands->NextCommand<SetRenderPipelineCmd>();
                     RenderPipeline* pipeline = checked_cast<RenderPipeline>(cmd->pipeline.Get());
                     lastPipeline = pipeline;
                     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetHandle());
+                    if (!pipeline->HasExtendedDynamicState())
+                    {
+                        mExtendedDynamicState.recorded = false;
+                        break;
+                    }
+
+                    // Until the encoder sets one of its topology class, the pipeline's topology is used.
+                    PrimitiveType& primitiveType = mExtendedDynamicState.raster.primitiveType;
+                    const bool primitiveTypeChanged =
+                            !mExtendedDynamicState.primitiveTypeSet ||
+                            GetTopologyClass(primitiveType) != pipeline->GetPrimitiveType();
+                    if (primitiveTypeChanged)
+                    {
+                        primitiveType = pipeline->GetPrimitiveType();
+                        mExtendedDynamicState.primitiveTypeSet = true;
+                    }
+
+                    if (!mExtendedDynamicState.recorded)
+                    {
+                        RecordExtendedDynamicState(
+                                commandBuffer, mExtendedDynamicState.raster, mExtendedDynamicState.depthStencil);
+                        mExtendedDynamicState.recorded = true;
+                    }
+                    else if (primitiveTypeChanged)
+                    {
+                        vkCmdSetPrimitiveTopology(commandBuffer, PrimitiveTopologyConvert(primitiveType));
+                    }
                     break;
                 }
             case Command::SetBindSet:
                 {
-                    SetBindSetCmd* cmd = mCommandIter.NextCommand<SetBindSetCmd>();
+                    SetBindSetCmd* cmd = commands->NextCommand<SetBindSetCmd>();
                     BindSet* bindSet = checked_cast<BindSet>(cmd->set.Get());
-                    bindSet->MarkUsedInQueue(queue->GetType());
-                    VkDescriptorSet set = bindSet->GetHandle();
+                    if (!mUsePreparedBarriers)
+                    {
+                        bindSet->MarkUsedInQueue(queue->GetType());
+                    }
                     uint32_t* dynamicOffsets = nullptr;
                     if (cmd->dynamicOffsetCount > 0)
                     {
-                        dynamicOffsets = mCommandIter.NextData<uint32_t>(cmd->dynamicOffsetCount);
+                        dynamicOffsets = commands->NextData<uint32_t>(cmd->dynamicOffsetCount);
                     }
                     ASSERT(lastPipeline != nullptr);
                     VkPipelineLayout layout = checked_cast<PipelineLayout>(lastPipeline->GetLayout())->GetHandle();
-                    vkCmdBindDescriptorSets(commandBuffer,
-                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                            layout,
-                                            cmd->setIndex,
-                                            1,
-                                            &set,
-                                            cmd->dynamicOffsetCount,
-                                            dynamicOffsets);
+                    RecordSetBindSet(device,
+                                     commandBuffer,
+                                     VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                     layout,
+                                     cmd->setIndex,
+                                     bindSet,
+                                     cmd->dynamicOffsetCount,
+                                     dynamicOffsets);
+                    break;
+                }
+            case Command::PushBindings:
+                {
+                    PushBindingsCmd* cmd = commands->NextCommand<PushBindingsCmd>();
+                    PushBinding* bindings = commands->NextData<PushBinding>(cmd->entryCount);
+                    ASSERT(lastPipeline != nullptr);
+                    RecordPushBindings(device,
+                                       commandBuffer,
+                                       VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                       checked_cast<PipelineLayout>(lastPipeline->GetLayout()),
+                                       cmd,
+                                       bindings);
+                    break;
+                }
+            case Command::UseResidentResources:
+                {
+                    // The usages were merged into the sync scope of the pass.
+                    UseResidentResourcesCmd* cmd = commands->NextCommand<UseResidentResourcesCmd>();
+                    commands->NextData<Ref<ResourceBase>>(cmd->resourceCount);
                     break;
                 }
             case Command::SetIndexBuffer:
                 {
-                    SetIndexBufferCmd* cmd = mCommandIter.NextCommand<SetIndexBufferCmd>();
+                    SetIndexBufferCmd* cmd = commands->NextCommand<SetIndexBufferCmd>();
                     Buffer* indexBuffer = checked_cast<Buffer>(cmd->buffer.Get());
                     vkCmdBindIndexBuffer(
                             commandBuffer, indexBuffer->GetHandle(), cmd->offset, VulkanIndexType(cmd->format));
@@ -250,7 +548,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::SetVertexBuffer:
                 {
-                    SetVertexBufferCmd* cmd = mCommandIter.NextCommand<SetVertexBufferCmd>();
+                    SetVertexBufferCmd* cmd = commands->NextCommand<SetVertexBufferCmd>();
                     std::array<VkBuffer, cMaxVertexBuffers> buffers;
                     std::array<VkDeviceSize, cMaxVertexBuffers> offsets;
                     for (uint32_t i = 0; i < cmd->bufferCount; ++i)
@@ -264,14 +562,14 @@ namespace rhi::impl::vulkan
                 }
             case Command::Draw:
                 {
-                    DrawCmd* cmd = mCommandIter.NextCommand<DrawCmd>();
+                    DrawCmd* cmd = commands->NextCommand<DrawCmd>();
                     vkCmdDraw(
                             commandBuffer, cmd->vertexCount, cmd->instanceCount, cmd->firstVertex, cmd->firstInstance);
                     break;
                 }
             case Command::DrawIndexed:
                 {
-                    DrawIndexedCmd* cmd = mCommandIter.NextCommand<DrawIndexedCmd>();
+                    DrawIndexedCmd* cmd = commands->NextCommand<DrawIndexedCmd>();
                     vkCmdDrawIndexed(commandBuffer,
                                      cmd->indexCount,
                                      cmd->instanceCount,
@@ -282,7 +580,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::DrawIndirect:
                 {
-                    DrawIndirectCmd* cmd = mCommandIter.NextCommand<DrawIndirectCmd>();
+                    DrawIndirectCmd* cmd = commands->NextCommand<DrawIndirectCmd>();
                     Buffer* buffer = checked_cast<Buffer>(cmd->indirectBuffer.Get());
                     vkCmdDrawIndirect(
                             commandBuffer, buffer->GetHandle(), static_cast<VkDeviceSize>(cmd->indirectOffset), 1, 0);
@@ -290,7 +588,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::DrawIndexedIndirect:
                 {
-                    DrawIndexedIndirectCmd* cmd = mCommandIter.NextCommand<DrawIndexedIndirectCmd>();
+                    DrawIndexedIndirectCmd* cmd = commands->NextCommand<DrawIndexedIndirectCmd>();
                     Buffer* buffer = checked_cast<Buffer>(cmd->indirectBuffer.Get());
                     vkCmdDrawIndexedIndirect(
                             commandBuffer, buffer->GetHandle(), static_cast<VkDeviceSize>(cmd->indirectOffset), 1, 0);
@@ -298,7 +596,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::MultiDrawIndirect:
                 {
-                    MultiDrawIndirectCmd* cmd = mCommandIter.NextCommand<MultiDrawIndirectCmd>();
+                    MultiDrawIndirectCmd* cmd = commands->NextCommand<MultiDrawIndirectCmd>();
                     Buffer* indirectBuffer = checked_cast<Buffer>(cmd->indirectBuffer.Get());
                     // Count buffer is optional
                     Buffer* countBuffer = checked_cast<Buffer>(cmd->drawCountBuffer.Get());
@@ -324,7 +622,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::MultiDrawIndexedIndirect:
                 {
-                    MultiDrawIndexedIndirectCmd* cmd = mCommandIter.NextCommand<MultiDrawIndexedIndirectCmd>();
+                    MultiDrawIndexedIndirectCmd* cmd = commands->NextCommand<MultiDrawIndexedIndirectCmd>();
                     Buffer* indirectBuffer = checked_cast<Buffer>(cmd->indirectBuffer.Get());
 
                     // Count buffer is optional
@@ -351,8 +649,8 @@ namespace rhi::impl::vulkan
                 }
             case Command::SetPushConstant:
                 {
-                    SetPushConstantCmd* cmd = mCommandIter.NextCommand<SetPushConstantCmd>();
-                    void* data = mCommandIter.NextData<uint32_t>(cmd->size);
+                    SetPushConstantCmd* cmd = commands->NextCommand<SetPushConstantCmd>();
+                    void* data = commands->NextData<uint8_t>(cmd->size);
                     PipelineLayout* pipelineLayout = checked_cast<PipelineLayout>(lastPipeline->GetLayout());
 
                     vkCmdPushConstants(commandBuffer,
@@ -365,13 +663,27 @@ namespace rhi::impl::vulkan
                 }
             case Command::EndRenderPass:
                 {
-                    EndRenderPassCmd* cmd = mCommandIter.NextCommand<EndRenderPassCmd>();
+                    EndRenderPassCmd* cmd = commands->NextCommand<EndRenderPassCmd>();
                     vkCmdEndRendering(commandBuffer);
                     return; // to void mCommandIter.reset()
                 }
+            case Command::ExecuteBundles:
+                {
+                    ExecuteBundlesCmd* cmd = commands->NextCommand<ExecuteBundlesCmd>();
+                    Ref<RenderBundleBase>* bundles = commands->NextData<Ref<RenderBundleBase>>(cmd->count);
+                    for (uint32_t i = 0; i < cmd->count; ++i)
+                    {
+                        // The bundle stream has no EndRenderPass, it is replayed until its end which also rewinds it.
+                        auto lock = bundles[i]->LockCommands();
+                        RecordRenderCommands(queue, commandBuffer, bundles[i]->GetCommands());
+                    }
+                    // The bundles leave no state bound for the following commands.
+                    lastPipeline = nullptr;
+                    break;
+                }
             case Command::SetViewport:
                 {
-                    SetViewportCmd* cmd = mCommandIter.NextCommand<SetViewportCmd>();
+                    SetViewportCmd* cmd = commands->NextCommand<SetViewportCmd>();
                     std::array<VkViewport, cMaxViewports> viewports;
                     for (uint32_t i = 0; i < cmd->viewportCount; ++i)
                     {
@@ -389,7 +701,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::SetScissorRects:
                 {
-                    SetScissorRectsCmd* cmd = mCommandIter.NextCommand<SetScissorRectsCmd>();
+                    SetScissorRectsCmd* cmd = commands->NextCommand<SetScissorRectsCmd>();
                     std::array<VkRect2D, cMaxViewports> scissorRect;
                     for (uint32_t i = 0; i < cmd->scissorCount; ++i)
                     {
@@ -405,13 +717,13 @@ namespace rhi::impl::vulkan
                 }
             case Command::SetStencilReference:
                 {
-                    SetStencilReferenceCmd* cmd = mCommandIter.NextCommand<SetStencilReferenceCmd>();
+                    SetStencilReferenceCmd* cmd = commands->NextCommand<SetStencilReferenceCmd>();
                     vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FRONT_AND_BACK, cmd->reference);
                     break;
                 }
             case Command::SetBlendConstant:
                 {
-                    SetBlendConstantCmd* cmd = mCommandIter.NextCommand<SetBlendConstantCmd>();
+                    SetBlendConstantCmd* cmd = commands->NextCommand<SetBlendConstantCmd>();
                     const std::array<float, 4> blendConstants = {
                             cmd->color.r,
                             cmd->color.g,
@@ -422,11 +734,74 @@ namespace rhi::impl::vulkan
                     vkCmdSetBlendConstants(commandBuffer, blendConstants.data());
                     break;
                 }
+            // Extended dynamic state is only recorded while a pipeline using it is bound, otherwise it is recorded
+            // when the next one is bound.
+            case Command::SetCullMode:
+                {
+                    SetCullModeCmd* cmd = commands->NextCommand<SetCullModeCmd>();
+                    mExtendedDynamicState.raster.cullMode = cmd->cullMode;
+                    if (mExtendedDynamicState.recorded)
+                    {
+                        vkCmdSetCullMode(commandBuffer, CullModeConvert(cmd->cullMode));
+                    }
+                    break;
+                }
+            case Command::SetFrontFace:
+                {
+                    SetFrontFaceCmd* cmd = commands->NextCommand<SetFrontFaceCmd>();
+                    mExtendedDynamicState.raster.frontFace = cmd->frontFace;
+                    if (mExtendedDynamicState.recorded)
+                    {
+                        vkCmdSetFrontFace(commandBuffer, FrontFaceConvert(cmd->frontFace));
+                    }
+                    break;
+                }
+            case Command::SetPrimitiveType:
+                {
+                    SetPrimitiveTypeCmd* cmd = commands->NextCommand<SetPrimitiveTypeCmd>();
+                    mExtendedDynamicState.raster.primitiveType = cmd->primitiveType;
+                    mExtendedDynamicState.primitiveTypeSet = true;
+                    if (mExtendedDynamicState.recorded)
+                    {
+                        vkCmdSetPrimitiveTopology(commandBuffer, PrimitiveTopologyConvert(cmd->primitiveType));
+                    }
+                    break;
+                }
+            case Command::SetDepthState:
+                {
+                    SetDepthStateCmd* cmd = commands->NextCommand<SetDepthStateCmd>();
+                    DepthStencilState& depthStencil = mExtendedDynamicState.depthStencil;
+                    depthStencil.depthTestEnable = cmd->depthTestEnable;
+                    depthStencil.depthWriteEnable = cmd->depthWriteEnable;
+                    depthStencil.depthCompareOp = cmd->depthCompareOp;
+                    if (mExtendedDynamicState.recorded)
+                    {
+                        vkCmdSetDepthTestEnable(commandBuffer, cmd->depthTestEnable);
+                        vkCmdSetDepthWriteEnable(commandBuffer, cmd->depthWriteEnable);
+                        vkCmdSetDepthCompareOp(commandBuffer, CompareOpConvert(cmd->depthCompareOp));
+                    }
+                    break;
+                }
+            case Command::SetStencilState:
+                {
+                    SetStencilStateCmd* cmd = commands->NextCommand<SetStencilStateCmd>();
+                    DepthStencilState& depthStencil = mExtendedDynamicState.depthStencil;
+                    depthStencil.stencilTestEnable = cmd->stencilTestEnable;
+                    depthStencil.frontFaceStencil = cmd->front;
+                    depthStencil.backFaceStencil = cmd->back;
+                    if (mExtendedDynamicState.recorded)
+                    {
+                        vkCmdSetStencilTestEnable(commandBuffer, cmd->stencilTestEnable);
+                        RecordSetStencilOps(commandBuffer, VK_STENCIL_FACE_FRONT_BIT, cmd->front);
+                        RecordSetStencilOps(commandBuffer, VK_STENCIL_FACE_BACK_BIT, cmd->back);
+                    }
+                    break;
+                }
 
             case Command::BeginDebugLabel:
                 {
-                    BeginDebugLabelCmd* cmd = mCommandIter.NextCommand<BeginDebugLabelCmd>();
-                    const char* label = mCommandIter.NextData<char>(cmd->labelLength);
+                    BeginDebugLabelCmd* cmd = commands->NextCommand<BeginDebugLabelCmd>();
+                    const char* label = commands->NextData<char>(cmd->labelLength);
                     if (mDevice->IsDebugLayerEnabled())
                     {
                         VkDebugUtilsLabelEXT utilsLabel;
@@ -444,7 +819,7 @@ namespace rhi::impl::vulkan
                 }
             case Command::EndDebugLabel:
                 {
-                    EndDebugLabelCmd* cmd = mCommandIter.NextCommand<EndDebugLabelCmd>();
+                    EndDebugLabelCmd* cmd = commands->NextCommand<EndDebugLabelCmd>();
                     if (mDevice->IsDebugLayerEnabled())
                     {
                         device->Fn.vkCmdEndDebugUtilsLabelEXT(commandBuffer);
@@ -459,11 +834,12 @@ namespace rhi::impl::vulkan
         }
     }
 
-    void CommandList::RecordComputePass(Queue* queue, BeginComputePassCmd* computePassCmd)
+    void CommandList::RecordComputePass(Queue* queue,
+                                        VkCommandBuffer commandBuffer,
+                                        BeginComputePassCmd* computePassCmd)
     {
         Device* device = checked_cast<Device>(mDevice);
 
-        VkCommandBuffer commandBuffer = queue->GetPendingRecordingContext()->commandBufferAndPool.bufferHandle;
         ComputePipeline* lastPipeline = nullptr;
         Command type;
         while (mCommandIter.NextCommandId(&type))
@@ -482,8 +858,10 @@ namespace rhi::impl::vulkan
                 {
                     SetBindSetCmd* cmd = mCommandIter.NextCommand<SetBindSetCmd>();
                     BindSet* bindSet = checked_cast<BindSet>(cmd->set.Get());
-                    bindSet->MarkUsedInQueue(queue->GetType());
-                    VkDescriptorSet set = bindSet->GetHandle();
+                    if (!mUsePreparedBarriers)
+                    {
+                        bindSet->MarkUsedInQueue(queue->GetType());
+                    }
                     uint32_t* dynamicOffsets = nullptr;
                     if (cmd->dynamicOffsetCount > 0)
                     {
@@ -491,14 +869,34 @@ namespace rhi::impl::vulkan
                     }
                     ASSERT(lastPipeline != nullptr);
                     VkPipelineLayout layout = checked_cast<PipelineLayout>(lastPipeline->GetLayout())->GetHandle();
-                    vkCmdBindDescriptorSets(commandBuffer,
-                                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                            layout,
-                                            cmd->setIndex,
-                                            1,
-                                            &set,
-                                            cmd->dynamicOffsetCount,
-                                            dynamicOffsets);
+                    RecordSetBindSet(device,
+                                     commandBuffer,
+                                     VK_PIPELINE_BIND_POINT_COMPUTE,
+                                     layout,
+                                     cmd->setIndex,
+                                     bindSet,
+                                     cmd->dynamicOffsetCount,
+                                     dynamicOffsets);
+                    break;
+                }
+            case Command::PushBindings:
+                {
+                    PushBindingsCmd* cmd = mCommandIter.NextCommand<PushBindingsCmd>();
+                    PushBinding* bindings = mCommandIter.NextData<PushBinding>(cmd->entryCount);
+                    ASSERT(lastPipeline != nullptr);
+                    RecordPushBindings(device,
+                                       commandBuffer,
+                                       VK_PIPELINE_BIND_POINT_COMPUTE,
+                                       checked_cast<PipelineLayout>(lastPipeline->GetLayout()),
+                                       cmd,
+                                       bindings);
+                    break;
+                }
+            case Command::UseResidentResources:
+                {
+                    // The usages were merged into the sync scope of the pass.
+                    UseResidentResourcesCmd* cmd = mCommandIter.NextCommand<UseResidentResourcesCmd>();
+                    mCommandIter.NextData<Ref<ResourceBase>>(cmd->resourceCount);
                     break;
                 }
             case Command::Dispatch:
@@ -517,7 +915,7 @@ namespace rhi::impl::vulkan
             case Command::SetPushConstant:
                 {
                     SetPushConstantCmd* cmd = mCommandIter.NextCommand<SetPushConstantCmd>();
-                    void* data = mCommandIter.NextData<uint32_t>(cmd->size);
+                    void* data = mCommandIter.NextData<uint8_t>(cmd->size);
                     PipelineLayout* pipelineLayout = checked_cast<PipelineLayout>(lastPipeline->GetLayout());
 
                     vkCmdPushConstants(commandBuffer,
@@ -531,7 +929,7 @@ namespace rhi::impl::vulkan
             case Command::EndComputePass:
                 {
                     mCommandIter.NextCommand<EndComputePassCmd>();
-                    break;
+                    return;
                 }
             case Command::BeginDebugLabel:
                 {
@@ -570,11 +968,239 @@ namespace rhi::impl::vulkan
 
     void CommandList::RecordCommands(Queue* queue)
     {
-        Device* device = checked_cast<Device>(mDevice);
+        mUsePreparedBarriers = false;
+        RecordCommandsImpl(queue, queue->GetPendingRecordingContext()->commandBufferAndPool.bufferHandle);
+    }
 
+    void CommandList::PrepareBarriers(Queue* queue)
+    {
         CommandRecordContext* recordContext = queue->GetPendingRecordingContext();
 
-        VkCommandBuffer commandBuffer = recordContext->commandBufferAndPool.bufferHandle;
+        mPreparedBarriers.clear();
+        mNextPreparedBarrier = 0;
+
+        uint32_t nextRenderPassIndex = 0;
+        uint32_t nextComputePassIndex = 0;
+
+        // Walks the commands the same way RecordCommandsImpl does, but only keeps what touches the resource
+        // state and skips everything else including the trailing data.
+        Command type;
+        while (mCommandIter.NextCommandId(&type))
+        {
+            switch (type)
+            {
+            case Command::BeginRenderPass:
+                {
+                    mCommandIter.NextCommand<BeginRenderPassCmd>();
+                    TrackSyncScope(queue, GetResourceUsages().renderPassUsages[nextRenderPassIndex]);
+                    mPreparedBarriers.push_back(recordContext->TakeBarriers());
+                    ++nextRenderPassIndex;
+                    break;
+                }
+            case Command::BeginComputePass:
+                {
+                    mCommandIter.NextCommand<BeginComputePassCmd>();
+                    TrackSyncScope(queue, GetResourceUsages().computePassUsages[nextComputePassIndex]);
+                    mPreparedBarriers.push_back(recordContext->TakeBarriers());
+                    ++nextComputePassIndex;
+                    break;
+                }
+            case Command::CopyBufferToBuffer:
+                {
+                    CopyBufferToBufferCmd* cmd = mCommandIter.NextCommand<CopyBufferToBufferCmd>();
+                    if (cmd->size == 0)
+                    {
+                        break;
+                    }
+                    TrackCopyUsage(queue, cmd);
+                    mPreparedBarriers.push_back(recordContext->TakeBarriers());
+                    break;
+                }
+            case Command::CopyBufferToTexture:
+                {
+                    CopyBufferToTextureCmd* cmd = mCommandIter.NextCommand<CopyBufferToTextureCmd>();
+                    if (IsEmptyCopy(cmd->size))
+                    {
+                        break;
+                    }
+                    TrackCopyUsage(queue, cmd);
+                    mPreparedBarriers.push_back(recordContext->TakeBarriers());
+                    break;
+                }
+            case Command::CopyTextureToBuffer:
+                {
+                    CopyTextureToBufferCmd* cmd = mCommandIter.NextCommand<CopyTextureToBufferCmd>();
+                    if (IsEmptyCopy(cmd->size))
+                    {
+                        break;
+                    }
+                    TrackCopyUsage(queue, cmd);
+                    mPreparedBarriers.push_back(recordContext->TakeBarriers());
+                    break;
+                }
+            case Command::CopyTextureToTexture:
+                {
+                    CopyTextureToTextureCmd* cmd = mCommandIter.NextCommand<CopyTextureToTextureCmd>();
+                    if (IsEmptyCopy(GetCopySize(cmd)))
+                    {
+                        break;
+                    }
+                    TrackCopyUsage(queue, cmd);
+                    mPreparedBarriers.push_back(recordContext->TakeBarriers());
+                    break;
+                }
+            case Command::SetBindSet:
+                {
+                    SetBindSetCmd* cmd = mCommandIter.NextCommand<SetBindSetCmd>();
+                    checked_cast<BindSet>(cmd->set.Get())->MarkUsedInQueue(queue->GetType());
+                    if (cmd->dynamicOffsetCount > 0)
+                    {
+                        mCommandIter.NextData<uint32_t>(cmd->dynamicOffsetCount);
+                    }
+                    break;
+                }
+            case Command::PushBindings:
+                {
+                    PushBindingsCmd* cmd = mCommandIter.NextCommand<PushBindingsCmd>();
+                    mCommandIter.NextData<PushBinding>(cmd->entryCount);
+                    break;
+                }
+            case Command::UseResidentResources:
+                {
+                    UseResidentResourcesCmd* cmd = mCommandIter.NextCommand<UseResidentResourcesCmd>();
+                    mCommandIter.NextData<Ref<ResourceBase>>(cmd->resourceCount);
+                    break;
+                }
+            case Command::ExecuteBundles:
+                {
+                    ExecuteBundlesCmd* cmd = mCommandIter.NextCommand<ExecuteBundlesCmd>();
+                    Ref<RenderBundleBase>* bundles = mCommandIter.NextData<Ref<RenderBundleBase>>(cmd->count);
+                    for (uint32_t i = 0; i < cmd->count; ++i)
+                    {
+                        for (BindSetBase* bindSet : bundles[i]->GetBindSets())
+                        {
+                            checked_cast<BindSet>(bindSet)->MarkUsedInQueue(queue->GetType());
+                        }
+                    }
+                    break;
+                }
+            case Command::SetPushConstant:
+                {
+                    SetPushConstantCmd* cmd = mCommandIter.NextCommand<SetPushConstantCmd>();
+                    mCommandIter.NextData<uint8_t>(cmd->size);
+                    break;
+                }
+            case Command::BeginDebugLabel:
+                {
+                    BeginDebugLabelCmd* cmd = mCommandIter.NextCommand<BeginDebugLabelCmd>();
+                    mCommandIter.NextData<char>(cmd->labelLength);
+                    break;
+                }
+            case Command::ClearBuffer:
+                mCommandIter.NextCommand<ClearBufferCmd>();
+                break;
+            case Command::Dispatch:
+                mCommandIter.NextCommand<DispatchCmd>();
+                break;
+            case Command::DispatchIndirect:
+                mCommandIter.NextCommand<DispatchIndirectCmd>();
+                break;
+            case Command::Draw:
+                mCommandIter.NextCommand<DrawCmd>();
+                break;
+            case Command::DrawIndexed:
+                mCommandIter.NextCommand<DrawIndexedCmd>();
+                break;
+            case Command::DrawIndirect:
+                mCommandIter.NextCommand<DrawIndirectCmd>();
+                break;
+            case Command::DrawIndexedIndirect:
+                mCommandIter.NextCommand<DrawIndexedIndirectCmd>();
+                break;
+            case Command::MultiDrawIndirect:
+                mCommandIter.NextCommand<MultiDrawIndirectCmd>();
+                break;
+            case Command::MultiDrawIndexedIndirect:
+                mCommandIter.NextCommand<MultiDrawIndexedIndirectCmd>();
+                break;
+            case Command::SetRenderPipeline:
+                mCommandIter.NextCommand<SetRenderPipelineCmd>();
+                break;
+            case Command::SetComputePipeline:
+                mCommandIter.NextCommand<SetComputePipelineCmd>();
+                break;
+            case Command::SetViewport:
+                mCommandIter.NextCommand<SetViewportCmd>();
+                break;
+            case Command::SetScissorRects:
+                mCommandIter.NextCommand<SetScissorRectsCmd>();
+                break;
+            case Command::SetIndexBuffer:
+                mCommandIter.NextCommand<SetIndexBufferCmd>();
+                break;
+            case Command::SetVertexBuffer:
+                mCommandIter.NextCommand<SetVertexBufferCmd>();
+                break;
+            case Command::SetStencilReference:
+                mCommandIter.NextCommand<SetStencilReferenceCmd>();
+                break;
+            case Command::SetBlendConstant:
+                mCommandIter.NextCommand<SetBlendConstantCmd>();
+                break;
+            case Command::SetCullMode:
+                mCommandIter.NextCommand<SetCullModeCmd>();
+                break;
+            case Command::SetFrontFace:
+                mCommandIter.NextCommand<SetFrontFaceCmd>();
+                break;
+            case Command::SetPrimitiveType:
+                mCommandIter.NextCommand<SetPrimitiveTypeCmd>();
+                break;
+            case Command::SetDepthState:
+                mCommandIter.NextCommand<SetDepthStateCmd>();
+                break;
+            case Command::SetStencilState:
+                mCommandIter.NextCommand<SetStencilStateCmd>();
+                break;
+            case Command::EndRenderPass:
+                mCommandIter.NextCommand<EndRenderPassCmd>();
+                break;
+            case Command::EndComputePass:
+                mCommandIter.NextCommand<EndComputePassCmd>();
+                break;
+            case Command::EndDebugLabel:
+                mCommandIter.NextCommand<EndDebugLabelCmd>();
+                break;
+            case Command::MapBufferAsync:
+                mCommandIter.NextCommand<MapBufferAsyncCmd>();
+                break;
+            default:
+                ASSERT(!"Unreachable");
+                break;
+            }
+        }
+    }
+
+    void CommandList::RecordPreparedCommands(Queue* queue, VkCommandBuffer commandBuffer)
+    {
+        mUsePreparedBarriers = true;
+        RecordCommandsImpl(queue, commandBuffer);
+        ASSERT(mNextPreparedBarrier == mPreparedBarriers.size());
+
+        mUsePreparedBarriers = false;
+        mPreparedBarriers.clear();
+        mNextPreparedBarrier = 0;
+    }
+
+    void CommandList::RecordCommandsImpl(Queue* queue, VkCommandBuffer commandBuffer)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+
+        // The heap stays bound for the rest of the command buffer, bind sets only select their offset in it.
+        if (device->IsDescriptorBufferEnabled())
+        {
+            device->GetDescriptorBufferHeap()->BindToCommandBuffer(commandBuffer);
+        }
 
         uint32_t nextRenderPassIndex = 0;
         uint32_t nextComputePassIndex = 0;
@@ -601,15 +1227,28 @@ namespace rhi::impl::vulkan
             case Command::BeginRenderPass:
                 {
                     BeginRenderPassCmd* cmd = mCommandIter.NextCommand<BeginRenderPassCmd>();
-                    TransitionSyncScope(queue, GetResourceUsages().renderPassUsages[nextRenderPassIndex]);
-                    RecordRenderPass(queue, cmd);
+                    TrackAndEmitBarriers(queue,
+                                         commandBuffer,
+                                         [&]()
+                                         {
+                                             TrackSyncScope(queue,
+                                                            GetResourceUsages().renderPassUsages[nextRenderPassIndex]);
+                                         });
+                    RecordRenderPass(queue, commandBuffer, cmd);
                     ++nextRenderPassIndex;
                     break;
                 }
             case Command::BeginComputePass:
                 {
                     BeginComputePassCmd* cmd = mCommandIter.NextCommand<BeginComputePassCmd>();
-                    TransitionSyncScope(queue, GetResourceUsages().computePassUsages[nextComputePassIndex]);
+                    TrackAndEmitBarriers(queue,
+                                         commandBuffer,
+                                         [&]()
+                                         {
+                                             TrackSyncScope(queue,
+                                                            GetResourceUsages().computePassUsages[nextComputePassIndex]);
+                                         });
+                    RecordComputePass(queue, commandBuffer, cmd);
                     ++nextComputePassIndex;
                     break;
                 }
@@ -643,9 +1282,7 @@ namespace rhi::impl::vulkan
                     Buffer* src = checked_cast<Buffer>(cmd->srcBuffer.Get());
                     Buffer* dst = checked_cast<Buffer>(cmd->dstBuffer.Get());
 
-                    src->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopySrc);
-                    dst->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopyDst);
-                    recordContext->EmitBarriers();
+                    TrackAndEmitBarriers(queue, commandBuffer, [&]() { TrackCopyUsage(queue, cmd); });
 
                     VkBufferCopy region{};
                     region.srcOffset = cmd->srcOffset;
@@ -659,7 +1296,7 @@ namespace rhi::impl::vulkan
             case Command::CopyBufferToTexture:
                 {
                     CopyBufferToTextureCmd* cmd = mCommandIter.NextCommand<CopyBufferToTextureCmd>();
-                    if (cmd->size.width == 0 || cmd->size.height == 0 || cmd->size.depthOrArrayLayers == 0)
+                    if (IsEmptyCopy(cmd->size))
                     {
                         break;
                     }
@@ -670,13 +1307,7 @@ namespace rhi::impl::vulkan
                     VkBufferImageCopy region = ComputeBufferImageCopyRegion(
                             cmd->dataLayout, cmd->size, dstTexture, cmd->mipLevel, cmd->origin, cmd->aspect);
 
-                    SubresourceRange range = {
-                            cmd->aspect, cmd->origin.z, cmd->size.depthOrArrayLayers, cmd->mipLevel, 1};
-
-                    srcBuffer->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopySrc);
-                    dstTexture->TransitionUsageAndGetResourceBarrier(
-                            queue, TextureUsage::CopyDst, ShaderStage::None, range);
-                    recordContext->EmitBarriers();
+                    TrackAndEmitBarriers(queue, commandBuffer, [&]() { TrackCopyUsage(queue, cmd); });
 
                     vkCmdCopyBufferToImage(commandBuffer,
                                            srcBuffer->GetHandle(),
@@ -689,7 +1320,7 @@ namespace rhi::impl::vulkan
             case Command::CopyTextureToBuffer:
                 {
                     CopyTextureToBufferCmd* cmd = mCommandIter.NextCommand<CopyTextureToBufferCmd>();
-                    if (cmd->size.width == 0 || cmd->size.height == 0 || cmd->size.depthOrArrayLayers == 0)
+                    if (IsEmptyCopy(cmd->size))
                     {
                         break;
                     }
@@ -701,13 +1332,7 @@ namespace rhi::impl::vulkan
                     VkBufferImageCopy region = ComputeBufferImageCopyRegion(
                             cmd->dataLayout, cmd->size, srcTexture, cmd->mipLevel, cmd->origin, cmd->aspect);
 
-                    SubresourceRange range = {
-                            cmd->aspect, cmd->origin.z, cmd->size.depthOrArrayLayers, cmd->mipLevel, 1};
-
-                    srcTexture->TransitionUsageAndGetResourceBarrier(
-                            queue, TextureUsage::CopySrc, ShaderStage::None, range);
-                    dstBuffer->TrackUsageAndGetResourceBarrier(queue, BufferUsage::CopyDst);
-                    recordContext->EmitBarriers();
+                    TrackAndEmitBarriers(queue, commandBuffer, [&]() { TrackCopyUsage(queue, cmd); });
 
                     vkCmdCopyImageToBuffer(commandBuffer,
                                            srcTexture->GetHandle(),
@@ -722,11 +1347,8 @@ namespace rhi::impl::vulkan
                 {
                     CopyTextureToTextureCmd* cmd = mCommandIter.NextCommand<CopyTextureToTextureCmd>();
 
-                    Extent3D size = {(std::min)(cmd->srcSize.width, cmd->dstSize.width),
-                                     (std::min)(cmd->srcSize.height, cmd->dstSize.height),
-                                     (std::min)(cmd->srcSize.depthOrArrayLayers, cmd->dstSize.depthOrArrayLayers)};
-
-                    if (size.width == 0 || size.height == 0 || size.depthOrArrayLayers == 0)
+                    Extent3D size = GetCopySize(cmd);
+                    if (IsEmptyCopy(size))
                     {
                         break;
                     }
@@ -734,16 +1356,7 @@ namespace rhi::impl::vulkan
                     Texture* srcTexture = checked_cast<Texture>(cmd->srcTexture.Get());
                     Texture* dstTexture = checked_cast<Texture>(cmd->dstTexture.Get());
 
-                    SubresourceRange srcRange = {
-                            cmd->srcAspect, cmd->srcOrigin.z, size.depthOrArrayLayers, cmd->srcMipLevel, 1};
-                    SubresourceRange dstRange = {
-                            cmd->dstAspect, cmd->dstOrigin.z, size.depthOrArrayLayers, cmd->dstMipLevel, 1};
-
-                    srcTexture->TransitionUsageAndGetResourceBarrier(
-                            queue, TextureUsage::CopySrc, ShaderStage::None, srcRange);
-                    dstTexture->TransitionUsageAndGetResourceBarrier(
-                            queue, TextureUsage::CopyDst, ShaderStage::None, dstRange);
-                    recordContext->EmitBarriers();
+                    TrackAndEmitBarriers(queue, commandBuffer, [&]() { TrackCopyUsage(queue, cmd); });
 
                     VkImageCopy region{};
                     region.srcSubresource.aspectMask = ImageAspectFlagsConvert(cmd->srcAspect);
@@ -778,8 +1391,6 @@ namespace rhi::impl::vulkan
                                    &region);
                     break;
                 }
-            case Command::EndComputePass:
-                return;
             case Command::EndDebugLabel:
                 {
                     EndDebugLabelCmd* cmd = mCommandIter.NextCommand<EndDebugLabelCmd>();
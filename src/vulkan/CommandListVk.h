@@ -2,6 +2,10 @@
 
 #include "common/Ref.hpp"
 #include "common/CommandListBase.h"
+#include "common/RHIStruct.h"
+#include "CommandRecordContextVk.h"
+
+#include <vector>
 
 namespace rhi::impl
 {
@@ -11,7 +15,6 @@ namespace rhi::impl
 
 namespace rhi::impl::vulkan
 {
-    struct CommandRecordContext;
     class Queue;
     class Device;
 
@@ -20,10 +23,38 @@ namespace rhi::impl::vulkan
     public:
         static Ref<CommandList> Create(Device* device, CommandEncoder* encoder);
         void RecordCommands(Queue* queue);
+        // Parallel recording is split in two steps. PrepareBarriers does the resource state tracking and must be
+        // called for every command list in submission order. RecordPreparedCommands then only replays the computed
+        // barriers into its own command buffer and may run concurrently with other command lists.
+        void PrepareBarriers(Queue* queue);
+        void RecordPreparedCommands(Queue* queue, VkCommandBuffer commandBuffer);
 
     private:
         explicit CommandList(Device* device, CommandEncoder* encoder);
-        void RecordRenderPass(Queue* queue, BeginRenderPassCmd* renderPassCmd);
-        void RecordComputePass(Queue* queue, BeginComputePassCmd* computePassCmd);
+        void RecordCommandsImpl(Queue* queue, VkCommandBuffer commandBuffer);
+        void RecordRenderPass(Queue* queue, VkCommandBuffer commandBuffer, BeginRenderPassCmd* renderPassCmd);
+        // Records the draw commands of a render pass or of a render bundle, until EndRenderPass or the end of commands.
+        void RecordRenderCommands(Queue* queue, VkCommandBuffer commandBuffer, CommandIterator* commands);
+        void RecordComputePass(Queue* queue, VkCommandBuffer commandBuffer, BeginComputePassCmd* computePassCmd);
+        template <typename TrackUsage>
+        void TrackAndEmitBarriers(Queue* queue, VkCommandBuffer commandBuffer, TrackUsage&& trackUsage);
+
+        // Extended dynamic state of the render pass being recorded. Binding a pipeline that bakes these states leaves
+        // them undefined, so they are recorded again when a pipeline with extended dynamic state is bound after it.
+        struct ExtendedDynamicState
+        {
+            // Only the primitive type, cull mode and front face are used.
+            RasterState raster;
+            // Only the depth test, the stencil test and the stencil ops are used.
+            DepthStencilState depthStencil;
+            // False until the encoder or a pipeline sets the primitive type.
+            bool primitiveTypeSet = false;
+            bool recorded = false;
+        };
+        ExtendedDynamicState mExtendedDynamicState;
+
+        bool mUsePreparedBarriers = false;
+        std::vector<BarrierBatch> mPreparedBarriers;
+        size_t mNextPreparedBarrier = 0;
     };
 }
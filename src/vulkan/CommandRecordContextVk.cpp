@@ -14,27 +14,49 @@ namespace rhi::impl::vulkan
         mImageMemoryBarriers.push_back(barrier);
     }
 
-    void CommandRecordContext::EmitBarriers()
+    void RecordBarriers(VkCommandBuffer commandBuffer,
+                        const std::vector<VkImageMemoryBarrier2>& imageMemoryBarriers,
+                        const std::vector<VkBufferMemoryBarrier2>& bufferMemoryBarriers)
     {
+        if (imageMemoryBarriers.empty() && bufferMemoryBarriers.empty())
+        {
+            return;
+        }
+
         VkDependencyInfo dependencyInfo{};
         dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
         dependencyInfo.pNext = nullptr;
         dependencyInfo.dependencyFlags = 0;
-        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(mImageMemoryBarriers.size());
-        dependencyInfo.pImageMemoryBarriers = mImageMemoryBarriers.data();
-        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(mBufferMemoryBarriers.size());
-        dependencyInfo.pBufferMemoryBarriers = mBufferMemoryBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageMemoryBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = imageMemoryBarriers.data();
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferMemoryBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = bufferMemoryBarriers.data();
 
-        vkCmdPipelineBarrier2(commandBufferAndPool.bufferHandle, &dependencyInfo);
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    }
+
+    void CommandRecordContext::EmitBarriers()
+    {
+        RecordBarriers(commandBufferAndPool.bufferHandle, mImageMemoryBarriers, mBufferMemoryBarriers);
 
         mBufferMemoryBarriers.clear();
         mImageMemoryBarriers.clear();
     }
 
+    BarrierBatch CommandRecordContext::TakeBarriers()
+    {
+        BarrierBatch batch;
+        batch.imageMemoryBarriers.swap(mImageMemoryBarriers);
+        batch.bufferMemoryBarriers.swap(mBufferMemoryBarriers);
+        return batch;
+    }
+
     void CommandRecordContext::Reset()
     {
         commandBufferAndPool = CommandPoolAndBuffer();
+        recordedCommandBuffers.clear();
         needsSubmit = false;
+        needsHostReadBarrier = false;
         waitSemaphoreSubmitInfos.clear();
         signalSemaphoreSubmitInfos.clear();
         mBufferMemoryBarriers.clear();
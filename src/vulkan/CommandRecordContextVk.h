@@ -15,12 +15,26 @@ namespace rhi::impl::vulkan
         VkCommandPool poolHandle = VK_NULL_HANDLE;
     };
 
+    struct BarrierBatch
+    {
+        std::vector<VkImageMemoryBarrier2> imageMemoryBarriers;
+        std::vector<VkBufferMemoryBarrier2> bufferMemoryBarriers;
+    };
+
+    void RecordBarriers(VkCommandBuffer commandBuffer,
+                        const std::vector<VkImageMemoryBarrier2>& imageMemoryBarriers,
+                        const std::vector<VkBufferMemoryBarrier2>& bufferMemoryBarriers);
+
     struct CommandRecordContext
     {
     public:
         CommandPoolAndBuffer commandBufferAndPool;
+        // Command buffers that were already ended, submitted in order before commandBufferAndPool.
+        std::vector<CommandPoolAndBuffer> recordedCommandBuffers;
 
         bool needsSubmit = false;
+        // Set by readback copies, the transfer writes are made visible to the host at the end of the submit.
+        bool needsHostReadBarrier = false;
 
         std::vector<VkSemaphoreSubmitInfo> waitSemaphoreSubmitInfos;
         std::vector<VkSemaphoreSubmitInfo> signalSemaphoreSubmitInfos;
@@ -28,6 +42,8 @@ namespace rhi::impl::vulkan
         void AddBufferBarrier(const VkBufferMemoryBarrier2& barrier);
         void AddTextureBarrier(const VkImageMemoryBarrier2& barrier);
         void EmitBarriers();
+        // Hands the pending barriers over to the caller instead of recording them.
+        BarrierBatch TakeBarriers();
         void Reset();
     private:
         std::vector<VkImageMemoryBarrier2> mImageMemoryBarriers;
@@ -16,17 +16,22 @@ namespace rhi::impl::vulkan
 
     Ref<ComputePipeline> ComputePipeline::Create(Device* device, const ComputePipelineDesc& desc)
     {
-        Ref<ComputePipeline> pipeline = AcquireRef(new ComputePipeline(device, desc));
+        Ref<ComputePipeline> pipeline = CreateUninitialized(device, desc);
         if (!pipeline->Initialize(desc.cache))
         {
             return nullptr;
         }
-        pipeline->TrackResource();
         return pipeline;
     }
 
+    Ref<ComputePipeline> ComputePipeline::CreateUninitialized(Device* device, const ComputePipelineDesc& desc)
+    {
+        return AcquireRef(new ComputePipeline(device, desc));
+    }
+
     void ComputePipeline::DestroyImpl()
     {
+        ComputePipelineBase::DestroyImpl();
         Device* device = checked_cast<Device>(mDevice);
 
         if (mHandle != VK_NULL_HANDLE)
@@ -36,7 +41,7 @@ namespace rhi::impl::vulkan
         }
     }
 
-    bool ComputePipeline::Initialize(PipelineCacheBase* cache)
+    bool ComputePipeline::InitializeImpl(PipelineCacheBase* cache)
     {
         ASSERT(HasShaderStage(ShaderStage::Compute));
 
@@ -75,7 +80,11 @@ namespace rhi::impl::vulkan
         }
 
         Device* device = checked_cast<Device>(mDevice);
-        VkPipelineCache vkPipelineCache = cache != nullptr ? checked_cast<PipelineCache>(cache)->GetHandle() : nullptr;
+        if (device->IsDescriptorBufferEnabled())
+        {
+            createInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+        VkPipelineCache vkPipelineCache = device->GetPipelineCacheHandle(cache);
         VkResult err = vkCreateComputePipelines(device->GetHandle(), vkPipelineCache, 1, &createInfo, nullptr, &mHandle);
         CHECK_VK_RESULT_FALSE(err, "CreateComputePipelines");
 
@@ -11,12 +11,14 @@ namespace rhi::impl::vulkan
     {
     public:
         static Ref<ComputePipeline> Create(Device* device, const ComputePipelineDesc& desc);
+        // The pipeline still has to be compiled with Initialize.
+        static Ref<ComputePipeline> CreateUninitialized(Device* device, const ComputePipelineDesc& desc);
         VkPipeline GetHandle() const;
 
     private:
         explicit ComputePipeline(Device* device, const ComputePipelineDesc& desc);
         ~ComputePipeline() override;
-        bool Initialize(PipelineCacheBase* cache);
+        bool InitializeImpl(PipelineCacheBase* cache) override;
         void DestroyImpl() override;
 
         VkPipeline mHandle = VK_NULL_HANDLE;
@@ -0,0 +1,208 @@
+#include "DescriptorBufferHeap.h"
+
+#include "../common/Utils.h"
+#include "DeviceVk.h"
+#include "ErrorsVk.h"
+#include "QueueVk.h"
+#include "VulkanUtils.h"
+
+#include <algorithm>
+
+namespace rhi::impl::vulkan
+{
+    DescriptorBufferHeap::DescriptorBufferHeap(Device* device) : mDevice(device) {}
+
+    DescriptorBufferHeap::~DescriptorBufferHeap()
+    {
+        // The device waited for idle, no command reads the heap anymore.
+        if (mHandle != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(mDevice->GetMemoryAllocator(), mHandle, mAllocation);
+        }
+    }
+
+    bool DescriptorBufferHeap::Initialize()
+    {
+        const VkPhysicalDeviceDescriptorBufferPropertiesEXT& properties = mDevice->GetDescriptorBufferProperties();
+        mAlignment = std::max<uint64_t>(properties.descriptorBufferOffsetAlignment, 1);
+        // Sampler and resource descriptors share the buffer, so both of their address ranges must cover it.
+        mSize = std::min({cHeapSize,
+                          static_cast<uint64_t>(properties.maxSamplerDescriptorBufferRange),
+                          static_cast<uint64_t>(properties.maxResourceDescriptorBufferRange)});
+        mSize -= mSize % mAlignment;
+
+        // Every queue reads the descriptors, which are only ever written by the host.
+        std::vector<uint32_t> queueFamilies;
+        for (QueueType queueType : {QueueType::Graphics, QueueType::Compute, QueueType::Transfer})
+        {
+            Ref<QueueBase> queue = mDevice->GetQueue(queueType);
+            if (queue != nullptr)
+            {
+                queueFamilies.push_back(checked_cast<Queue>(queue.Get())->GetQueueFamilyIndex());
+            }
+        }
+
+        VkBufferCreateInfo bufferCI{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bufferCI.size = mSize;
+        bufferCI.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                         VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        bufferCI.sharingMode = queueFamilies.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        if (bufferCI.sharingMode == VK_SHARING_MODE_CONCURRENT)
+        {
+            bufferCI.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+            bufferCI.pQueueFamilyIndices = queueFamilies.data();
+        }
+
+        // Coherent memory spares flushing every descriptor write.
+        VmaAllocationCreateInfo allocCI{};
+        allocCI.usage = VMA_MEMORY_USAGE_AUTO;
+        allocCI.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        allocCI.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        VmaAllocationInfo allocationInfo{};
+        VkResult err = vmaCreateBuffer(
+                mDevice->GetMemoryAllocator(), &bufferCI, &allocCI, &mHandle, &mAllocation, &allocationInfo);
+        CHECK_VK_RESULT_FALSE(err, "Could not create descriptor buffer");
+
+        SetDebugName(mDevice, mHandle, "DescriptorBufferHeap", "");
+
+        mMappedPointer = static_cast<uint8_t*>(allocationInfo.pMappedData);
+
+        VkBufferDeviceAddressInfo addressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+        addressInfo.buffer = mHandle;
+        mDeviceAddress = vkGetBufferDeviceAddress(mDevice->GetHandle(), &addressInfo);
+
+        mFreeRanges.emplace(0, mSize);
+        return true;
+    }
+
+    uint64_t DescriptorBufferHeap::Allocate(uint64_t size)
+    {
+        // Layouts without descriptors still get a valid offset to bind.
+        if (size == 0)
+        {
+            return 0;
+        }
+        size = AlignUp(size, mAlignment);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto iter = mFreeRanges.begin(); iter != mFreeRanges.end(); ++iter)
+        {
+            if (iter->second < size)
+            {
+                continue;
+            }
+
+            const uint64_t offset = iter->first;
+            const uint64_t remaining = iter->second - size;
+            mFreeRanges.erase(iter);
+            if (remaining > 0)
+            {
+                mFreeRanges.emplace(offset + size, remaining);
+            }
+
+            mUsedBytes.fetch_add(size, std::memory_order_relaxed);
+            mAllocations.fetch_add(1, std::memory_order_relaxed);
+            return offset;
+        }
+
+        mFailedAllocations.fetch_add(1, std::memory_order_relaxed);
+        return cInvalidOffset;
+    }
+
+    void DescriptorBufferHeap::Free(uint64_t offset, uint64_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFrameFrees.push_back({offset, AlignUp(size, mAlignment)});
+    }
+
+    void DescriptorBufferHeap::InsertFreeRange(uint64_t offset, uint64_t size)
+    {
+        auto next = mFreeRanges.lower_bound(offset);
+        if (next != mFreeRanges.end() && offset + size == next->first)
+        {
+            size += next->second;
+            next = mFreeRanges.erase(next);
+        }
+        if (next != mFreeRanges.begin())
+        {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset)
+            {
+                previous->second += size;
+                return;
+            }
+        }
+        mFreeRanges.emplace_hint(next, offset, size);
+    }
+
+    void DescriptorBufferHeap::Tick()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::array<uint64_t, 2> completedSerials = {};
+        std::array<uint64_t, 2> lastUsableSerials = {};
+        for (QueueType queueType : {QueueType::Graphics, QueueType::Compute})
+        {
+            Ref<QueueBase> queue = mDevice->GetQueue(queueType);
+            if (queue != nullptr)
+            {
+                const uint32_t index = static_cast<uint32_t>(queueType);
+                completedSerials[index] = queue->GetCompletedSerial();
+                // Push bindings free their range while their commands are being recorded, so the pending serial
+                // is included too.
+                lastUsableSerials[index] = queue->GetPendingSubmitSerial();
+            }
+        }
+
+        if (!mFrameFrees.empty())
+        {
+            mRetiredRanges.push_back({std::move(mFrameFrees), lastUsableSerials});
+            mFrameFrees.clear();
+        }
+
+        while (!mRetiredRanges.empty())
+        {
+            RetiredRanges& retired = mRetiredRanges.front();
+            if (retired.serials[0] > completedSerials[0] || retired.serials[1] > completedSerials[1])
+            {
+                break;
+            }
+            for (const Range& range : retired.ranges)
+            {
+                InsertFreeRange(range.offset, range.size);
+                mUsedBytes.fetch_sub(range.size, std::memory_order_relaxed);
+            }
+            mRetiredRanges.pop_front();
+        }
+    }
+
+    uint8_t* DescriptorBufferHeap::GetMappedPointer() const
+    {
+        return mMappedPointer;
+    }
+
+    void DescriptorBufferHeap::BindToCommandBuffer(VkCommandBuffer commandBuffer) const
+    {
+        VkDescriptorBufferBindingInfoEXT bindingInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+        bindingInfo.address = mDeviceAddress;
+        bindingInfo.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                            VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+        mDevice->Fn.vkCmdBindDescriptorBuffersEXT(commandBuffer, 1, &bindingInfo);
+    }
+
+    DescriptorBufferHeapStats DescriptorBufferHeap::GetStats() const
+    {
+        DescriptorBufferHeapStats stats{};
+        stats.capacity = mSize;
+        stats.usedBytes = mUsedBytes.load(std::memory_order_relaxed);
+        stats.allocations = mAllocations.load(std::memory_order_relaxed);
+        stats.failedAllocations = mFailedAllocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+} // namespace rhi::impl::vulkan
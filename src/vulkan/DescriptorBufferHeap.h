@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../common/NoCopyable.h"
+#include "../common/RHIStruct.h"
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace rhi::impl::vulkan
+{
+    class Device;
+
+    struct DescriptorBufferHeapStats
+    {
+        uint64_t capacity;
+        uint64_t usedBytes;
+        uint64_t allocations;
+        // Allocations that found no free range large enough.
+        uint64_t failedAllocations;
+    };
+
+    // The GPU visible buffer holding the descriptors of every bind set when VK_EXT_descriptor_buffer is enabled. It
+    // is bound once per command buffer and bind sets are ranges of it selected with vkCmdSetDescriptorBufferOffsetsEXT.
+    // Freed ranges are retired on Tick and only reused once the commands submitted or being recorded at that point
+    // completed on every queue.
+    class DescriptorBufferHeap : public NonCopyable
+    {
+    public:
+        explicit DescriptorBufferHeap(Device* device);
+        ~DescriptorBufferHeap();
+
+        bool Initialize();
+
+        // Returns cInvalidOffset when no free range is large enough.
+        uint64_t Allocate(uint64_t size);
+        void Free(uint64_t offset, uint64_t size);
+        void Tick();
+
+        uint8_t* GetMappedPointer() const;
+        void BindToCommandBuffer(VkCommandBuffer commandBuffer) const;
+
+        DescriptorBufferHeapStats GetStats() const;
+
+        static constexpr uint64_t cInvalidOffset = std::numeric_limits<uint64_t>::max();
+
+    private:
+        struct Range
+        {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct RetiredRanges
+        {
+            std::vector<Range> ranges;
+            // Last serial of the graphics and compute queues that may read these ranges.
+            std::array<uint64_t, 2> serials;
+        };
+
+        void InsertFreeRange(uint64_t offset, uint64_t size);
+
+        static constexpr uint64_t cHeapSize = 32 * 1024 * 1024;
+
+        VkBuffer mHandle = VK_NULL_HANDLE;
+        VmaAllocation mAllocation = VK_NULL_HANDLE;
+        uint8_t* mMappedPointer = nullptr;
+        VkDeviceAddress mDeviceAddress = 0;
+        uint64_t mSize = 0;
+        uint64_t mAlignment = 1;
+
+        std::mutex mMutex;
+        // Free ranges keyed by offset, adjacent ranges are merged.
+        std::map<uint64_t, uint64_t> mFreeRanges;
+        // Ranges freed since the last Tick.
+        std::vector<Range> mFrameFrees;
+        std::deque<RetiredRanges> mRetiredRanges;
+
+        std::atomic<uint64_t> mUsedBytes = 0;
+        std::atomic<uint64_t> mAllocations = 0;
+        std::atomic<uint64_t> mFailedAllocations = 0;
+
+        Device* mDevice;
+    };
+} // namespace rhi::impl::vulkan
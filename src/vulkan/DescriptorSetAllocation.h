@@ -8,6 +8,5 @@ namespace rhi::impl::vulkan
     {
         VkDescriptorSet set;
         uint32_t poolIndex;
-        uint32_t setIndex;
     };
 }
@@ -7,6 +7,8 @@
 #include "ErrorsVk.h"
 #include "QueueVk.h"
 
+#include <algorithm>
+
 namespace rhi::impl::vulkan
 {
 
@@ -16,140 +18,230 @@ namespace rhi::impl::vulkan
             (cMaxSampledTexturesPerShaderStage + cMaxSamplersPerShaderStage + cMaxStorageBuffersPerShaderStage +
              cMaxStorageTexturesPerShaderStage + cMaxUniformBuffersPerShaderStage);
 
-    static constexpr uint32_t cMaxDescriptorsPerPool = 512;
-
     DescriptorSetAllocator::DescriptorSetAllocator(
-            Device* device, std::unordered_map<VkDescriptorType, uint32_t>&& descriptorCountPerType)
-        : mDevice(device)
+            Device* device,
+            std::unordered_map<VkDescriptorType, uint32_t>&& descriptorCountPerType,
+            VkDescriptorPoolCreateFlags poolFlags,
+            uint32_t maxSetsPerPool)
+        : mPoolFlags(poolFlags),
+          mMaxSetsPerPool(maxSetsPerPool),
+          mMinSetsPerPool(std::min(cMinSetsPerPool, maxSetsPerPool)),
+          mNextPoolMaxSets(mMinSetsPerPool),
+          mDevice(device)
     {
         // Compute the total number of descriptors for this layout.
-        uint32_t totalDescriptorCount = 0;
-        mPoolSizes.reserve(descriptorCountPerType.size());
+        mSetPoolSizes.reserve(descriptorCountPerType.size());
 
         for (const auto& [type, count] : descriptorCountPerType)
         {
             ASSERT(count > 0);
-            totalDescriptorCount += count;
-            mPoolSizes.push_back(VkDescriptorPoolSize{type, count});
+            mDescriptorCountPerSet += count;
+            mSetPoolSizes.push_back(VkDescriptorPoolSize{type, count});
         }
 
-        if (totalDescriptorCount == 0)
-        {
-            // Vulkan specs requires that valid usage of vkCreateDescriptorPool must have a non-zero
-            // number of pools, each of which has non-zero descriptor counts.
-            mPoolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1});
-            mMaxSets = 1;
-        }
-        else
-        {
-            ASSERT(totalDescriptorCount <= cMaxBindingsPerPipelineLayout);
-            // Compute the total number of descriptors sets that fits given the max.
-            mMaxSets = cMaxDescriptorsPerPool / totalDescriptorCount;
-            ASSERT(mMaxSets > 0);
+        ASSERT(maxSetsPerPool > 0);
+        // Update after bind layouts are the large descriptor arrays of resource heaps.
+        ASSERT(mDescriptorCountPerSet <= cMaxBindingsPerPipelineLayout ||
+               (poolFlags & VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT) != 0);
+    }
 
-            // Grow the number of desciptors in the pool to fit the computed |mMaxSets|.
-            for (auto& poolSize : mPoolSizes)
+    DescriptorSetAllocator::~DescriptorSetAllocator()
+    {
+        for (auto& deallocations : mDeallocationsInQueues)
+        {
+            for (Deallocation* dealloc : deallocations.pendingDeallocations.IterateAll())
             {
-                poolSize.descriptorCount *= mMaxSets;
+                if (--dealloc->refQueueCount == 0)
+                {
+                    delete dealloc;
+                }
             }
         }
-    }
 
-    DescriptorSetAllocator::~DescriptorSetAllocator()
-    {
         for (auto& pool : mDescriptorPools)
         {
-            ASSERT(pool.freeSetIndices.size() == mMaxSets);
+            ASSERT(pool.liveSetCount == 0);
             if (pool.vkPool != VK_NULL_HANDLE)
             {
-                // todo: dstory whe unused?
                 vkDestroyDescriptorPool(mDevice->GetHandle(), pool.vkPool, nullptr);
             }
         }
     }
 
     Ref<DescriptorSetAllocator> DescriptorSetAllocator::Create(
-            Device* device, std::unordered_map<VkDescriptorType, uint32_t>&& descriptorCountPerType)
+            Device* device,
+            std::unordered_map<VkDescriptorType, uint32_t>&& descriptorCountPerType,
+            VkDescriptorPoolCreateFlags poolFlags,
+            uint32_t maxSetsPerPool)
     {
-        Ref<DescriptorSetAllocator> allocator =
-                AcquireRef(new DescriptorSetAllocator(device, std::move(descriptorCountPerType)));
+        Ref<DescriptorSetAllocator> allocator = AcquireRef(
+                new DescriptorSetAllocator(device, std::move(descriptorCountPerType), poolFlags, maxSetsPerPool));
         return allocator;
     }
 
+    bool DescriptorSetAllocator::HasFreeSet(const DescriptorPool& pool) const
+    {
+        return !pool.freeSets.empty() || pool.allocatedSetCount < pool.maxSets;
+    }
+
     DescriptorSetAllocation DescriptorSetAllocator::Allocate(BindSetLayout* layout)
     {
         std::lock_guard<std::mutex> lock(mMutex);
 
-        if (mAvailableDescriptorPoolIndices.empty())
+        while (true)
         {
-            AllocateDescriptorPool(layout);
-        }
+            if (mAvailableDescriptorPoolIndices.empty() && !AllocateDescriptorPool())
+            {
+                return {};
+            }
 
-        ASSERT(!mAvailableDescriptorPoolIndices.empty());
+            const uint32_t poolIndex = mAvailableDescriptorPoolIndices.back();
+            DescriptorPool* pool = &mDescriptorPools[poolIndex];
+            ASSERT(HasFreeSet(*pool));
 
-        const uint32_t poolIndex = mAvailableDescriptorPoolIndices.back();
-        DescriptorPool* pool = &mDescriptorPools[poolIndex];
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            if (!pool->freeSets.empty())
+            {
+                // Sets of a pool all use this layout, a recycled one only needs to be rewritten.
+                set = pool->freeSets.back();
+                pool->freeSets.pop_back();
+            }
+            else
+            {
+                VkDescriptorSetLayout layoutHandle = layout->GetHandle();
 
-        ASSERT(!pool->freeSetIndices.empty());
+                VkDescriptorSetAllocateInfo allocateInfo;
+                allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+                allocateInfo.pNext = nullptr;
+                allocateInfo.descriptorPool = pool->vkPool;
+                allocateInfo.descriptorSetCount = 1;
+                allocateInfo.pSetLayouts = &layoutHandle;
 
-        uint32_t setIndex = pool->freeSetIndices.back();
-        pool->freeSetIndices.pop_back();
+                VkResult err = vkAllocateDescriptorSets(mDevice->GetHandle(), &allocateInfo, &set);
+                if (err != VK_SUCCESS)
+                {
+                    // The pool is sized for maxSets of this layout so this should not happen, but a driver running
+                    // out of pool memory only means this pool is full.
+                    pool->allocatedSetCount = pool->maxSets;
+                    mAvailableDescriptorPoolIndices.pop_back();
+                    if (err != VK_ERROR_OUT_OF_POOL_MEMORY && err != VK_ERROR_FRAGMENTED_POOL)
+                    {
+                        CHECK_VK_RESULT(err, "AllocateDescriptorSets");
+                        return {};
+                    }
+                    continue;
+                }
+                pool->allocatedSetCount++;
+            }
 
-        if (pool->freeSetIndices.empty())
-        {
-            mAvailableDescriptorPoolIndices.pop_back();
-        }
+            if (pool->liveSetCount == 0)
+            {
+                ASSERT(mIdlePoolCount > 0);
+                mIdlePoolCount--;
+            }
+            pool->liveSetCount++;
 
-        return DescriptorSetAllocation{pool->sets[setIndex], poolIndex, setIndex};
-    }
+            if (!HasFreeSet(*pool))
+            {
+                mAvailableDescriptorPoolIndices.pop_back();
+            }
 
+            return DescriptorSetAllocation{set, poolIndex};
+        }
+    }
 
-    void DescriptorSetAllocator::AllocateDescriptorPool(BindSetLayout* layout)
+    bool DescriptorSetAllocator::AllocateDescriptorPool()
     {
+        uint32_t maxSets = mNextPoolMaxSets;
+        std::vector<VkDescriptorPoolSize> poolSizes = mSetPoolSizes;
+
+        if (mDescriptorCountPerSet == 0)
+        {
+            // Vulkan specs requires that valid usage of vkCreateDescriptorPool must have a non-zero
+            // number of pools, each of which has non-zero descriptor counts.
+            poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1});
+        }
+        else
+        {
+            maxSets = std::max(1u, std::min(maxSets, cMaxDescriptorsPerPool / mDescriptorCountPerSet));
+            for (auto& poolSize : poolSizes)
+            {
+                poolSize.descriptorCount *= maxSets;
+            }
+        }
+
         VkDescriptorPoolCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         createInfo.pNext = nullptr;
-        createInfo.flags = 0;
-        createInfo.maxSets = mMaxSets;
-        createInfo.poolSizeCount = mPoolSizes.size();
-        createInfo.pPoolSizes = mPoolSizes.data();
+        createInfo.flags = mPoolFlags;
+        createInfo.maxSets = maxSets;
+        createInfo.poolSizeCount = poolSizes.size();
+        createInfo.pPoolSizes = poolSizes.data();
 
         VkDescriptorPool descriptorPool;
 
         VkResult err = vkCreateDescriptorPool(mDevice->GetHandle(), &createInfo, nullptr, &descriptorPool);
-        CHECK_VK_RESULT_RETURN(err, "CreateDescriptorPool");
+        CHECK_VK_RESULT_FALSE(err, "CreateDescriptorPool");
 
-        std::vector<VkDescriptorSetLayout> layouts(mMaxSets, layout->GetHandle());
+        uint32_t poolIndex;
+        if (!mFreePoolSlots.empty())
+        {
+            poolIndex = mFreePoolSlots.back();
+            mFreePoolSlots.pop_back();
+        }
+        else
+        {
+            poolIndex = static_cast<uint32_t>(mDescriptorPools.size());
+            mDescriptorPools.emplace_back();
+        }
 
-        VkDescriptorSetAllocateInfo allocateInfo;
-        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocateInfo.pNext = nullptr;
-        allocateInfo.descriptorPool = descriptorPool;
-        allocateInfo.descriptorSetCount = mMaxSets;
-        allocateInfo.pSetLayouts = layouts.data();
+        DescriptorPool& pool = mDescriptorPools[poolIndex];
+        pool = {};
+        pool.vkPool = descriptorPool;
+        pool.maxSets = maxSets;
+        // Counted as idle until its first set is allocated right after.
+        mIdlePoolCount++;
+
+        mAvailableDescriptorPoolIndices.push_back(poolIndex);
+        mNextPoolMaxSets = std::min(mNextPoolMaxSets * 2, mMaxSetsPerPool);
+        mPoolCreations++;
+        return true;
+    }
 
-        std::vector<VkDescriptorSet> sets(mMaxSets);
+    void DescriptorSetAllocator::FreeSet(uint32_t poolIndex, VkDescriptorSet set, QueueType queueType, uint64_t serial)
+    {
+        ASSERT(poolIndex < mDescriptorPools.size());
+        DescriptorPool& pool = mDescriptorPools[poolIndex];
+        ASSERT(pool.liveSetCount > 0);
 
-        err = vkAllocateDescriptorSets(mDevice->GetHandle(), &allocateInfo, sets.data());
-        CHECK_VK_RESULT(err, "AllocateDescriptorSets");
+        if (!HasFreeSet(pool))
+        {
+            mAvailableDescriptorPoolIndices.emplace_back(poolIndex);
+        }
+        pool.freeSets.push_back(set);
+        pool.liveSetCount--;
 
-        if (err != VK_SUCCESS)
+        if (pool.liveSetCount == 0)
         {
-            // On an error we can destroy the pool immediately because no command references it.
-            vkDestroyDescriptorPool(mDevice->GetHandle(), descriptorPool, nullptr);
-            return;
+            pool.idleQueue = queueType;
+            pool.idleSerial = serial;
+            mIdlePoolCount++;
+            ScheduleFinishDeallocation(queueType);
         }
+    }
 
-        std::vector<uint32_t> freeSetIndices;
-        freeSetIndices.reserve(mMaxSets);
+    void DescriptorSetAllocator::ScheduleFinishDeallocation(QueueType queueType)
+    {
+        ASSERT(static_cast<uint32_t>(queueType) <= 1);
+        Queue* queue = checked_cast<Queue>(mDevice->GetQueue(queueType).Get());
+        const uint64_t serial = queue->GetPendingSubmitSerial();
 
-        for (uint32_t i = 0; i < mMaxSets; ++i)
+        DeallocationsInQueue& deallocations = mDeallocationsInQueues[static_cast<uint32_t>(queueType)];
+        if (deallocations.lastDeallocationSerial != serial)
         {
-            freeSetIndices.push_back(i);
+            deallocations.lastDeallocationSerial = serial;
+            queue->EnqueueDeferredDeallocation(this);
         }
-
-        mAvailableDescriptorPoolIndices.push_back(mDescriptorPools.size());
-        mDescriptorPools.emplace_back(DescriptorPool{descriptorPool, std::move(sets), std::move(freeSetIndices)});
     }
 
     void DescriptorSetAllocator::Deallocate(DescriptorSetAllocation* allocationInfo,
@@ -165,77 +257,131 @@ namespace rhi::impl::vulkan
         // documentation for vkCmdBindDescriptorSets that the set may be consumed any time between
         // host execution of the command and the end of the draw/dispatch.
 
-        auto deallocation = new Deallocation();
-        deallocation->poolIndex = allocationInfo->poolIndex;
-        deallocation->setIndex = allocationInfo->setIndex;
-        deallocation->refQueueCount = 0;
-
-
-        auto deferredDeallocationFunc = [&](QueueType queueType)
+        if (!usedInGraphicsQueue && !usedInComputeQueue)
         {
-            deallocation->refQueueCount += 1;
+            // we can deallocate it right now
+            Queue* queue = checked_cast<Queue>(mDevice->GetQueue(QueueType::Graphics).Get());
+            FreeSet(allocationInfo->poolIndex, allocationInfo->set, QueueType::Graphics, queue->GetCompletedSerial());
+        }
+        else
+        {
+            auto deallocation = new Deallocation();
+            deallocation->poolIndex = allocationInfo->poolIndex;
+            deallocation->set = allocationInfo->set;
+            deallocation->refQueueCount = 0;
 
-            Queue* queue = checked_cast<Queue>(mDevice->GetQueue(queueType).Get());
+            auto deferredDeallocationFunc = [&](QueueType queueType)
+            {
+                deallocation->refQueueCount += 1;
 
-            const uint64_t serial = queue->GetPendingSubmitSerial();
+                Queue* queue = checked_cast<Queue>(mDevice->GetQueue(queueType).Get());
+                mDeallocationsInQueues[static_cast<uint32_t>(queueType)].pendingDeallocations.Push(
+                        queue->GetPendingSubmitSerial(), deallocation);
+                ScheduleFinishDeallocation(queueType);
+            };
 
-            assert(static_cast<uint32_t>(queueType) <= 1);
+            if (usedInGraphicsQueue)
+            {
+                deferredDeallocationFunc(QueueType::Graphics);
+            }
 
-            mDeallocationsInQueues[static_cast<uint32_t>(queueType)].pendingDeallocations.Push(serial, deallocation);
-            if (mDeallocationsInQueues[static_cast<uint32_t>(queueType)].lastDeallocationSerial != serial)
+            if (usedInComputeQueue)
             {
-                mDeallocationsInQueues[static_cast<uint32_t>(queueType)].lastDeallocationSerial = serial;
-                queue->EnqueueDeferredDeallocation(this);
+                deferredDeallocationFunc(QueueType::Compute);
             }
-        };
+        }
 
-        if (usedInGraphicsQueue)
+        // Clear the content of allocation so that use after frees are more visible.
+        *allocationInfo = {};
+    }
+
+    void DescriptorSetAllocator::FinishDeallocation(Queue* queue, uint64_t completedSerial)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        const QueueType queueType = queue->GetType();
+        auto& pendingDeallocations = mDeallocationsInQueues[static_cast<uint32_t>(queueType)].pendingDeallocations;
+
+        for (Deallocation* dealloc : pendingDeallocations.IterateUpTo(completedSerial))
         {
-            deferredDeallocationFunc(QueueType::Graphics);
+            ASSERT(dealloc->refQueueCount >= 1);
+            dealloc->refQueueCount -= 1;
+
+            if (dealloc->refQueueCount == 0)
+            {
+                FreeSet(dealloc->poolIndex, dealloc->set, queueType, completedSerial);
+                delete dealloc;
+            }
         }
+        pendingDeallocations.ClearUpTo(completedSerial);
 
-        if (usedInComputeQueue)
+        ReclaimIdlePools(queueType, completedSerial);
+    }
+
+    void DescriptorSetAllocator::ReclaimIdlePools(QueueType queueType, uint64_t completedSerial)
+    {
+        if (mIdlePoolCount == 0)
         {
-            deferredDeallocationFunc(QueueType::Compute);
+            return;
         }
 
-        // we can deallocate it right now
-        if (deallocation->refQueueCount == 0)
+        bool hasPendingIdlePool = false;
+        for (uint32_t poolIndex = 0; poolIndex < mDescriptorPools.size(); ++poolIndex)
         {
-            auto& freeSetIndices = mDescriptorPools[deallocation->poolIndex].freeSetIndices;
-            if (freeSetIndices.empty())
+            DescriptorPool& pool = mDescriptorPools[poolIndex];
+            if (pool.vkPool == VK_NULL_HANDLE || pool.liveSetCount != 0 || pool.idleQueue != queueType)
+            {
+                continue;
+            }
+
+            if (completedSerial < pool.idleSerial + cPoolReclaimSerials)
             {
-                mAvailableDescriptorPoolIndices.emplace_back(deallocation->poolIndex);
+                hasPendingIdlePool = true;
+                continue;
             }
-            freeSetIndices.emplace_back(deallocation->setIndex);
+
+            // Every set of the pool is free and no longer used by the GPU.
+            vkDestroyDescriptorPool(mDevice->GetHandle(), pool.vkPool, nullptr);
+            pool = {};
+
+            auto it = std::find(mAvailableDescriptorPoolIndices.begin(), mAvailableDescriptorPoolIndices.end(), poolIndex);
+            if (it != mAvailableDescriptorPoolIndices.end())
+            {
+                mAvailableDescriptorPoolIndices.erase(it);
+            }
+            mFreePoolSlots.push_back(poolIndex);
+
+            mIdlePoolCount--;
+            mPoolReclaims++;
+            // The layout is used less than before, start the next pools smaller again.
+            mNextPoolMaxSets = std::max(mNextPoolMaxSets / 2, mMinSetsPerPool);
         }
 
-        // Clear the content of allocation so that use after frees are more visible.
-        *allocationInfo = {};
+        // Come back once the queue made progress so that the remaining idle pools get reclaimed too.
+        if (hasPendingIdlePool)
+        {
+            ScheduleFinishDeallocation(queueType);
+        }
     }
 
-    void DescriptorSetAllocator::FinishDeallocation(Queue* queue, uint64_t completedSerial)
+    DescriptorStats DescriptorSetAllocator::GetStats()
     {
         std::lock_guard<std::mutex> lock(mMutex);
 
-        for (Deallocation* dealloc :
-             mDeallocationsInQueues[static_cast<uint32_t>(queue->GetType())].pendingDeallocations.IterateUpTo(
-                     completedSerial))
+        DescriptorStats stats{};
+        for (const DescriptorPool& pool : mDescriptorPools)
         {
-            ASSERT(dealloc->poolIndex < mDescriptorPools.size());
-            ASSERT(dealloc->refQueueCount >= 1);
-            dealloc->refQueueCount -= 1;
-
-            if (dealloc->refQueueCount == 0)
+            if (pool.vkPool == VK_NULL_HANDLE)
             {
-                auto& freeSetIndices = mDescriptorPools[dealloc->poolIndex].freeSetIndices;
-                if (freeSetIndices.empty())
-                {
-                    mAvailableDescriptorPoolIndices.emplace_back(dealloc->poolIndex);
-                }
-                freeSetIndices.emplace_back(dealloc->setIndex);
+                continue;
             }
+            stats.poolCount++;
+            stats.setCapacity += pool.maxSets;
+            stats.liveSets += pool.liveSetCount;
+            stats.freeSets += pool.maxSets - pool.liveSetCount;
         }
-        mDeallocationsInQueues[static_cast<uint32_t>(queue->GetType())].pendingDeallocations.ClearUpTo(completedSerial);
+        stats.poolCreations = mPoolCreations;
+        stats.poolReclaims = mPoolReclaims;
+        return stats;
     }
 } // namespace rhi::impl::vulkan
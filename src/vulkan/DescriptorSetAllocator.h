@@ -3,6 +3,7 @@
 #include "../common/RefCounted.h"
 #include "../common/SerialQueue.hpp"
 #include "../common/Ref.hpp"
+#include "../common/RHIStruct.h"
 #include "DescriptorSetAllocation.h"
 
 #include <vulkan/vulkan.h>
@@ -16,40 +17,73 @@ namespace rhi::impl::vulkan
     class Device;
     class BindSetLayout;
 
+    // Descriptor sets of one bind set layout. Pools grow geometrically as the layout is used more, sets are only
+    // allocated from a pool when first needed and are recycled afterwards, and pools left fully free for
+    // cPoolReclaimSerials serials are destroyed.
     class DescriptorSetAllocator : public RefCounted
     {
     public:
         static Ref<DescriptorSetAllocator> Create(Device* device,
                                                   std::unordered_map<VkDescriptorType, uint32_t>&&
-                                                  descriptorCountPerType);
+                                                  descriptorCountPerType,
+                                                  VkDescriptorPoolCreateFlags poolFlags = 0,
+                                                  uint32_t maxSetsPerPool = cMaxSetsPerPool);
         DescriptorSetAllocation Allocate(BindSetLayout* layout);
         void Deallocate(DescriptorSetAllocation* allocationInfo, bool usedInGraphicsQueue, bool usedInComputeQueue);
         void FinishDeallocation(Queue* queue, uint64_t completedSerial);
 
+        DescriptorStats GetStats();
+
     private:
         explicit DescriptorSetAllocator(Device* device,
-                                        std::unordered_map<VkDescriptorType, uint32_t>&& descriptorCountPerType);
+                                        std::unordered_map<VkDescriptorType, uint32_t>&& descriptorCountPerType,
+                                        VkDescriptorPoolCreateFlags poolFlags,
+                                        uint32_t maxSetsPerPool);
         ~DescriptorSetAllocator();
 
-        void AllocateDescriptorPool(BindSetLayout* layout);
-
-        std::vector<VkDescriptorPoolSize> mPoolSizes;
-        uint32_t mMaxSets;
-
         struct DescriptorPool
         {
-            VkDescriptorPool vkPool;
-            std::vector<VkDescriptorSet> sets;
-            std::vector<uint32_t> freeSetIndices;
+            VkDescriptorPool vkPool = VK_NULL_HANDLE;
+            uint32_t maxSets = 0;
+            // Sets already allocated from vkPool, the others are allocated lazily.
+            uint32_t allocatedSetCount = 0;
+            uint32_t liveSetCount = 0;
+            std::vector<VkDescriptorSet> freeSets;
+            // Where the pool became fully free, valid while liveSetCount is 0.
+            QueueType idleQueue = QueueType::Graphics;
+            uint64_t idleSerial = 0;
         };
 
+        bool HasFreeSet(const DescriptorPool& pool) const;
+        bool AllocateDescriptorPool();
+        void FreeSet(uint32_t poolIndex, VkDescriptorSet set, QueueType queueType, uint64_t serial);
+        void ReclaimIdlePools(QueueType queueType, uint64_t completedSerial);
+        void ScheduleFinishDeallocation(QueueType queueType);
+
+        // Smallest and largest number of sets per pool. Each new pool doubles the previous one in between.
+        static constexpr uint32_t cMinSetsPerPool = 16;
+        static constexpr uint32_t cMaxSetsPerPool = 1024;
+        static constexpr uint32_t cMaxDescriptorsPerPool = 16384;
+        static constexpr uint64_t cPoolReclaimSerials = 16;
+
+        // Descriptor counts of a single set.
+        std::vector<VkDescriptorPoolSize> mSetPoolSizes;
+        uint32_t mDescriptorCountPerSet = 0;
+        const VkDescriptorPoolCreateFlags mPoolFlags;
+        const uint32_t mMaxSetsPerPool;
+        const uint32_t mMinSetsPerPool;
+        uint32_t mNextPoolMaxSets;
+
         std::vector<uint32_t> mAvailableDescriptorPoolIndices;
         std::vector<DescriptorPool> mDescriptorPools;
+        // Slots of reclaimed pools, reused by the next pools.
+        std::vector<uint32_t> mFreePoolSlots;
+        uint32_t mIdlePoolCount = 0;
 
         struct Deallocation
         {
             uint32_t poolIndex;
-            uint32_t setIndex;
+            VkDescriptorSet set;
             uint32_t refQueueCount;
         };
 
@@ -61,6 +95,9 @@ namespace rhi::impl::vulkan
 
         std::array<DeallocationsInQueue, 2> mDeallocationsInQueues;
 
+        uint64_t mPoolCreations = 0;
+        uint64_t mPoolReclaims = 0;
+
         std::mutex mMutex;
         Device* mDevice;
     };
@@ -17,6 +17,7 @@
 #include "SwapChainVk.h"
 #include "TextureVk.h"
 #include "PipelineCacheVk.h"
+#include "ResourceHeapVk.h"
 
 #include <algorithm>
 #include <iostream>
@@ -67,6 +68,53 @@ namespace rhi::impl::vulkan
             }
         }
 
+        mDescriptorBufferEnabled = HasRequiredFeature(FeatureName::DescriptorBuffer);
+        if (mDescriptorBufferEnabled)
+        {
+            deviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        }
+
+        // Descriptor buffer pipelines cannot mix in push descriptor sets, push bindings are written to the descriptor
+        // buffer heap instead.
+        mPushDescriptorSupported = !mDescriptorBufferEnabled &&
+                                   std::find(supportedExtensions.begin(),
+                                             supportedExtensions.end(),
+                                             VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) != supportedExtensions.end();
+        if (mPushDescriptorSupported)
+        {
+            deviceExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+        }
+
+        // Pipeline libraries only pay off when linking them is fast, otherwise pipelines stay monolithic.
+        if (std::find(supportedExtensions.begin(),
+                      supportedExtensions.end(),
+                      VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) != supportedExtensions.end() &&
+            std::find(supportedExtensions.begin(), supportedExtensions.end(), VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) !=
+                    supportedExtensions.end())
+        {
+            VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT libraryFeatures{};
+            libraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &libraryFeatures;
+            vkGetPhysicalDeviceFeatures2(adapter->GetHandle(), &features2);
+
+            VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT libraryProperties{};
+            libraryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &libraryProperties;
+            vkGetPhysicalDeviceProperties2(adapter->GetHandle(), &properties2);
+
+            mGraphicsPipelineLibrarySupported =
+                    libraryFeatures.graphicsPipelineLibrary && libraryProperties.graphicsPipelineLibraryFastLinking;
+        }
+        if (mGraphicsPipelineLibrarySupported)
+        {
+            deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        }
+
         for (auto extension : deviceExtensions)
         {
             if (std::find(supportedExtensions.begin(), supportedExtensions.end(), extension) ==
@@ -107,8 +155,37 @@ namespace rhi::impl::vulkan
         feature12.uniformBufferStandardLayout = true;
         feature12.scalarBlockLayout = true;
         feature12.separateDepthStencilLayouts = true;
+        if (HasRequiredFeature(FeatureName::DescriptorIndexing))
+        {
+            feature12.descriptorIndexing = true;
+            feature12.runtimeDescriptorArray = true;
+            feature12.descriptorBindingPartiallyBound = true;
+            feature12.descriptorBindingUpdateUnusedWhilePending = true;
+            feature12.descriptorBindingSampledImageUpdateAfterBind = true;
+            feature12.descriptorBindingStorageBufferUpdateAfterBind = true;
+            feature12.shaderSampledImageArrayNonUniformIndexing = true;
+            feature12.shaderStorageBufferArrayNonUniformIndexing = true;
+        }
+        feature12.bufferDeviceAddress = mDescriptorBufferEnabled;
         feature12.pNext = &feature13;
 
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{};
+        descriptorBufferFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+        descriptorBufferFeatures.descriptorBuffer = true;
+        if (mDescriptorBufferEnabled)
+        {
+            feature13.pNext = &descriptorBufferFeatures;
+        }
+
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+        graphicsPipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+        graphicsPipelineLibraryFeatures.graphicsPipelineLibrary = true;
+        if (mGraphicsPipelineLibrarySupported)
+        {
+            graphicsPipelineLibraryFeatures.pNext = feature13.pNext;
+            feature13.pNext = &graphicsPipelineLibraryFeatures;
+        }
+
         uint32_t queueFamilyCount = 0;
         vkGetPhysicalDeviceQueueFamilyProperties(
                 checked_cast<Adapter>(mAdapter)->GetHandle(), &queueFamilyCount, nullptr);
@@ -173,6 +250,10 @@ namespace rhi::impl::vulkan
 
         VmaAllocatorCreateInfo allocatorCreateInfo{};
         allocatorCreateInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        if (mDescriptorBufferEnabled)
+        {
+            allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        }
         allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_3;
         allocatorCreateInfo.physicalDevice = checked_cast<Adapter>(mAdapter)->GetHandle();
         allocatorCreateInfo.device = mHandle;
@@ -194,6 +275,37 @@ namespace rhi::impl::vulkan
         vkGetPhysicalDeviceProperties(adapter->GetHandle(), &mVkDeviceInfo.properties);
 
         LoadExtFunctions();
+        mTransientDescriptorAllocator = std::make_unique<TransientDescriptorAllocator>(this);
+        if (mDescriptorBufferEnabled)
+        {
+            mDescriptorBufferProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &mDescriptorBufferProperties;
+            vkGetPhysicalDeviceProperties2(adapter->GetHandle(), &properties2);
+
+            mDescriptorBufferHeap = std::make_unique<DescriptorBufferHeap>(this);
+            if (!mDescriptorBufferHeap->Initialize())
+            {
+                return false;
+            }
+        }
+
+        if (mGraphicsPipelineLibrarySupported)
+        {
+            mPipelineLibraryCache = std::make_unique<PipelineLibraryCache>(this);
+        }
+
+        if (!desc.pipelineCacheDirectory.empty())
+        {
+            mPipelineCacheManager = std::make_unique<PipelineCacheManager>(this, desc.pipelineCacheDirectory);
+            // The device works without the persistent cache, pipelines just compile from scratch.
+            if (!mPipelineCacheManager->Initialize())
+            {
+                mPipelineCacheManager = nullptr;
+            }
+        }
+
         DeviceBase::Initialize();
         return true;
     }
@@ -210,6 +322,24 @@ namespace rhi::impl::vulkan
             Fn.vkSetDebugUtilsObjectNameEXT = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(
                     vkGetInstanceProcAddr(instance->GetHandle(), "vkSetDebugUtilsObjectNameEXT"));
         }
+        if (mPushDescriptorSupported)
+        {
+            Fn.vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+                    vkGetDeviceProcAddr(mHandle, "vkCmdPushDescriptorSetKHR"));
+        }
+        if (mDescriptorBufferEnabled)
+        {
+            Fn.vkGetDescriptorSetLayoutSizeEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(
+                    vkGetDeviceProcAddr(mHandle, "vkGetDescriptorSetLayoutSizeEXT"));
+            Fn.vkGetDescriptorSetLayoutBindingOffsetEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(
+                    vkGetDeviceProcAddr(mHandle, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
+            Fn.vkGetDescriptorEXT =
+                    reinterpret_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(mHandle, "vkGetDescriptorEXT"));
+            Fn.vkCmdBindDescriptorBuffersEXT = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(
+                    vkGetDeviceProcAddr(mHandle, "vkCmdBindDescriptorBuffersEXT"));
+            Fn.vkCmdSetDescriptorBufferOffsetsEXT = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(
+                    vkGetDeviceProcAddr(mHandle, "vkCmdSetDescriptorBufferOffsetsEXT"));
+        }
     }
 
     VkDevice Device::GetHandle() const
@@ -237,6 +367,105 @@ namespace rhi::impl::vulkan
         return static_cast<uint32_t>(mVkDeviceInfo.properties.limits.optimalBufferCopyOffsetAlignment);
     }
 
+    void Device::AddDescriptorUpdate(bool usedTemplate)
+    {
+        if (usedTemplate)
+        {
+            mTemplateDescriptorUpdates.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            mWriteDescriptorUpdates.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool Device::IsPushDescriptorSupported() const
+    {
+        return mPushDescriptorSupported;
+    }
+
+    TransientDescriptorAllocator* Device::GetTransientDescriptorAllocator() const
+    {
+        return mTransientDescriptorAllocator.get();
+    }
+
+    void Device::TickImpl()
+    {
+        mTransientDescriptorAllocator->Tick();
+        if (mDescriptorBufferHeap != nullptr)
+        {
+            mDescriptorBufferHeap->Tick();
+        }
+        if (mPipelineCacheManager != nullptr)
+        {
+            mPipelineCacheManager->Tick();
+        }
+    }
+
+    PipelineCacheManager* Device::GetPipelineCacheManager() const
+    {
+        return mPipelineCacheManager.get();
+    }
+
+    VkPipelineCache Device::GetPipelineCacheHandle(PipelineCacheBase* cache)
+    {
+        if (cache != nullptr)
+        {
+            return checked_cast<PipelineCache>(cache)->GetHandle();
+        }
+        return mPipelineCacheManager != nullptr ? mPipelineCacheManager->GetThreadCache() : VK_NULL_HANDLE;
+    }
+
+    PipelineLibraryCache* Device::GetPipelineLibraryCache() const
+    {
+        return mPipelineLibraryCache.get();
+    }
+
+    bool Device::IsDescriptorBufferEnabled() const
+    {
+        return mDescriptorBufferEnabled;
+    }
+
+    DescriptorBufferHeap* Device::GetDescriptorBufferHeap() const
+    {
+        return mDescriptorBufferHeap.get();
+    }
+
+    const VkPhysicalDeviceDescriptorBufferPropertiesEXT& Device::GetDescriptorBufferProperties() const
+    {
+        return mDescriptorBufferProperties;
+    }
+
+    uint64_t Device::GetDescriptorSize(BindingType bindingType) const
+    {
+        switch (bindingType)
+        {
+        case BindingType::SampledTexture:
+            return mDescriptorBufferProperties.sampledImageDescriptorSize;
+        case BindingType::StorageTexture:
+            return mDescriptorBufferProperties.storageImageDescriptorSize;
+        case BindingType::UniformBuffer:
+            return mDescriptorBufferProperties.uniformBufferDescriptorSize;
+        case BindingType::StorageBuffer:
+            return mDescriptorBufferProperties.storageBufferDescriptorSize;
+        case BindingType::Sampler:
+            return mDescriptorBufferProperties.samplerDescriptorSize;
+        case BindingType::CombinedTextureSampler:
+            return mDescriptorBufferProperties.combinedImageSamplerDescriptorSize;
+        default:
+            ASSERT(!"unreachable");
+            return 0;
+        }
+    }
+
+    DescriptorUpdateStats Device::GetDescriptorUpdateStats() const
+    {
+        DescriptorUpdateStats stats{};
+        stats.templateUpdates = mTemplateDescriptorUpdates.load(std::memory_order_relaxed);
+        stats.writeUpdates = mWriteDescriptorUpdates.load(std::memory_order_relaxed);
+        return stats;
+    }
+
     Device::~Device()
     {
         // We failed during initialization so early that we don't even have a VkDevice. There is
@@ -246,9 +475,24 @@ namespace rhi::impl::vulkan
             return;
         }
 
+        ShutDownAsyncWork();
+
+        for (Ref<QueueBase>& queue : mQueues)
+        {
+            if (queue)
+            {
+                queue->WaitForPendingSubmissions();
+                queue->StopCompletionThread();
+            }
+        }
+
         vkDeviceWaitIdle(mHandle);
 
         DestroyObjects();
+        mTransientDescriptorAllocator = nullptr;
+        mDescriptorBufferHeap = nullptr;
+        mPipelineCacheManager = nullptr;
+        mPipelineLibraryCache = nullptr;
 
         for (uint32_t i = 0; i < mQueues.size(); ++i)
         {
@@ -290,14 +534,14 @@ namespace rhi::impl::vulkan
         return PipelineLayout::Create(this, desc);
     }
 
-    Ref<RenderPipelineBase> Device::CreateRenderPipelineImpl(const RenderPipelineDesc& desc)
+    Ref<RenderPipelineBase> Device::CreateUninitializedRenderPipelineImpl(const RenderPipelineDesc& desc)
     {
-        return RenderPipeline::Create(this, desc);
+        return RenderPipeline::CreateUninitialized(this, desc);
     }
 
-    Ref<ComputePipelineBase> Device::CreateComputePipelineImpl(const ComputePipelineDesc& desc)
+    Ref<ComputePipelineBase> Device::CreateUninitializedComputePipelineImpl(const ComputePipelineDesc& desc)
     {
-        return ComputePipeline::Create(this, desc);
+        return ComputePipeline::CreateUninitialized(this, desc);
     }
 
     Ref<PipelineCacheBase> Device::CreatePipelineCacheImpl(const PipelineCacheDesc& desc)
@@ -305,6 +549,11 @@ namespace rhi::impl::vulkan
         return PipelineCache::Create(this, desc);
     }
 
+    Ref<ResourceHeapBase> Device::CreateResourceHeapImpl(const ResourceHeapDesc& desc)
+    {
+        return ResourceHeap::Create(this, desc);
+    }
+
     Ref<BindSetLayoutBase> Device::CreateBindSetLayoutImpl(const BindSetLayoutDesc& desc)
     {
         return BindSetLayout::Create(this, desc);
@@ -315,6 +564,11 @@ namespace rhi::impl::vulkan
         return BindSet::Create(this, desc);
     }
 
+    Ref<BindSetBase> Device::CreateTransientBindSetImpl(const BindSetDesc& desc)
+    {
+        return BindSet::CreateTransient(this, desc);
+    }
+
     Ref<TextureBase> Device::CreateTextureImpl(const TextureDesc& desc)
     {
         return Texture::Create(this, desc);
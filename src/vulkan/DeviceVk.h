@@ -3,9 +3,15 @@
 #include "common/DeviceBase.h"
 #include "common/Ref.hpp"
 #include "CommandRecordContextVk.h"
+#include "DescriptorBufferHeap.h"
+#include "PipelineCacheManager.h"
+#include "PipelineLibraryCache.h"
+#include "TransientDescriptorAllocator.h"
 #include "VulkanEXTFunctions.h"
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <vk_mem_alloc.h>
 
 namespace rhi::impl::vulkan
@@ -18,6 +24,14 @@ namespace rhi::impl::vulkan
         VkPhysicalDeviceProperties properties;
     };
 
+    struct DescriptorUpdateStats
+    {
+        // Bind sets written with the descriptor update template of their layout.
+        uint64_t templateUpdates;
+        // Bind sets written with vkUpdateDescriptorSets.
+        uint64_t writeUpdates;
+    };
+
     class Device final : public DeviceBase
     {
     public:
@@ -29,11 +43,13 @@ namespace rhi::impl::vulkan
                                                const SurfaceConfiguration& config) override;
         Ref<PipelineLayoutBase> CreatePipelineLayoutImpl(const PipelineLayoutDesc& desc) override;
         Ref<PipelineLayoutBase> CreatePipelineLayout2Impl(const PipelineLayoutDesc2& desc) override;
-        Ref<RenderPipelineBase> CreateRenderPipelineImpl(const RenderPipelineDesc& desc) override;
-        Ref<ComputePipelineBase> CreateComputePipelineImpl(const ComputePipelineDesc& desc) override;
+        Ref<RenderPipelineBase> CreateUninitializedRenderPipelineImpl(const RenderPipelineDesc& desc) override;
+        Ref<ComputePipelineBase> CreateUninitializedComputePipelineImpl(const ComputePipelineDesc& desc) override;
         Ref<PipelineCacheBase> CreatePipelineCacheImpl(const PipelineCacheDesc& desc) override;
+        Ref<ResourceHeapBase> CreateResourceHeapImpl(const ResourceHeapDesc& desc) override;
         Ref<BindSetLayoutBase> CreateBindSetLayoutImpl(const BindSetLayoutDesc& desc) override;
         Ref<BindSetBase> CreateBindSetImpl(const BindSetDesc& desc) override;
+        Ref<BindSetBase> CreateTransientBindSetImpl(const BindSetDesc& desc) override;
         Ref<TextureBase> CreateTextureImpl(const TextureDesc& desc) override;
         Ref<BufferBase> CreateBufferImpl(const BufferDesc& desc, QueueType initialQueueOwner = QueueType::Undefined) override;
         Ref<ShaderModuleBase> CreateShaderImpl(const ShaderModuleDesc& desc) override;
@@ -46,6 +62,24 @@ namespace rhi::impl::vulkan
         const VkDeviceInfo& GetVkDeviceInfo() const;
         uint32_t GetOptimalBytesPerRowAlignment() const override;
         uint32_t GetOptimalBufferToTextureCopyOffsetAlignment() const override;
+        void AddDescriptorUpdate(bool usedTemplate);
+        DescriptorUpdateStats GetDescriptorUpdateStats() const;
+        TransientDescriptorAllocator* GetTransientDescriptorAllocator() const;
+        // Push descriptor layouts fall back to transient bind sets without VK_KHR_push_descriptor.
+        bool IsPushDescriptorSupported() const;
+        // Bind sets live in the descriptor buffer heap instead of descriptor pools, see FeatureName::DescriptorBuffer.
+        bool IsDescriptorBufferEnabled() const;
+        DescriptorBufferHeap* GetDescriptorBufferHeap() const;
+        const VkPhysicalDeviceDescriptorBufferPropertiesEXT& GetDescriptorBufferProperties() const;
+        // Size of a descriptor of the binding type in the descriptor buffer.
+        uint64_t GetDescriptorSize(BindingType bindingType) const;
+        // nullptr unless DeviceDesc::pipelineCacheDirectory is set.
+        PipelineCacheManager* GetPipelineCacheManager() const;
+        // The explicit cache if there is one, else the persistent cache of the calling thread.
+        VkPipelineCache GetPipelineCacheHandle(PipelineCacheBase* cache);
+        // nullptr unless VK_EXT_graphics_pipeline_library with fast linking is supported, render pipelines are then
+        // linked from cached library parts.
+        PipelineLibraryCache* GetPipelineLibraryCache() const;
 
         VulkanExtFunctions Fn{};
 
@@ -54,11 +88,25 @@ namespace rhi::impl::vulkan
         ~Device() override;
         bool Initialize(const DeviceDesc& desc);
         void LoadExtFunctions();
+        void TickImpl() override;
 
         VkDevice mHandle = VK_NULL_HANDLE;
 
         VmaAllocator mMemoryAllocator = VK_NULL_HANDLE;
 
         VkDeviceInfo mVkDeviceInfo{};
+
+        std::unique_ptr<TransientDescriptorAllocator> mTransientDescriptorAllocator;
+        std::unique_ptr<DescriptorBufferHeap> mDescriptorBufferHeap;
+        std::unique_ptr<PipelineCacheManager> mPipelineCacheManager;
+        std::unique_ptr<PipelineLibraryCache> mPipelineLibraryCache;
+
+        bool mPushDescriptorSupported = false;
+        bool mDescriptorBufferEnabled = false;
+        bool mGraphicsPipelineLibrarySupported = false;
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT mDescriptorBufferProperties{};
+
+        std::atomic<uint64_t> mTemplateDescriptorUpdates = 0;
+        std::atomic<uint64_t> mWriteDescriptorUpdates = 0;
     };
 } // namespace rhi::impl::vulkan
@@ -0,0 +1,207 @@
+#include "PipelineCacheManager.h"
+
+#include "../common/Error.h"
+#include "../common/WorkerTaskPool.h"
+#include "DeviceVk.h"
+#include "ErrorsVk.h"
+#include "PipelineCacheVk.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace rhi::impl::vulkan
+{
+    PipelineCacheManager::PipelineCacheManager(Device* device, std::string_view directory)
+        : mDevice(device)
+        , mDirectory(directory)
+    {}
+
+    PipelineCacheManager::~PipelineCacheManager()
+    {
+        if (mMergedCache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        // Drains a background save that is still queued.
+        mSaveThread = nullptr;
+        Save();
+
+        for (auto& [threadId, cache] : mThreadCaches)
+        {
+            vkDestroyPipelineCache(mDevice->GetHandle(), cache, nullptr);
+        }
+        vkDestroyPipelineCache(mDevice->GetHandle(), mMergedCache, nullptr);
+    }
+
+    bool PipelineCacheManager::Initialize()
+    {
+        std::error_code error;
+        std::filesystem::create_directories(mDirectory, error);
+        if (error)
+        {
+            LOG_ERROR("Could not create the pipeline cache directory ", mDirectory.string(), ": ", error.message());
+            return false;
+        }
+
+        const VkPhysicalDeviceProperties& properties = mDevice->GetVkDeviceInfo().properties;
+        std::ostringstream fileName;
+        fileName << "pipeline_cache_" << std::hex << std::setfill('0') << std::setw(4) << properties.vendorID << '_'
+                 << std::setw(4) << properties.deviceID << '_' << std::setw(8) << properties.driverVersion << '_';
+        for (uint8_t byte : properties.pipelineCacheUUID)
+        {
+            fileName << std::setw(2) << static_cast<uint32_t>(byte);
+        }
+        fileName << ".bin";
+        mFilePath = mDirectory / fileName.str();
+
+        std::ifstream file(mFilePath, std::ios::binary | std::ios::ate);
+        if (file)
+        {
+            mInitialData.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(mInitialData.data()), static_cast<std::streamsize>(mInitialData.size()));
+            // A truncated or foreign file is ignored and overwritten by the next save.
+            if (!file || !IsPipelineCacheDataCompatible(mDevice, mInitialData.data(), mInitialData.size()))
+            {
+                mInitialData.clear();
+            }
+        }
+        mLoadedBytes = mInitialData.size();
+        mLastSavedSize = mInitialData.size();
+
+        mMergedCache = CreateCache();
+        if (mMergedCache == VK_NULL_HANDLE)
+        {
+            return false;
+        }
+
+        mSaveThread = std::make_unique<WorkerTaskPool>(1);
+        mLastSaveTime = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    VkPipelineCache PipelineCacheManager::CreateCache() const
+    {
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pInitialData = mInitialData.data();
+        createInfo.initialDataSize = mInitialData.size();
+
+        VkPipelineCache cache = VK_NULL_HANDLE;
+        VkResult err = vkCreatePipelineCache(mDevice->GetHandle(), &createInfo, nullptr, &cache);
+        CHECK_VK_RESULT(err, "CreatePipelineCache");
+        return cache;
+    }
+
+    VkPipelineCache PipelineCacheManager::GetThreadCache()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto iter = mThreadCaches.find(std::this_thread::get_id());
+        if (iter != mThreadCaches.end())
+        {
+            return iter->second;
+        }
+
+        // Pipelines are still created without a cache if it could not be created.
+        VkPipelineCache cache = CreateCache();
+        if (cache != VK_NULL_HANDLE)
+        {
+            mThreadCaches.emplace(std::this_thread::get_id(), cache);
+        }
+        return cache;
+    }
+
+    void PipelineCacheManager::Tick()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - mLastSaveTime < cSaveInterval || mSaveInFlight.exchange(true))
+        {
+            return;
+        }
+        mLastSaveTime = now;
+
+        mSaveThread->PostTask(
+                [this]()
+                {
+                    Save();
+                    mSaveInFlight = false;
+                });
+    }
+
+    void PipelineCacheManager::Save()
+    {
+        std::lock_guard<std::mutex> saveLock(mSaveMutex);
+
+        // Thread caches live as long as the manager, only the map itself needs the lock.
+        std::vector<VkPipelineCache> threadCaches;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            threadCaches.reserve(mThreadCaches.size());
+            for (auto& [threadId, cache] : mThreadCaches)
+            {
+                threadCaches.push_back(cache);
+            }
+        }
+        if (!threadCaches.empty())
+        {
+            VkResult err = vkMergePipelineCaches(mDevice->GetHandle(),
+                                                 mMergedCache,
+                                                 static_cast<uint32_t>(threadCaches.size()),
+                                                 threadCaches.data());
+            CHECK_VK_RESULT_RETURN(err, "MergePipelineCaches");
+        }
+
+        size_t dataSize = 0;
+        VkResult err = vkGetPipelineCacheData(mDevice->GetHandle(), mMergedCache, &dataSize, nullptr);
+        CHECK_VK_RESULT_RETURN(err, "GetPipelineCacheData");
+        if (dataSize == mLastSavedSize)
+        {
+            mSkippedSaves.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::vector<uint8_t> data(dataSize);
+        err = vkGetPipelineCacheData(mDevice->GetHandle(), mMergedCache, &dataSize, data.data());
+        CHECK_VK_RESULT_RETURN(err, "GetPipelineCacheData");
+        data.resize(dataSize);
+
+        // The previous file is only replaced once the new one is complete, so a crash never leaves a truncated cache.
+        std::filesystem::path tempPath = mFilePath;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file)
+            {
+                LOG_ERROR("Could not write the pipeline cache ", tempPath.string());
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, mFilePath, error);
+        if (error)
+        {
+            LOG_ERROR("Could not replace the pipeline cache ", mFilePath.string(), ": ", error.message());
+            return;
+        }
+
+        mLastSavedSize = dataSize;
+        mSavedBytes.store(dataSize, std::memory_order_relaxed);
+        mSaveCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PipelineCacheManagerStats PipelineCacheManager::GetStats() const
+    {
+        PipelineCacheManagerStats stats{};
+        stats.loadedBytes = mLoadedBytes.load(std::memory_order_relaxed);
+        stats.savedBytes = mSavedBytes.load(std::memory_order_relaxed);
+        stats.saveCount = mSaveCount.load(std::memory_order_relaxed);
+        stats.skippedSaves = mSkippedSaves.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mMutex);
+        stats.threadCacheCount = mThreadCaches.size();
+        return stats;
+    }
+} // namespace rhi::impl::vulkan
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../common/NoCopyable.h"
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace rhi::impl
+{
+    class WorkerTaskPool;
+}
+
+namespace rhi::impl::vulkan
+{
+    class Device;
+
+    struct PipelineCacheManagerStats
+    {
+        uint64_t loadedBytes;
+        uint64_t savedBytes;
+        uint64_t saveCount;
+        // Saves skipped because the caches did not grow since the previous save.
+        uint64_t skippedSaves;
+        uint64_t threadCacheCount;
+    };
+
+    // Backs every pipeline created without an explicit PipelineCache with a cache persisted in a directory. The file
+    // name is derived from the vendor, device, driver version and pipeline cache UUID, so a driver update starts from
+    // an empty cache. Every thread compiling pipelines gets a cache of its own, they are merged with
+    // vkMergePipelineCaches whenever the cache is saved.
+    class PipelineCacheManager : public NonCopyable
+    {
+    public:
+        PipelineCacheManager(Device* device, std::string_view directory);
+        // Writes the cache a last time.
+        ~PipelineCacheManager();
+
+        bool Initialize();
+        VkPipelineCache GetThreadCache();
+        // Saves the cache on a background thread once the save interval elapsed since the previous save.
+        void Tick();
+
+        PipelineCacheManagerStats GetStats() const;
+
+    private:
+        VkPipelineCache CreateCache() const;
+        void Save();
+
+        static constexpr std::chrono::seconds cSaveInterval{30};
+
+        Device* mDevice;
+        std::filesystem::path mDirectory;
+        std::filesystem::path mFilePath;
+        // Content of the cache file, every thread cache starts from it.
+        std::vector<uint8_t> mInitialData;
+
+        mutable std::mutex mMutex;
+        std::unordered_map<std::thread::id, VkPipelineCache> mThreadCaches;
+
+        std::mutex mSaveMutex;
+        // Merge target of the thread caches, only used while saving.
+        VkPipelineCache mMergedCache = VK_NULL_HANDLE;
+        size_t mLastSavedSize = 0;
+
+        std::unique_ptr<WorkerTaskPool> mSaveThread;
+        std::chrono::steady_clock::time_point mLastSaveTime;
+        std::atomic<bool> mSaveInFlight = false;
+
+        std::atomic<uint64_t> mLoadedBytes = 0;
+        std::atomic<uint64_t> mSavedBytes = 0;
+        std::atomic<uint64_t> mSaveCount = 0;
+        std::atomic<uint64_t> mSkippedSaves = 0;
+    };
+} // namespace rhi::impl::vulkan
@@ -8,6 +8,26 @@
 
 namespace rhi::impl::vulkan
 {
+    bool IsPipelineCacheDataCompatible(const Device* device, const void* data, size_t dataSize)
+    {
+        if (data == nullptr || dataSize <= sizeof(VkPipelineCacheHeaderVersionOne))
+        {
+            return false;
+        }
+
+        const auto& vkProps = device->GetVkDeviceInfo().properties;
+
+        VkPipelineCacheHeaderVersionOne HeaderVersion;
+        std::memcpy(&HeaderVersion, data, sizeof(HeaderVersion));
+
+        return HeaderVersion.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               HeaderVersion.headerSize == 32 && // from specs
+               HeaderVersion.deviceID == vkProps.deviceID && HeaderVersion.vendorID == vkProps.vendorID &&
+               std::memcmp(HeaderVersion.pipelineCacheUUID,
+                           vkProps.pipelineCacheUUID,
+                           sizeof(HeaderVersion.pipelineCacheUUID)) == 0;
+    }
+
     Ref<PipelineCache> PipelineCache::Create(DeviceBase* device, const PipelineCacheDesc& desc)
     {
         Ref<PipelineCache> pipelineCache = AcquireRef(new PipelineCache(device, desc));
@@ -42,22 +62,10 @@ namespace rhi::impl::vulkan
         VkPipelineCacheCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
-        if (desc.data != nullptr && desc.dataSize > sizeof(VkPipelineCacheHeaderVersionOne))
+        if (IsPipelineCacheDataCompatible(device, desc.data, desc.dataSize))
         {
-            const auto& vkProps = device->GetVkDeviceInfo().properties;
-
-            VkPipelineCacheHeaderVersionOne HeaderVersion;
-            std::memcpy(&HeaderVersion, desc.data, sizeof(HeaderVersion));
-
-            if (HeaderVersion.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
-                HeaderVersion.headerSize == 32 && // from specs
-                HeaderVersion.deviceID == vkProps.deviceID && HeaderVersion.vendorID == vkProps.vendorID &&
-                std::memcmp(
-                        HeaderVersion.pipelineCacheUUID, vkProps.pipelineCacheUUID, sizeof(HeaderVersion.pipelineCacheUUID)) == 0)
-            {
-                createInfo.pInitialData = desc.data;
-                createInfo.initialDataSize = desc.dataSize;
-            }
+            createInfo.pInitialData = desc.data;
+            createInfo.initialDataSize = desc.dataSize;
         }
 
         VkResult err = vkCreatePipelineCache(device->GetHandle(), &createInfo, nullptr, &mHandle);
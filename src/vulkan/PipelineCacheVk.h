@@ -6,6 +6,11 @@
 
 namespace rhi::impl::vulkan
 {
+    class Device;
+
+    // Whether the header of the cache data matches the physical device, other data must not be passed to the driver.
+    bool IsPipelineCacheDataCompatible(const Device* device, const void* data, size_t dataSize);
+
     class PipelineCache final : public PipelineCacheBase
     {
     public:
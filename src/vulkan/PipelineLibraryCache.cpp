@@ -0,0 +1,110 @@
+#include "PipelineLibraryCache.h"
+
+#include "../common/Error.h"
+#include "DeviceVk.h"
+
+namespace rhi::impl::vulkan
+{
+    void PipelineLibraryKey::RecordObject(ResourceBase* object)
+    {
+        Record(reinterpret_cast<uintptr_t>(object));
+        mReferences.emplace_back(object);
+    }
+
+    bool PipelineLibraryKey::operator==(const PipelineLibraryKey& other) const
+    {
+        return mBytes == other.mBytes;
+    }
+
+    size_t PipelineLibraryKey::Hash::operator()(const PipelineLibraryKey& key) const
+    {
+        return std::hash<std::string>{}(key.mBytes);
+    }
+
+    PipelineLibraryCache::PipelineLibraryCache(Device* device) : mDevice(device) {}
+
+    PipelineLibraryCache::~PipelineLibraryCache()
+    {
+        // The device waited for idle, no linked pipeline is in use anymore.
+        for (LibraryMap& libraries : mLibraries)
+        {
+            for (auto& [key, library] : libraries)
+            {
+                vkDestroyPipeline(mDevice->GetHandle(), library.handle, nullptr);
+            }
+        }
+    }
+
+    VkPipeline PipelineLibraryCache::GetOrCreate(PipelineLibraryPart part,
+                                                 PipelineLibraryKey key,
+                                                 const std::function<VkPipeline()>& createFunc)
+    {
+        LibraryMap& libraries = mLibraries[static_cast<uint32_t>(part)];
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto iter = libraries.find(key);
+            if (iter != libraries.end())
+            {
+                mHits.fetch_add(1, std::memory_order_relaxed);
+                ++iter->second.refCount;
+                return iter->second.handle;
+            }
+        }
+        mMisses.fetch_add(1, std::memory_order_relaxed);
+
+        // Compiled without the lock, another thread may have cached the same library in the meantime.
+        VkPipeline library = createFunc();
+        if (library == VK_NULL_HANDLE)
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto [iter, inserted] = libraries.emplace(std::move(key), Library{library, 0});
+        if (!inserted)
+        {
+            vkDestroyPipeline(mDevice->GetHandle(), library, nullptr);
+        }
+        ++iter->second.refCount;
+        return iter->second.handle;
+    }
+
+    void PipelineLibraryCache::Release(PipelineLibraryPart part, const PipelineLibraryKey& key)
+    {
+        LibraryMap& libraries = mLibraries[static_cast<uint32_t>(part)];
+        VkPipeline library;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto iter = libraries.find(key);
+            ASSERT(iter != libraries.end() && iter->second.refCount > 0);
+            if (--iter->second.refCount > 0)
+            {
+                return;
+            }
+            library = iter->second.handle;
+            // Drops the references the key holds on layouts and shader modules.
+            libraries.erase(iter);
+        }
+        vkDestroyPipeline(mDevice->GetHandle(), library, nullptr);
+    }
+
+    void PipelineLibraryCache::AddLink(bool optimized)
+    {
+        (optimized ? mOptimizedLinks : mFastLinks).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PipelineLibraryStats PipelineLibraryCache::GetStats() const
+    {
+        PipelineLibraryStats stats{};
+        stats.hits = mHits.load(std::memory_order_relaxed);
+        stats.misses = mMisses.load(std::memory_order_relaxed);
+        stats.fastLinks = mFastLinks.load(std::memory_order_relaxed);
+        stats.optimizedLinks = mOptimizedLinks.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const LibraryMap& libraries : mLibraries)
+        {
+            stats.libraryCount += libraries.size();
+        }
+        return stats;
+    }
+} // namespace rhi::impl::vulkan
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../common/NoCopyable.h"
+#include "../common/Ref.hpp"
+#include "../common/ResourceBase.h"
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace rhi::impl::vulkan
+{
+    class Device;
+
+    enum class PipelineLibraryPart : uint32_t
+    {
+        VertexInput,
+        PreRasterizationShaders,
+        FragmentShader,
+        FragmentOutput,
+        Count
+    };
+
+    // The state a library part was compiled from, recorded field by field so keys compare exactly. Layouts and shader
+    // modules are keyed by address, the key keeps them alive while the part is cached so an address is never reused
+    // for another object.
+    class PipelineLibraryKey
+    {
+    public:
+        template <typename T>
+        void Record(const T& value)
+        {
+            static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Only scalars can be recorded.");
+            mBytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void RecordObject(ResourceBase* object);
+
+        bool operator==(const PipelineLibraryKey& other) const;
+
+        struct Hash
+        {
+            size_t operator()(const PipelineLibraryKey& key) const;
+        };
+
+    private:
+        std::string mBytes;
+        std::vector<Ref<ResourceBase>> mReferences;
+    };
+
+    struct PipelineLibraryStats
+    {
+        // Library parts reused by another render pipeline.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t libraryCount;
+        uint64_t fastLinks;
+        // Fast linked pipelines replaced by a link time optimized one in the background.
+        uint64_t optimizedLinks;
+    };
+
+    // Library parts of VK_EXT_graphics_pipeline_library shared by every render pipeline of the device. A part is
+    // destroyed once the last render pipeline using it released it, linked pipelines do not depend on their libraries.
+    class PipelineLibraryCache : public NonCopyable
+    {
+    public:
+        explicit PipelineLibraryCache(Device* device);
+        ~PipelineLibraryCache();
+
+        // Returns VK_NULL_HANDLE if the library is not cached and createFunc failed. Every returned library has to be
+        // released with Release.
+        VkPipeline GetOrCreate(PipelineLibraryPart part,
+                               PipelineLibraryKey key,
+                               const std::function<VkPipeline()>& createFunc);
+        void Release(PipelineLibraryPart part, const PipelineLibraryKey& key);
+        void AddLink(bool optimized);
+
+        PipelineLibraryStats GetStats() const;
+
+    private:
+        struct Library
+        {
+            VkPipeline handle;
+            uint32_t refCount;
+        };
+        using LibraryMap = std::unordered_map<PipelineLibraryKey, Library, PipelineLibraryKey::Hash>;
+
+        Device* mDevice;
+
+        mutable std::mutex mMutex;
+        std::array<LibraryMap, static_cast<uint32_t>(PipelineLibraryPart::Count)> mLibraries;
+
+        std::atomic<uint64_t> mHits = 0;
+        std::atomic<uint64_t> mMisses = 0;
+        std::atomic<uint64_t> mFastLinks = 0;
+        std::atomic<uint64_t> mOptimizedLinks = 0;
+    };
+} // namespace rhi::impl::vulkan
@@ -8,6 +8,9 @@
 #include "ErrorsVk.h"
 #include "TextureVk.h"
 #include "VulkanUtils.h"
+#include "common/WorkerTaskPool.h"
+
+#include <atomic>
 
 namespace rhi::impl::vulkan
 {
@@ -33,6 +36,8 @@ namespace rhi::impl::vulkan
     {
         Device* device = checked_cast<Device>(mDevice);
 
+        WaitForPendingSubmissions();
+        StopCompletionThread();
         TickImpl(UINT64_MAX);
 
         mRecordContext.needsSubmit = false;
@@ -40,6 +45,11 @@ namespace rhi::impl::vulkan
         {
             vkDestroyCommandPool(device->GetHandle(), mRecordContext.commandBufferAndPool.poolHandle, nullptr);
         }
+        for (CommandPoolAndBuffer& poolAndBuffer : mRecordContext.recordedCommandBuffers)
+        {
+            vkDestroyCommandPool(device->GetHandle(), poolAndBuffer.poolHandle, nullptr);
+        }
+        mRecordContext.recordedCommandBuffers.clear();
 
         ASSERT(mCommandBufferInFlight.Empty());
 
@@ -50,6 +60,8 @@ namespace rhi::impl::vulkan
         mUnusedCommandBuffer.clear();
 
         mUploadAllocator = nullptr;
+        mUniformRingAllocator = nullptr;
+        mReadbackAllocator = nullptr;
 
         vkDestroySemaphore(device->GetHandle(), mTrackingSubmitSemaphore, nullptr);
     }
@@ -58,6 +70,7 @@ namespace rhi::impl::vulkan
     {
         SetTrackingSubmitSemaphore();
         NextRecordingContext();
+        StartCompletionThread();
     }
 
     void Queue::SetTrackingSubmitSemaphore()
@@ -92,14 +105,43 @@ namespace rhi::impl::vulkan
         return completedSerial;
     }
 
+    SerialWaitResult Queue::WaitForSerialImpl(uint64_t serial, uint64_t timeoutNs)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &mTrackingSubmitSemaphore;
+        waitInfo.pValues = &serial;
+
+        VkResult err = vkWaitSemaphores(device->GetHandle(), &waitInfo, timeoutNs);
+        if (err == VK_TIMEOUT)
+        {
+            return SerialWaitResult::TimedOut;
+        }
+        if (err != VK_SUCCESS)
+        {
+            CHECK_VK_RESULT(err, "vkWaitSemaphores");
+            return SerialWaitResult::Failed;
+        }
+        return SerialWaitResult::Completed;
+    }
+
     CommandPoolAndBuffer Queue::GetOrCreateCommandPoolAndBuffer()
     {
         Device* device = checked_cast<Device>(mDevice);
         CommandPoolAndBuffer poolAndBuffer;
-        if (!mUnusedCommandBuffer.empty())
         {
-            poolAndBuffer = mUnusedCommandBuffer.back();
-            mUnusedCommandBuffer.pop_back();
+            std::lock_guard<std::mutex> lock(mCommandBufferMutex);
+            if (!mUnusedCommandBuffer.empty())
+            {
+                poolAndBuffer = mUnusedCommandBuffer.back();
+                mUnusedCommandBuffer.pop_back();
+            }
+        }
+        if (poolAndBuffer.poolHandle != VK_NULL_HANDLE)
+        {
             VkResult err = vkResetCommandPool(device->GetHandle(), poolAndBuffer.poolHandle, 0);
             CHECK_VK_RESULT(err, "vkResetCommandPool");
         }
@@ -112,7 +154,11 @@ namespace rhi::impl::vulkan
             createInfo.queueFamilyIndex = mQueueFamilyIndex;
 
             VkResult err = vkCreateCommandPool(device->GetHandle(), &createInfo, nullptr, &poolAndBuffer.poolHandle);
-            CHECK_VK_RESULT(err, "vkCreateCommandPool");
+            if (err != VK_SUCCESS)
+            {
+                CHECK_VK_RESULT(err, "vkCreateCommandPool");
+                return {};
+            }
 
             VkCommandBufferAllocateInfo allocateInfo;
             allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -122,19 +168,24 @@ namespace rhi::impl::vulkan
             allocateInfo.commandBufferCount = 1;
 
             err = vkAllocateCommandBuffers(device->GetHandle(), &allocateInfo, &poolAndBuffer.bufferHandle);
-            CHECK_VK_RESULT(err, "vkAllocateCommandBuffers");
+            if (err != VK_SUCCESS)
+            {
+                CHECK_VK_RESULT(err, "vkAllocateCommandBuffers");
+                vkDestroyCommandPool(device->GetHandle(), poolAndBuffer.poolHandle, nullptr);
+                return {};
+            }
         }
 
         return poolAndBuffer;
     }
 
-    void Queue::NextRecordingContext()
+    CommandPoolAndBuffer Queue::BeginCommandPoolAndBuffer()
     {
-        ASSERT(mRecordContext.needsSubmit != true);
-        ASSERT(mRecordContext.commandBufferAndPool.bufferHandle == VK_NULL_HANDLE &&
-               mRecordContext.commandBufferAndPool.poolHandle == VK_NULL_HANDLE);
-
         CommandPoolAndBuffer poolAndBuffer = GetOrCreateCommandPoolAndBuffer();
+        if (poolAndBuffer.bufferHandle == VK_NULL_HANDLE)
+        {
+            return {};
+        }
 
         VkCommandBufferBeginInfo beginInfo;
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -142,9 +193,36 @@ namespace rhi::impl::vulkan
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         beginInfo.pInheritanceInfo = nullptr;
         VkResult err = vkBeginCommandBuffer(poolAndBuffer.bufferHandle, &beginInfo);
-        CHECK_VK_RESULT_RETURN(err, "vkBeginCommandBuffer");
+        if (err != VK_SUCCESS)
+        {
+            CHECK_VK_RESULT(err, "vkBeginCommandBuffer");
+            // The pool is reset before its next use, so it can be used again.
+            RecycleCommandPoolAndBuffers(&poolAndBuffer, 1);
+            return {};
+        }
+
+        return poolAndBuffer;
+    }
+
+    void Queue::RecycleCommandPoolAndBuffers(const CommandPoolAndBuffer* poolAndBuffers, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mCommandBufferMutex);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (poolAndBuffers[i].poolHandle != VK_NULL_HANDLE)
+            {
+                mUnusedCommandBuffer.push_back(poolAndBuffers[i]);
+            }
+        }
+    }
+
+    void Queue::NextRecordingContext()
+    {
+        ASSERT(mRecordContext.needsSubmit != true);
+        ASSERT(mRecordContext.commandBufferAndPool.bufferHandle == VK_NULL_HANDLE &&
+               mRecordContext.commandBufferAndPool.poolHandle == VK_NULL_HANDLE);
 
-        mRecordContext.commandBufferAndPool = poolAndBuffer;
+        mRecordContext.commandBufferAndPool = BeginCommandPoolAndBuffer();
     }
 
     void Queue::SubmitPendingCommands(VkFence frameDoneFence)
@@ -155,6 +233,29 @@ namespace rhi::impl::vulkan
         }
 
         VkCommandBuffer commandBuffer = mRecordContext.commandBufferAndPool.bufferHandle;
+        if (commandBuffer == VK_NULL_HANDLE)
+        {
+            LOG_ERROR("The pending command buffer could not be begun, its commands are not submitted.");
+            return;
+        }
+
+        if (mRecordContext.needsHostReadBarrier)
+        {
+            // Covers every readback copy recorded before it in submission order, not only those of this command
+            // buffer.
+            VkMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+            VkDependencyInfo dependencyInfo{};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependencyInfo.memoryBarrierCount = 1;
+            dependencyInfo.pMemoryBarriers = &barrier;
+            vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+        }
 
         VkResult err = vkEndCommandBuffer(commandBuffer);
         CHECK_VK_RESULT_RETURN(err, "vkEndCommandBuffer");
@@ -163,17 +264,23 @@ namespace rhi::impl::vulkan
         trackingSemaphore.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
         trackingSemaphore.pNext = nullptr;
         trackingSemaphore.semaphore = mTrackingSubmitSemaphore;
-        trackingSemaphore.value = GetPendingSubmitSerial();
+        trackingSemaphore.value = GetLastSubmittedSerial() + 1;
         trackingSemaphore.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
 
-        VkCommandBufferSubmitInfo commandBufferInfo{};
-        commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-        commandBufferInfo.commandBuffer = commandBuffer;
+        std::vector<VkCommandBufferSubmitInfo> commandBufferInfos(mRecordContext.recordedCommandBuffers.size() + 1);
+        for (size_t i = 0; i < commandBufferInfos.size(); ++i)
+        {
+            VkCommandBufferSubmitInfo& commandBufferInfo = commandBufferInfos[i];
+            commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            commandBufferInfo.commandBuffer = i < mRecordContext.recordedCommandBuffers.size()
+                                                      ? mRecordContext.recordedCommandBuffers[i].bufferHandle
+                                                      : commandBuffer;
+        }
 
         VkSubmitInfo2 submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-        submitInfo.commandBufferInfoCount = 1;
-        submitInfo.pCommandBufferInfos = &commandBufferInfo;
+        submitInfo.commandBufferInfoCount = static_cast<uint32_t>(commandBufferInfos.size());
+        submitInfo.pCommandBufferInfos = commandBufferInfos.data();
         submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(mRecordContext.signalSemaphoreSubmitInfos.size());
         submitInfo.pSignalSemaphoreInfos = mRecordContext.signalSemaphoreSubmitInfos.data();
         submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(mRecordContext.waitSemaphoreSubmitInfos.size());
@@ -182,8 +289,13 @@ namespace rhi::impl::vulkan
         err = vkQueueSubmit2(mHandle, 1, &submitInfo, frameDoneFence);
         CHECK_VK_RESULT_RETURN(err, "vkQueueSubmit2");
 
-        mLastSubmittedSerial.fetch_add(1u, std::memory_order_release);
+        IncrementLastSubmittedSerial();
 
+        std::lock_guard<std::mutex> lock(mCommandBufferMutex);
+        for (CommandPoolAndBuffer& poolAndBuffer : mRecordContext.recordedCommandBuffers)
+        {
+            mCommandBufferInFlight.Push(GetLastSubmittedSerial(), poolAndBuffer);
+        }
         mCommandBufferInFlight.Push(GetLastSubmittedSerial(), mRecordContext.commandBufferAndPool);
 
         mRecordContext.Reset();
@@ -195,9 +307,30 @@ namespace rhi::impl::vulkan
                                ResourceTransfer const* transfers,
                                uint32_t transferCount)
     {
-        for (uint32_t i = 0; i < commandListCount; ++i)
+        CommandRecordContext* recordContext = GetPendingRecordingContext();
+        if (recordContext->commandBufferAndPool.bufferHandle == VK_NULL_HANDLE)
         {
-            checked_cast<CommandList>(commands[i])->RecordCommands(this);
+            // Beginning it failed last time, nothing can be recorded until it succeeds.
+            recordContext->commandBufferAndPool = BeginCommandPoolAndBuffer();
+            if (recordContext->commandBufferAndPool.bufferHandle == VK_NULL_HANDLE)
+            {
+                return GetLastSubmittedSerial();
+            }
+        }
+
+        if (mDevice->GetCommandRecordingPool() != nullptr && commandListCount > 1)
+        {
+            if (!RecordCommandListsInParallel(commands, commandListCount))
+            {
+                return GetLastSubmittedSerial();
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < commandListCount; ++i)
+            {
+                checked_cast<CommandList>(commands[i])->RecordCommands(this);
+            }
         }
 
         for (uint32_t i = 0; i < transferCount; ++i)
@@ -231,25 +364,92 @@ namespace rhi::impl::vulkan
         return GetLastSubmittedSerial();
     }
 
+    bool Queue::RecordCommandListsInParallel(CommandListBase* const* commands, uint32_t commandListCount)
+    {
+        CommandRecordContext* recordContext = GetPendingRecordingContext();
+
+        // Resource state tracking depends on the submission order, so it stays on this thread.
+        for (uint32_t i = 0; i < commandListCount; ++i)
+        {
+            checked_cast<CommandList>(commands[i])->PrepareBarriers(this);
+        }
+
+        std::vector<CommandPoolAndBuffer> commandBuffers(commandListCount);
+        for (uint32_t i = 0; i < commandListCount; ++i)
+        {
+            commandBuffers[i] = BeginCommandPoolAndBuffer();
+            if (commandBuffers[i].bufferHandle == VK_NULL_HANDLE)
+            {
+                RecycleCommandPoolAndBuffers(commandBuffers.data(), i);
+                return false;
+            }
+        }
+
+        std::atomic<bool> recordFailed = false;
+        mDevice->GetCommandRecordingPool()->ParallelFor(
+                commandListCount,
+                [&](uint32_t i)
+                {
+                    VkCommandBuffer commandBuffer = commandBuffers[i].bufferHandle;
+                    checked_cast<CommandList>(commands[i])->RecordPreparedCommands(this, commandBuffer);
+                    VkResult err = vkEndCommandBuffer(commandBuffer);
+                    if (err != VK_SUCCESS)
+                    {
+                        CHECK_VK_RESULT(err, "vkEndCommandBuffer");
+                        recordFailed = true;
+                    }
+                });
+        // None of the command lists is submitted if one of them could not be recorded.
+        if (recordFailed)
+        {
+            RecycleCommandPoolAndBuffers(commandBuffers.data(), commandBuffers.size());
+            return false;
+        }
+
+        // Whatever was recorded before the command lists, e.g. staging copies, has to execute first.
+        VkResult err = vkEndCommandBuffer(recordContext->commandBufferAndPool.bufferHandle);
+        if (err != VK_SUCCESS)
+        {
+            CHECK_VK_RESULT(err, "vkEndCommandBuffer");
+            RecycleCommandPoolAndBuffers(commandBuffers.data(), commandBuffers.size());
+            RecycleCommandPoolAndBuffers(&recordContext->commandBufferAndPool, 1);
+            recordContext->commandBufferAndPool = BeginCommandPoolAndBuffer();
+            return false;
+        }
+        recordContext->recordedCommandBuffers.push_back(recordContext->commandBufferAndPool);
+        recordContext->recordedCommandBuffers.insert(
+                recordContext->recordedCommandBuffers.end(), commandBuffers.begin(), commandBuffers.end());
+
+        recordContext->commandBufferAndPool = BeginCommandPoolAndBuffer();
+        return true;
+    }
+
     void Queue::TickImpl(uint64_t completedSerial)
     {
         mDeleter->Tick(completedSerial);
 
+        // Allocators may schedule themselves again while finishing, so they are called outside of the lock.
+        std::vector<Ref<DescriptorSetAllocator>> allocators;
         mDescriptorAllocatorsPendingDeallocation.Use(
                 [&](auto pending)
                 {
                     for (Ref<DescriptorSetAllocator>& allocator : pending->IterateUpTo(completedSerial))
                     {
-                        allocator->FinishDeallocation(this, completedSerial);
+                        allocators.push_back(std::move(allocator));
                     }
                     pending->ClearUpTo(completedSerial);
                 });
+        for (Ref<DescriptorSetAllocator>& allocator : allocators)
+        {
+            allocator->FinishDeallocation(this, completedSerial);
+        }
 
         RecycleCompletedCommandBuffer(completedSerial);
     }
 
     void Queue::RecycleCompletedCommandBuffer(uint64_t completedSerial)
     {
+        std::lock_guard<std::mutex> lock(mCommandBufferMutex);
         for (auto& commands : mCommandBufferInFlight.IterateUpTo(completedSerial))
         {
             mUnusedCommandBuffer.push_back(commands);
@@ -267,6 +467,11 @@ namespace rhi::impl::vulkan
         GetPendingRecordingContext()->needsSubmit = true;
     }
 
+    void Queue::FlushPendingCommands()
+    {
+        SubmitPendingCommands();
+    }
+
     uint32_t Queue::GetQueueFamilyIndex() const
     {
         return mQueueFamilyIndex;
@@ -339,6 +544,53 @@ namespace rhi::impl::vulkan
                                &region);
     }
 
+    void Queue::CopyFromBufferToStagingImpl(
+            BufferBase* src, uint64_t srcOffset, BufferBase* dst, uint64_t dstOffset, uint64_t size)
+    {
+        CommandRecordContext* recordContext = GetPendingRecordingContext();
+
+        Buffer* srcBuffer = checked_cast<Buffer>(src);
+        srcBuffer->TransitionUsageNow(this, BufferUsage::CopySrc);
+
+        VkBufferCopy copy;
+        copy.srcOffset = srcOffset;
+        copy.dstOffset = dstOffset;
+        copy.size = size;
+
+        vkCmdCopyBuffer(recordContext->commandBufferAndPool.bufferHandle,
+                        srcBuffer->GetHandle(),
+                        checked_cast<Buffer>(dst)->GetHandle(),
+                        1,
+                        &copy);
+        recordContext->needsHostReadBarrier = true;
+    }
+
+    void Queue::CopyFromTextureToStagingImpl(const TextureSlice& src,
+                                             BufferBase* dst,
+                                             const TextureDataLayout& dataLayout)
+    {
+        CommandRecordContext* recordContext = GetPendingRecordingContext();
+
+        Texture* texture = checked_cast<Texture>(src.texture);
+
+        Aspect aspect = AspectConvert(texture->APIGetFormat(), src.aspect);
+
+        VkBufferImageCopy region =
+                ComputeBufferImageCopyRegion(dataLayout, src.size, texture, src.mipLevel, src.origin, aspect);
+
+        SubresourceRange range = {aspect, src.origin.z, src.size.depthOrArrayLayers, src.mipLevel, 1};
+
+        texture->TransitionUsageNow(this, TextureUsage::CopySrc, range);
+
+        vkCmdCopyImageToBuffer(recordContext->commandBufferAndPool.bufferHandle,
+                               texture->GetHandle(),
+                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               checked_cast<Buffer>(dst)->GetHandle(),
+                               1,
+                               &region);
+        recordContext->needsHostReadBarrier = true;
+    }
+
     void Queue::WaitForImpl(QueueBase* queue, uint64_t submitSerial)
     {
         Queue* waitQueue = checked_cast<Queue>(queue);
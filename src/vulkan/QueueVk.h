@@ -11,6 +11,7 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <memory>
+#include <mutex>
 
 
 namespace rhi::impl::vulkan
@@ -23,6 +24,7 @@ namespace rhi::impl::vulkan
     public:
         static Ref<Queue> Create(Device* device, uint32_t family, QueueType type);
         // internal 
+        // Outside of a submit, only used through QueueBase::EnqueueRecording and EnqueueSubmit.
         CommandRecordContext* GetPendingRecordingContext();
         MutexProtected<VkResourceDeleter>& GetDeleter();
         Device* GetDevice() const;
@@ -43,7 +45,9 @@ namespace rhi::impl::vulkan
                             ResourceTransfer const* transfers,
                             uint32_t transferCount) override;
         uint64_t QueryCompletedSerial() override;
+        SerialWaitResult WaitForSerialImpl(uint64_t serial, uint64_t timeoutNs) override;
         void MarkRecordingContextIsUsed() override;
+        void FlushPendingCommands() override;
         void CopyFromStagingToBufferImpl(BufferBase* src,
                                          uint64_t srcOffset,
                                          BufferBase* dst,
@@ -52,11 +56,25 @@ namespace rhi::impl::vulkan
         void CopyFromStagingToTextureImpl(BufferBase* src,
                                           const TextureSlice& dst,
                                           const TextureDataLayout& dataLayout) override;
+        void CopyFromBufferToStagingImpl(BufferBase* src,
+                                         uint64_t srcOffset,
+                                         BufferBase* dst,
+                                         uint64_t dstOffset,
+                                         uint64_t size) override;
+        void CopyFromTextureToStagingImpl(const TextureSlice& src,
+                                          BufferBase* dst,
+                                          const TextureDataLayout& dataLayout) override;
         void WaitForImpl(QueueBase* queue, uint64_t submitSerial) override;
         void RecycleCompletedCommandBuffer(uint64_t completedSerial);
         void SetTrackingSubmitSemaphore();
+        // Return null handles on failure.
         CommandPoolAndBuffer GetOrCreateCommandPoolAndBuffer();
+        CommandPoolAndBuffer BeginCommandPoolAndBuffer();
+        // Makes pools that were not submitted available again.
+        void RecycleCommandPoolAndBuffers(const CommandPoolAndBuffer* poolAndBuffers, size_t count);
         void NextRecordingContext();
+        // Returns false without recording anything to submit if a command buffer could not be begun or ended.
+        bool RecordCommandListsInParallel(CommandListBase* const* commands, uint32_t commandListCount);
 
         uint32_t mQueueFamilyIndex;
 
@@ -66,6 +84,9 @@ namespace rhi::impl::vulkan
 
         CommandRecordContext mRecordContext;
 
+        // Guards the command buffers below, which the submission thread uses while the queue is ticked.
+        std::mutex mCommandBufferMutex;
+
         SerialQueue<uint64_t, CommandPoolAndBuffer> mCommandBufferInFlight;
 
         std::vector<CommandPoolAndBuffer> mUnusedCommandBuffer;
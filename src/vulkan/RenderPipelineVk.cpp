@@ -4,6 +4,7 @@
 #include "../common/EnumFlagIterator.hpp"
 #include "DeviceVk.h"
 #include "ErrorsVk.h"
+#include "PipelineLibraryCache.h"
 #include "PipelineLayoutVk.h"
 #include "ShaderModuleVk.h"
 #include "TextureVk.h"
@@ -256,7 +257,7 @@ namespace rhi::impl::vulkan
         }
     }
 
-    bool RenderPipeline::Initialize(PipelineCacheBase* cache)
+    bool RenderPipeline::InitializeImpl(PipelineCacheBase* cache)
     {
         // shader stage
         ASSERT(HasShaderStage(ShaderStage::Vertex));
@@ -411,7 +412,7 @@ namespace rhi::impl::vulkan
         VkSampleMask sampleMask = mSampleState.mask;
         multisampleStateCI.pSampleMask = &sampleMask;
         multisampleStateCI.alphaToOneEnable = false;
-        VkDynamicState dynamicStates[] = {
+        std::vector<VkDynamicState> dynamicStates = {
                 VK_DYNAMIC_STATE_VIEWPORT,
                 VK_DYNAMIC_STATE_SCISSOR,
                 /*VK_DYNAMIC_STATE_LINE_WIDTH, */
@@ -419,10 +420,25 @@ namespace rhi::impl::vulkan
                 VK_DYNAMIC_STATE_DEPTH_BOUNDS,
                 VK_DYNAMIC_STATE_STENCIL_REFERENCE,
         };
+        if (mExtendedDynamicState)
+        {
+            // Core in Vulkan 1.3, no extension is needed.
+            dynamicStates.insert(dynamicStates.end(),
+                                 {
+                                         VK_DYNAMIC_STATE_CULL_MODE,
+                                         VK_DYNAMIC_STATE_FRONT_FACE,
+                                         VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+                                         VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+                                         VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+                                         VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+                                         VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE,
+                                         VK_DYNAMIC_STATE_STENCIL_OP,
+                                 });
+        }
         VkPipelineDynamicStateCreateInfo dynamicStateCI{};
         dynamicStateCI.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicStateCI.dynamicStateCount = sizeof(dynamicStates) / sizeof(dynamicStates[0]);
-        dynamicStateCI.pDynamicStates = dynamicStates;
+        dynamicStateCI.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicStateCI.pDynamicStates = dynamicStates.data();
 
         // Viewport state sets the number of viewports and scissor used in this pipeline
         // Note: This is actually overridden by the dynamic states
@@ -462,39 +478,366 @@ namespace rhi::impl::vulkan
         createInfo.pNext = &pipelineRenderingCI;
 
         Device* device = checked_cast<Device>(mDevice);
-        VkPipelineCache vkPipelineCache = cache != nullptr ? checked_cast<PipelineCache>(cache)->GetHandle() : nullptr;
-        VkResult err = vkCreateGraphicsPipelines(device->GetHandle(), vkPipelineCache, 1, &createInfo, nullptr, &mHandle);
+        if (device->IsDescriptorBufferEnabled())
+        {
+            createInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+
+        if (device->GetPipelineLibraryCache() != nullptr)
+        {
+            return InitializeFromLibraries(createInfo, pipelineRenderingCI, cache);
+        }
+
+        VkPipelineCache vkPipelineCache = device->GetPipelineCacheHandle(cache);
+        VkPipeline handle = VK_NULL_HANDLE;
+        VkResult err = vkCreateGraphicsPipelines(device->GetHandle(), vkPipelineCache, 1, &createInfo, nullptr, &handle);
         CHECK_VK_RESULT_FALSE(err, "CreateGraphicsPipelines");
+        mHandle.store(handle, std::memory_order_release);
+
+        SetDebugName(device, handle, "RenderPipeline", GetName());
+
+        return true;
+    }
+
+    void RecordStencilOpState(PipelineLibraryKey* key, const StencilOpState& state)
+    {
+        key->Record(state.failOp);
+        key->Record(state.passOp);
+        key->Record(state.depthFailOp);
+        key->Record(state.compareOp);
+        key->Record(state.compareMak);
+        key->Record(state.writeMask);
+        key->Record(state.referenceValue);
+    }
+
+    PipelineLibraryKey RenderPipeline::GetLibraryKey(PipelineLibraryPart part) const
+    {
+        PipelineLibraryKey key;
+        auto recordStage = [&](ShaderStage stage)
+        {
+            if (!HasShaderStage(stage))
+            {
+                return;
+            }
+            const ShaderStageState& state = GetShaderStageState(stage);
+            key.Record(stage);
+            // Modules are deduplicated by content, the same code is always the same module.
+            key.RecordObject(state.shaderModule.Get());
+            key.Record(state.constants.size());
+            for (const SpecializationConstant& constant : state.constants)
+            {
+                key.Record(constant.constantID);
+                key.Record(constant.value.u);
+            }
+        };
+        auto recordSampleState = [&]()
+        {
+            key.Record(mSampleState.count);
+            key.Record(mSampleState.mask);
+            key.Record(mBlendState.alphaToCoverageEnable);
+        };
+
+        switch (part)
+        {
+        case PipelineLibraryPart::VertexInput:
+            for (const VertexInputAttribute& attribute : mVertexInputAttributes)
+            {
+                key.Record(attribute.bindingBufferSlot);
+                key.Record(attribute.location);
+                key.Record(attribute.format);
+                key.Record(attribute.rate);
+                key.Record(attribute.offsetInElement);
+                key.Record(attribute.elementStride);
+            }
+            key.Record(mRasterState.primitiveType);
+            key.Record(mExtendedDynamicState);
+            break;
+        case PipelineLibraryPart::PreRasterizationShaders:
+            key.RecordObject(mPipelineLayout.Get());
+            recordStage(ShaderStage::Vertex);
+            recordStage(ShaderStage::TessellationControl);
+            recordStage(ShaderStage::TessellationEvaluation);
+            recordStage(ShaderStage::Geometry);
+            key.Record(mRasterState.fillMode);
+            key.Record(mRasterState.cullMode);
+            key.Record(mRasterState.frontFace);
+            key.Record(mRasterState.depthClampEnable);
+            key.Record(mRasterState.lineWidth);
+            key.Record(mDepthStencilState.depthBias);
+            key.Record(mDepthStencilState.depthBiasSlopeScale);
+            key.Record(mViewportCount);
+            key.Record(mPatchControlPoints);
+            key.Record(mExtendedDynamicState);
+            break;
+        case PipelineLibraryPart::FragmentShader:
+            key.RecordObject(mPipelineLayout.Get());
+            recordStage(ShaderStage::Fragment);
+            key.Record(mDepthStencilState.depthTestEnable);
+            key.Record(mDepthStencilState.depthWriteEnable);
+            key.Record(mDepthStencilState.depthCompareOp);
+            key.Record(mDepthStencilState.stencilTestEnable);
+            RecordStencilOpState(&key, mDepthStencilState.frontFaceStencil);
+            RecordStencilOpState(&key, mDepthStencilState.backFaceStencil);
+            key.Record(mExtendedDynamicState);
+            recordSampleState();
+            break;
+        case PipelineLibraryPart::FragmentOutput:
+            key.Record(mColorAttachmentFormats.size());
+            for (size_t i = 0; i < mColorAttachmentFormats.size(); ++i)
+            {
+                const ColorAttachmentBlendState& state = mBlendState.colorAttachmentBlendStates[i];
+                key.Record(mColorAttachmentFormats[i]);
+                key.Record(state.blendEnable);
+                key.Record(state.srcColorBlend);
+                key.Record(state.destColorBlend);
+                key.Record(state.colorBlendOp);
+                key.Record(state.srcAlphaBlend);
+                key.Record(state.destAlphaBlend);
+                key.Record(state.alphaBlendOp);
+                key.Record(state.colorWriteMask);
+            }
+            key.Record(mDepthStencilFormat);
+            recordSampleState();
+            break;
+        default:
+            ASSERT(!"Unreachable");
+            break;
+        }
+        return key;
+    }
+
+    VkPipeline RenderPipeline::CreateLibrary(PipelineLibraryPart part,
+                                             const VkGraphicsPipelineCreateInfo& createInfo,
+                                             const VkPipelineRenderingCreateInfo& renderingCI,
+                                             VkPipelineCache pipelineCache) const
+    {
+        VkPipelineRenderingCreateInfo libraryRenderingCI = renderingCI;
+        libraryRenderingCI.pNext = nullptr;
+
+        VkGraphicsPipelineLibraryCreateInfoEXT libraryCI{};
+        libraryCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+        libraryCI.pNext = &libraryRenderingCI;
+
+        // Libraries keep what link time optimization needs, so the background link can still optimize across them.
+        VkGraphicsPipelineCreateInfo libraryCreateInfo{};
+        libraryCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        libraryCreateInfo.pNext = &libraryCI;
+        libraryCreateInfo.flags = createInfo.flags | VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+                                  VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+        libraryCreateInfo.pDynamicState = createInfo.pDynamicState;
+
+        std::vector<VkPipelineShaderStageCreateInfo> stages;
+        switch (part)
+        {
+        case PipelineLibraryPart::VertexInput:
+            libraryCI.flags = VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+            libraryCreateInfo.pVertexInputState = createInfo.pVertexInputState;
+            libraryCreateInfo.pInputAssemblyState = createInfo.pInputAssemblyState;
+            break;
+        case PipelineLibraryPart::PreRasterizationShaders:
+            libraryCI.flags = VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+            for (uint32_t i = 0; i < createInfo.stageCount; ++i)
+            {
+                if (createInfo.pStages[i].stage != VK_SHADER_STAGE_FRAGMENT_BIT)
+                {
+                    stages.push_back(createInfo.pStages[i]);
+                }
+            }
+            libraryCreateInfo.pViewportState = createInfo.pViewportState;
+            libraryCreateInfo.pRasterizationState = createInfo.pRasterizationState;
+            libraryCreateInfo.pTessellationState = createInfo.pTessellationState;
+            libraryCreateInfo.layout = createInfo.layout;
+            break;
+        case PipelineLibraryPart::FragmentShader:
+            libraryCI.flags = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+            for (uint32_t i = 0; i < createInfo.stageCount; ++i)
+            {
+                if (createInfo.pStages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT)
+                {
+                    stages.push_back(createInfo.pStages[i]);
+                }
+            }
+            libraryCreateInfo.pDepthStencilState = createInfo.pDepthStencilState;
+            libraryCreateInfo.pMultisampleState = createInfo.pMultisampleState;
+            libraryCreateInfo.layout = createInfo.layout;
+            break;
+        case PipelineLibraryPart::FragmentOutput:
+            libraryCI.flags = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+            libraryCreateInfo.pColorBlendState = createInfo.pColorBlendState;
+            libraryCreateInfo.pMultisampleState = createInfo.pMultisampleState;
+            break;
+        default:
+            ASSERT(!"Unreachable");
+            break;
+        }
+        libraryCreateInfo.stageCount = static_cast<uint32_t>(stages.size());
+        libraryCreateInfo.pStages = stages.data();
+
+        Device* device = checked_cast<Device>(mDevice);
+        VkPipeline library = VK_NULL_HANDLE;
+        VkResult err =
+                vkCreateGraphicsPipelines(device->GetHandle(), pipelineCache, 1, &libraryCreateInfo, nullptr, &library);
+        CHECK_VK_RESULT(err, "CreateGraphicsPipelines");
+        return library;
+    }
+
+    VkPipeline RenderPipeline::LinkLibraries(const Libraries& libraries,
+                                             VkPipelineCache pipelineCache,
+                                             bool optimized) const
+    {
+        Device* device = checked_cast<Device>(mDevice);
+
+        VkPipelineLibraryCreateInfoKHR libraryCI{};
+        libraryCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+        libraryCI.libraryCount = static_cast<uint32_t>(libraries.size());
+        libraryCI.pLibraries = libraries.data();
+
+        VkGraphicsPipelineCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = &libraryCI;
+        createInfo.layout = checked_cast<PipelineLayout>(mPipelineLayout.Get())->GetHandle();
+        if (optimized)
+        {
+            createInfo.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+        }
+        if (device->IsDescriptorBufferEnabled())
+        {
+            createInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
 
-        SetDebugName(device, mHandle, "RenderPipeline", GetName());
+        VkPipeline handle = VK_NULL_HANDLE;
+        VkResult err = vkCreateGraphicsPipelines(device->GetHandle(), pipelineCache, 1, &createInfo, nullptr, &handle);
+        CHECK_VK_RESULT(err, "CreateGraphicsPipelines");
+        if (handle != VK_NULL_HANDLE)
+        {
+            SetDebugName(device, handle, "RenderPipeline", GetName());
+            device->GetPipelineLibraryCache()->AddLink(optimized);
+        }
+        return handle;
+    }
 
+    bool RenderPipeline::InitializeFromLibraries(const VkGraphicsPipelineCreateInfo& createInfo,
+                                                 const VkPipelineRenderingCreateInfo& renderingCI,
+                                                 PipelineCacheBase* cache)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+        VkPipelineCache vkPipelineCache = device->GetPipelineCacheHandle(cache);
+
+        Libraries libraries{};
+        for (uint32_t i = 0; i < libraries.size(); ++i)
+        {
+            const PipelineLibraryPart part = static_cast<PipelineLibraryPart>(i);
+            PipelineLibraryKey key = GetLibraryKey(part);
+            libraries[i] = device->GetPipelineLibraryCache()->GetOrCreate(
+                    part, key, [&]() { return CreateLibrary(part, createInfo, renderingCI, vkPipelineCache); });
+            if (libraries[i] == VK_NULL_HANDLE)
+            {
+                // A pipeline failing to initialize is never destroyed, release the parts acquired so far.
+                ReleaseLibraries();
+                return false;
+            }
+            mLibraryKeys.push_back(std::move(key));
+        }
+
+        VkPipeline handle = LinkLibraries(libraries, vkPipelineCache, false);
+        if (handle == VK_NULL_HANDLE)
+        {
+            ReleaseLibraries();
+            return false;
+        }
+        mHandle.store(handle, std::memory_order_release);
+
+        // The task keeps the pipeline alive, the libraries are released once both the task and DestroyImpl ran.
+        mLinkInFlight = true;
+        device->PostPipelineCompilationTask(
+                [pipeline = Ref<RenderPipeline>(this), libraries, cache = Ref<PipelineCacheBase>(cache)]()
+                { pipeline->SwapInOptimizedLink(libraries, cache.Get()); });
         return true;
     }
 
+    void RenderPipeline::SwapInOptimizedLink(const Libraries& libraries, PipelineCacheBase* cache)
+    {
+        Device* device = checked_cast<Device>(mDevice);
+        // The fast linked pipeline stays in use if the optimized link fails.
+        VkPipeline optimized = LinkLibraries(libraries, device->GetPipelineCacheHandle(cache), true);
+
+        {
+            std::lock_guard<std::mutex> lock(mLinkMutex);
+            mLinkInFlight = false;
+            if (!mDestroyed)
+            {
+                if (optimized != VK_NULL_HANDLE)
+                {
+                    mFastLinkedHandle = mHandle.exchange(optimized, std::memory_order_acq_rel);
+                }
+                return;
+            }
+        }
+        // The pipeline was destroyed while linking.
+        if (optimized != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(device->GetHandle(), optimized, nullptr);
+        }
+        ReleaseLibraries();
+    }
+
+    void RenderPipeline::ReleaseLibraries()
+    {
+        Device* device = checked_cast<Device>(mDevice);
+        for (uint32_t i = 0; i < mLibraryKeys.size(); ++i)
+        {
+            device->GetPipelineLibraryCache()->Release(static_cast<PipelineLibraryPart>(i), mLibraryKeys[i]);
+        }
+        mLibraryKeys.clear();
+    }
+
     void RenderPipeline::DestroyImpl()
     {
+        RenderPipelineBase::DestroyImpl();
         Device* device = checked_cast<Device>(mDevice);
 
-        if (mHandle != VK_NULL_HANDLE)
+        VkPipeline handle;
+        VkPipeline fastLinkedHandle;
+        bool linkInFlight;
         {
-            vkDestroyPipeline(device->GetHandle(), mHandle, nullptr);
-            mHandle = VK_NULL_HANDLE;
+            std::lock_guard<std::mutex> lock(mLinkMutex);
+            mDestroyed = true;
+            handle = mHandle.exchange(VK_NULL_HANDLE);
+            fastLinkedHandle = mFastLinkedHandle;
+            mFastLinkedHandle = VK_NULL_HANDLE;
+            linkInFlight = mLinkInFlight;
+        }
+
+        for (VkPipeline pipeline : {handle, fastLinkedHandle})
+        {
+            if (pipeline != VK_NULL_HANDLE)
+            {
+                vkDestroyPipeline(device->GetHandle(), pipeline, nullptr);
+            }
+        }
+        if (!linkInFlight)
+        {
+            ReleaseLibraries();
         }
     }
 
     VkPipeline RenderPipeline::GetHandle() const
     {
-        return mHandle;
+        return mHandle.load(std::memory_order_acquire);
     }
 
     Ref<RenderPipeline> RenderPipeline::Create(Device* device, const RenderPipelineDesc& desc)
     {
-        Ref<RenderPipeline> pipeline = AcquireRef(new RenderPipeline(device, desc));
+        Ref<RenderPipeline> pipeline = CreateUninitialized(device, desc);
         if (!pipeline->Initialize(desc.cache))
         {
             return nullptr;
         }
-        pipeline->TrackResource();
         return pipeline;
     }
+
+    Ref<RenderPipeline> RenderPipeline::CreateUninitialized(Device* device, const RenderPipelineDesc& desc)
+    {
+        return AcquireRef(new RenderPipeline(device, desc));
+    }
 } // namespace rhi::impl::vulkan
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include "common/RenderPipelinebase.h"
+#include "PipelineLibraryCache.h"
 
 namespace rhi::impl::vulkan
 {
@@ -11,14 +16,46 @@ namespace rhi::impl::vulkan
     {
     public:
         static Ref<RenderPipeline> Create(Device* device, const RenderPipelineDesc& desc);
+        // The pipeline still has to be compiled with Initialize.
+        static Ref<RenderPipeline> CreateUninitialized(Device* device, const RenderPipelineDesc& desc);
         VkPipeline GetHandle() const;
 
     private:
         explicit RenderPipeline(Device* device, const RenderPipelineDesc& desc);
         ~RenderPipeline() override;
-        bool Initialize(PipelineCacheBase* cache);
+        bool InitializeImpl(PipelineCacheBase* cache) override;
         void DestroyImpl() override;
 
-        VkPipeline mHandle = VK_NULL_HANDLE;
+        using Libraries = std::array<VkPipeline, static_cast<uint32_t>(PipelineLibraryPart::Count)>;
+        // Fast links the cached library parts, then schedules a link time optimized link in the background.
+        bool InitializeFromLibraries(const VkGraphicsPipelineCreateInfo& createInfo,
+                                     const VkPipelineRenderingCreateInfo& renderingCI,
+                                     PipelineCacheBase* cache);
+        PipelineLibraryKey GetLibraryKey(PipelineLibraryPart part) const;
+        VkPipeline CreateLibrary(PipelineLibraryPart part,
+                                 const VkGraphicsPipelineCreateInfo& createInfo,
+                                 const VkPipelineRenderingCreateInfo& renderingCI,
+                                 VkPipelineCache pipelineCache) const;
+        VkPipeline LinkLibraries(const Libraries& libraries, VkPipelineCache pipelineCache, bool optimized) const;
+        void SwapInOptimizedLink(const Libraries& libraries, PipelineCacheBase* cache);
+        void ReleaseLibraries();
+
+        // Replaced by the link time optimized pipeline once it is ready, command lists read it while recording.
+        std::atomic<VkPipeline> mHandle = VK_NULL_HANDLE;
+        // Guards the swap in of the optimized link against DestroyImpl.
+        std::mutex mLinkMutex;
+        // Command buffers recorded before the swap may still use it, so it lives as long as this pipeline.
+        VkPipeline mFastLinkedHandle = VK_NULL_HANDLE;
+        // An optimized link finishing after it is destroyed right away instead of being swapped in.
+        bool mDestroyed = false;
+        // The libraries are released by whichever of DestroyImpl and the optimized link finishes last.
+        bool mLinkInFlight = false;
+        // Keys of the library parts acquired from the device cache, in part order.
+        std::vector<PipelineLibraryKey> mLibraryKeys;
     };
+
+    VkPrimitiveTopology PrimitiveTopologyConvert(PrimitiveType type);
+    VkCullModeFlagBits CullModeConvert(CullMode mode);
+    VkFrontFace FrontFaceConvert(FrontFace face);
+    VkStencilOp StencilOpConvert(StencilOp op);
 } // namespace rhi::impl::vulkan
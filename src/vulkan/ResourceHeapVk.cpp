@@ -0,0 +1,143 @@
+#include "ResourceHeapVk.h"
+
+#include "../common/Utils.h"
+#include "BindSetLayoutVk.h"
+#include "BindSetVk.h"
+#include "BufferVk.h"
+#include "DeviceVk.h"
+#include "SamplerVk.h"
+#include "TextureVk.h"
+#include "VulkanUtils.h"
+
+#include <vector>
+
+namespace rhi::impl::vulkan
+{
+    static constexpr VkDescriptorType cDescriptorTypes[] = {
+            VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            VK_DESCRIPTOR_TYPE_SAMPLER,
+    };
+
+    // The binding of each slot type is its value in ResourceHeapSlotType.
+    static uint32_t GetBinding(ResourceHeapSlotType type)
+    {
+        return static_cast<uint32_t>(type);
+    }
+
+    Ref<ResourceHeap> ResourceHeap::Create(Device* device, const ResourceHeapDesc& desc)
+    {
+        Ref<ResourceHeap> heap = AcquireRef(new ResourceHeap(device, desc));
+        if (!heap->Initialize(desc))
+        {
+            return nullptr;
+        }
+        heap->TrackResource();
+        return heap;
+    }
+
+    ResourceHeap::ResourceHeap(Device* device, const ResourceHeapDesc& desc)
+        : ResourceHeapBase(device, desc)
+    {}
+
+    ResourceHeap::~ResourceHeap() = default;
+
+    bool ResourceHeap::Initialize(const ResourceHeapDesc& desc)
+    {
+        std::vector<BindSetLayoutEntry> entries;
+        if (desc.sampledTextureCount > 0)
+        {
+            entries.push_back(BindSetLayoutEntry::SampledTexture(
+                    desc.visibility, GetBinding(ResourceHeapSlotType::SampledTexture), desc.sampledTextureCount));
+        }
+        if (desc.storageBufferCount > 0)
+        {
+            entries.push_back(BindSetLayoutEntry::StorageBuffer(
+                    desc.visibility, GetBinding(ResourceHeapSlotType::StorageBuffer), desc.storageBufferCount));
+        }
+        if (desc.samplerCount > 0)
+        {
+            entries.push_back(BindSetLayoutEntry::Sampler(
+                    desc.visibility, GetBinding(ResourceHeapSlotType::Sampler), desc.samplerCount));
+        }
+
+        BindSetLayoutDesc layoutDesc{};
+        layoutDesc.name = desc.name;
+        layoutDesc.entryCount = static_cast<uint32_t>(entries.size());
+        layoutDesc.entries = entries.data();
+
+        Ref<BindSetLayout> layout = BindSetLayout::CreateUpdateAfterBind(mDevice, layoutDesc);
+        if (layout == nullptr)
+        {
+            return false;
+        }
+
+        BindSetDesc setDesc{};
+        setDesc.name = desc.name;
+        setDesc.layout = layout.Get();
+        setDesc.entryCount = 0;
+        setDesc.entries = nullptr;
+
+        Ref<BindSet> bindSet = layout->AllocateBindSet(setDesc);
+        if (bindSet == nullptr ||
+            (bindSet->GetHandle() == VK_NULL_HANDLE && !checked_cast<Device>(mDevice)->IsDescriptorBufferEnabled()))
+        {
+            return false;
+        }
+
+        mBindSetLayout = std::move(layout);
+        mBindSet = std::move(bindSet);
+        return true;
+    }
+
+    void ResourceHeap::WriteDescriptor(ResourceHeapSlotType type,
+                                       uint32_t slot,
+                                       const VkDescriptorImageInfo* imageInfo,
+                                       const VkDescriptorBufferInfo* bufferInfo)
+    {
+        ASSERT(mBindSet != nullptr);
+
+        if (checked_cast<Device>(mDevice)->IsDescriptorBufferEnabled())
+        {
+            checked_cast<BindSet>(mBindSet.Get())->WriteDescriptorBuffer(GetBinding(type), slot, imageInfo, bufferInfo);
+            return;
+        }
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = checked_cast<BindSet>(mBindSet.Get())->GetHandle();
+        write.dstBinding = GetBinding(type);
+        write.dstArrayElement = slot;
+        write.descriptorCount = 1;
+        write.descriptorType = cDescriptorTypes[static_cast<uint32_t>(type)];
+        write.pImageInfo = imageInfo;
+        write.pBufferInfo = bufferInfo;
+
+        vkUpdateDescriptorSets(checked_cast<Device>(mDevice)->GetHandle(), 1, &write, 0, nullptr);
+    }
+
+    void ResourceHeap::WriteSampledTextureImpl(uint32_t slot, TextureViewBase* textureView)
+    {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView = checked_cast<TextureView>(textureView)->GetHandle();
+        imageInfo.imageLayout =
+                ImageLayoutConvert(TextureUsage::SampledBinding, textureView->GetTexture()->APIGetFormat());
+        WriteDescriptor(ResourceHeapSlotType::SampledTexture, slot, &imageInfo, nullptr);
+    }
+
+    void ResourceHeap::WriteStorageBufferImpl(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size)
+    {
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = checked_cast<Buffer>(buffer)->GetHandle();
+        bufferInfo.offset = offset;
+        bufferInfo.range = size;
+        WriteDescriptor(ResourceHeapSlotType::StorageBuffer, slot, nullptr, &bufferInfo);
+    }
+
+    void ResourceHeap::WriteSamplerImpl(uint32_t slot, SamplerBase* sampler)
+    {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = checked_cast<Sampler>(sampler)->GetHandle();
+        WriteDescriptor(ResourceHeapSlotType::Sampler, slot, &imageInfo, nullptr);
+    }
+} // namespace rhi::impl::vulkan
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "common/ResourceHeapBase.h"
+#include "common/Ref.hpp"
+
+namespace rhi::impl::vulkan
+{
+    class Device;
+
+    class ResourceHeap final : public ResourceHeapBase
+    {
+    public:
+        static Ref<ResourceHeap> Create(Device* device, const ResourceHeapDesc& desc);
+
+    private:
+        explicit ResourceHeap(Device* device, const ResourceHeapDesc& desc);
+        ~ResourceHeap() override;
+        bool Initialize(const ResourceHeapDesc& desc);
+
+        void WriteSampledTextureImpl(uint32_t slot, TextureViewBase* textureView) override;
+        void WriteStorageBufferImpl(uint32_t slot, BufferBase* buffer, uint64_t offset, uint64_t size) override;
+        void WriteSamplerImpl(uint32_t slot, SamplerBase* sampler) override;
+        void WriteDescriptor(ResourceHeapSlotType type,
+                             uint32_t slot,
+                             const VkDescriptorImageInfo* imageInfo,
+                             const VkDescriptorBufferInfo* bufferInfo);
+    };
+} // namespace rhi::impl::vulkan
@@ -4,7 +4,7 @@
 #include "ErrorsVk.h"
 #include "VulkanUtils.h"
 
-// #include <spirv_reflect.h>
+#include <cstring>
 
 namespace rhi::impl::vulkan
 {
@@ -27,10 +27,15 @@ namespace rhi::impl::vulkan
 
     bool ShaderModule::Initialize(const ShaderModuleDesc& desc)
     {
+        // Copied into words to get the alignment SPIR-V needs, and released once the module is created.
+        std::vector<uint32_t> spirv(desc.code.size() / sizeof(uint32_t));
+        std::memcpy(spirv.data(), desc.code.data(), spirv.size() * sizeof(uint32_t));
+        Reflect(spirv.data(), spirv.size() * sizeof(uint32_t));
+
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.pCode = mSpirvData.data();
-        createInfo.codeSize = desc.code.size();
+        createInfo.pCode = spirv.data();
+        createInfo.codeSize = spirv.size() * sizeof(uint32_t);
 
         Device* device = checked_cast<Device>(mDevice);
 
@@ -44,6 +49,7 @@ namespace rhi::impl::vulkan
 
     void ShaderModule::DestroyImpl()
     {
+        ShaderModuleBase::DestroyImpl();
         Device* device = checked_cast<Device>(mDevice);
 
         if (mHandle != VK_NULL_HANDLE)
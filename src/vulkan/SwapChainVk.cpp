@@ -308,6 +308,8 @@ namespace rhi::impl::vulkan
                 queue->GetDeleter()->DeleteWhenUnused(fence);
             }
 
+            // Presents of the old swap chain may still be queued on the submission thread.
+            queue->WaitForPendingSubmissions();
             vkDestroySwapchainKHR(device->GetHandle(), oldSwapchain, nullptr);
             oldSwapchain = VK_NULL_HANDLE;
         }
@@ -385,6 +387,11 @@ namespace rhi::impl::vulkan
 
         SurfaceAcquireNextTextureStatus status{};
 
+        if (mOutdated.exchange(false))
+        {
+            Recreate();
+        }
+
         VkSemaphore semaphore = mAquireImageSemaphores[mCurrentFrameIndex];
         VkFence fence = mFrameDoneFences[mCurrentFrameIndex];
 
@@ -423,7 +430,7 @@ namespace rhi::impl::vulkan
                     break;
                 }
                 // Re-initialize the VkSwapchain and try getting the texture again.
-                Initialize(this);
+                Recreate();
                 return AcquireNextTextureImpl(true);
             }
 
@@ -437,18 +444,30 @@ namespace rhi::impl::vulkan
             break;
         }
 
-        VkSemaphoreSubmitInfo& waitInfo = checked_cast<Queue>(device->GetQueue(QueueType::Graphics))
-                                                  ->GetPendingRecordingContext()
-                                                  ->waitSemaphoreSubmitInfos.emplace_back();
-        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-        waitInfo.pNext = nullptr;
-        waitInfo.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-        waitInfo.semaphore = semaphore;
-        waitInfo.value = 0;
+        Queue* queue = checked_cast<Queue>(device->GetQueue(QueueType::Graphics).Get());
+        queue->EnqueueRecording(
+                [queue, semaphore]()
+                {
+                    VkSemaphoreSubmitInfo& waitInfo =
+                            queue->GetPendingRecordingContext()->waitSemaphoreSubmitInfos.emplace_back();
+                    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+                    waitInfo.pNext = nullptr;
+                    waitInfo.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    waitInfo.semaphore = semaphore;
+                    waitInfo.value = 0;
+                });
 
         return status;
     }
 
+    void SwapChain::Recreate()
+    {
+        Device* device = checked_cast<Device>(mDevice);
+        // The queued presents use the images of the current swap chain.
+        device->GetQueue(QueueType::Graphics)->WaitForPendingSubmissions();
+        Initialize(this);
+    }
+
     Ref<TextureViewBase> SwapChain::GetCurrentTextureView()
     {
         return mTextures[mImageIndex].defualtView;
@@ -464,44 +483,54 @@ namespace rhi::impl::vulkan
         Device* device = checked_cast<Device>(mDevice);
         Queue* queue = checked_cast<Queue>(device->GetQueue(QueueType::Graphics).Get());
 
-        VkSemaphore semaphore = mTextures[mImageIndex].renderingDoneSemaphore;
-
-        VkSemaphoreSubmitInfo& signalInfo = queue->GetPendingRecordingContext()->signalSemaphoreSubmitInfos.emplace_back();
-        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-        signalInfo.pNext = nullptr;
-        signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        signalInfo.semaphore = semaphore;
-        signalInfo.value = 0;
-
-        // to ensure that all commandBuffers on this queue have been executed to completion and transition the
-        // colorattchment layout.
-        mTextures[mImageIndex].texture->TransitionUsageNow(
-                queue, cSwapChainImagePresentUsage, mTextures[mImageIndex].texture->GetAllSubresources());
-
-        queue->SubmitPendingCommands(mFrameDoneFences[mCurrentFrameIndex]);
-
-        VkPresentInfoKHR presentInfo{};
-        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = &semaphore;
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = &mHandle;
-        presentInfo.pImageIndices = &mImageIndex;
-
-        VkResult err = vkQueuePresentKHR(queue->GetHandle(), &presentInfo);
-        switch (err)
-        {
-        case VK_SUCCESS:
-        case VK_SUBOPTIMAL_KHR:
-            break;
-        case VK_ERROR_OUT_OF_DATE_KHR:
-            Initialize(this);
-            break;
-        default:
-            {
-                CHECK_VK_RESULT(err, "QueuePresent");
-            }
-        }
+        // The submit and the present go through the submit path of the queue, which holds the submit mutex, orders
+        // them after the work recorded before and keeps the VkQueue on a single thread.
+        queue->EnqueueSubmit(
+                [swapChain = Ref<SwapChain>(this),
+                 queue,
+                 handle = mHandle,
+                 imageIndex = mImageIndex,
+                 texture = mTextures[mImageIndex].texture,
+                 semaphore = mTextures[mImageIndex].renderingDoneSemaphore,
+                 frameDoneFence = mFrameDoneFences[mCurrentFrameIndex]]()
+                {
+                    VkSemaphoreSubmitInfo& signalInfo =
+                            queue->GetPendingRecordingContext()->signalSemaphoreSubmitInfos.emplace_back();
+                    signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+                    signalInfo.pNext = nullptr;
+                    signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                    signalInfo.semaphore = semaphore;
+                    signalInfo.value = 0;
+
+                    // to ensure that all commandBuffers on this queue have been executed to completion and transition
+                    // the colorattchment layout.
+                    texture->TransitionUsageNow(queue, cSwapChainImagePresentUsage, texture->GetAllSubresources());
+
+                    queue->SubmitPendingCommands(frameDoneFence);
+
+                    VkPresentInfoKHR presentInfo{};
+                    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+                    presentInfo.waitSemaphoreCount = 1;
+                    presentInfo.pWaitSemaphores = &semaphore;
+                    presentInfo.swapchainCount = 1;
+                    presentInfo.pSwapchains = &handle;
+                    presentInfo.pImageIndices = &imageIndex;
+
+                    VkResult err = vkQueuePresentKHR(queue->GetHandle(), &presentInfo);
+                    switch (err)
+                    {
+                    case VK_SUCCESS:
+                    case VK_SUBOPTIMAL_KHR:
+                        break;
+                    case VK_ERROR_OUT_OF_DATE_KHR:
+                        swapChain->mOutdated.store(true);
+                        break;
+                    default:
+                        {
+                            CHECK_VK_RESULT(err, "QueuePresent");
+                        }
+                    }
+                });
 
         mCurrentFrameIndex = (mCurrentFrameIndex + 1) % mTextures.size();
     }
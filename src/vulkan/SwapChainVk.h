@@ -2,6 +2,7 @@
 
 #include "common/SwapchainBase.h"
 
+#include <atomic>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -30,6 +31,7 @@ namespace rhi::impl::vulkan
         bool Initialize(SwapChainBase* previous);
         bool CreateSwapChainInternal(SwapChainBase* previous);
         SurfaceAcquireNextTextureStatus AcquireNextTextureImpl(bool isReentrant);
+        void Recreate();
 
         VkSwapchainKHR mHandle = VK_NULL_HANDLE;
 
@@ -49,5 +51,8 @@ namespace rhi::impl::vulkan
         std::vector<PerTexture> mTextures;
 
         uint32_t mImageIndex = UINT32_MAX;
+
+        // Set by a present that found the swap chain out of date, it is recreated by the next acquire.
+        std::atomic<bool> mOutdated = false;
     };
 } // namespace rhi::impl::vulkan
@@ -0,0 +1,169 @@
+#include "TransientDescriptorAllocator.h"
+
+#include "../common/Utils.h"
+#include "BindSetLayoutVk.h"
+#include "DeviceVk.h"
+#include "ErrorsVk.h"
+
+namespace rhi::impl::vulkan
+{
+    TransientDescriptorAllocator::TransientDescriptorAllocator(Device* device) : mDevice(device) {}
+
+    TransientDescriptorAllocator::~TransientDescriptorAllocator()
+    {
+        // The device waited for idle, every set is done being used.
+        for (VkDescriptorPool pool : mFramePools)
+        {
+            vkDestroyDescriptorPool(mDevice->GetHandle(), pool, nullptr);
+        }
+        for (const RetiredPools& retired : mRetiredPools)
+        {
+            for (VkDescriptorPool pool : retired.pools)
+            {
+                vkDestroyDescriptorPool(mDevice->GetHandle(), pool, nullptr);
+            }
+        }
+        for (VkDescriptorPool pool : mFreePools)
+        {
+            vkDestroyDescriptorPool(mDevice->GetHandle(), pool, nullptr);
+        }
+    }
+
+    VkDescriptorSet TransientDescriptorAllocator::Allocate(BindSetLayout* layout)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        VkDescriptorSetLayout layoutHandle = layout->GetHandle();
+
+        VkDescriptorSetAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &layoutHandle;
+
+        // A full pool only means moving on to the next one, a fresh pool has to fit any set.
+        for (uint32_t attempt = 0; attempt < 2; ++attempt)
+        {
+            if (mCurrentPool == VK_NULL_HANDLE && !AcquirePool())
+            {
+                return VK_NULL_HANDLE;
+            }
+
+            allocateInfo.descriptorPool = mCurrentPool;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            VkResult err = vkAllocateDescriptorSets(mDevice->GetHandle(), &allocateInfo, &set);
+            if (err == VK_SUCCESS)
+            {
+                mAllocatedSets.fetch_add(1, std::memory_order_relaxed);
+                return set;
+            }
+            if (err != VK_ERROR_OUT_OF_POOL_MEMORY && err != VK_ERROR_FRAGMENTED_POOL)
+            {
+                CHECK_VK_RESULT(err, "AllocateDescriptorSets");
+                return VK_NULL_HANDLE;
+            }
+            mCurrentPool = VK_NULL_HANDLE;
+        }
+
+        LOG_ERROR("The bind set layout does not fit in a transient descriptor pool.");
+        return VK_NULL_HANDLE;
+    }
+
+    bool TransientDescriptorAllocator::AcquirePool()
+    {
+        if (!mFreePools.empty())
+        {
+            mCurrentPool = mFreePools.back();
+            mFreePools.pop_back();
+            mFramePools.push_back(mCurrentPool);
+            return true;
+        }
+
+        static constexpr std::array<VkDescriptorType, 8> cDescriptorTypes = {
+                VK_DESCRIPTOR_TYPE_SAMPLER,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+        };
+        std::array<VkDescriptorPoolSize, cDescriptorTypes.size()> poolSizes;
+        for (size_t i = 0; i < cDescriptorTypes.size(); ++i)
+        {
+            poolSizes[i] = VkDescriptorPoolSize{cDescriptorTypes[i], cDescriptorsPerTypePerPool};
+        }
+
+        // No VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, sets are only ever released by resetting the pool.
+        VkDescriptorPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.maxSets = cMaxSetsPerPool;
+        createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        createInfo.pPoolSizes = poolSizes.data();
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        VkResult err = vkCreateDescriptorPool(mDevice->GetHandle(), &createInfo, nullptr, &pool);
+        CHECK_VK_RESULT_FALSE(err, "CreateDescriptorPool");
+
+        mCurrentPool = pool;
+        mFramePools.push_back(pool);
+        mPoolCount.fetch_add(1, std::memory_order_relaxed);
+        mPoolCreations.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void TransientDescriptorAllocator::Tick()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::array<uint64_t, 2> completedSerials = {};
+        std::array<uint64_t, 2> lastUsableSerials = {};
+        for (QueueType queueType : {QueueType::Graphics, QueueType::Compute})
+        {
+            Ref<QueueBase> queue = mDevice->GetQueue(queueType);
+            if (queue != nullptr)
+            {
+                const uint32_t index = static_cast<uint32_t>(queueType);
+                completedSerials[index] = queue->GetCompletedSerial();
+                // Sets of this frame may only be used by commands submitted before this tick.
+                lastUsableSerials[index] = queue->GetPendingSubmitSerial() - 1;
+            }
+        }
+
+        if (!mFramePools.empty())
+        {
+            mRetiredPools.push_back({std::move(mFramePools), lastUsableSerials});
+            mFramePools.clear();
+            mCurrentPool = VK_NULL_HANDLE;
+        }
+
+        while (!mRetiredPools.empty())
+        {
+            RetiredPools& retired = mRetiredPools.front();
+            if (retired.serials[0] > completedSerials[0] || retired.serials[1] > completedSerials[1])
+            {
+                break;
+            }
+            for (VkDescriptorPool pool : retired.pools)
+            {
+                vkResetDescriptorPool(mDevice->GetHandle(), pool, 0);
+                mFreePools.push_back(pool);
+            }
+            mPoolResets.fetch_add(retired.pools.size(), std::memory_order_relaxed);
+            mRetiredPools.pop_front();
+        }
+    }
+
+    TransientDescriptorAllocatorStats TransientDescriptorAllocator::GetStats() const
+    {
+        TransientDescriptorAllocatorStats stats{};
+        stats.allocatedSets = mAllocatedSets.load(std::memory_order_relaxed);
+        stats.poolCount = mPoolCount.load(std::memory_order_relaxed);
+        stats.poolCreations = mPoolCreations.load(std::memory_order_relaxed);
+        stats.poolResets = mPoolResets.load(std::memory_order_relaxed);
+        return stats;
+    }
+} // namespace rhi::impl::vulkan
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../common/NoCopyable.h"
+#include "../common/RHIStruct.h"
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace rhi::impl::vulkan
+{
+    class Device;
+    class BindSetLayout;
+
+    struct TransientDescriptorAllocatorStats
+    {
+        uint64_t allocatedSets;
+        uint64_t poolCount;
+        uint64_t poolCreations;
+        // Pools reset with vkResetDescriptorPool once the work of their frame completed.
+        uint64_t poolResets;
+    };
+
+    // Descriptor sets that live until the next device tick. They are linearly allocated from shared pools that are
+    // never freed set by set: the pools used during a frame are retired on Tick and reset as a whole once the
+    // commands submitted up to that point completed on every queue.
+    class TransientDescriptorAllocator : public NonCopyable
+    {
+    public:
+        explicit TransientDescriptorAllocator(Device* device);
+        ~TransientDescriptorAllocator();
+
+        VkDescriptorSet Allocate(BindSetLayout* layout);
+        void Tick();
+
+        TransientDescriptorAllocatorStats GetStats() const;
+
+    private:
+        struct RetiredPools
+        {
+            std::vector<VkDescriptorPool> pools;
+            // Last serial of the graphics and compute queues that may use sets of these pools.
+            std::array<uint64_t, 2> serials;
+        };
+
+        bool AcquirePool();
+
+        static constexpr uint32_t cMaxSetsPerPool = 1024;
+        static constexpr uint32_t cDescriptorsPerTypePerPool = 4096;
+
+        std::mutex mMutex;
+        VkDescriptorPool mCurrentPool = VK_NULL_HANDLE;
+        // Pools allocated from since the last Tick, including the current one.
+        std::vector<VkDescriptorPool> mFramePools;
+        std::deque<RetiredPools> mRetiredPools;
+        std::vector<VkDescriptorPool> mFreePools;
+
+        std::atomic<uint64_t> mAllocatedSets = 0;
+        std::atomic<uint64_t> mPoolCount = 0;
+        std::atomic<uint64_t> mPoolCreations = 0;
+        std::atomic<uint64_t> mPoolResets = 0;
+
+        Device* mDevice;
+    };
+} // namespace rhi::impl::vulkan